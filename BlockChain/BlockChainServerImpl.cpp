@@ -8,7 +8,15 @@
 
 #include <Config/Config.h>
 #include <Crypto.h>
+#include <Crypto/RandomNumberGenerator.h>
+#include <HexUtil.h>
 #include <PMMR/TxHashSet.h>
+#include <PoW/PoWManager.h>
+#include <Infrastructure/Logger.h>
+#include <algorithm>
+
+// Max number of compact blocks whose transactions can still be requested by peers.
+static const size_t MAX_COMPACT_BLOCK_NONCES = 16;
 
 BlockChainServer::BlockChainServer(const Config& config, IDatabase& database)
 	: m_config(config), m_database(database)
@@ -36,6 +44,7 @@ void BlockChainServer::Initialize()
 	m_pTransactionPool = TxPoolAPI::CreateTransactionPool(m_config, *m_pTxHashSetManager, m_database.GetBlockDB());
 	m_pChainState = new ChainState(m_config, *m_pChainStore, *m_pBlockStore, *m_pHeaderMMR, *m_pTransactionPool, *m_pTxHashSetManager);
 	m_pChainState->Initialize(genesisBlock.GetBlockHeader());
+	m_pTxHashSetSnapshotCache = new TxHashSetSnapshotCache(m_config, *m_pChainState);
 
 	m_initialized = true;
 }
@@ -48,6 +57,9 @@ void BlockChainServer::Shutdown()
 
 		m_pChainState->FlushAll();
 
+		delete m_pTxHashSetSnapshotCache;
+		m_pTxHashSetSnapshotCache = nullptr;
+
 		delete m_pChainState;
 		m_pChainState = nullptr;
 
@@ -84,16 +96,28 @@ EBlockChainStatus BlockChainServer::AddBlock(const FullBlock& block)
 }
 
 EBlockChainStatus BlockChainServer::AddCompactBlock(const CompactBlock& compactBlock)
+{
+	return AddCompactBlock(compactBlock, std::vector<Transaction>());
+}
+
+EBlockChainStatus BlockChainServer::AddCompactBlock(const CompactBlock& compactBlock, const std::vector<Transaction>& receivedTransactions)
 {
 	const CBigInteger<32>& hash = compactBlock.GetHash();
 
-	std::unique_ptr<BlockHeader> pConfirmedHeader = m_pChainState->GetBlockHeaderByHeight(compactBlock.GetBlockHeader().GetHeight(), EChainType::CONFIRMED);
+	std::shared_ptr<const BlockHeader> pConfirmedHeader = m_pChainState->GetBlockHeaderByHeight(compactBlock.GetBlockHeader().GetHeight(), EChainType::CONFIRMED);
 	if (pConfirmedHeader != nullptr && pConfirmedHeader->GetHash() == hash)
 	{
 		return EBlockChainStatus::ALREADY_EXISTS;
 	}
 
-	std::unique_ptr<FullBlock> pHydratedBlock = BlockHydrator(*m_pChainState, *m_pTransactionPool).Hydrate(compactBlock);
+	// Hydrating indexes the pool by the block's short ids, so a peer must at least find a proof of work to make us do that.
+	if (!PoWManager(m_config).IsProofValid(compactBlock.GetBlockHeader()))
+	{
+		LoggerAPI::LogWarning("BlockChainServer::AddCompactBlock - Invalid proof of work for compact block " + compactBlock.GetBlockHeader().FormatHash());
+		return EBlockChainStatus::INVALID;
+	}
+
+	std::unique_ptr<FullBlock> pHydratedBlock = BlockHydrator(*m_pTransactionPool).Hydrate(compactBlock, receivedTransactions);
 	if (pHydratedBlock != nullptr)
 	{
 		return AddBlock(*pHydratedBlock);
@@ -102,16 +126,39 @@ EBlockChainStatus BlockChainServer::AddCompactBlock(const CompactBlock& compactB
 	return EBlockChainStatus::TRANSACTIONS_MISSING;
 }
 
+std::vector<ShortId> BlockChainServer::GetMissingShortIds(const CompactBlock& compactBlock) const
+{
+	return BlockHydrator(*m_pTransactionPool).GetMissingShortIds(compactBlock);
+}
+
+std::vector<Transaction> BlockChainServer::GetTransactionsByShortId(const Hash& blockHash, const uint64_t nonce, const std::vector<ShortId>& shortIds) const
+{
+	// Only serve compact blocks that were actually sent, so peers can't force the pool to be reindexed for arbitrary nonces.
+	{
+		std::lock_guard<std::mutex> lockGuard(m_compactBlockNoncesMutex);
+		if (std::find(m_compactBlockNonces.cbegin(), m_compactBlockNonces.cend(), std::make_pair(blockHash, nonce)) == m_compactBlockNonces.cend())
+		{
+			LoggerAPI::LogDebug("BlockChainServer::GetTransactionsByShortId - Transactions requested for unknown compact block " + HexUtil::ConvertHash(blockHash));
+			return std::vector<Transaction>();
+		}
+	}
+
+	return m_pTransactionPool->GetTransactionsByShortId(blockHash, nonce, std::set<ShortId>(shortIds.cbegin(), shortIds.cend()));
+}
+
 EBlockChainStatus BlockChainServer::ProcessTransactionHashSet(const Hash& blockHash, const std::string& path)
 {
-	const bool success = TxHashSetProcessor(m_config, *this, *m_pChainState, m_database.GetBlockDB()).ProcessTxHashSet(blockHash, path);
+	return TxHashSetProcessor(m_config, *this, *m_pChainState, m_database.GetBlockDB()).ProcessTxHashSet(blockHash, path);
+}
 
-	return success ? EBlockChainStatus::SUCCESS : EBlockChainStatus::INVALID;
+EBlockChainStatus BlockChainServer::ProcessTransactionHashSet(const Hash& blockHash, const uint64_t zippedSize, const std::function<size_t(unsigned char*, const size_t)>& readChunk)
+{
+	return TxHashSetProcessor(m_config, *this, *m_pChainState, m_database.GetBlockDB()).ProcessTxHashSet(blockHash, zippedSize, readChunk);
 }
 
 EBlockChainStatus BlockChainServer::AddTransaction(const Transaction& transaction, const EPoolType poolType)
 {
-	std::unique_ptr<BlockHeader> pLastConfimedHeader = m_pChainState->GetBlockHeaderByHeight(m_pChainState->GetHeight(EChainType::CONFIRMED), EChainType::CONFIRMED);
+	std::shared_ptr<const BlockHeader> pLastConfimedHeader = m_pChainState->GetBlockHeaderByHeight(m_pChainState->GetHeight(EChainType::CONFIRMED), EChainType::CONFIRMED);
 	if (pLastConfimedHeader != nullptr)
 	{
 		if (m_pTransactionPool->AddTransaction(transaction, poolType, *pLastConfimedHeader))
@@ -123,6 +170,11 @@ EBlockChainStatus BlockChainServer::AddTransaction(const Transaction& transactio
 	return EBlockChainStatus::INVALID;
 }
 
+std::shared_ptr<const TxHashSetSnapshot> BlockChainServer::GetTxHashSetSnapshot(const uint64_t requestedHeight)
+{
+	return m_pTxHashSetSnapshotCache->GetSnapshot(requestedHeight);
+}
+
 EBlockChainStatus BlockChainServer::AddBlockHeader(const BlockHeader& blockHeader)
 {
 	return BlockHeaderProcessor(m_config, *m_pChainState).ProcessSingleHeader(blockHeader);
@@ -138,7 +190,7 @@ std::vector<BlockHeader> BlockChainServer::GetBlockHeadersByHash(const std::vect
 	std::vector<BlockHeader> headers;
 	for (const CBigInteger<32>& hash : hashes)
 	{
-		std::unique_ptr<BlockHeader> pHeader = m_pChainState->GetBlockHeaderByHash(hash);
+		std::shared_ptr<const BlockHeader> pHeader = m_pChainState->GetBlockHeaderByHash(hash);
 		if (pHeader != nullptr)
 		{
 			headers.push_back(*pHeader);
@@ -148,23 +200,23 @@ std::vector<BlockHeader> BlockChainServer::GetBlockHeadersByHash(const std::vect
 	return headers;
 }
 
-std::unique_ptr<BlockHeader> BlockChainServer::GetBlockHeaderByHeight(const uint64_t height, const EChainType chainType) const
+std::shared_ptr<const BlockHeader> BlockChainServer::GetBlockHeaderByHeight(const uint64_t height, const EChainType chainType) const
 {
 	return m_pChainState->GetBlockHeaderByHeight(height, chainType);
 }
 
-std::unique_ptr<BlockHeader> BlockChainServer::GetBlockHeaderByHash(const CBigInteger<32>& hash) const
+std::shared_ptr<const BlockHeader> BlockChainServer::GetBlockHeaderByHash(const CBigInteger<32>& hash) const
 {
 	return m_pChainState->GetBlockHeaderByHash(hash);
 }
 
-std::unique_ptr<BlockHeader> BlockChainServer::GetBlockHeaderByCommitment(const Hash& outputCommitment) const
+std::shared_ptr<const BlockHeader> BlockChainServer::GetBlockHeaderByCommitment(const Hash& outputCommitment) const
 {
 	// TODO: Implement this
-	return std::unique_ptr<BlockHeader>(nullptr);
+	return std::shared_ptr<const BlockHeader>(nullptr);
 }
 
-std::unique_ptr<BlockHeader> BlockChainServer::GetTipBlockHeader(const EChainType chainType) const
+std::shared_ptr<const BlockHeader> BlockChainServer::GetTipBlockHeader(const EChainType chainType) const
 {
 	return m_pChainState->GetBlockHeaderByHeight(m_pChainState->GetHeight(chainType), chainType);
 }
@@ -182,7 +234,7 @@ std::unique_ptr<FullBlock> BlockChainServer::GetBlockByHash(const Hash& hash) co
 
 std::unique_ptr<FullBlock> BlockChainServer::GetBlockByHeight(const uint64_t height) const
 {
-	std::unique_ptr<BlockHeader> pHeader = m_pChainState->GetBlockHeaderByHeight(height, EChainType::CONFIRMED);
+	std::shared_ptr<const BlockHeader> pHeader = m_pChainState->GetBlockHeaderByHeight(height, EChainType::CONFIRMED);
 	if (pHeader != nullptr)
 	{
 		return m_pChainState->GetBlockByHash(pHeader->GetHash());
@@ -191,6 +243,43 @@ std::unique_ptr<FullBlock> BlockChainServer::GetBlockByHeight(const uint64_t hei
 	return std::unique_ptr<FullBlock>(nullptr);
 }
 
+std::unique_ptr<CompactBlock> BlockChainServer::GetCompactBlockByHash(const Hash& hash) const
+{
+	std::unique_ptr<FullBlock> pBlock = m_pChainState->GetBlockByHash(hash);
+	if (pBlock != nullptr)
+	{
+		const uint64_t nonce = GetCompactBlockNonce(hash);
+		return std::make_unique<CompactBlock>(BlockHydrator::Compact(*pBlock, nonce));
+	}
+
+	return std::unique_ptr<CompactBlock>(nullptr);
+}
+
+//
+// Returns the nonce the compact block with the given hash is sent with, generating one the first time it's sent.
+// Every peer gets the same nonce, so the pool only needs to be indexed once per block.
+//
+uint64_t BlockChainServer::GetCompactBlockNonce(const Hash& hash) const
+{
+	std::lock_guard<std::mutex> lockGuard(m_compactBlockNoncesMutex);
+	for (const std::pair<Hash, uint64_t>& compactBlockNonce : m_compactBlockNonces)
+	{
+		if (compactBlockNonce.first == hash)
+		{
+			return compactBlockNonce.second;
+		}
+	}
+
+	const uint64_t nonce = RandomNumberGenerator::GeneratePseudoRandomNumber(0, UINT64_MAX);
+	m_compactBlockNonces.emplace_back(hash, nonce);
+	if (m_compactBlockNonces.size() > MAX_COMPACT_BLOCK_NONCES)
+	{
+		m_compactBlockNonces.pop_front();
+	}
+
+	return nonce;
+}
+
 std::vector<std::pair<uint64_t, Hash>> BlockChainServer::GetBlocksNeeded(const uint64_t maxNumBlocks) const
 {
 	return m_pChainState->GetBlocksNeeded(maxNumBlocks);
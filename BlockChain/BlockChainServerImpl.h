@@ -3,6 +3,7 @@
 #include "BlockStore.h"
 #include "ChainState.h"
 #include "ChainStore.h"
+#include "TxHashSetSnapshotCache.h"
 
 #include <TxPool/TransactionPool.h>
 #include <BlockChainServer.h>
@@ -10,6 +11,7 @@
 #include <Database/Database.h>
 #include <PMMR/TxHashSetManager.h>
 #include <stdint.h>
+#include <deque>
 #include <mutex>
 
 class BlockChainServer : public IBlockChainServer
@@ -30,26 +32,34 @@ public:
 
 	virtual EBlockChainStatus AddBlock(const FullBlock& block) override final;
 	virtual EBlockChainStatus AddCompactBlock(const CompactBlock& block) override final;
+	virtual EBlockChainStatus AddCompactBlock(const CompactBlock& block, const std::vector<Transaction>& receivedTransactions) override final;
+	virtual std::vector<ShortId> GetMissingShortIds(const CompactBlock& compactBlock) const override final;
+	virtual std::vector<Transaction> GetTransactionsByShortId(const Hash& blockHash, const uint64_t nonce, const std::vector<ShortId>& shortIds) const override final;
 
 	virtual EBlockChainStatus AddBlockHeader(const BlockHeader& blockHeader) override final;
 	virtual EBlockChainStatus AddBlockHeaders(const std::vector<BlockHeader>& blockHeaders) override final;
 
 	virtual EBlockChainStatus ProcessTransactionHashSet(const Hash& blockHash, const std::string& path) override final;
+	virtual EBlockChainStatus ProcessTransactionHashSet(const Hash& blockHash, const uint64_t zippedSize, const std::function<size_t(unsigned char*, const size_t)>& readChunk) override final;
 	virtual EBlockChainStatus AddTransaction(const Transaction& transaction, const EPoolType poolType) override final;
+	virtual std::shared_ptr<const TxHashSetSnapshot> GetTxHashSetSnapshot(const uint64_t requestedHeight) override final;
 
-	virtual std::unique_ptr<BlockHeader> GetBlockHeaderByHeight(const uint64_t height, const EChainType chainType) const override final;
-	virtual std::unique_ptr<BlockHeader> GetBlockHeaderByHash(const CBigInteger<32>& hash) const override final;
-	virtual std::unique_ptr<BlockHeader> GetBlockHeaderByCommitment(const Hash& outputCommitment) const override final;
-	virtual std::unique_ptr<BlockHeader> GetTipBlockHeader(const EChainType chainType) const override final;
+	virtual std::shared_ptr<const BlockHeader> GetBlockHeaderByHeight(const uint64_t height, const EChainType chainType) const override final;
+	virtual std::shared_ptr<const BlockHeader> GetBlockHeaderByHash(const CBigInteger<32>& hash) const override final;
+	virtual std::shared_ptr<const BlockHeader> GetBlockHeaderByCommitment(const Hash& outputCommitment) const override final;
+	virtual std::shared_ptr<const BlockHeader> GetTipBlockHeader(const EChainType chainType) const override final;
 	virtual std::vector<BlockHeader> GetBlockHeadersByHash(const std::vector<CBigInteger<32>>& hashes) const override final;
 
 	virtual std::unique_ptr<FullBlock> GetBlockByCommitment(const Hash& blockHash) const override final;
 	virtual std::unique_ptr<FullBlock> GetBlockByHash(const Hash& blockHash) const override final;
 	virtual std::unique_ptr<FullBlock> GetBlockByHeight(const uint64_t height) const override final;
+	virtual std::unique_ptr<CompactBlock> GetCompactBlockByHash(const Hash& blockHash) const override final;
 
 	virtual std::vector<std::pair<uint64_t, Hash>> GetBlocksNeeded(const uint64_t maxNumBlocks) const override final;
 
 private:
+	uint64_t GetCompactBlockNonce(const Hash& hash) const;
+
 	bool m_initialized = { false };
 	BlockStore* m_pBlockStore;
 	ChainState* m_pChainState;
@@ -57,7 +67,12 @@ private:
 	IHeaderMMR* m_pHeaderMMR;
 	ITransactionPool* m_pTransactionPool;
 	TxHashSetManager* m_pTxHashSetManager;
+	TxHashSetSnapshotCache* m_pTxHashSetSnapshotCache;
 	const Config& m_config;
 
 	IDatabase& m_database;
+
+	// The (hash, nonce) of the most recent compact blocks sent to peers, so GetTransactionsByShortId only indexes the pool for those.
+	mutable std::mutex m_compactBlockNoncesMutex;
+	mutable std::deque<std::pair<Hash, uint64_t>> m_compactBlockNonces;
 };
\ No newline at end of file
@@ -1,36 +1,103 @@
 #include "BlockHydrator.h"
 
 #include <Common/FunctionalUtil.h>
+#include <algorithm>
 
-BlockHydrator::BlockHydrator(const ChainState& chainState, const ITransactionPool& transactionPool)
-	: m_chainState(chainState), m_transactionPool(transactionPool)
+BlockHydrator::BlockHydrator(const ITransactionPool& transactionPool)
+	: m_transactionPool(transactionPool)
 {
 
 }
 
-std::unique_ptr<FullBlock> BlockHydrator::Hydrate(const CompactBlock& compactBlock) const
+std::unique_ptr<FullBlock> BlockHydrator::Hydrate(const CompactBlock& compactBlock, const std::vector<Transaction>& receivedTransactions) const
+{
+	std::set<ShortId> missingShortIds;
+	const std::vector<Transaction> transactions = FindTransactions(compactBlock, receivedTransactions, missingShortIds);
+	if (!missingShortIds.empty())
+	{
+		return std::unique_ptr<FullBlock>(nullptr);
+	}
+
+	return BuildBlock(compactBlock, transactions);
+}
+
+std::vector<ShortId> BlockHydrator::GetMissingShortIds(const CompactBlock& compactBlock) const
+{
+	std::set<ShortId> missingShortIds;
+	FindTransactions(compactBlock, std::vector<Transaction>(), missingShortIds);
+
+	return std::vector<ShortId>(missingShortIds.cbegin(), missingShortIds.cend());
+}
+
+CompactBlock BlockHydrator::Compact(const FullBlock& block, const uint64_t nonce)
+{
+	std::vector<TransactionOutput> coinbaseOutputs;
+	for (const TransactionOutput& output : block.GetTransactionBody().GetOutputs())
+	{
+		if (output.GetFeatures() == EOutputFeatures::COINBASE_OUTPUT)
+		{
+			coinbaseOutputs.push_back(output);
+		}
+	}
+
+	std::vector<TransactionKernel> coinbaseKernels;
+	std::vector<ShortId> shortIds;
+	for (const TransactionKernel& kernel : block.GetTransactionBody().GetKernels())
+	{
+		if (kernel.GetFeatures() == EKernelFeatures::COINBASE_KERNEL)
+		{
+			coinbaseKernels.push_back(kernel);
+		}
+		else
+		{
+			shortIds.push_back(ShortId::Create(kernel.GetHash(), block.GetHash(), nonce));
+		}
+	}
+
+	std::sort(shortIds.begin(), shortIds.end());
+
+	BlockHeader header = block.GetBlockHeader();
+	return CompactBlock(std::move(header), nonce, std::move(coinbaseOutputs), std::move(coinbaseKernels), std::move(shortIds));
+}
+
+//
+// Returns the pool and received transactions with at least one kernel matching a short id of the compact block.
+// The short ids left unmatched are returned in missingShortIds. Received transactions that match nothing are ignored.
+//
+std::vector<Transaction> BlockHydrator::FindTransactions(const CompactBlock& compactBlock, const std::vector<Transaction>& receivedTransactions, std::set<ShortId>& missingShortIds) const
 {
 	const std::vector<ShortId>& shortIds = compactBlock.GetShortIds();
-	if (shortIds.empty())
+	missingShortIds = std::set<ShortId>(shortIds.cbegin(), shortIds.cend());
+	if (missingShortIds.empty())
 	{
-		return Hydrate(compactBlock, std::vector<Transaction>());
+		return std::vector<Transaction>();
 	}
-	else
+
+	const Hash& hash = compactBlock.GetBlockHeader().GetHash();
+	const uint64_t nonce = compactBlock.GetNonce();
+
+	std::vector<Transaction> candidates = m_transactionPool.GetTransactionsByShortId(hash, nonce, missingShortIds);
+	candidates.insert(candidates.end(), receivedTransactions.cbegin(), receivedTransactions.cend());
+
+	std::vector<Transaction> transactions;
+	for (Transaction& candidate : candidates)
 	{
-		const Hash& hash = compactBlock.GetBlockHeader().GetHash();
-		const uint64_t nonce = compactBlock.GetNonce();
-		const std::vector<Transaction> transactions = m_transactionPool.GetTransactionsByShortId(hash, nonce, std::set<ShortId>(shortIds.cbegin(), shortIds.cend()));
+		bool matched = false;
+		for (const TransactionKernel& kernel : candidate.GetBody().GetKernels())
+		{
+			matched = (missingShortIds.erase(ShortId::Create(kernel.GetHash(), hash, nonce)) > 0) || matched;
+		}
 
-		if (transactions.size() == shortIds.size())
+		if (matched)
 		{
-			return Hydrate(compactBlock, transactions);
+			transactions.emplace_back(std::move(candidate));
 		}
 	}
 
-	return std::unique_ptr<FullBlock>(nullptr);
+	return transactions;
 }
 
-std::unique_ptr<FullBlock> BlockHydrator::Hydrate(const CompactBlock& compactBlock, const std::vector<Transaction>& transactions) const
+std::unique_ptr<FullBlock> BlockHydrator::BuildBlock(const CompactBlock& compactBlock, const std::vector<Transaction>& transactions) const
 {
 	std::set<TransactionInput> inputsSet;
 	std::set<TransactionOutput> outputsSet;
@@ -103,8 +170,8 @@ void BlockHydrator::PerformCutThrough(std::vector<TransactionInput>& inputs, std
 	}
 
 	auto filterInputs = [outputCommitments](TransactionInput& input) -> bool { return outputCommitments.count(input.GetCommitment()) > 0; };
-	FunctionalUtil::filter(inputs, filterInputs);
+	inputs = FunctionalUtil::filterNot(inputs, filterInputs);
 
 	auto filterOutputs = [inputCommitments](TransactionOutput& output) -> bool { return inputCommitments.count(output.GetCommitment()) > 0; };
-	FunctionalUtil::filter(outputs, filterOutputs);
+	outputs = FunctionalUtil::filterNot(outputs, filterOutputs);
 }
\ No newline at end of file
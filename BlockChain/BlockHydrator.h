@@ -1,24 +1,37 @@
 #pragma once
 
-#include "ChainState.h"
-
 #include <Core/CompactBlock.h>
 #include <Core/FullBlock.h>
 #include <Core/Transaction.h>
 #include <TxPool/TransactionPool.h>
 #include <memory>
+#include <set>
 
 class BlockHydrator
 {
 public:
-	BlockHydrator(const ChainState& chainState, const ITransactionPool& transactionPool);
+	BlockHydrator(const ITransactionPool& transactionPool);
+
+	//
+	// Rebuilds the full block from the transaction pool and the given transactions received from a peer.
+	// Returns null if any of the compact block's short ids can't be matched to a transaction.
+	//
+	std::unique_ptr<FullBlock> Hydrate(const CompactBlock& compactBlock, const std::vector<Transaction>& receivedTransactions) const;
+
+	//
+	// Returns the short ids of the compact block that don't match any transaction in the transaction pool.
+	//
+	std::vector<ShortId> GetMissingShortIds(const CompactBlock& compactBlock) const;
 
-	std::unique_ptr<FullBlock> Hydrate(const CompactBlock& compactBlock) const;
+	//
+	// Creates a compact block with the given nonce, carrying the coinbase outputs and kernels in full and the short ids of all other kernels.
+	//
+	static CompactBlock Compact(const FullBlock& block, const uint64_t nonce);
 
 private:
-	std::unique_ptr<FullBlock> Hydrate(const CompactBlock& compactBlock, const std::vector<Transaction>& transactions) const;
+	std::vector<Transaction> FindTransactions(const CompactBlock& compactBlock, const std::vector<Transaction>& receivedTransactions, std::set<ShortId>& missingShortIds) const;
+	std::unique_ptr<FullBlock> BuildBlock(const CompactBlock& compactBlock, const std::vector<Transaction>& transactions) const;
 	void PerformCutThrough(std::vector<TransactionInput>& inputs, std::vector<TransactionOutput>& outputs) const;
 
-	const ChainState& m_chainState;
 	const ITransactionPool& m_transactionPool;
 };
\ No newline at end of file
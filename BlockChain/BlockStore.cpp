@@ -1,49 +1,54 @@
 #include "BlockStore.h"
 
 BlockStore::BlockStore(const Config& config, IBlockDB& blockDB)
-	: m_config(config), m_blockDB(blockDB)
+	: m_config(config), m_blockDB(blockDB), m_pHeaders(std::make_shared<HeaderTable>())
 {
 
 }
 
 BlockStore::~BlockStore()
 {
-	for (auto iter = m_blockHeadersByHash.begin(); iter != m_blockHeadersByHash.end(); iter++)
-	{
-		delete iter->second;
-	}
+
 }
 
 void BlockStore::LoadHeaders(const std::vector<Hash>& hashes)
 {
 	std::vector<BlockHeader*> blockHeaders = m_blockDB.LoadBlockHeaders(hashes);
+
+	std::lock_guard<std::mutex> lockGuard(m_headersMutex);
 	for (BlockHeader* pBlockHeader : blockHeaders)
 	{
-		const Hash& hash = pBlockHeader->GetHash();
-		m_blockHeadersByHash.insert({ hash, pBlockHeader });
+		m_pHeaders->Add(*pBlockHeader);
+		delete pBlockHeader;
 	}
 }
 
-std::unique_ptr<BlockHeader> BlockStore::GetBlockHeaderByHash(const Hash& hash) const
+std::shared_ptr<const BlockHeader> BlockStore::GetBlockHeaderByHash(const Hash& hash) const
 {
-	auto iter = m_blockHeadersByHash.find(hash);
-	if (iter != m_blockHeadersByHash.cend())
+	std::lock_guard<std::mutex> lockGuard(m_headersMutex);
+
+	const BlockHeader* pHeader = m_pHeaders->Find(hash);
+	if (pHeader == nullptr)
 	{
-		return std::make_unique<BlockHeader>(*iter->second);
+		std::unique_ptr<BlockHeader> pHeaderFromDB = m_blockDB.GetBlockHeader(hash);
+		if (pHeaderFromDB == nullptr)
+		{
+			return std::shared_ptr<const BlockHeader>(nullptr);
+		}
+
+		pHeader = m_pHeaders->Add(*pHeaderFromDB);
 	}
 
-	return m_blockDB.GetBlockHeader(hash); // TODO: Cache this?
+	return Share(pHeader);
 }
 
 bool BlockStore::AddHeader(const BlockHeader& blockHeader)
 {
-	const Hash& hash = blockHeader.GetHash();
+	std::lock_guard<std::mutex> lockGuard(m_headersMutex);
 
-	auto iter = m_blockHeadersByHash.find(hash);
-	if (iter == m_blockHeadersByHash.cend())
+	if (m_pHeaders->Find(blockHeader.GetHash()) == nullptr)
 	{
-		m_blockHeadersByHash[hash] = new BlockHeader(blockHeader);
-		m_blockDB.AddBlockHeader(blockHeader);
+		m_blockDB.AddBlockHeader(*m_pHeaders->Add(blockHeader));
 
 		return true;
 	}
@@ -53,19 +58,15 @@ bool BlockStore::AddHeader(const BlockHeader& blockHeader)
 
 void BlockStore::AddHeaders(const std::vector<BlockHeader>& blockHeaders)
 {
-	std::vector<BlockHeader*> blockHeadersToAdd;
+	std::vector<const BlockHeader*> blockHeadersToAdd;
 	blockHeadersToAdd.reserve(blockHeaders.size());
 
+	std::lock_guard<std::mutex> lockGuard(m_headersMutex);
 	for (const BlockHeader& blockHeader : blockHeaders)
 	{
-		const Hash& hash = blockHeader.GetHash();
-
-		auto iter = m_blockHeadersByHash.find(hash);
-		if (iter == m_blockHeadersByHash.cend())
+		if (m_pHeaders->Find(blockHeader.GetHash()) == nullptr)
 		{
-			BlockHeader* pHeader = new BlockHeader(blockHeader);
-			m_blockHeadersByHash[hash] = pHeader;
-			blockHeadersToAdd.push_back(pHeader);
+			blockHeadersToAdd.push_back(m_pHeaders->Add(blockHeader));
 		}
 	}
 
@@ -82,4 +83,12 @@ bool BlockStore::AddBlock(const FullBlock& block)
 std::unique_ptr<FullBlock> BlockStore::GetBlockByHash(const Hash& hash) const
 {
 	return m_blockDB.GetBlock(hash);
+}
+
+//
+// Aliases the table's ownership, so sharing a header costs a reference count increment instead of a copy.
+//
+std::shared_ptr<const BlockHeader> BlockStore::Share(const BlockHeader* pHeader) const
+{
+	return std::shared_ptr<const BlockHeader>(m_pHeaders, pHeader);
 }
\ No newline at end of file
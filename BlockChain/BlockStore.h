@@ -1,9 +1,12 @@
 #pragma once
 
+#include "HeaderTable.h"
+
 #include <Config/Config.h>
 #include <Database/BlockDb.h>
 #include <Core/BlockHeader.h>
-#include <map>
+#include <memory>
+#include <mutex>
 
 class BlockStore
 {
@@ -12,7 +15,12 @@ public:
 	~BlockStore();
 
 	void LoadHeaders(const std::vector<Hash>& hashes);
-	std::unique_ptr<BlockHeader> GetBlockHeaderByHash(const Hash& hash) const;
+
+	//
+	// Returns the header shared with the in-memory header table, loading it from the database on first use.
+	// The returned pointer keeps the table alive, so it remains valid even after the BlockStore is destroyed.
+	//
+	std::shared_ptr<const BlockHeader> GetBlockHeaderByHash(const Hash& hash) const;
 
 	bool AddHeader(const BlockHeader& blockHeader);
 	void AddHeaders(const std::vector<BlockHeader>& blockHeaders);
@@ -23,8 +31,11 @@ public:
 	inline IBlockDB& GetBlockDB() { return m_blockDB; }
 
 private:
+	std::shared_ptr<const BlockHeader> Share(const BlockHeader* pHeader) const;
+
 	const Config& m_config;
 	IBlockDB& m_blockDB;
 
-	std::map<Hash, BlockHeader*> m_blockHeadersByHash;
+	mutable std::mutex m_headersMutex;
+	std::shared_ptr<HeaderTable> m_pHeaders;
 };
\ No newline at end of file
@@ -1,7 +1,9 @@
 #include "Chain.h"
 
+#include <algorithm>
+
 Chain::Chain(const EChainType chainType, BlockIndex* pGenesisBlock)
-	: m_chainType(chainType), m_height(0)
+	: m_chainType(chainType), m_height(0), m_firstDirtyHeight(0)
 {
 	pGenesisBlock->AddChainType(m_chainType);
 	m_indices.push_back(pGenesisBlock);
@@ -29,6 +31,7 @@ bool Chain::AddBlock(BlockIndex* pBlockIndex)
 		pBlockIndex->AddChainType(m_chainType);
 		m_indices.push_back(pBlockIndex);
 		m_height++;
+		m_firstDirtyHeight = std::min(m_firstDirtyHeight, (uint64_t)m_height);
 		return true;
 	}
 
@@ -56,6 +59,7 @@ bool Chain::Rewind(const uint64_t lastHeight)
 
 		m_indices.erase(m_indices.begin() + lastHeight + 1, m_indices.end());
 		m_height = lastHeight;
+		m_firstDirtyHeight = std::min(m_firstDirtyHeight, lastHeight + 1);
 	}
 
 	return true;
@@ -14,8 +14,16 @@ public:
 	bool AddBlock(BlockIndex* pBlockIndex);
 	bool Rewind(const uint64_t lastHeight);
 
+	//
+	// The lowest height added or rewound since MarkFlushed was last called.
+	// Everything below it is unchanged since the chain was last written out.
+	//
+	inline uint64_t GetFirstDirtyHeight() const { return m_firstDirtyHeight; }
+	inline void MarkFlushed() { m_firstDirtyHeight = m_height + 1; }
+
 private:
 	const EChainType m_chainType;
 	std::vector<BlockIndex*> m_indices;
 	size_t m_height;
+	uint64_t m_firstDirtyHeight;
 };
\ No newline at end of file
@@ -34,7 +34,7 @@ uint64_t ChainState::GetHeight(const EChainType chainType)
 {
 	std::shared_lock<std::shared_mutex> readLock(m_chainMutex);
 
-	std::unique_ptr<BlockHeader> pHead = GetHead_Locked(chainType);
+	std::shared_ptr<const BlockHeader> pHead = GetHead_Locked(chainType);
 	if (pHead != nullptr)
 	{
 		return pHead->GetHeight();
@@ -47,7 +47,7 @@ uint64_t ChainState::GetTotalDifficulty(const EChainType chainType)
 {
 	std::shared_lock<std::shared_mutex> readLock(m_chainMutex);
 
-	std::unique_ptr<BlockHeader> pHead = GetHead_Locked(chainType);
+	std::shared_ptr<const BlockHeader> pHead = GetHead_Locked(chainType);
 	if (pHead != nullptr)
 	{
 		return pHead->GetTotalDifficulty();
@@ -56,14 +56,14 @@ uint64_t ChainState::GetTotalDifficulty(const EChainType chainType)
 	return 0;
 }
 
-std::unique_ptr<BlockHeader> ChainState::GetBlockHeaderByHash(const Hash& hash)
+std::shared_ptr<const BlockHeader> ChainState::GetBlockHeaderByHash(const Hash& hash)
 {
 	std::shared_lock<std::shared_mutex> readLock(m_chainMutex);
 
 	return m_blockStore.GetBlockHeaderByHash(hash);
 }
 
-std::unique_ptr<BlockHeader> ChainState::GetBlockHeaderByHeight(const uint64_t height, const EChainType chainType)
+std::shared_ptr<const BlockHeader> ChainState::GetBlockHeaderByHeight(const uint64_t height, const EChainType chainType)
 {
 	std::shared_lock<std::shared_mutex> readLock(m_chainMutex);
 
@@ -74,7 +74,7 @@ std::unique_ptr<BlockHeader> ChainState::GetBlockHeaderByHeight(const uint64_t h
 		return m_blockStore.GetBlockHeaderByHash(pBlockIndex->GetHash());
 	}
 
-	return std::unique_ptr<BlockHeader>(nullptr);
+	return std::shared_ptr<const BlockHeader>(nullptr);
 }
 
 std::unique_ptr<FullBlock> ChainState::GetBlockByHash(const Hash& hash)
@@ -116,7 +116,7 @@ std::vector<std::pair<uint64_t, Hash>> ChainState::GetBlocksNeeded(const uint64_
 	return blocksNeeded;
 }
 
-std::unique_ptr<BlockHeader> ChainState::GetHead_Locked(const EChainType chainType)
+std::shared_ptr<const BlockHeader> ChainState::GetHead_Locked(const EChainType chainType)
 {
 	const Hash& headHash = GetHeadHash_Locked(chainType);
 
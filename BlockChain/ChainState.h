@@ -27,8 +27,8 @@ public:
 	uint64_t GetHeight(const EChainType chainType);
 	uint64_t GetTotalDifficulty(const EChainType chainType);
 
-	std::unique_ptr<BlockHeader> GetBlockHeaderByHash(const Hash& hash);
-	std::unique_ptr<BlockHeader> GetBlockHeaderByHeight(const uint64_t height, const EChainType chainType);
+	std::shared_ptr<const BlockHeader> GetBlockHeaderByHash(const Hash& hash);
+	std::shared_ptr<const BlockHeader> GetBlockHeaderByHeight(const uint64_t height, const EChainType chainType);
 	std::unique_ptr<FullBlock> GetBlockByHash(const Hash& hash);
 	std::unique_ptr<FullBlock> GetOrphanBlock(const Hash& hash) const;
 
@@ -38,7 +38,7 @@ public:
 	void FlushAll();
 
 private:
-	std::unique_ptr<BlockHeader> GetHead_Locked(const EChainType chainType);
+	std::shared_ptr<const BlockHeader> GetHead_Locked(const EChainType chainType);
 	const Hash& GetHeadHash_Locked(const EChainType chainType);
 
 	mutable std::shared_mutex m_chainMutex;
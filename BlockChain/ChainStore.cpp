@@ -1,16 +1,34 @@
 #include "ChainStore.h"
 
+#include <Infrastructure/Logger.h>
+#include <Serialization/ByteBuffer.h>
+#include <Serialization/Serializer.h>
+#include <StringUtil.h>
 #include <filesystem>
 #include <FileUtil.h>
+#include <algorithm>
 #include <vector>
 #include <map>
 
+// Each chain's file begins with the height of its first hash.
+static const uint64_t SUFFIX_HEADER_SIZE = 8;
+
+// A chain's file is rewritten to start right after the common prefix once all of its hashes are duplicated in common.chain,
+// or more of them are than not, and at least this many are.
+static const uint64_t MIN_DUPLICATES_TO_REWRITE = 1024;
+
 ChainStore::ChainStore(const Config& config, BlockIndex* pGenesisIndex)
 	: m_config(config),
 	m_confirmedChain(EChainType::CONFIRMED, pGenesisIndex),
 	m_candidateChain(EChainType::CANDIDATE, pGenesisIndex),
 	m_syncChain(EChainType::SYNC, pGenesisIndex),
-	m_loaded(false)
+	m_commonFile(config.GetChainDirectory() + "common.chain"),
+	m_confirmedFile(config.GetChainDirectory() + "confirmed.suffix"),
+	m_candidateFile(config.GetChainDirectory() + "candidate.suffix"),
+	m_syncFile(config.GetChainDirectory() + "sync.suffix"),
+	m_loaded(false),
+	m_hasLegacyFiles(false),
+	m_validCommonHashes(0)
 {
 
 }
@@ -24,104 +42,326 @@ bool ChainStore::Load()
 
 	m_loaded = true;
 
-	const std::string dbPath = m_config.GetChainDirectory();
+	if (!m_commonFile.Load())
+	{
+		return LoadLegacy();
+	}
+
+	// Heights shared by all three chains are given a single BlockIndex.
+	const uint64_t commonSize = m_commonFile.GetSize() / HASH_SIZE;
+	m_validCommonHashes = commonSize;
+	BlockIndex* pPrevious = m_confirmedChain.GetByHeight(0);
+	for (uint64_t height = 1; height < commonSize; height++) // Start at 1 to ignore genesis hash
+	{
+		BlockIndex* pIndex = new BlockIndex(Hash(m_commonFile.Read(height * HASH_SIZE, HASH_SIZE).data()), height, pPrevious);
+		m_syncChain.AddBlock(pIndex);
+		m_candidateChain.AddBlock(pIndex);
+		m_confirmedChain.AddBlock(pIndex);
 
-	// TODO: Use Common Chain (pre-horizon?)
+		pPrevious = pIndex;
+	}
 
 	bool success = true;
-	if (!ReadChain(m_syncChain, dbPath + "sync.chain"))
+	if (!LoadSuffix(m_syncChain, m_syncFile, commonSize))
 	{
 		success = false;
 	}
 
-	if (!ReadChain(m_candidateChain, dbPath + "candidate.chain"))
+	if (!LoadSuffix(m_candidateChain, m_candidateFile, commonSize))
 	{
 		success = false;
 	}
 
-	if (!ReadChain(m_confirmedChain, dbPath + "confirmed.chain"))
+	if (!LoadSuffix(m_confirmedChain, m_confirmedFile, commonSize))
 	{
 		success = false;
 	}
 
-	return false;
+	m_syncChain.MarkFlushed();
+	m_candidateChain.MarkFlushed();
+	m_confirmedChain.MarkFlushed();
+
+	return success;
 }
 
-bool ChainStore::ReadChain(Chain& chain, const std::string& path)
+//
+// A chain's own file takes precedence over common.chain, both for its hashes and for where the chain ends,
+// since a crash during Flush can leave the files from different flushes.
+// Common hashes the chain doesn't agree with are excluded from m_validCommonHashes, so the next Flush replaces them.
+// A file starting past the end of common.chain can't be joined to it, so it's discarded, and the chain is left at the common prefix.
+//
+bool ChainStore::LoadSuffix(Chain& chain, File& suffixFile, const uint64_t commonSize)
 {
-	std::vector<unsigned char> data;
-	if (FileUtil::ReadFile(path, data)) // TODO: Buffered read
+	if (!suffixFile.Load() || suffixFile.GetSize() < SUFFIX_HEADER_SIZE)
 	{
-		BlockIndex* pPrevious = chain.GetByHeight(0);
-		uint64_t height = 1; // Start at 1 to ignore genesis hash
-		while (height * 32 < data.size())
+		return true;
+	}
+
+	ByteBuffer headerBuffer(suffixFile.Read(0, SUFFIX_HEADER_SIZE));
+	const uint64_t startHeight = headerBuffer.ReadU64();
+	if (startHeight > commonSize)
+	{
+		LoggerAPI::LogWarning(StringUtil::Format("ChainStore::LoadSuffix - Chain starts at %llu, but only %llu common hashes were found. Discarding it.", startHeight, commonSize));
+		return true;
+	}
+
+	const uint64_t endHeight = startHeight + ((suffixFile.GetSize() - SUFFIX_HEADER_SIZE) / HASH_SIZE);
+	const uint64_t lastHeight = std::max<uint64_t>(endHeight, 1) - 1;
+	if (chain.GetTip()->GetHeight() > lastHeight)
+	{
+		chain.Rewind(lastHeight);
+		m_validCommonHashes = std::min(m_validCommonHashes, lastHeight + 1);
+	}
+
+	for (uint64_t height = std::max<uint64_t>(startHeight, 1); height < endHeight; height++)
+	{
+		const uint64_t position = SUFFIX_HEADER_SIZE + ((height - startHeight) * HASH_SIZE);
+		const Hash hash(suffixFile.Read(position, HASH_SIZE).data());
+
+		BlockIndex* pCommonIndex = chain.GetByHeight(height);
+		if (pCommonIndex != nullptr)
 		{
-			const Hash hash = Hash(&data[height * 32]);
-			BlockIndex* pIndex = GetOrCreateIndex(hash, height, pPrevious);
-			chain.AddBlock(pIndex);
+			if (pCommonIndex->GetHash() == hash)
+			{
+				continue;
+			}
 
-			pPrevious = pIndex;
-			++height;
+			chain.Rewind(height - 1);
+			m_validCommonHashes = std::min(m_validCommonHashes, height);
 		}
 
-		return true;
+		chain.AddBlock(GetOrCreateIndex(hash, height, chain.GetTip()));
 	}
 
-	return false;
+	return true;
 }
 
+//
+// Ordered so a crash at any point leaves files that Load can join into consistent chains.
+// When common.chain only grows, it's written first, so each chain's file still starts within it.
+// When hashes in common.chain must be replaced, the chains' files are first rewritten to start at the first of those hashes,
+// so they don't depend on the hashes being replaced.
+//
 bool ChainStore::Flush()
 {
-	// Open file for writing
-	const std::string path = m_config.GetChainDirectory();
+	const uint64_t commonHeight = GetCommonHeight();
+	const uint64_t validCommonHashes = GetValidCommonHashes(commonHeight);
+	const bool replacesCommonHashes = validCommonHashes < (m_commonFile.GetSize() / HASH_SIZE);
+	if (!replacesCommonHashes && !FlushCommon(validCommonHashes, commonHeight))
+	{
+		LoggerAPI::LogError("ChainStore::Flush - Failed to write common chain.");
+		return false;
+	}
+
+	const uint64_t suffixCommonHeight = replacesCommonHashes ? std::max<uint64_t>(validCommonHashes, 1) - 1 : commonHeight;
 
 	bool success = true;
-	if (!WriteChain(m_syncChain, path + "sync.chain"))
+	if (!FlushSuffix(m_syncChain, m_syncFile, suffixCommonHeight))
 	{
 		success = false;
 	}
 
-	if (!WriteChain(m_candidateChain, path + "candidate.chain"))
+	if (!FlushSuffix(m_candidateChain, m_candidateFile, suffixCommonHeight))
 	{
 		success = false;
 	}
 
-	if (!WriteChain(m_confirmedChain, path + "confirmed.chain"))
+	if (!FlushSuffix(m_confirmedChain, m_confirmedFile, suffixCommonHeight))
 	{
 		success = false;
 	}
 
-	return success;
+	if (!success)
+	{
+		LoggerAPI::LogError("ChainStore::Flush - Failed to write chains.");
+		return false;
+	}
+
+	if (replacesCommonHashes && !FlushCommon(validCommonHashes, commonHeight))
+	{
+		LoggerAPI::LogError("ChainStore::Flush - Failed to write common chain.");
+		return false;
+	}
+
+	m_syncChain.MarkFlushed();
+	m_candidateChain.MarkFlushed();
+	m_confirmedChain.MarkFlushed();
+
+	if (m_hasLegacyFiles)
+	{
+		const std::string path = m_config.GetChainDirectory();
+		FileUtil::RemoveFile(path + "sync.chain");
+		FileUtil::RemoveFile(path + "candidate.chain");
+		FileUtil::RemoveFile(path + "confirmed.chain");
+		m_hasLegacyFiles = false;
+	}
+
+	return true;
+}
+
+//
+// Hashes in common.chain stay valid up to the first height any chain has changed at, or disagreed with them when loaded,
+// and up to the new common height. Anything past that is truncated by FlushCommon.
+//
+uint64_t ChainStore::GetValidCommonHashes(const uint64_t commonHeight) const
+{
+	const uint64_t firstDirtyHeight = std::min({ m_syncChain.GetFirstDirtyHeight(), m_candidateChain.GetFirstDirtyHeight(), m_confirmedChain.GetFirstDirtyHeight() });
+	const uint64_t storedHashes = m_commonFile.GetSize() / HASH_SIZE;
+	return std::min({ storedHashes, m_validCommonHashes, firstDirtyHeight, commonHeight + 1 });
 }
 
-bool ChainStore::WriteChain(Chain& chain, const std::string& path)
+//
+// Truncates common.chain to its valid hashes, and appends the missing common hashes.
+//
+bool ChainStore::FlushCommon(const uint64_t validHashes, const uint64_t commonHeight)
 {
-	std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::ate);
-	if (!file.is_open())
+	const uint64_t storedHashes = m_commonFile.GetSize() / HASH_SIZE;
+	if (validHashes < storedHashes && !m_commonFile.Rewind(validHashes * HASH_SIZE))
 	{
 		return false;
 	}
 
-	bool success = false;
+	for (uint64_t height = validHashes; height <= commonHeight; height++)
+	{
+		m_commonFile.Append(m_confirmedChain.GetByHeight(height)->GetHash().GetData());
+	}
 
-	// For each block, write hash to file
-	const uint64_t height = chain.GetTip()->GetHeight();
-	for (uint64_t i = 0; i <= height; i++)
+	if (!m_commonFile.Flush())
 	{
-		BlockIndex* pIndex = chain.GetByHeight(i);
-		if (pIndex == nullptr)
+		return false;
+	}
+
+	m_validCommonHashes = commonHeight + 1;
+	return true;
+}
+
+//
+// Appends the chain's hashes past the last valid one in its file, truncating first if the chain was rewound.
+// commonHeight is the height through which common.chain is valid both before and after this flush.
+// If the common prefix has shrunk below the start of the file, or has grown to cover all or most of it,
+// the file is rewritten to begin right after the common prefix.
+//
+bool ChainStore::FlushSuffix(Chain& chain, File& suffixFile, const uint64_t commonHeight)
+{
+	const uint64_t nextCommonHeight = commonHeight + 1;
+
+	bool rewrite = true;
+	uint64_t validEndHeight = nextCommonHeight;
+	if (suffixFile.GetSize() >= SUFFIX_HEADER_SIZE)
+	{
+		ByteBuffer headerBuffer(suffixFile.Read(0, SUFFIX_HEADER_SIZE));
+		const uint64_t startHeight = headerBuffer.ReadU64();
+		const uint64_t endHeight = startHeight + ((suffixFile.GetSize() - SUFFIX_HEADER_SIZE) / HASH_SIZE);
+
+		if (startHeight <= nextCommonHeight)
+		{
+			// Judged by what the file would hold after this flush, so hashes that became common while being appended aren't kept for a flush.
+			const uint64_t chainEndHeight = chain.GetTip()->GetHeight() + 1;
+			const uint64_t duplicates = std::min(chainEndHeight, nextCommonHeight) - startHeight;
+			const uint64_t unique = chainEndHeight - std::min(chainEndHeight, nextCommonHeight);
+			rewrite = (duplicates > 0 && unique == 0) || (duplicates >= MIN_DUPLICATES_TO_REWRITE && duplicates > unique);
+		}
+
+		if (!rewrite)
+		{
+			validEndHeight = std::max(startHeight, std::min(endHeight, chain.GetFirstDirtyHeight()));
+			if (validEndHeight < endHeight && !suffixFile.Rewind(SUFFIX_HEADER_SIZE + ((validEndHeight - startHeight) * HASH_SIZE)))
+			{
+				return false;
+			}
+		}
+	}
+
+	if (rewrite)
+	{
+		if (suffixFile.GetSize() > 0 && !suffixFile.Rewind(0))
+		{
+			return false;
+		}
+
+		Serializer serializer;
+		serializer.Append<uint64_t>(nextCommonHeight);
+		suffixFile.Append(serializer.GetBytes());
+	}
+
+	const uint64_t tipHeight = chain.GetTip()->GetHeight();
+	for (uint64_t height = validEndHeight; height <= tipHeight; height++)
+	{
+		suffixFile.Append(chain.GetByHeight(height)->GetHash().GetData());
+	}
+
+	return suffixFile.Flush();
+}
+
+uint64_t ChainStore::GetCommonHeight()
+{
+	uint64_t height = std::min({ m_syncChain.GetTip()->GetHeight(), m_candidateChain.GetTip()->GetHeight(), m_confirmedChain.GetTip()->GetHeight() });
+	while (height > 0)
+	{
+		const Hash& hash = m_confirmedChain.GetByHeight(height)->GetHash();
+		if (m_syncChain.GetByHeight(height)->GetHash() == hash && m_candidateChain.GetByHeight(height)->GetHash() == hash)
 		{
 			break;
 		}
 
-		file.write((const char*)&pIndex->GetHash().GetData()[0], 32); // TODO: Use a buffered write.
+		--height;
+	}
+
+	return height;
+}
+
+//
+// Reads chains written before the common prefix was split out, where each file held every hash of its chain.
+// They're rewritten in the current format, and removed, by the next Flush.
+//
+bool ChainStore::LoadLegacy()
+{
+	const std::string dbPath = m_config.GetChainDirectory();
+
+	bool success = true;
+	if (!ReadLegacyChain(m_syncChain, dbPath + "sync.chain"))
+	{
+		success = false;
+	}
+
+	if (!ReadLegacyChain(m_candidateChain, dbPath + "candidate.chain"))
+	{
+		success = false;
+	}
+
+	if (!ReadLegacyChain(m_confirmedChain, dbPath + "confirmed.chain"))
+	{
+		success = false;
 	}
 
-	// Close file
-	file.close();
+	m_hasLegacyFiles = success;
+
 	return success;
 }
 
+bool ChainStore::ReadLegacyChain(Chain& chain, const std::string& path)
+{
+	std::vector<unsigned char> data;
+	if (FileUtil::ReadFile(path, data))
+	{
+		BlockIndex* pPrevious = chain.GetByHeight(0);
+		uint64_t height = 1; // Start at 1 to ignore genesis hash
+		while (height * 32 < data.size())
+		{
+			const Hash hash = Hash(&data[height * 32]);
+			BlockIndex* pIndex = GetOrCreateIndex(hash, height, pPrevious);
+			chain.AddBlock(pIndex);
+
+			pPrevious = pIndex;
+			++height;
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
 BlockIndex* ChainStore::GetOrCreateIndex(const Hash& hash, const uint64_t height, BlockIndex* pPreviousIndex)
 {
 	BlockIndex* pSyncIndex = m_syncChain.GetByHeight(height);
@@ -3,7 +3,14 @@
 #include "Chain.h"
 
 #include <Config/Config.h>
-
+#include <Core/File.h>
+
+//
+// Stores the sync, candidate and confirmed chains as memory-mapped arrays of block hashes.
+// The prefix shared by all three chains is stored once (in common.chain), and each chain's file only holds the hashes after it.
+// Flush only writes the hashes added since the last flush, and truncates the files when a chain has been rewound,
+// so startup and flush costs grow with the changes rather than with the height of the chain.
+//
 // TODO: Move to Database
 class ChainStore
 {
@@ -21,13 +28,28 @@ public:
 	inline Chain& GetSyncChain() { return m_syncChain; }
 
 private:
-	bool ReadChain(Chain& chain, const std::string& path);
-	bool WriteChain(Chain& chain, const std::string& path);
+	bool LoadSuffix(Chain& chain, File& suffixFile, const uint64_t commonSize);
+	uint64_t GetValidCommonHashes(const uint64_t commonHeight) const;
+	bool FlushCommon(const uint64_t validHashes, const uint64_t commonHeight);
+	bool FlushSuffix(Chain& chain, File& suffixFile, const uint64_t commonHeight);
+	uint64_t GetCommonHeight();
+
+	bool LoadLegacy();
+	bool ReadLegacyChain(Chain& chain, const std::string& path);
 
 	bool m_loaded;
+	bool m_hasLegacyFiles;
+
+	// Hashes at the start of common.chain that every chain agreed with when it was last loaded or flushed.
+	uint64_t m_validCommonHashes;
 	Chain m_confirmedChain;
 	Chain m_candidateChain;
 	Chain m_syncChain;
 
+	File m_commonFile;
+	File m_confirmedFile;
+	File m_candidateFile;
+	File m_syncFile;
+
 	const Config& m_config;
 };
\ No newline at end of file
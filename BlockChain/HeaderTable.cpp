@@ -0,0 +1,87 @@
+#include "HeaderTable.h"
+
+#include <cstring>
+
+static const size_t HEADERS_PER_CHUNK = 4096;
+static const size_t INITIAL_INDEX_SIZE = 1 << 16;
+
+HeaderTable::HeaderTable()
+	: m_size(0), m_index(INITIAL_INDEX_SIZE, 0)
+{
+
+}
+
+const BlockHeader* HeaderTable::Find(const Hash& hash) const
+{
+	const uint32_t position = m_index[FindSlot(hash)];
+	if (position == 0)
+	{
+		return nullptr;
+	}
+
+	return &GetHeader(position - 1);
+}
+
+const BlockHeader* HeaderTable::Add(const BlockHeader& header)
+{
+	const size_t slot = FindSlot(header.GetHash());
+	if (m_index[slot] != 0)
+	{
+		return &GetHeader(m_index[slot] - 1);
+	}
+
+	if (m_chunks.empty() || m_chunks.back().size() == HEADERS_PER_CHUNK)
+	{
+		m_chunks.emplace_back();
+		m_chunks.back().reserve(HEADERS_PER_CHUNK);
+	}
+
+	m_chunks.back().push_back(header);
+	m_index[slot] = (uint32_t)++m_size;
+
+	// Keep the index at most half full, so probe sequences stay short.
+	if (m_size * 2 > m_index.size())
+	{
+		GrowIndex();
+	}
+
+	return &m_chunks.back().back();
+}
+
+const BlockHeader& HeaderTable::GetHeader(const uint32_t position) const
+{
+	return m_chunks[position / HEADERS_PER_CHUNK][position % HEADERS_PER_CHUNK];
+}
+
+//
+// Returns the slot holding the header with the given hash, or the empty slot where it belongs.
+// Block hashes are uniformly distributed, so their first 8 bytes are used as the slot hash directly.
+//
+size_t HeaderTable::FindSlot(const Hash& hash) const
+{
+	uint64_t hashPrefix = 0;
+	memcpy(&hashPrefix, &hash[0], sizeof(uint64_t));
+
+	const size_t mask = m_index.size() - 1;
+	size_t slot = (size_t)hashPrefix & mask;
+	while (m_index[slot] != 0 && GetHeader(m_index[slot] - 1).GetHash() != hash)
+	{
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+void HeaderTable::GrowIndex()
+{
+	std::vector<uint32_t> oldIndex(m_index.size() * 2, 0);
+	m_index.swap(oldIndex);
+
+	for (const uint32_t position : oldIndex)
+	{
+		if (position != 0)
+		{
+			m_index[FindSlot(GetHeader(position - 1).GetHash())] = position;
+		}
+	}
+}
\ No newline at end of file
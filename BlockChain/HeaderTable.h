@@ -0,0 +1,40 @@
+#pragma once
+
+#include <Core/BlockHeader.h>
+#include <Hash.h>
+#include <vector>
+#include <stdint.h>
+
+//
+// Append-only table of block headers, indexed by hash.
+// Headers are stored in fixed-capacity chunks, so adding a header never moves the ones already in the table,
+// and pointers to them remain valid for the lifetime of the table.
+// The hash index is a flat, open-addressed array of table positions, rather than a node per header.
+// This class is not thread-safe.
+//
+class HeaderTable
+{
+public:
+	HeaderTable();
+
+	const BlockHeader* Find(const Hash& hash) const;
+
+	//
+	// Adds the header, unless a header with the same hash is already in the table.
+	// Returns the header stored in the table.
+	//
+	const BlockHeader* Add(const BlockHeader& header);
+
+	inline size_t GetSize() const { return m_size; }
+
+private:
+	const BlockHeader& GetHeader(const uint32_t position) const;
+	size_t FindSlot(const Hash& hash) const;
+	void GrowIndex();
+
+	std::vector<std::vector<BlockHeader>> m_chunks;
+	size_t m_size;
+
+	// Each slot holds a table position + 1, or 0 if empty.
+	std::vector<uint32_t> m_index;
+};
\ No newline at end of file
@@ -5,6 +5,9 @@
 #include <HeaderMMR.h>
 #include <HexUtil.h>
 #include <StringUtil.h>
+#include <PoW/PoWManager.h>
+#include <async++.h>
+#include <algorithm>
 
 BlockHeaderProcessor::BlockHeaderProcessor(const Config& config, ChainState& chainState)
 	: m_config(config), m_chainState(chainState)
@@ -39,8 +42,8 @@ EBlockChainStatus BlockHeaderProcessor::ProcessSingleHeader(const BlockHeader& h
 	LoggerAPI::LogDebug("BlockHeaderProcessor::ProcessSingleHeader - Processing next candidate header " + header.FormatHash());
 
 	// Validate the header.
-	std::unique_ptr<BlockHeader> pPreviousHeaderPtr = lockedState.m_blockStore.GetBlockHeaderByHash(pLastIndex->GetHash());
-	if (!BlockHeaderValidator(m_config, lockedState.m_headerMMR).IsValidHeader(header, *pPreviousHeaderPtr))
+	std::shared_ptr<const BlockHeader> pPreviousHeaderPtr = lockedState.m_blockStore.GetBlockHeaderByHash(pLastIndex->GetHash());
+	if (!BlockHeaderValidator(m_config, lockedState.m_headerMMR).IsValidHeader(header, *pPreviousHeaderPtr, false))
 	{
 		LoggerAPI::LogError("BlockHeaderProcessor::ProcessSingleHeader - Header failed to validate.");
 		return EBlockChainStatus::INVALID;
@@ -73,15 +76,24 @@ EBlockChainStatus BlockHeaderProcessor::ProcessSyncHeaders(const std::vector<Blo
 		return EBlockChainStatus::INVALID;
 	}
 
-	const size_t size = headers.size();
-	size_t index = 0;
+	// Headers already in the sync chain are skipped before verifying any proofs of work, so peers resending known headers cost nothing.
+	const size_t firstNewIndex = CountKnownSyncHeaders(headers);
+	if (firstNewIndex == headers.size())
+	{
+		LoggerAPI::LogDebug("BlockHeaderProcessor::ProcessSyncHeaders - Headers already processed.");
+		return EBlockChainStatus::ALREADY_EXISTS;
+	}
+
+	// Verify every proof of work before taking the chain lock, so only the cheap sequential checks are done while holding it.
+	const size_t size = VerifyProofsOfWork(headers, firstNewIndex);
+	size_t index = firstNewIndex;
 
 	std::vector<BlockHeader> chunkedHeaders;
 	chunkedHeaders.reserve(32);
 	while (index < size)
 	{
 		chunkedHeaders.push_back(headers[index++]);
-		if (index % 32 == 0)
+		if (chunkedHeaders.size() == 32)
 		{
 			const EBlockChainStatus processChunkStatus = ProcessChunkedSyncHeaders(chunkedHeaders);
 			if (processChunkStatus != EBlockChainStatus::SUCCESS && processChunkStatus != EBlockChainStatus::ALREADY_EXISTS)
@@ -93,12 +105,63 @@ EBlockChainStatus BlockHeaderProcessor::ProcessSyncHeaders(const std::vector<Blo
 		}
 	}
 
+	EBlockChainStatus status = EBlockChainStatus::SUCCESS;
 	if (!chunkedHeaders.empty())
 	{
-		return ProcessChunkedSyncHeaders(chunkedHeaders);
+		status = ProcessChunkedSyncHeaders(chunkedHeaders);
+		if (status != EBlockChainStatus::SUCCESS && status != EBlockChainStatus::ALREADY_EXISTS)
+		{
+			return status;
+		}
 	}
 
-	return EBlockChainStatus::SUCCESS;
+	if (size < headers.size())
+	{
+		LoggerAPI::LogWarning("BlockHeaderProcessor::ProcessSyncHeaders - Invalid Proof of Work for header " + headers[size].FormatHash());
+		return EBlockChainStatus::INVALID;
+	}
+
+	return status;
+}
+
+//
+// Returns the number of leading headers that are already part of the sync chain.
+// Since each header commits to its predecessor, once one header is unknown, the rest are too.
+//
+size_t BlockHeaderProcessor::CountKnownSyncHeaders(const std::vector<BlockHeader>& headers) const
+{
+	LockedChainState lockedState = m_chainState.GetLocked();
+	Chain& syncChain = lockedState.m_chainStore.GetSyncChain();
+
+	size_t numKnown = 0;
+	while (numKnown < headers.size())
+	{
+		const BlockHeader& header = headers[numKnown];
+		BlockIndex* pSyncHeader = syncChain.GetByHeight(header.GetHeight());
+		if (pSyncHeader == nullptr || header.GetHash() != pSyncHeader->GetHash())
+		{
+			break;
+		}
+
+		numKnown++;
+	}
+
+	return numKnown;
+}
+
+//
+// Verifies the proof of work of every header from firstIndex on, using the Async++ threadpool.
+// Returns the index of the first header with an invalid proof, or the number of headers if all are valid.
+//
+size_t BlockHeaderProcessor::VerifyProofsOfWork(const std::vector<BlockHeader>& headers, const size_t firstIndex) const
+{
+	std::vector<uint8_t> validProofs(headers.size() - firstIndex, 0);
+	async::parallel_for(async::irange((size_t)0, validProofs.size()), [this, &headers, firstIndex, &validProofs](const size_t index)
+	{
+		validProofs[index] = PoWManager(m_config).IsProofValid(headers[firstIndex + index]) ? 1 : 0;
+	});
+
+	return firstIndex + (size_t)std::distance(validProofs.cbegin(), std::find(validProofs.cbegin(), validProofs.cend(), 0));
 }
 
 EBlockChainStatus BlockHeaderProcessor::ProcessChunkedSyncHeaders(const std::vector<BlockHeader>& headers)
@@ -140,11 +203,11 @@ EBlockChainStatus BlockHeaderProcessor::ProcessChunkedSyncHeaders(const std::vec
 	headerMMR.Rewind(newHeaders.front().GetHeight());
 
 	// Validate the headers.
-	std::unique_ptr<BlockHeader> pPreviousHeaderPtr = lockedState.m_blockStore.GetBlockHeaderByHash(pPrevIndex->GetHash());
+	std::shared_ptr<const BlockHeader> pPreviousHeaderPtr = lockedState.m_blockStore.GetBlockHeaderByHash(pPrevIndex->GetHash());
 	const BlockHeader* pPreviousHeader = pPreviousHeaderPtr.get();
 	for (auto& header : newHeaders)
 	{
-		if (!BlockHeaderValidator(m_config, headerMMR).IsValidHeader(header, *pPreviousHeader))
+		if (!BlockHeaderValidator(m_config, headerMMR).IsValidHeader(header, *pPreviousHeader, true))
 		{
 			headerMMR.Rollback();
 			return EBlockChainStatus::INVALID;
@@ -218,10 +281,10 @@ bool BlockHeaderProcessor::CheckAndAcceptSyncChain(LockedChainState& lockedState
 	Chain& candidateChain = lockedState.m_chainStore.GetCandidateChain();
 
 	const Hash syncHeadHash = syncChain.GetTip()->GetHash();
-	std::unique_ptr<BlockHeader> pSyncHead = lockedState.m_blockStore.GetBlockHeaderByHash(syncHeadHash);
+	std::shared_ptr<const BlockHeader> pSyncHead = lockedState.m_blockStore.GetBlockHeaderByHash(syncHeadHash);
 
 	const Hash candidateHeadHash = candidateChain.GetTip()->GetHash();
-	std::unique_ptr<BlockHeader> pCandidateHead = lockedState.m_blockStore.GetBlockHeaderByHash(candidateHeadHash);
+	std::shared_ptr<const BlockHeader> pCandidateHead = lockedState.m_blockStore.GetBlockHeaderByHash(candidateHeadHash);
 
 	if (pSyncHead == nullptr || pCandidateHead == nullptr)
 	{
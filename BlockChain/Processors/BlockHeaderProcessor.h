@@ -15,6 +15,8 @@ public:
 	EBlockChainStatus ProcessSingleHeader(const BlockHeader& header);
 
 private:
+	size_t CountKnownSyncHeaders(const std::vector<BlockHeader>& headers) const;
+	size_t VerifyProofsOfWork(const std::vector<BlockHeader>& headers, const size_t firstIndex) const;
 	EBlockChainStatus ProcessChunkedSyncHeaders(const std::vector<BlockHeader>& headers);
 	EBlockChainStatus AddSyncHeaders(LockedChainState& lockedState, const std::vector<BlockHeader>& headers) const;
 	bool CheckAndAcceptSyncChain(LockedChainState& lockedState) const;
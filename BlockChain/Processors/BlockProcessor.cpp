@@ -44,7 +44,7 @@ EBlockChainStatus BlockProcessor::ProcessBlock(const FullBlock& block)
 		EBlockChainStatus status = returnStatus;
 		while (status == EBlockChainStatus::SUCCESS)
 		{
-			std::unique_ptr<BlockHeader> pOrphanHeader = m_chainState.GetBlockHeaderByHeight(++height, EChainType::CANDIDATE);
+			std::shared_ptr<const BlockHeader> pOrphanHeader = m_chainState.GetBlockHeaderByHeight(++height, EChainType::CANDIDATE);
 			if (pOrphanHeader == nullptr)
 			{
 				break;
@@ -97,7 +97,7 @@ EBlockChainStatus BlockProcessor::ProcessNextBlock(const FullBlock& block, Locke
 	Chain& confirmedChain = lockedState.m_chainStore.GetConfirmedChain();
 	confirmedChain.Rewind(block.GetBlockHeader().GetHeight() - 1);
 
-	std::unique_ptr<BlockHeader> pPreviousHeader = lockedState.m_blockStore.GetBlockHeaderByHash(block.GetBlockHeader().GetPreviousBlockHash());
+	std::shared_ptr<const BlockHeader> pPreviousHeader = lockedState.m_blockStore.GetBlockHeaderByHash(block.GetBlockHeader().GetPreviousBlockHash());
 	if (pPreviousHeader == nullptr)
 	{
 		return EBlockChainStatus::STORE_ERROR;
@@ -13,13 +13,13 @@ TxHashSetProcessor::TxHashSetProcessor(const Config& config, IBlockChainServer&
 
 }
 
-bool TxHashSetProcessor::ProcessTxHashSet(const Hash& blockHash, const std::string& path)
+EBlockChainStatus TxHashSetProcessor::ProcessTxHashSet(const Hash& blockHash, const std::string& path)
 {
-	std::unique_ptr<BlockHeader> pHeader = m_chainState.GetBlockHeaderByHash(blockHash);
+	std::shared_ptr<const BlockHeader> pHeader = m_chainState.GetBlockHeaderByHash(blockHash);
 	if (pHeader == nullptr)
 	{
 		LoggerAPI::LogError(StringUtil::Format("TxHashSetProcessor::ProcessTxHashSet - Header not found for hash %s.", HexUtil::ConvertHash(blockHash)));
-		return false;
+		return EBlockChainStatus::NOT_FOUND;
 	}
 
 	// 1. Close Existing TxHashSet
@@ -30,40 +30,82 @@ bool TxHashSetProcessor::ProcessTxHashSet(const Hash& blockHash, const std::stri
 	if (pTxHashSet == nullptr)
 	{
 		LoggerAPI::LogError("TxHashSetProcessor::ProcessTxHashSet - Failed to load " + path);
-		return false;
+		return EBlockChainStatus::INVALID;
+	}
+
+	return ValidateAndStore(pTxHashSet, *pHeader, false);
+}
+
+EBlockChainStatus TxHashSetProcessor::ProcessTxHashSet(const Hash& blockHash, const uint64_t zippedSize, const std::function<size_t(unsigned char*, const size_t)>& readChunk)
+{
+	std::shared_ptr<const BlockHeader> pHeader = m_chainState.GetBlockHeaderByHash(blockHash);
+	if (pHeader == nullptr)
+	{
+		LoggerAPI::LogError(StringUtil::Format("TxHashSetProcessor::ProcessTxHashSet - Header not found for hash %s.", HexUtil::ConvertHash(blockHash).c_str()));
+		return EBlockChainStatus::NOT_FOUND;
+	}
+
+	// 1. Close Existing TxHashSet
+	m_chainState.GetLocked().m_txHashSetManager.Close();
+
+	// 2. Extract TxHashSet as it's received, verifying MMR hashes along the way
+	TxHashSetManager::EStreamFailure failure = TxHashSetManager::EStreamFailure::INVALID_ARCHIVE;
+	ITxHashSet* pTxHashSet = TxHashSetManager::LoadFromStream(m_config, m_blockDB, *pHeader, zippedSize, readChunk, failure);
+	if (pTxHashSet == nullptr)
+	{
+		LoggerAPI::LogError("TxHashSetProcessor::ProcessTxHashSet - Failed to receive TxHashSet for " + pHeader->FormatHash());
+		switch (failure)
+		{
+		case TxHashSetManager::EStreamFailure::INVALID_ARCHIVE:
+			return EBlockChainStatus::INVALID;
+		case TxHashSetManager::EStreamFailure::LOCAL_FAILURE:
+			return EBlockChainStatus::STORE_ERROR;
+		default:
+			return EBlockChainStatus::UNKNOWN_ERROR;
+		}
 	}
 
+	return ValidateAndStore(pTxHashSet, *pHeader, true);
+}
+
+EBlockChainStatus TxHashSetProcessor::ValidateAndStore(ITxHashSet* pTxHashSet, const BlockHeader& header, const bool mmrHashesVerified)
+{
 	// 3. Validate entire TxHashSet
 	Commitment outputSum(CBigInteger<33>::ValueOf(0));
 	Commitment kernelSum(CBigInteger<33>::ValueOf(0));
-	if (!pTxHashSet->Validate(*pHeader, m_blockChainServer, outputSum, kernelSum))
+	if (!pTxHashSet->Validate(header, m_blockChainServer, mmrHashesVerified, outputSum, kernelSum))
 	{
-		LoggerAPI::LogError(StringUtil::Format("TxHashSetProcessor::ProcessTxHashSet - Validation of %s failed.", path.c_str()));
+		LoggerAPI::LogError(StringUtil::Format("TxHashSetProcessor::ValidateAndStore - Validation of TxHashSet for %s failed.", header.FormatHash().c_str()));
 		TxHashSetManager::DestroyTxHashSet(pTxHashSet);
-		return false;
+		return EBlockChainStatus::INVALID;
 	}
 
-	// 4. Add BlockSums to DB
-	const BlockSums blockSums(std::move(outputSum), std::move(kernelSum));
-	m_blockDB.AddBlockSums(pHeader->GetHash(), blockSums);
+	// 4. Add Output positions to DB
+	if (!pTxHashSet->SaveOutputPositions())
+	{
+		LoggerAPI::LogError(StringUtil::Format("TxHashSetProcessor::ValidateAndStore - Failed to save output positions for %s.", header.FormatHash().c_str()));
+		TxHashSetManager::DestroyTxHashSet(pTxHashSet);
+		return EBlockChainStatus::STORE_ERROR;
+	}
 
-	// 5. Add Output positions to DB
-	pTxHashSet->SaveOutputPositions();
+	// 5. Add BlockSums to DB. These are written last, so they're only present once the output positions are.
+	const BlockSums blockSums(std::move(outputSum), std::move(kernelSum));
+	m_blockDB.AddBlockSums(header.GetHash(), blockSums);
 
 	// 6. Store TxHashSet
 	m_chainState.GetLocked().m_txHashSetManager.SetTxHashSet(pTxHashSet);
 
 	// 6. Update confirmed chain
-	if (!UpdateConfirmedChain(*pHeader))
+	if (!UpdateConfirmedChain(header))
 	{
-		LoggerAPI::LogError(StringUtil::Format("TxHashSetProcessor::ProcessTxHashSet - Failed to update confirmed chain for %s.", path.c_str()));
+		LoggerAPI::LogError(StringUtil::Format("TxHashSetProcessor::ValidateAndStore - Failed to update confirmed chain for %s.", header.FormatHash().c_str()));
 		m_chainState.GetLocked().m_txHashSetManager.Close();
-		return false;
+		return EBlockChainStatus::UNKNOWN_ERROR;
 	}
 
 	// TODO: 7. Check for orphans
 
-	return true;
+	return EBlockChainStatus::SUCCESS;
 }
 
 bool TxHashSetProcessor::UpdateConfirmedChain(const BlockHeader& blockHeader)
@@ -2,10 +2,12 @@
 
 #include "../ChainState.h"
 
+#include <BlockChainStatus.h>
 #include <PMMR/TxHashSet.h>
 #include <Config/Config.h>
 #include <Hash.h>
 #include <string>
+#include <functional>
 
 // Forward Declarations
 class IBlockChainServer;
@@ -17,9 +19,16 @@ class TxHashSetProcessor
 public:
 	TxHashSetProcessor(const Config& config, IBlockChainServer& blockChainServer, ChainState& chainState, IBlockDB& blockDB);
 
-	bool ProcessTxHashSet(const Hash& blockHash, const std::string& path);
+	EBlockChainStatus ProcessTxHashSet(const Hash& blockHash, const std::string& path);
+
+	//
+	// Extracts the TxHashSet archive while it's being received, then validates it and updates the confirmed chain.
+	// Returns INVALID only when the archive itself was bad. Local failures, like unwritable files, return STORE_ERROR.
+	//
+	EBlockChainStatus ProcessTxHashSet(const Hash& blockHash, const uint64_t zippedSize, const std::function<size_t(unsigned char*, const size_t)>& readChunk);
 
 private:
+	EBlockChainStatus ValidateAndStore(ITxHashSet* pTxHashSet, const BlockHeader& header, const bool mmrHashesVerified);
 	bool UpdateConfirmedChain(const BlockHeader& blockHeader);
 
 	const Config& m_config;
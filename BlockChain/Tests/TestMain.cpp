@@ -0,0 +1,2 @@
+#define CATCH_CONFIG_MAIN
+#include "Catch2/catch.hpp"
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include <Catch2/catch.hpp>
+
+#include "../BlockHydrator.h"
+
+#include <Config/Genesis.h>
+#include <algorithm>
+
+//
+// Serves GetTransactionsByShortId from a fixed list of transactions, the way the mempool does.
+//
+class TestTransactionPool : public ITransactionPool
+{
+public:
+	TestTransactionPool(const std::vector<Transaction>& transactions) : m_transactions(transactions) { }
+
+	virtual std::vector<Transaction> GetTransactionsByShortId(const Hash& hash, const uint64_t nonce, const std::set<ShortId>& missingShortIds) const override final
+	{
+		std::vector<Transaction> transactions;
+		for (const Transaction& transaction : m_transactions)
+		{
+			for (const TransactionKernel& kernel : transaction.GetBody().GetKernels())
+			{
+				if (missingShortIds.count(ShortId::Create(kernel.GetHash(), hash, nonce)) > 0)
+				{
+					transactions.push_back(transaction);
+					break;
+				}
+			}
+		}
+
+		return transactions;
+	}
+
+	virtual bool AddTransaction(const Transaction&, const EPoolType, const BlockHeader&) override final { return false; }
+	virtual std::vector<Transaction> FindTransactionsByKernel(const std::set<TransactionKernel>&) const override final { return std::vector<Transaction>(); }
+	virtual void ReconcileBlock(const FullBlock&) override final { }
+	virtual std::unique_ptr<Transaction> GetTransactionToStem(const BlockHeader&) override final { return std::unique_ptr<Transaction>(nullptr); }
+	virtual std::unique_ptr<Transaction> GetTransactionToFluff(const BlockHeader&) override final { return std::unique_ptr<Transaction>(nullptr); }
+	virtual std::vector<Transaction> GetExpiredTransactions() const override final { return std::vector<Transaction>(); }
+	virtual bool ValidateTransaction(const Transaction&) const override final { return true; }
+	virtual bool ValidateTransactionBody(const TransactionBody&, const bool) const override final { return true; }
+	virtual std::unique_ptr<Transaction> BuildBlockTemplate(const uint64_t) override final { return std::unique_ptr<Transaction>(nullptr); }
+
+private:
+	std::vector<Transaction> m_transactions;
+};
+
+static TransactionOutput CreateOutput(const unsigned char id, const EOutputFeatures features = EOutputFeatures::DEFAULT_OUTPUT)
+{
+	return TransactionOutput(features, Commitment(CBigInteger<33>::ValueOf(id)), RangeProof(std::vector<unsigned char>(675, id)));
+}
+
+static TransactionKernel CreateKernel(const unsigned char id, const EKernelFeatures features = EKernelFeatures::DEFAULT_KERNEL)
+{
+	return TransactionKernel(features, id, 0, Commitment(CBigInteger<33>::ValueOf(id)), Signature(CBigInteger<64>::ValueOf(id)));
+}
+
+//
+// Creates a transaction with one kernel, spending the given input (if any) and creating the given output.
+//
+static Transaction CreateTransaction(const unsigned char kernelId, const unsigned char outputId, const unsigned char inputId = 0)
+{
+	std::vector<TransactionInput> inputs;
+	if (inputId != 0)
+	{
+		inputs.emplace_back(TransactionInput(EOutputFeatures::DEFAULT_OUTPUT, Commitment(CBigInteger<33>::ValueOf(inputId))));
+	}
+
+	std::vector<TransactionOutput> outputs({ CreateOutput(outputId) });
+	std::vector<TransactionKernel> kernels({ CreateKernel(kernelId) });
+	return Transaction(BlindingFactor(CBigInteger<32>::ValueOf(kernelId)), TransactionBody(std::move(inputs), std::move(outputs), std::move(kernels)));
+}
+
+//
+// Creates a block with a coinbase output and kernel, confirming the given transactions.
+//
+static FullBlock CreateBlock(const std::vector<Transaction>& transactions)
+{
+	std::vector<TransactionInput> inputs;
+	std::vector<TransactionOutput> outputs({ CreateOutput(200, EOutputFeatures::COINBASE_OUTPUT) });
+	std::vector<TransactionKernel> kernels({ CreateKernel(200, EKernelFeatures::COINBASE_KERNEL) });
+	for (const Transaction& transaction : transactions)
+	{
+		const TransactionBody& body = transaction.GetBody();
+		inputs.insert(inputs.end(), body.GetInputs().cbegin(), body.GetInputs().cend());
+		outputs.insert(outputs.end(), body.GetOutputs().cbegin(), body.GetOutputs().cend());
+		kernels.insert(kernels.end(), body.GetKernels().cbegin(), body.GetKernels().cend());
+	}
+
+	std::sort(inputs.begin(), inputs.end());
+	std::sort(outputs.begin(), outputs.end());
+	std::sort(kernels.begin(), kernels.end());
+
+	BlockHeader header = Genesis::FLOONET_GENESIS.GetBlockHeader();
+	return FullBlock(std::move(header), TransactionBody(std::move(inputs), std::move(outputs), std::move(kernels)));
+}
+
+static void RequireSameBody(const TransactionBody& expected, const TransactionBody& actual)
+{
+	REQUIRE(actual.GetInputs() == expected.GetInputs());
+	REQUIRE(actual.GetOutputs() == expected.GetOutputs());
+	REQUIRE(actual.GetKernels() == expected.GetKernels());
+}
+
+TEST_CASE("BlockHydrator::Compact")
+{
+	const std::vector<Transaction> transactions({ CreateTransaction(1, 11), CreateTransaction(2, 12) });
+	const FullBlock block = CreateBlock(transactions);
+
+	const CompactBlock compactBlock = BlockHydrator::Compact(block, 12345);
+	REQUIRE(compactBlock.GetHash() == block.GetHash());
+	REQUIRE(compactBlock.GetNonce() == 12345);
+	REQUIRE(compactBlock.GetOutputs() == std::vector<TransactionOutput>({ CreateOutput(200, EOutputFeatures::COINBASE_OUTPUT) }));
+	REQUIRE(compactBlock.GetKernels() == std::vector<TransactionKernel>({ CreateKernel(200, EKernelFeatures::COINBASE_KERNEL) }));
+
+	std::vector<ShortId> expectedShortIds({
+		ShortId::Create(CreateKernel(1).GetHash(), block.GetHash(), 12345),
+		ShortId::Create(CreateKernel(2).GetHash(), block.GetHash(), 12345)
+	});
+	std::sort(expectedShortIds.begin(), expectedShortIds.end());
+	REQUIRE(compactBlock.GetShortIds() == expectedShortIds);
+}
+
+TEST_CASE("BlockHydrator::Hydrate")
+{
+	const Transaction transaction1 = CreateTransaction(1, 11);
+	const Transaction transaction2 = CreateTransaction(2, 12);
+	const Transaction transaction3 = CreateTransaction(3, 13);
+	const FullBlock block = CreateBlock({ transaction1, transaction2, transaction3 });
+	const CompactBlock compactBlock = BlockHydrator::Compact(block, 7);
+
+	SECTION("All transactions in pool")
+	{
+		const TestTransactionPool transactionPool({ transaction1, transaction2, transaction3, CreateTransaction(4, 14) });
+		const BlockHydrator hydrator(transactionPool);
+		REQUIRE(hydrator.GetMissingShortIds(compactBlock).empty());
+
+		std::unique_ptr<FullBlock> pHydratedBlock = hydrator.Hydrate(compactBlock, std::vector<Transaction>());
+		REQUIRE(pHydratedBlock != nullptr);
+		REQUIRE(pHydratedBlock->GetHash() == block.GetHash());
+		RequireSameBody(block.GetTransactionBody(), pHydratedBlock->GetTransactionBody());
+	}
+
+	SECTION("Missing transactions received from peer")
+	{
+		const TestTransactionPool transactionPool({ transaction2 });
+		const BlockHydrator hydrator(transactionPool);
+
+		std::vector<ShortId> expectedMissing({
+			ShortId::Create(CreateKernel(1).GetHash(), block.GetHash(), 7),
+			ShortId::Create(CreateKernel(3).GetHash(), block.GetHash(), 7)
+		});
+		std::sort(expectedMissing.begin(), expectedMissing.end());
+		REQUIRE(hydrator.GetMissingShortIds(compactBlock) == expectedMissing);
+
+		REQUIRE(hydrator.Hydrate(compactBlock, std::vector<Transaction>()) == nullptr);
+		REQUIRE(hydrator.Hydrate(compactBlock, { transaction1 }) == nullptr);
+
+		// Received transactions that aren't in the block are ignored.
+		std::unique_ptr<FullBlock> pHydratedBlock = hydrator.Hydrate(compactBlock, { CreateTransaction(5, 15), transaction3, transaction1 });
+		REQUIRE(pHydratedBlock != nullptr);
+		RequireSameBody(block.GetTransactionBody(), pHydratedBlock->GetTransactionBody());
+	}
+
+	SECTION("Nothing in pool")
+	{
+		const TestTransactionPool transactionPool({ });
+		const BlockHydrator hydrator(transactionPool);
+		REQUIRE(hydrator.GetMissingShortIds(compactBlock).size() == 3);
+		REQUIRE(hydrator.Hydrate(compactBlock, std::vector<Transaction>()) == nullptr);
+	}
+}
+
+TEST_CASE("BlockHydrator::Hydrate - Coinbase only")
+{
+	const FullBlock block = CreateBlock({ });
+	const CompactBlock compactBlock = BlockHydrator::Compact(block, 7);
+	REQUIRE(compactBlock.GetShortIds().empty());
+
+	const TestTransactionPool transactionPool({ CreateTransaction(1, 11) });
+	std::unique_ptr<FullBlock> pHydratedBlock = BlockHydrator(transactionPool).Hydrate(compactBlock, std::vector<Transaction>());
+	REQUIRE(pHydratedBlock != nullptr);
+	RequireSameBody(block.GetTransactionBody(), pHydratedBlock->GetTransactionBody());
+}
+
+TEST_CASE("BlockHydrator::Hydrate - Cut-through")
+{
+	// transaction2 spends the output created by transaction1, so the block contains neither.
+	const Transaction transaction1 = CreateTransaction(1, 11);
+	const Transaction transaction2 = CreateTransaction(2, 12, 11);
+
+	std::vector<TransactionOutput> outputs({ CreateOutput(200, EOutputFeatures::COINBASE_OUTPUT), CreateOutput(12) });
+	std::vector<TransactionKernel> kernels({ CreateKernel(200, EKernelFeatures::COINBASE_KERNEL), CreateKernel(1), CreateKernel(2) });
+	std::sort(outputs.begin(), outputs.end());
+	std::sort(kernels.begin(), kernels.end());
+	BlockHeader header = Genesis::FLOONET_GENESIS.GetBlockHeader();
+	const FullBlock block(std::move(header), TransactionBody(std::vector<TransactionInput>(), std::move(outputs), std::move(kernels)));
+
+	const CompactBlock compactBlock = BlockHydrator::Compact(block, 7);
+	const TestTransactionPool transactionPool({ transaction1, transaction2 });
+	std::unique_ptr<FullBlock> pHydratedBlock = BlockHydrator(transactionPool).Hydrate(compactBlock, std::vector<Transaction>());
+	REQUIRE(pHydratedBlock != nullptr);
+	RequireSameBody(block.GetTransactionBody(), pHydratedBlock->GetTransactionBody());
+}
\ No newline at end of file
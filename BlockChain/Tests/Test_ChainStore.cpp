@@ -0,0 +1,304 @@
+#include <Catch2/catch.hpp>
+
+#include "../ChainStore.h"
+
+#include <FileUtil.h>
+#include <BitUtil.h>
+#include <filesystem>
+#include <map>
+
+static Config CreateConfig(const std::string& testName)
+{
+	const std::string dataPath = (std::filesystem::temp_directory_path() / testName).string() + "/";
+	std::filesystem::remove_all(dataPath);
+
+	const Environment environment(EEnvironmentType::FLOONET, Genesis::FLOONET_GENESIS, { 83, 59 }, 13414, BitUtil::ConvertToU32(0x03, 0x3C, 0x04, 0xA4), BitUtil::ConvertToU32(0x03, 0x3C, 0x08, 0xDF));
+	return Config(EClientMode::FAST_SYNC, environment, dataPath, DandelionConfig(10, 180, 15, 90), P2PConfig(), DatabaseConfig());
+}
+
+static Hash CreateHash(const uint64_t height, const unsigned char fork)
+{
+	Hash hash;
+	for (size_t i = 0; i < sizeof(uint64_t); i++)
+	{
+		hash[(int)(HASH_SIZE - 1 - i)] = (unsigned char)(height >> (8 * i));
+	}
+
+	hash[0] = fork;
+	return hash;
+}
+
+static BlockIndex* CreateGenesisIndex()
+{
+	return new BlockIndex(CreateHash(0, 0), 0, nullptr);
+}
+
+static void Extend(ChainStore& chainStore, Chain& chain, const uint64_t height, const unsigned char fork)
+{
+	for (uint64_t nextHeight = chain.GetTip()->GetHeight() + 1; nextHeight <= height; nextHeight++)
+	{
+		chain.AddBlock(chainStore.GetOrCreateIndex(CreateHash(nextHeight, fork), nextHeight, chain.GetTip()));
+	}
+}
+
+static void RequireSameChains(ChainStore& expected, ChainStore& actual)
+{
+	for (const EChainType chainType : { EChainType::SYNC, EChainType::CANDIDATE, EChainType::CONFIRMED })
+	{
+		Chain& expectedChain = expected.GetChain(chainType);
+		Chain& actualChain = actual.GetChain(chainType);
+		REQUIRE(actualChain.GetTip()->GetHeight() == expectedChain.GetTip()->GetHeight());
+
+		for (uint64_t height = 0; height <= expectedChain.GetTip()->GetHeight(); height++)
+		{
+			REQUIRE(actualChain.GetByHeight(height)->GetHash() == expectedChain.GetByHeight(height)->GetHash());
+		}
+	}
+}
+
+static void RequireReloadMatches(const Config& config, ChainStore& chainStore)
+{
+	ChainStore reloaded(config, CreateGenesisIndex());
+	REQUIRE(reloaded.Load());
+	RequireSameChains(chainStore, reloaded);
+}
+
+static uint64_t GetCommonFileHashes(const Config& config)
+{
+	return std::filesystem::file_size(config.GetChainDirectory() + "common.chain") / HASH_SIZE;
+}
+
+TEST_CASE("ChainStore - Load and Flush")
+{
+	const Config config = CreateConfig("Test_ChainStore_Load");
+
+	ChainStore chainStore(config, CreateGenesisIndex());
+	chainStore.Load();
+	REQUIRE(chainStore.Flush());
+	RequireReloadMatches(config, chainStore);
+
+	Extend(chainStore, chainStore.GetSyncChain(), 5000, 0);
+	Extend(chainStore, chainStore.GetCandidateChain(), 3000, 0);
+	Extend(chainStore, chainStore.GetConfirmedChain(), 100, 0);
+	REQUIRE(chainStore.Flush());
+	RequireReloadMatches(config, chainStore);
+
+	// Flushing again without changes leaves the files as they are.
+	REQUIRE(chainStore.Flush());
+	RequireReloadMatches(config, chainStore);
+
+	// A reloaded store keeps appending to the files it loaded.
+	ChainStore reloaded(config, CreateGenesisIndex());
+	REQUIRE(reloaded.Load());
+	Extend(reloaded, reloaded.GetConfirmedChain(), 200, 0);
+	Extend(reloaded, reloaded.GetSyncChain(), 5100, 0);
+	REQUIRE(reloaded.Flush());
+	RequireReloadMatches(config, reloaded);
+}
+
+TEST_CASE("ChainStore - Rewind")
+{
+	const Config config = CreateConfig("Test_ChainStore_Rewind");
+
+	ChainStore chainStore(config, CreateGenesisIndex());
+	chainStore.Load();
+	Extend(chainStore, chainStore.GetSyncChain(), 3000, 0);
+	Extend(chainStore, chainStore.GetCandidateChain(), 3000, 0);
+	Extend(chainStore, chainStore.GetConfirmedChain(), 2000, 0);
+	REQUIRE(chainStore.Flush());
+
+	// Rewinding within a chain's own file, then extending on a fork, must replace the old hashes rather than leave them behind.
+	chainStore.GetCandidateChain().Rewind(2500);
+	Extend(chainStore, chainStore.GetCandidateChain(), 2600, 1);
+	REQUIRE(chainStore.Flush());
+	RequireReloadMatches(config, chainStore);
+
+	// A rewind with nothing appended afterwards must shrink the file.
+	chainStore.GetSyncChain().Rewind(2700);
+	REQUIRE(chainStore.Flush());
+	RequireReloadMatches(config, chainStore);
+
+	// Rewind and re-extend several times between flushes.
+	chainStore.GetConfirmedChain().Rewind(1800);
+	Extend(chainStore, chainStore.GetConfirmedChain(), 1900, 2);
+	chainStore.GetConfirmedChain().Rewind(1850);
+	Extend(chainStore, chainStore.GetConfirmedChain(), 1950, 3);
+	REQUIRE(chainStore.Flush());
+	RequireReloadMatches(config, chainStore);
+}
+
+TEST_CASE("ChainStore - Common prefix shrinks and grows")
+{
+	const Config config = CreateConfig("Test_ChainStore_Common");
+
+	ChainStore chainStore(config, CreateGenesisIndex());
+	chainStore.Load();
+	Extend(chainStore, chainStore.GetSyncChain(), 4000, 0);
+	Extend(chainStore, chainStore.GetCandidateChain(), 4000, 0);
+	Extend(chainStore, chainStore.GetConfirmedChain(), 3000, 0);
+	REQUIRE(chainStore.Flush());
+	REQUIRE(GetCommonFileHashes(config) == 3001);
+	RequireReloadMatches(config, chainStore);
+
+	// A reorg below the common prefix shrinks it.
+	chainStore.GetSyncChain().Rewind(1000);
+	chainStore.GetCandidateChain().Rewind(1000);
+	chainStore.GetConfirmedChain().Rewind(1000);
+	Extend(chainStore, chainStore.GetSyncChain(), 4500, 1);
+	Extend(chainStore, chainStore.GetCandidateChain(), 4500, 1);
+	REQUIRE(chainStore.Flush());
+	REQUIRE(GetCommonFileHashes(config) == 1001);
+	RequireReloadMatches(config, chainStore);
+
+	// Once the confirmed chain catches up on the new fork, the prefix grows again.
+	Extend(chainStore, chainStore.GetConfirmedChain(), 4200, 1);
+	REQUIRE(chainStore.Flush());
+	REQUIRE(GetCommonFileHashes(config) == 4201);
+	RequireReloadMatches(config, chainStore);
+
+	// A chain whose hashes are now all in the common file is rewritten without them, leaving only its start height.
+	REQUIRE(std::filesystem::file_size(config.GetChainDirectory() + "confirmed.suffix") == sizeof(uint64_t));
+}
+
+//
+// Snapshots the given chain files, so a flush can be undone for some of them, as if the process crashed partway through it.
+//
+static std::map<std::string, std::vector<unsigned char>> ReadChainFiles(const Config& config, const std::vector<std::string>& fileNames)
+{
+	std::map<std::string, std::vector<unsigned char>> files;
+	for (const std::string& fileName : fileNames)
+	{
+		REQUIRE(FileUtil::ReadFile(config.GetChainDirectory() + fileName, files[fileName]));
+	}
+
+	return files;
+}
+
+static void RestoreChainFiles(const Config& config, const std::map<std::string, std::vector<unsigned char>>& files)
+{
+	for (const auto& file : files)
+	{
+		REQUIRE(FileUtil::SafeWriteToFile(config.GetChainDirectory() + file.first, file.second));
+	}
+}
+
+static void RequireLinkedChains(ChainStore& chainStore)
+{
+	for (const EChainType chainType : { EChainType::SYNC, EChainType::CANDIDATE, EChainType::CONFIRMED })
+	{
+		Chain& chain = chainStore.GetChain(chainType);
+		for (uint64_t height = 1; height <= chain.GetTip()->GetHeight(); height++)
+		{
+			REQUIRE(chain.GetByHeight(height)->GetPrevious() == chain.GetByHeight(height - 1));
+		}
+	}
+}
+
+TEST_CASE("ChainStore - Crash during Flush")
+{
+	const Config config = CreateConfig("Test_ChainStore_Crash");
+	const std::vector<std::string> suffixFiles = { "sync.suffix", "candidate.suffix", "confirmed.suffix" };
+
+	ChainStore chainStore(config, CreateGenesisIndex());
+	chainStore.Load();
+	Extend(chainStore, chainStore.GetSyncChain(), 4000, 0);
+	Extend(chainStore, chainStore.GetCandidateChain(), 4000, 0);
+	Extend(chainStore, chainStore.GetConfirmedChain(), 3000, 0);
+	REQUIRE(chainStore.Flush());
+
+	SECTION("Before the chains are written, while common.chain grows")
+	{
+		ChainStore flushed(config, CreateGenesisIndex());
+		REQUIRE(flushed.Load());
+
+		const auto oldSuffixes = ReadChainFiles(config, suffixFiles);
+		Extend(chainStore, chainStore.GetConfirmedChain(), 3500, 0);
+		Extend(chainStore, chainStore.GetSyncChain(), 4500, 0);
+		REQUIRE(chainStore.Flush());
+		RestoreChainFiles(config, oldSuffixes);
+
+		// The chains are loaded as of the previous flush.
+		ChainStore reloaded(config, CreateGenesisIndex());
+		REQUIRE(reloaded.Load());
+		RequireSameChains(flushed, reloaded);
+	}
+
+	SECTION("Before common.chain is truncated")
+	{
+		const auto oldCommon = ReadChainFiles(config, { "common.chain" });
+		chainStore.GetSyncChain().Rewind(1000);
+		chainStore.GetCandidateChain().Rewind(1000);
+		chainStore.GetConfirmedChain().Rewind(1000);
+		Extend(chainStore, chainStore.GetSyncChain(), 4500, 1);
+		Extend(chainStore, chainStore.GetCandidateChain(), 4500, 1);
+		Extend(chainStore, chainStore.GetConfirmedChain(), 1500, 1);
+		REQUIRE(chainStore.Flush());
+		RestoreChainFiles(config, oldCommon);
+
+		// The chains' files already hold everything past the hashes being replaced.
+		ChainStore reloaded(config, CreateGenesisIndex());
+		REQUIRE(reloaded.Load());
+		RequireSameChains(chainStore, reloaded);
+
+		// The next flush replaces the stale common hashes, even though none of the chains changed below them since loading.
+		Extend(reloaded, reloaded.GetConfirmedChain(), 4200, 1);
+		REQUIRE(reloaded.Flush());
+		REQUIRE(GetCommonFileHashes(config) == 4201);
+		RequireReloadMatches(config, reloaded);
+	}
+
+	SECTION("After common.chain is truncated, with the chains' files from before")
+	{
+		// Flushes that replace common hashes no longer write in this order, but files left by one must still load.
+		const auto oldSuffixes = ReadChainFiles(config, suffixFiles);
+		chainStore.GetSyncChain().Rewind(1000);
+		chainStore.GetCandidateChain().Rewind(1000);
+		chainStore.GetConfirmedChain().Rewind(1000);
+		Extend(chainStore, chainStore.GetSyncChain(), 4500, 1);
+		Extend(chainStore, chainStore.GetCandidateChain(), 4500, 1);
+		REQUIRE(chainStore.Flush());
+		RestoreChainFiles(config, oldSuffixes);
+
+		// Files starting past the end of common.chain are discarded, leaving those chains at the common prefix.
+		ChainStore reloaded(config, CreateGenesisIndex());
+		REQUIRE(reloaded.Load());
+		RequireLinkedChains(reloaded);
+		REQUIRE(reloaded.GetConfirmedChain().GetTip()->GetHeight() == 1000);
+		REQUIRE(reloaded.GetConfirmedChain().GetTip()->GetHash() == CreateHash(1000, 0));
+	}
+}
+
+TEST_CASE("ChainStore - Legacy conversion")
+{
+	const Config config = CreateConfig("Test_ChainStore_Legacy");
+
+	// The old format stored every hash of each chain, genesis included.
+	const std::vector<std::pair<std::string, uint64_t>> legacyChains = { { "sync.chain", 2500 }, { "candidate.chain", 2000 }, { "confirmed.chain", 1500 } };
+	for (const auto& legacyChain : legacyChains)
+	{
+		std::vector<unsigned char> data;
+		for (uint64_t height = 0; height <= legacyChain.second; height++)
+		{
+			const Hash hash = CreateHash(height, 0);
+			data.insert(data.end(), hash.GetData().cbegin(), hash.GetData().cend());
+		}
+
+		REQUIRE(FileUtil::SafeWriteToFile(config.GetChainDirectory() + legacyChain.first, data));
+	}
+
+	ChainStore chainStore(config, CreateGenesisIndex());
+	REQUIRE(chainStore.Load());
+	REQUIRE(chainStore.GetSyncChain().GetTip()->GetHeight() == 2500);
+	REQUIRE(chainStore.GetCandidateChain().GetTip()->GetHeight() == 2000);
+	REQUIRE(chainStore.GetConfirmedChain().GetTip()->GetHeight() == 1500);
+	REQUIRE(chainStore.GetSyncChain().GetByHeight(1200)->GetHash() == CreateHash(1200, 0));
+
+	// The legacy files are only removed once the new ones have been written.
+	REQUIRE(chainStore.Flush());
+	for (const auto& legacyChain : legacyChains)
+	{
+		REQUIRE(!std::filesystem::exists(config.GetChainDirectory() + legacyChain.first));
+	}
+
+	RequireReloadMatches(config, chainStore);
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "TxHashSetSnapshotCache.h"
+
+#include <Consensus/BlockTime.h>
+#include <PMMR/TxHashSetManager.h>
+#include <Infrastructure/Logger.h>
+#include <StringUtil.h>
+#include <HexUtil.h>
+#include <filesystem>
+
+TxHashSetSnapshotCache::TxHashSetSnapshotCache(const Config& config, ChainState& chainState)
+	: m_config(config), m_chainState(chainState), m_creating(false)
+{
+
+}
+
+std::shared_ptr<const TxHashSetSnapshot> TxHashSetSnapshotCache::GetSnapshot(const uint64_t requestedHeight)
+{
+	{
+		std::lock_guard<std::mutex> lockGuard(m_mutex);
+
+		if (m_pSnapshot != nullptr)
+		{
+			const BlockHeader& header = m_pSnapshot->GetHeader();
+			if (!IsConfirmed(header))
+			{
+				LoggerAPI::LogInfo("TxHashSetSnapshotCache::GetSnapshot - Discarding snapshot for reorged block " + header.FormatHash());
+				m_pSnapshot.reset();
+			}
+			else if (IsUsable(header, requestedHeight))
+			{
+				return m_pSnapshot;
+			}
+		}
+
+		if (m_creating)
+		{
+			LoggerAPI::LogInfo("TxHashSetSnapshotCache::GetSnapshot - A snapshot is already being created.");
+			return nullptr;
+		}
+
+		m_creating = true;
+	}
+
+	std::shared_ptr<const TxHashSetSnapshot> pSnapshot = CreateSnapshot(requestedHeight);
+
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	m_creating = false;
+	if (pSnapshot != nullptr)
+	{
+		// Peers still downloading the old snapshot keep it alive until they're done.
+		m_pSnapshot = pSnapshot;
+	}
+
+	return pSnapshot;
+}
+
+bool TxHashSetSnapshotCache::IsConfirmed(const BlockHeader& header) const
+{
+	std::shared_ptr<const BlockHeader> pConfirmedHeader = m_chainState.GetBlockHeaderByHeight(header.GetHeight(), EChainType::CONFIRMED);
+	return pConfirmedHeader != nullptr && pConfirmedHeader->GetHash() == header.GetHash();
+}
+
+bool TxHashSetSnapshotCache::IsUsable(const BlockHeader& header, const uint64_t requestedHeight) const
+{
+	return header.GetHeight() >= requestedHeight && header.GetHeight() <= (requestedHeight + Consensus::STATE_SYNC_THRESHOLD);
+}
+
+std::shared_ptr<const TxHashSetSnapshot> TxHashSetSnapshotCache::CreateSnapshot(const uint64_t requestedHeight)
+{
+	const std::string snapshotDir = m_config.GetTxHashSetDirectory() + "snapshot/";
+
+	std::shared_ptr<const BlockHeader> pHeader = nullptr;
+	std::vector<std::pair<std::string, uint64_t>> filesToCopy;
+	{
+		// Only the leaf sets and prune lists are saved while no blocks can be applied.
+		// The MMR files are append-only, so their current sizes are enough to copy them once the lock is released.
+		LockedChainState lockedState = m_chainState.GetLocked();
+		const Hash& tipHash = lockedState.m_chainStore.GetConfirmedChain().GetTip()->GetHash();
+		pHeader = lockedState.m_blockStore.GetBlockHeaderByHash(tipHash);
+		if (pHeader == nullptr || !IsUsable(*pHeader, requestedHeight))
+		{
+			return nullptr;
+		}
+
+		if (!lockedState.m_txHashSetManager.SaveSnapshot(*pHeader, snapshotDir, filesToCopy))
+		{
+			LoggerAPI::LogError("TxHashSetSnapshotCache::CreateSnapshot - Failed to save snapshot for " + pHeader->FormatHash());
+			return nullptr;
+		}
+	}
+
+	if (!TxHashSetManager::CopySnapshotFiles(m_config, snapshotDir, filesToCopy))
+	{
+		LoggerAPI::LogError("TxHashSetSnapshotCache::CreateSnapshot - Failed to copy MMR files for " + pHeader->FormatHash());
+		return nullptr;
+	}
+
+	// If the block was rewound while copying, the copied files may be missing data it committed to.
+	if (!IsConfirmed(*pHeader))
+	{
+		LoggerAPI::LogInfo("TxHashSetSnapshotCache::CreateSnapshot - Block reorged while copying snapshot " + pHeader->FormatHash());
+		return nullptr;
+	}
+
+	const std::string zipPath = m_config.GetTxHashSetDirectory() + StringUtil::Format("txhashset_%s.zip", HexUtil::ConvertHash(pHeader->GetHash()).c_str());
+	if (!TxHashSetManager::ZipSnapshot(m_config, *pHeader, snapshotDir, zipPath))
+	{
+		LoggerAPI::LogError("TxHashSetSnapshotCache::CreateSnapshot - Failed to zip snapshot for " + pHeader->FormatHash());
+		return nullptr;
+	}
+
+	std::error_code errorCode;
+	const uint64_t zippedSize = std::filesystem::file_size(zipPath, errorCode);
+	if (errorCode)
+	{
+		return nullptr;
+	}
+
+	LoggerAPI::LogInfo(StringUtil::Format("TxHashSetSnapshotCache::CreateSnapshot - Created %llu byte snapshot at height %llu.", zippedSize, pHeader->GetHeight()));
+	return std::make_shared<const TxHashSetSnapshot>(*pHeader, zipPath, zippedSize);
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "ChainState.h"
+
+#include <PMMR/TxHashSetSnapshot.h>
+#include <Config/Config.h>
+#include <memory>
+#include <mutex>
+
+//
+// Keeps the most recent TxHashSet snapshot on disk, so it can be served to every peer that requests state until the horizon moves past it.
+//
+class TxHashSetSnapshotCache
+{
+public:
+	TxHashSetSnapshotCache(const Config& config, ChainState& chainState);
+
+	//
+	// Returns the cached snapshot if it's still on the confirmed chain and usable by a peer requesting state at requestedHeight.
+	// Otherwise, a new snapshot is taken at the confirmed tip, if the tip is usable and no other snapshot is being taken.
+	// A snapshot is usable if its block is no lower than the requested height, and no higher than the requester's header tip,
+	// which is STATE_SYNC_THRESHOLD blocks above the requested height.
+	// Returns null if no usable snapshot could be found or created.
+	//
+	std::shared_ptr<const TxHashSetSnapshot> GetSnapshot(const uint64_t requestedHeight);
+
+private:
+	bool IsConfirmed(const BlockHeader& header) const;
+	bool IsUsable(const BlockHeader& header, const uint64_t requestedHeight) const;
+	std::shared_ptr<const TxHashSetSnapshot> CreateSnapshot(const uint64_t requestedHeight);
+
+	const Config& m_config;
+	ChainState& m_chainState;
+
+	// Only guards the members. Snapshots are copied and zipped without holding it, so requests for the cached snapshot never wait on them.
+	std::mutex m_mutex;
+	std::shared_ptr<const TxHashSetSnapshot> m_pSnapshot;
+	bool m_creating;
+};
\ No newline at end of file
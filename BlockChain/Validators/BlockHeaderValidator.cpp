@@ -17,7 +17,7 @@ BlockHeaderValidator::BlockHeaderValidator(const Config& config, const IHeaderMM
 
 // TODO: Return status enum with error type instead of just true/false
 // TODO: Look up previous header instead of taking it in
-bool BlockHeaderValidator::IsValidHeader(const BlockHeader& header, const BlockHeader& previousHeader) const
+bool BlockHeaderValidator::IsValidHeader(const BlockHeader& header, const BlockHeader& previousHeader, const bool proofVerified) const
 {
 	// Validate Height
 	if (header.GetHeight() != (previousHeader.GetHeight() + 1))
@@ -50,7 +50,8 @@ bool BlockHeaderValidator::IsValidHeader(const BlockHeader& header, const BlockH
 	}
 
 	// Validate Proof Of Work
-	const bool validPoW = PoWManager(m_config).IsPoWValid(header, previousHeader);
+	const PoWManager powManager(m_config);
+	const bool validPoW = proofVerified ? powManager.IsDifficultyValid(header, previousHeader) : powManager.IsPoWValid(header, previousHeader);
 	if (!validPoW)
 	{
 		LoggerAPI::LogWarning("BlockHeaderValidator::IsValidHeader - Invalid Proof of Work for header " + HexUtil::ConvertHash(header.GetHash()));
@@ -11,7 +11,11 @@ class BlockHeaderValidator
 public:
 	BlockHeaderValidator(const Config& config, const IHeaderMMR& headerMMR);
 
-	bool IsValidHeader(const BlockHeader& header, const BlockHeader& previousHeader) const;
+	//
+	// When proofVerified is true, the proof of work's cycle is assumed to have already been verified with PoWManager::IsProofValid,
+	// and only the checks that depend on the previous header or the header MMR are performed.
+	//
+	bool IsValidHeader(const BlockHeader& header, const BlockHeader& previousHeader, const bool proofVerified) const;
 
 	const Config& m_config;
 	const IHeaderMMR& m_headerMMR;
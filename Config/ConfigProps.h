@@ -14,6 +14,18 @@ namespace ConfigProps
 
 		static const std::string MIN_PEERS = "MIN_PEERS";
 		static const std::string MAX_PEERS = "MAX_PEERS";
+		static const std::string HEADER_CHECKPOINTS = "HEADER_CHECKPOINTS";
+		static const std::string HEIGHT = "HEIGHT";
+		static const std::string HASH = "HASH";
+	}
+
+	namespace Database
+	{
+		static const std::string DATABASE = "DATABASE";
+
+		static const std::string BLOCK_CACHE_MB = "BLOCK_CACHE_MB";
+		static const std::string BLOOM_BITS_PER_KEY = "BLOOM_BITS_PER_KEY";
+		static const std::string BLOCK_COMPRESSION = "BLOCK_COMPRESSION";
 	}
 
 	namespace Dandelion
@@ -4,6 +4,8 @@
 #include <Config/Environment.h>
 #include <Config/Genesis.h>
 #include <BitUtil.h>
+#include <HexUtil.h>
+#include <Infrastructure/Logger.h>
 #include <filesystem>
 
 Config ConfigReader::ReadConfig(const Json::Value& root) const
@@ -20,12 +22,15 @@ Config ConfigReader::ReadConfig(const Json::Value& root) const
 	// Read P2P Config
 	const P2PConfig p2pConfig = ReadP2P(root);
 
+	// Read Database Config
+	const DatabaseConfig databaseConfig = ReadDatabase(root);
+
 	// Read Dandelion Config
 	const DandelionConfig dandelionConfig = ReadDandelion(root);
 
 	// TODO: Mempool, mining, wallet, and logger settings
 
-	return Config(clientMode, environment, dataPath, dandelionConfig, p2pConfig);
+	return Config(clientMode, environment, dataPath, dandelionConfig, p2pConfig, databaseConfig);
 }
 
 EClientMode ConfigReader::ReadClientMode(const Json::Value& root) const
@@ -91,6 +96,7 @@ P2PConfig ConfigReader::ReadP2P(const Json::Value& root) const
 {
 	int maxPeers = 30;
 	int minPeers = 15;
+	std::map<uint64_t, Hash> headerCheckpoints;
 
 	if (root.isMember(ConfigProps::P2P::P2P))
 	{
@@ -105,9 +111,69 @@ P2PConfig ConfigReader::ReadP2P(const Json::Value& root) const
 		{
 			minPeers = p2pRoot.get(ConfigProps::P2P::MIN_PEERS, 15).asInt();
 		}
+
+		if (p2pRoot.isMember(ConfigProps::P2P::HEADER_CHECKPOINTS))
+		{
+			for (const Json::Value& checkpointJSON : p2pRoot[ConfigProps::P2P::HEADER_CHECKPOINTS])
+			{
+				const uint64_t height = checkpointJSON.get(ConfigProps::P2P::HEIGHT, 0).asUInt64();
+				const std::string hash = checkpointJSON.get(ConfigProps::P2P::HASH, "").asString();
+				const size_t numDigits = hash.compare(0, 2, "0x") == 0 ? hash.size() - 2 : hash.size();
+				if (height > 0 && numDigits == 64 && HexUtil::IsValidHex(hash))
+				{
+					headerCheckpoints[height] = Hash::FromHex(hash);
+				}
+			}
+		}
+	}
+
+	return P2PConfig(maxPeers, minPeers, headerCheckpoints);
+}
+
+DatabaseConfig ConfigReader::ReadDatabase(const Json::Value& root) const
+{
+	const DatabaseConfig defaultConfig;
+	uint32_t blockCacheMB = defaultConfig.GetBlockCacheMB();
+	uint32_t bloomBitsPerKey = defaultConfig.GetBloomBitsPerKey();
+	EDBCompression blockCompression = defaultConfig.GetBlockCompression();
+
+	if (root.isMember(ConfigProps::Database::DATABASE))
+	{
+		const Json::Value& databaseRoot = root[ConfigProps::Database::DATABASE];
+
+		if (databaseRoot.isMember(ConfigProps::Database::BLOCK_CACHE_MB))
+		{
+			blockCacheMB = databaseRoot.get(ConfigProps::Database::BLOCK_CACHE_MB, blockCacheMB).asUInt();
+		}
+
+		if (databaseRoot.isMember(ConfigProps::Database::BLOOM_BITS_PER_KEY))
+		{
+			bloomBitsPerKey = databaseRoot.get(ConfigProps::Database::BLOOM_BITS_PER_KEY, bloomBitsPerKey).asUInt();
+		}
+
+		if (databaseRoot.isMember(ConfigProps::Database::BLOCK_COMPRESSION))
+		{
+			const std::string compression = databaseRoot.get(ConfigProps::Database::BLOCK_COMPRESSION, "NONE").asString();
+			if (compression == "NONE")
+			{
+				blockCompression = EDBCompression::NONE;
+			}
+			else if (compression == "LZ4")
+			{
+				blockCompression = EDBCompression::LZ4;
+			}
+			else if (compression == "ZSTD")
+			{
+				blockCompression = EDBCompression::ZSTD;
+			}
+			else
+			{
+				LoggerAPI::LogWarning("ConfigReader::ReadDatabase - Unknown " + ConfigProps::Database::BLOCK_COMPRESSION + " '" + compression + "'. Supported: NONE, LZ4, ZSTD.");
+			}
+		}
 	}
 
-	return P2PConfig(maxPeers, minPeers);
+	return DatabaseConfig(blockCacheMB, bloomBitsPerKey, blockCompression);
 }
 
 DandelionConfig ConfigReader::ReadDandelion(const Json::Value& root) const
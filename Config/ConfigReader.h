@@ -13,5 +13,6 @@ private:
 	Environment ReadEnvironment(const Json::Value& root) const;
 	std::string ReadDataPath(const Json::Value& root) const;
 	P2PConfig ReadP2P(const Json::Value& root) const;
+	DatabaseConfig ReadDatabase(const Json::Value& root) const;
 	DandelionConfig ReadDandelion(const Json::Value& root) const;
 };
\ No newline at end of file
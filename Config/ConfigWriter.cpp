@@ -2,6 +2,7 @@
 #include "ConfigProps.h"
 
 #include <Infrastructure/Logger.h>
+#include <HexUtil.h>
 #include <json/json.h>
 #include <fstream>
 
@@ -12,6 +13,7 @@ bool ConfigWriter::SaveConfig(const Config& config, const std::string& configPat
 	WriteEnvironment(root, config.GetEnvironment());
 	WriteDataPath(root, config.GetDataDirectory());
 	WriteP2P(root, config.GetP2PConfig());
+	WriteDatabase(root, config.GetDatabaseConfig());
 	WriteDandelion(root, config.GetDandelionConfig());
 
 	std::ofstream file(configPath, std::ios::out | std::ios::binary | std::ios::ate);
@@ -89,9 +91,58 @@ void ConfigWriter::WriteP2P(Json::Value& root, const P2PConfig& p2pConfig) const
 	minPeersValue.setComment(minPeersComment, Json::commentBefore);
 	p2pJSON[ConfigProps::P2P::MIN_PEERS] = minPeersValue;
 
+	Json::Value checkpointsValue = Json::Value(Json::arrayValue);
+	for (const auto& checkpoint : p2pConfig.GetHeaderCheckpoints())
+	{
+		Json::Value checkpointJSON;
+		checkpointJSON[ConfigProps::P2P::HEIGHT] = Json::Value((Json::UInt64)checkpoint.first);
+		checkpointJSON[ConfigProps::P2P::HASH] = Json::Value(HexUtil::ConvertToHex(checkpoint.second.ToSpan(), false, false));
+		checkpointsValue.append(checkpointJSON);
+	}
+
+	const std::string checkpointsComment = "/* Known header hashes, as a list of { \"HEIGHT\": n, \"HASH\": \"hex\" }. Header sync downloads the ranges between checkpoints from different peers in parallel. */";
+	checkpointsValue.setComment(checkpointsComment, Json::commentBefore);
+	p2pJSON[ConfigProps::P2P::HEADER_CHECKPOINTS] = checkpointsValue;
+
 	root[ConfigProps::P2P::P2P] = p2pJSON;
 }
 
+void ConfigWriter::WriteDatabase(Json::Value& root, const DatabaseConfig& databaseConfig) const
+{
+	Json::Value databaseJSON;
+
+	Json::Value blockCacheValue = Json::Value(databaseConfig.GetBlockCacheMB());
+	const std::string blockCacheComment = "/* Size in MB of the block cache shared by every column of the chain database. */";
+	blockCacheValue.setComment(blockCacheComment, Json::commentBefore);
+	databaseJSON[ConfigProps::Database::BLOCK_CACHE_MB] = blockCacheValue;
+
+	Json::Value bloomBitsValue = Json::Value(databaseConfig.GetBloomBitsPerKey());
+	const std::string bloomBitsComment = "/* Bloom filter bits per key for header, block sums and output position lookups. 0 disables the filters. */";
+	bloomBitsValue.setComment(bloomBitsComment, Json::commentBefore);
+	databaseJSON[ConfigProps::Database::BLOOM_BITS_PER_KEY] = bloomBitsValue;
+
+	std::string compression = "NONE";
+	switch (databaseConfig.GetBlockCompression())
+	{
+	case EDBCompression::NONE:
+		compression = "NONE";
+		break;
+	case EDBCompression::LZ4:
+		compression = "LZ4";
+		break;
+	case EDBCompression::ZSTD:
+		compression = "ZSTD";
+		break;
+	}
+
+	Json::Value compressionValue = Json::Value(compression);
+	const std::string compressionComment = "/* Compression of full blocks. Supported: NONE, LZ4, ZSTD (if RocksDB was built with them) */";
+	compressionValue.setComment(compressionComment, Json::commentBefore);
+	databaseJSON[ConfigProps::Database::BLOCK_COMPRESSION] = compressionValue;
+
+	root[ConfigProps::Database::DATABASE] = databaseJSON;
+}
+
 void ConfigWriter::WriteDandelion(Json::Value& root, const DandelionConfig& dandelionConfig) const
 {
 	Json::Value dandelionJSON;
@@ -14,5 +14,6 @@ private:
 	void WriteEnvironment(Json::Value& root, const Environment& environment) const;
 	void WriteDataPath(Json::Value& root, const std::string& dataPath) const;
 	void WriteP2P(Json::Value& root, const P2PConfig& p2pConfig) const;
+	void WriteDatabase(Json::Value& root, const DatabaseConfig& databaseConfig) const;
 	void WriteDandelion(Json::Value& root, const DandelionConfig& dandelionConfig) const;
 };
\ No newline at end of file
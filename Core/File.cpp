@@ -1,7 +1,10 @@
 #include <Core/File.h>
 
 #include <FileUtil.h>
+#include <filesystem>
 #include <fstream>
+
+#ifdef _WIN32
 #include <Windows.h>
 
 static bool TruncateFile(const std::string& filePath, const uint64_t size)
@@ -16,7 +19,15 @@ static bool TruncateFile(const std::string& filePath, const uint64_t size)
 
 	return success;
 }
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
+#ifdef _WIN32
 File::File(const std::string& path)
 	: m_path(path),
 	m_bufferIndex(0),
@@ -25,6 +36,18 @@ File::File(const std::string& path)
 
 }
 
+File::File(File&& other) noexcept
+	: m_path(other.m_path),
+	m_bufferIndex(other.m_bufferIndex),
+	m_fileSize(other.m_fileSize),
+	m_buffer(std::move(other.m_buffer)),
+	m_mmap(std::move(other.m_mmap))
+{
+
+}
+
+File::~File() = default;
+
 bool File::Load()
 {
 	std::ifstream file(m_path, std::ios::in | std::ifstream::ate | std::ifstream::binary);
@@ -46,6 +69,10 @@ bool File::Load()
 	return true;
 }
 
+//
+// The mapping is released first, since Windows won't truncate a file while it's mapped.
+// The file is opened for update rather than append, so the write lands at the rewind position instead of the old end of the file.
+//
 bool File::Flush()
 {
 	if (m_fileSize == m_bufferIndex && m_buffer.empty())
@@ -53,7 +80,23 @@ bool File::Flush()
 		return true;
 	}
 
-	std::ofstream file(m_path, std::ios::out | std::ios::binary | std::ios::app);
+	m_mmap.unmap();
+
+	if (m_bufferIndex < m_fileSize && !TruncateFile(m_path, m_bufferIndex))
+	{
+		return false;
+	}
+
+	if (!std::filesystem::exists(m_path))
+	{
+		std::ofstream createFile(m_path, std::ios::out | std::ios::binary);
+		if (!createFile.is_open())
+		{
+			return false;
+		}
+	}
+
+	std::fstream file(m_path, std::ios::in | std::ios::out | std::ios::binary);
 	if (!file.is_open())
 	{
 		return false;
@@ -65,16 +108,18 @@ bool File::Flush()
 	{
 		file.write((const char*)&m_buffer[0], m_buffer.size());
 	}
-	
+
 	file.close();
+	if (file.fail())
+	{
+		return false;
+	}
 
 	m_fileSize = m_bufferIndex + m_buffer.size();
-	
+
 	m_bufferIndex = m_fileSize;
 	m_buffer.clear();
 
-	TruncateFile(m_path, m_fileSize);
-
 	if (m_fileSize > 0)
 	{
 		std::error_code error;
@@ -84,7 +129,182 @@ bool File::Flush()
 	return true;
 }
 
-void File::Append(const std::vector<unsigned char>& data)
+const unsigned char* File::GetMappedData() const
+{
+	return (const unsigned char*)m_mmap.data();
+}
+#else
+File::File(const std::string& path)
+	: m_path(path),
+	m_bufferIndex(0),
+	m_fileSize(0),
+	m_fileDescriptor(-1),
+	m_pMapping(nullptr),
+	m_mappingSize(0)
+{
+
+}
+
+File::File(File&& other) noexcept
+	: m_path(other.m_path),
+	m_bufferIndex(other.m_bufferIndex),
+	m_fileSize(other.m_fileSize),
+	m_buffer(std::move(other.m_buffer)),
+	m_fileDescriptor(other.m_fileDescriptor),
+	m_pMapping(other.m_pMapping),
+	m_mappingSize(other.m_mappingSize)
+{
+	other.m_fileDescriptor = -1;
+	other.m_pMapping = nullptr;
+	other.m_mappingSize = 0;
+}
+
+File::~File()
+{
+	Unmap();
+
+	if (m_fileDescriptor != -1)
+	{
+		close(m_fileDescriptor);
+	}
+}
+
+bool File::Load()
+{
+	m_fileDescriptor = open(m_path.c_str(), O_RDWR | O_CLOEXEC);
+	if (m_fileDescriptor == -1)
+	{
+		return false;
+	}
+
+	struct stat fileStat;
+	if (fstat(m_fileDescriptor, &fileStat) != 0)
+	{
+		return false;
+	}
+
+	m_fileSize = (uint64_t)fileStat.st_size;
+	m_bufferIndex = m_fileSize;
+
+	return Map(m_fileSize);
+}
+
+bool File::Flush()
+{
+	if (m_fileSize == m_bufferIndex && m_buffer.empty())
+	{
+		return true;
+	}
+
+	if (m_fileDescriptor == -1 && !Open())
+	{
+		return false;
+	}
+
+	// Drop anything after the rewind position before writing the new data.
+	if (m_bufferIndex < m_fileSize && ftruncate(m_fileDescriptor, (off_t)m_bufferIndex) != 0)
+	{
+		return false;
+	}
+
+	size_t bytesWritten = 0;
+	while (bytesWritten < m_buffer.size())
+	{
+		const ssize_t result = pwrite(m_fileDescriptor, &m_buffer[bytesWritten], m_buffer.size() - bytesWritten, (off_t)(m_bufferIndex + bytesWritten));
+		if (result < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return false;
+		}
+
+		bytesWritten += (size_t)result;
+	}
+
+	if (fdatasync(m_fileDescriptor) != 0)
+	{
+		return false;
+	}
+
+	m_fileSize = m_bufferIndex + m_buffer.size();
+
+	m_bufferIndex = m_fileSize;
+	m_buffer.clear();
+
+	return Map(m_fileSize);
+}
+
+bool File::Open()
+{
+	m_fileDescriptor = open(m_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+	return m_fileDescriptor != -1;
+}
+
+//
+// Resizes the read-only mapping to cover the first 'size' bytes of the file.
+// On Linux, the existing mapping is resized with mremap rather than being torn down and rebuilt.
+//
+bool File::Map(const uint64_t size)
+{
+	if (size == m_mappingSize)
+	{
+		return true;
+	}
+
+	if (size == 0)
+	{
+		Unmap();
+		return true;
+	}
+
+	void* pMapping = MAP_FAILED;
+#ifdef __linux__
+	if (m_pMapping != nullptr)
+	{
+		pMapping = mremap(m_pMapping, m_mappingSize, size, MREMAP_MAYMOVE);
+	}
+	else
+	{
+		pMapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, m_fileDescriptor, 0);
+	}
+#else
+	Unmap();
+	pMapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, m_fileDescriptor, 0);
+#endif
+
+	if (pMapping == MAP_FAILED)
+	{
+		Unmap();
+		return false;
+	}
+
+	m_pMapping = (unsigned char*)pMapping;
+	m_mappingSize = size;
+
+	return true;
+}
+
+void File::Unmap()
+{
+	if (m_pMapping != nullptr)
+	{
+		munmap(m_pMapping, m_mappingSize);
+		m_pMapping = nullptr;
+		m_mappingSize = 0;
+	}
+}
+
+const unsigned char* File::GetMappedData() const
+{
+	return m_pMapping;
+}
+#endif
+
+void File::Append(const ByteSpan& data)
 {
 	m_buffer.insert(m_buffer.end(), data.cbegin(), data.cend());
 }
@@ -128,18 +348,25 @@ uint64_t File::GetSize() const
 	return m_bufferIndex + m_buffer.size();
 }
 
-bool File::Read(const uint64_t position, const uint64_t numBytes, std::vector<unsigned char>& data) const
+ByteSpan File::Read(const uint64_t position, const uint64_t numBytes) const
 {
 	if (position < m_bufferIndex)
 	{
-		data = std::vector<unsigned char>(m_mmap.cbegin() + position, m_mmap.cbegin() + position + numBytes);
+		if (position + numBytes > m_bufferIndex)
+		{
+			return ByteSpan();
+		}
+
+		return ByteSpan(GetMappedData() + position, numBytes);
 	}
 	else
 	{
 		const uint64_t firstBufferIndex = position - m_bufferIndex;
+		if (firstBufferIndex + numBytes > m_buffer.size())
+		{
+			return ByteSpan();
+		}
 
-		data.insert(data.end(), m_buffer.cbegin() + firstBufferIndex, m_buffer.cbegin() + firstBufferIndex + numBytes);
+		return ByteSpan(m_buffer.data() + firstBufferIndex, numBytes);
 	}
-
-	return true;
-}
\ No newline at end of file
+}
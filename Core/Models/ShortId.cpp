@@ -16,12 +16,13 @@ ShortId ShortId::Create(const CBigInteger<32>& hash, const CBigInteger<32>& bloc
 	const CBigInteger<32> hashWithNonce = Crypto::Blake2b(serializer.GetBytes());
 
 	// extract k0/k1 from the block_hash
-	ByteBuffer byteBuffer(hashWithNonce.GetData());
+	const std::vector<unsigned char> hashWithNonceBytes = hashWithNonce.ToVector();
+	ByteBuffer byteBuffer(hashWithNonceBytes);
 	const uint64_t k0 = byteBuffer.ReadU64_LE();
 	const uint64_t k1 = byteBuffer.ReadU64_LE();
 
 	// SipHash24 our hash using the k0 and k1 keys
-	const uint64_t sipHash = Crypto::SipHash24(k0, k1, hash.GetData());
+	const uint64_t sipHash = Crypto::SipHash24(k0, k1, hash.ToVector());
 
 	// construct a short_id from the resulting bytes (dropping the 2 most significant bytes)
 	Serializer serializer2;
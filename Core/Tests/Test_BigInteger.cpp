@@ -0,0 +1,200 @@
+#include <Catch2/catch.hpp>
+
+#include <Hash.h>
+#include <Crypto/Commitment.h>
+#include <Config/Genesis.h>
+#include <Serialization/ByteBuffer.h>
+#include <Serialization/Serializer.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+//
+// Counts the heap allocations made by the current thread while in scope.
+// operator new has to be replaced for the whole executable, but it only counts while one of these is alive,
+// so allocations made by every other test are unaffected.
+//
+class ScopedAllocationCounter
+{
+public:
+	ScopedAllocationCounter() : m_numAllocations(0), m_pPrevious(s_pCurrent) { s_pCurrent = this; }
+	~ScopedAllocationCounter() { s_pCurrent = m_pPrevious; }
+
+	inline size_t GetNumAllocations() const { return m_numAllocations; }
+
+	static void OnAllocation()
+	{
+		if (s_pCurrent != nullptr)
+		{
+			s_pCurrent->m_numAllocations++;
+		}
+	}
+
+private:
+	static thread_local ScopedAllocationCounter* s_pCurrent;
+
+	size_t m_numAllocations;
+	ScopedAllocationCounter* m_pPrevious;
+};
+
+thread_local ScopedAllocationCounter* ScopedAllocationCounter::s_pCurrent = nullptr;
+
+void* operator new(size_t size)
+{
+	ScopedAllocationCounter::OnAllocation();
+	void* pMemory = std::malloc(size == 0 ? 1 : size);
+	if (pMemory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return pMemory;
+}
+
+void operator delete(void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, size_t) noexcept
+{
+	std::free(pMemory);
+}
+
+static_assert(std::is_trivially_copyable<Hash>::value, "Hash must be trivially copyable");
+static_assert(std::is_trivially_copyable<CBigInteger<33>>::value, "CBigInteger<33> must be trivially copyable");
+static_assert(sizeof(Hash) == 32, "Hash must be stored inline");
+
+TEST_CASE("CBigInteger::FromHex")
+{
+	constexpr Hash hash = Hash::FromHex("0x81e47a19e6b29b0a65b9591762ce5143ed30d0261e5d24a3201752506b20f15c");
+	static_assert(hash[0] == 0x81 && hash[31] == 0x5c, "FromHex must be usable at compile time");
+
+	REQUIRE(hash == Hash::FromHex("81e4 7a19 e6b2 9b0a 65b9 5917 62ce 5143 ed30 d026 1e5d 24a3 2017 5250 6b20 f15c"));
+	REQUIRE(CBigInteger<6>::FromHex("0x02955A094534") == CBigInteger<6>::FromHex("0x02955a094534"));
+	REQUIRE_THROWS(CBigInteger<2>::FromHex("0x010203"));
+}
+
+TEST_CASE("CBigInteger::ValueOf")
+{
+	constexpr CBigInteger<33> value = CBigInteger<33>::ValueOf(7);
+	static_assert(value[32] == 7 && value[0] == 0, "ValueOf must be usable at compile time");
+
+	REQUIRE(ZERO_HASH == Hash());
+	REQUIRE(Hash::ValueOf(5) + Hash::ValueOf(6) == Hash::ValueOf(11));
+	REQUIRE(Hash::ValueOf(200) / 8 == Hash::ValueOf(25));
+	REQUIRE(Hash::ValueOf(3) < Hash::ValueOf(4));
+	REQUIRE(Hash::GetMaximumValue() > Hash::ValueOf(255));
+}
+
+TEST_CASE("CBigInteger::ToVector")
+{
+	const Hash hash = Hash::FromHex("0x3a42e66e46dd7633b57d1f921780a1ac715e6b93c19ee52ab714178eb3a9f673");
+	const std::vector<unsigned char> bytes = hash.ToVector();
+
+	REQUIRE(bytes.size() == 32);
+	REQUIRE(Hash(bytes) == hash);
+	REQUIRE(Hash(hash.ToSpan()) == hash);
+	REQUIRE(std::equal(bytes.cbegin(), bytes.cend(), hash.GetData().cbegin()));
+}
+
+TEST_CASE("CBigInteger - Copies do not allocate")
+{
+	const Hash hash = Hash::FromHex("0x81e47a19e6b29b0a65b9591762ce5143ed30d0261e5d24a3201752506b20f15c");
+	const Commitment commitment(CBigInteger<33>::ValueOf(9));
+
+	ScopedAllocationCounter allocationCounter;
+
+	Hash copy = hash;
+	Commitment commitmentCopy = commitment;
+	copy = ZERO_HASH;
+	commitmentCopy = Commitment(CBigInteger<33>::GetMaximumValue());
+
+	REQUIRE(allocationCounter.GetNumAllocations() == 0);
+}
+
+//
+// Compares copying hashes against copying the same bytes held in a std::vector, which is how CBigInteger used to store them.
+//
+TEST_CASE("CBigInteger - Copy cost vs vector storage", "[.benchmark]")
+{
+	const Hash hash = Hash::FromHex("0x81e47a19e6b29b0a65b9591762ce5143ed30d0261e5d24a3201752506b20f15c");
+	const size_t numCopies = 1000000;
+
+	std::vector<Hash> hashes(numCopies);
+	std::vector<std::vector<unsigned char>> vectors(numCopies);
+
+	size_t inlineAllocations = 0;
+	const auto inlineStart = std::chrono::steady_clock::now();
+	{
+		ScopedAllocationCounter allocationCounter;
+		for (size_t i = 0; i < numCopies; i++)
+		{
+			hashes[i] = hash;
+		}
+
+		inlineAllocations = allocationCounter.GetNumAllocations();
+	}
+	const auto inlineElapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - inlineStart).count();
+
+	const std::vector<unsigned char> bytes = hash.ToVector();
+	size_t vectorAllocations = 0;
+	const auto vectorStart = std::chrono::steady_clock::now();
+	{
+		ScopedAllocationCounter allocationCounter;
+		for (size_t i = 0; i < numCopies; i++)
+		{
+			vectors[i] = bytes;
+		}
+
+		vectorAllocations = allocationCounter.GetNumAllocations();
+	}
+	const auto vectorElapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - vectorStart).count();
+
+	REQUIRE(hashes.back() == hash);
+	REQUIRE(vectors.back() == bytes);
+	REQUIRE(inlineAllocations == 0);
+	REQUIRE(vectorAllocations == numCopies);
+
+	WARN("Copying " << numCopies << " hashes - inline: " << inlineAllocations << " allocations, " << inlineElapsed << "us. "
+		<< "vector: " << vectorAllocations << " allocations, " << vectorElapsed << "us.");
+}
+
+//
+// Reports allocations per deserialized block, next to the number of hashes, commitments and signatures in it.
+// With vector storage, each of those cost at least one more allocation.
+//
+TEST_CASE("CBigInteger - Allocations per block", "[.benchmark]")
+{
+	const FullBlock& genesis = Genesis::MAINNET_GENESIS;
+
+	Serializer serializer;
+	genesis.Serialize(serializer);
+	const std::vector<unsigned char>& serialized = serializer.GetBytes();
+
+	const TransactionBody& body = genesis.GetTransactionBody();
+	// The header holds 5 hashes and the total kernel offset, and caches its own hash.
+	const size_t numBigIntegers = 7 + body.GetInputs().size() + body.GetOutputs().size() + (2 * body.GetKernels().size());
+
+	const size_t numIterations = 1000;
+	size_t numMatches = 0;
+
+	ScopedAllocationCounter allocationCounter;
+	for (size_t i = 0; i < numIterations; i++)
+	{
+		ByteBuffer byteBuffer(serialized);
+		const FullBlock block = FullBlock::Deserialize(byteBuffer);
+		if (block.GetHash() == genesis.GetHash())
+		{
+			numMatches++;
+		}
+	}
+
+	REQUIRE(numMatches == numIterations);
+
+	const size_t allocationsPerBlock = allocationCounter.GetNumAllocations() / numIterations;
+	WARN("Allocations per deserialized and hashed block: " << allocationsPerBlock << " inline, at least "
+		<< (allocationsPerBlock + numBigIntegers) << " with vector storage (" << numBigIntegers << " hashes, commitments and signatures).");
+}
\ No newline at end of file
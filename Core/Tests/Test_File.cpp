@@ -0,0 +1,99 @@
+#include <Catch2/catch.hpp>
+
+#include <Core/File.h>
+
+#include <filesystem>
+
+static std::string GetTestFilePath(const std::string& fileName)
+{
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / fileName;
+	std::filesystem::remove(path);
+
+	return path.string();
+}
+
+static std::vector<unsigned char> CreateBytes(const size_t numBytes, const unsigned char value)
+{
+	return std::vector<unsigned char>(numBytes, value);
+}
+
+static std::vector<unsigned char> ReadAll(const File& file)
+{
+	const ByteSpan span = file.Read(0, file.GetSize());
+	return std::vector<unsigned char>(span.cbegin(), span.cend());
+}
+
+TEST_CASE("File - Append, Flush and Reload")
+{
+	const std::string path = GetTestFilePath("Test_File_Append.bin");
+
+	{
+		File file(path);
+		REQUIRE(!file.Load());
+
+		file.Append(CreateBytes(100, 1));
+		REQUIRE(file.GetSize() == 100);
+		REQUIRE(file.Flush());
+
+		file.Append(CreateBytes(50, 2));
+		REQUIRE(file.Flush());
+		REQUIRE(file.GetSize() == 150);
+	}
+
+	File reloaded(path);
+	REQUIRE(reloaded.Load());
+	REQUIRE(std::filesystem::file_size(path) == 150);
+
+	std::vector<unsigned char> expected = CreateBytes(100, 1);
+	const std::vector<unsigned char> appended = CreateBytes(50, 2);
+	expected.insert(expected.end(), appended.cbegin(), appended.cend());
+	REQUIRE(ReadAll(reloaded) == expected);
+}
+
+TEST_CASE("File - Rewind then Append overwrites the rewound bytes")
+{
+	const std::string path = GetTestFilePath("Test_File_Rewind.bin");
+
+	{
+		File file(path);
+		file.Load();
+		file.Append(CreateBytes(200, 1));
+		REQUIRE(file.Flush());
+
+		REQUIRE(file.Rewind(120));
+		file.Append(CreateBytes(30, 2));
+		REQUIRE(file.Flush());
+		REQUIRE(file.GetSize() == 150);
+	}
+
+	File reloaded(path);
+	REQUIRE(reloaded.Load());
+	REQUIRE(std::filesystem::file_size(path) == 150);
+
+	std::vector<unsigned char> expected = CreateBytes(120, 1);
+	const std::vector<unsigned char> appended = CreateBytes(30, 2);
+	expected.insert(expected.end(), appended.cbegin(), appended.cend());
+	REQUIRE(ReadAll(reloaded) == expected);
+}
+
+TEST_CASE("File - Rewind without Append truncates")
+{
+	const std::string path = GetTestFilePath("Test_File_Truncate.bin");
+
+	{
+		File file(path);
+		file.Load();
+		file.Append(CreateBytes(64, 3));
+		REQUIRE(file.Flush());
+
+		REQUIRE(file.Rewind(16));
+		REQUIRE(file.Flush());
+		REQUIRE(!file.Rewind(17));
+	}
+
+	REQUIRE(std::filesystem::file_size(path) == 16);
+
+	File reloaded(path);
+	REQUIRE(reloaded.Load());
+	REQUIRE(ReadAll(reloaded) == CreateBytes(16, 3));
+}
\ No newline at end of file
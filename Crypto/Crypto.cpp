@@ -129,6 +129,11 @@ bool Crypto::VerifyRangeProofs(const std::vector<Commitment>& commitments, const
 		return false;
 	}
 
+	if (rangeProofs.empty())
+	{
+		return true;
+	}
+
 	return Secp256k1Wrapper::GetInstance().VerifyBulletproofs(commitments, rangeProofs);
 }
 
@@ -43,10 +43,10 @@ uint8_t RandomNumberGenerator::DetermineNumberOfRandomBytesNeeded(const CBigInte
 {
 	uint8_t numRandomBytes = 32;
 
-	const std::vector<unsigned char>& vector = differenceBetweenMaximumAndMinimum.GetData();
+	const std::array<unsigned char, 32>& bytes = differenceBetweenMaximumAndMinimum.GetData();
 	for (int i = 0; i < 32; i++)
 	{
-		if (vector[i] == 0)
+		if (bytes[i] == 0)
 		{
 			numRandomBytes--;
 		}
@@ -5,11 +5,117 @@
 #include "secp256k1-zkp/include/secp256k1_commitment.h"
 #include "secp256k1-zkp/include/secp256k1_bulletproofs.h"
 #include <Crypto/RandomNumberGenerator.h>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 const uint64_t MAX_WIDTH = 1 << 20;
 const size_t SCRATCH_SPACE_SIZE = 256 * MAX_WIDTH;
 const size_t MAX_GENERATORS = 256;
 
+// Scratch spaces are large, so no more exist at once than there are cores to verify on. Verifications wait for one to be released beyond that.
+static size_t GetMaxScratchSpaces()
+{
+	return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+//
+// Scratch spaces can't be shared between threads, and are too large to keep one per thread or to recreate for every verification.
+// They're created as needed, up to a limit, and checked out for the duration of a verification.
+//
+class ScratchSpacePool
+{
+public:
+	ScratchSpacePool(const secp256k1_context* pContext, const size_t scratchSize, const size_t maxScratchSpaces)
+		: m_pContext(pContext), m_scratchSize(scratchSize), m_maxScratchSpaces(maxScratchSpaces), m_numCreated(0)
+	{
+
+	}
+
+	~ScratchSpacePool()
+	{
+		for (secp256k1_scratch_space* pScratchSpace : m_idle)
+		{
+			secp256k1_scratch_space_destroy(pScratchSpace);
+		}
+	}
+
+	//
+	// Returns an idle scratch space, creating one if the limit hasn't been reached, or waits for one to be released.
+	// Returns null if a scratch space couldn't be created.
+	//
+	secp256k1_scratch_space* Acquire()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_released.wait(lock, [this] { return !m_idle.empty() || m_numCreated < m_maxScratchSpaces; });
+
+		if (!m_idle.empty())
+		{
+			secp256k1_scratch_space* pScratchSpace = m_idle.back();
+			m_idle.pop_back();
+			return pScratchSpace;
+		}
+
+		m_numCreated++;
+		lock.unlock();
+
+		secp256k1_scratch_space* pScratchSpace = secp256k1_scratch_space_create(m_pContext, m_scratchSize);
+		if (pScratchSpace == nullptr)
+		{
+			lock.lock();
+			m_numCreated--;
+			m_released.notify_one();
+		}
+
+		return pScratchSpace;
+	}
+
+	void Release(secp256k1_scratch_space* pScratchSpace)
+	{
+		if (pScratchSpace != nullptr)
+		{
+			std::lock_guard<std::mutex> lockGuard(m_mutex);
+			m_idle.push_back(pScratchSpace);
+			m_released.notify_one();
+		}
+	}
+
+private:
+	const secp256k1_context* m_pContext;
+	const size_t m_scratchSize;
+	const size_t m_maxScratchSpaces;
+
+	std::mutex m_mutex;
+	std::condition_variable m_released;
+	std::vector<secp256k1_scratch_space*> m_idle;
+	size_t m_numCreated;
+};
+
+//
+// Checks a scratch space out of a ScratchSpacePool, and returns it when destroyed.
+//
+class ScopedScratchSpace
+{
+public:
+	ScopedScratchSpace(ScratchSpacePool& pool)
+		: m_pool(pool), m_pScratchSpace(pool.Acquire())
+	{
+
+	}
+
+	~ScopedScratchSpace()
+	{
+		m_pool.Release(m_pScratchSpace);
+	}
+
+	inline secp256k1_scratch_space* Get() const { return m_pScratchSpace; }
+
+private:
+	ScratchSpacePool& m_pool;
+	secp256k1_scratch_space* m_pScratchSpace;
+};
+
 Secp256k1Wrapper& Secp256k1Wrapper::GetInstance()
 {
 	static Secp256k1Wrapper instance;
@@ -20,10 +126,12 @@ Secp256k1Wrapper::Secp256k1Wrapper()
 {
 	m_pContext = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
 	m_pGenerators = secp256k1_bulletproof_generators_create(m_pContext, &secp256k1_generator_const_g, MAX_GENERATORS);
+	m_pBulletproofScratchSpaces = std::make_unique<ScratchSpacePool>(m_pContext, SCRATCH_SPACE_SIZE, GetMaxScratchSpaces());
 }
 
 Secp256k1Wrapper::~Secp256k1Wrapper()
 {
+	m_pBulletproofScratchSpaces.reset();
 	secp256k1_bulletproof_generators_destroy(m_pContext, m_pGenerators);
 	secp256k1_context_destroy(m_pContext);
 }
@@ -53,28 +161,38 @@ bool Secp256k1Wrapper::VerifyBulletproofs(const std::vector<Commitment>& commitm
 {
 	const size_t numBits = 64;
 
+	// Proofs verified together must all be the same length.
 	const size_t proofLength = rangeProofs.front().GetProofBytes().size();
 
 	// array of generator multiplied by value in pedersen commitments (cannot be NULL)
-	std::vector<secp256k1_generator> valueGenerators;
-	for (size_t i = 0; i < rangeProofs.size(); i++)
-	{
-		valueGenerators.push_back(secp256k1_generator_const_h);
-	}
-
+	std::vector<secp256k1_generator> valueGenerators(rangeProofs.size(), secp256k1_generator_const_h);
 
-	std::vector<secp256k1_pedersen_commitment*> commitmentPointers = ConvertCommitments(commitments);
 	std::vector<const unsigned char*> bulletproofPointers;
+	bulletproofPointers.reserve(rangeProofs.size());
 	for (const RangeProof& rangeProof : rangeProofs)
 	{
+		if (rangeProof.GetProofBytes().size() != proofLength)
+		{
+			return false;
+		}
+
 		bulletproofPointers.push_back(rangeProof.GetProofBytes().data());
 	}
 
-	secp256k1_scratch_space* pScratchSpace = secp256k1_scratch_space_create(m_pContext, SCRATCH_SPACE_SIZE);
+	std::vector<secp256k1_pedersen_commitment*> commitmentPointers = ConvertCommitments(commitments);
+	if (commitmentPointers.size() != rangeProofs.size())
+	{
+		return false;
+	}
 
-	const int result = secp256k1_bulletproof_rangeproof_verify_multi(m_pContext, pScratchSpace, m_pGenerators, bulletproofPointers.data(), rangeProofs.size(), proofLength, NULL, commitmentPointers.data(), 1, numBits, valueGenerators.data(), NULL, NULL);
+	const ScopedScratchSpace scratchSpace(*m_pBulletproofScratchSpaces);
+	if (scratchSpace.Get() == nullptr)
+	{
+		CleanupCommitments(commitmentPointers);
+		return false;
+	}
 
-	secp256k1_scratch_space_destroy(pScratchSpace);
+	const int result = secp256k1_bulletproof_rangeproof_verify_multi(m_pContext, scratchSpace.Get(), m_pGenerators, bulletproofPointers.data(), rangeProofs.size(), proofLength, NULL, commitmentPointers.data(), 1, numBits, valueGenerators.data(), NULL, NULL);
 
 	CleanupCommitments(commitmentPointers);
 
@@ -188,7 +306,7 @@ std::vector<secp256k1_pedersen_commitment*> Secp256k1Wrapper::ConvertCommitments
 	std::vector<secp256k1_pedersen_commitment*> convertedCommitments(commitments.size(), NULL);
 	for (int i = 0; i < commitments.size(); i++)
 	{
-		const std::vector<unsigned char>& commitmentBytes = commitments[i].GetCommitmentBytes().GetData();
+		const CBigInteger<33>& commitmentBytes = commitments[i].GetCommitmentBytes();
 
 		secp256k1_pedersen_commitment* pCommitment = new secp256k1_pedersen_commitment();
 		const int parsed = secp256k1_pedersen_commitment_parse(m_pContext, pCommitment, &commitmentBytes[0]);
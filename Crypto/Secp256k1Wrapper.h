@@ -12,6 +12,7 @@
 
 // Forward Declarations
 struct secp256k1_bulletproof_generators;
+class ScratchSpacePool;
 
 class Secp256k1Wrapper
 {
@@ -34,4 +35,5 @@ private:
 
 	secp256k1_context* m_pContext;
 	secp256k1_bulletproof_generators* m_pGenerators;
+	std::unique_ptr<ScratchSpacePool> m_pBulletproofScratchSpaces;
 };
\ No newline at end of file
@@ -0,0 +1,53 @@
+#include <Catch2/catch.hpp>
+
+#include <Crypto.h>
+
+// The coinbase kernel of the mainnet genesis block.
+static const Commitment MAINNET_EXCESS(CBigInteger<33>::FromHex("08df2f1d996cee37715d9ac0a0f3b13aae508d1101945acb8044954aee30960be9"));
+static const Signature MAINNET_SIGNATURE(CBigInteger<64>(std::vector<unsigned char>({
+	25, 176, 52, 246, 172, 1, 12, 220, 247, 111, 73, 101, 13, 16, 157, 130, 110, 196, 123,
+	217, 246, 137, 45, 110, 106, 186, 0, 151, 255, 193, 233, 178, 103, 26, 210, 215, 200,
+	89, 146, 188, 9, 161, 28, 212, 227, 143, 82, 54, 5, 223, 16, 65, 237, 132, 196, 241,
+	39, 76, 133, 45, 252, 131, 88, 0
+})));
+
+// The coinbase kernel of the floonet genesis block.
+static const Commitment FLOONET_EXCESS(CBigInteger<33>::FromHex("096385d86c5cfda718aa0b7295be0adf7e5ac051edfe130593a2a257f09f78a3b1"));
+static const Signature FLOONET_SIGNATURE(CBigInteger<64>(std::vector<unsigned char>({
+	80, 208, 41, 171, 28, 224, 250, 121, 60, 192, 213, 232, 111, 199, 111, 105, 18, 22, 54, 165, 107,
+	33, 186, 113, 186, 100, 12, 42, 72, 106, 42, 20, 67, 253, 188, 178, 228, 246, 21, 168, 253, 18, 22,
+	179, 41, 63, 250, 218, 80, 132, 75, 67, 244, 11, 108, 27, 188, 251, 212, 166, 233, 103, 117, 237
+})));
+
+// Coinbase kernels sign only their features byte.
+static Hash GetCoinbaseMessage()
+{
+	return Crypto::Blake2b(std::vector<unsigned char>({ 1 }));
+}
+
+TEST_CASE("Crypto::VerifyKernelSignature - Valid")
+{
+	REQUIRE(Crypto::VerifyKernelSignature(MAINNET_SIGNATURE, MAINNET_EXCESS, GetCoinbaseMessage()));
+	REQUIRE(Crypto::VerifyKernelSignature(FLOONET_SIGNATURE, FLOONET_EXCESS, GetCoinbaseMessage()));
+}
+
+TEST_CASE("Crypto::VerifyKernelSignature - Invalid")
+{
+	SECTION("Tampered signature")
+	{
+		std::vector<unsigned char> signatureBytes = MAINNET_SIGNATURE.GetSignatureBytes().ToVector();
+		signatureBytes[40] ^= 1;
+		REQUIRE(!Crypto::VerifyKernelSignature(Signature(CBigInteger<64>(std::move(signatureBytes))), MAINNET_EXCESS, GetCoinbaseMessage()));
+	}
+
+	SECTION("Wrong message")
+	{
+		REQUIRE(!Crypto::VerifyKernelSignature(MAINNET_SIGNATURE, MAINNET_EXCESS, Crypto::Blake2b(std::vector<unsigned char>({ 0 }))));
+	}
+
+	SECTION("Wrong public key")
+	{
+		REQUIRE(!Crypto::VerifyKernelSignature(MAINNET_SIGNATURE, FLOONET_EXCESS, GetCoinbaseMessage()));
+		REQUIRE(!Crypto::VerifyKernelSignature(FLOONET_SIGNATURE, MAINNET_EXCESS, GetCoinbaseMessage()));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include <Catch2/catch.hpp>
+
+#include <Crypto.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// The coinbase output of the mainnet genesis block.
+static const Commitment GENESIS_COMMITMENT(CBigInteger<33>::FromHex("08b7e57c448db5ef25aa119dde2312c64d7ff1b890c416c6dda5ec73cbfed2edea"));
+static const RangeProof GENESIS_RANGE_PROOF(std::vector<unsigned char>({
+	147, 48, 173, 140, 222, 32, 95, 49, 124, 101, 55, 236, 169, 107, 134, 98, 147, 160, 72, 150, 21, 169,
+	162, 119, 180, 211, 165, 151, 200, 115, 84, 76, 130, 71, 73, 50, 182, 65, 224, 106, 200, 113, 150, 4,
+	238, 82, 232, 149, 232, 205, 70, 33, 182, 191, 184, 87, 128, 205, 155, 236, 206, 20, 208, 112, 11, 131,
+	166, 100, 219, 47, 82, 162, 108, 66, 95, 215, 119, 173, 136, 148, 76, 223, 255, 56, 4, 58, 39, 147, 237,
+	77, 154, 166, 126, 54, 203, 253, 85, 133, 87, 159, 198, 157, 218, 147, 4, 24, 175, 94, 175, 96, 54, 84,
+	246, 247, 81, 37, 141, 45, 252, 140, 33, 19, 193, 113, 225, 48, 243, 30, 193, 230, 204, 226, 167, 24, 228,
+	53, 41, 143, 206, 93, 100, 255, 225, 189, 52, 100, 253, 124, 135, 207, 169, 32, 147, 133, 91, 224, 52, 191,
+	228, 67, 158, 146, 139, 217, 42, 215, 127, 208, 160, 224, 3, 85, 238, 29, 26, 156, 235, 30, 208, 196, 8,
+	220, 253, 186, 140, 88, 62, 117, 152, 220, 112, 10, 170, 159, 145, 67, 32, 151, 37, 154, 64, 95, 91, 115,
+	21, 162, 247, 101, 136, 97, 227, 52, 155, 176, 220, 139, 248, 131, 114, 106, 33, 95, 1, 73, 222, 214, 97,
+	62, 90, 192, 103, 12, 12, 82, 2, 36, 125, 124, 39, 200, 167, 208, 59, 219, 3, 201, 207, 84, 85, 70, 63, 155,
+	66, 207, 135, 64, 62, 49, 248, 56, 60, 196, 244, 154, 52, 198, 42, 228, 89, 245, 128, 26, 158, 237, 79, 14,
+	227, 223, 213, 245, 91, 112, 17, 192, 202, 227, 147, 196, 116, 171, 214, 248, 199, 150, 91, 155, 95, 255,
+	49, 4, 221, 78, 57, 84, 32, 119, 192, 200, 221, 47, 143, 252, 235, 107, 181, 152, 81, 45, 144, 80, 109, 10,
+	113, 132, 242, 15, 20, 152, 207, 69, 135, 135, 242, 50, 132, 181, 72, 136, 201, 190, 65, 109, 16, 63, 118,
+	4, 6, 53, 122, 22, 182, 216, 65, 163, 3, 213, 201, 91, 107, 71, 77, 45, 127, 15, 234, 10, 42, 118, 200, 151,
+	221, 33, 16, 233, 48, 63, 84, 104, 65, 105, 66, 17, 71, 104, 76, 111, 24, 25, 195, 60, 239, 63, 56, 236, 153,
+	90, 80, 132, 80, 192, 44, 209, 135, 47, 128, 101, 253, 238, 114, 49, 9, 193, 139, 29, 210, 221, 222, 117, 130,
+	85, 70, 236, 240, 223, 7, 147, 195, 83, 178, 12, 148, 108, 214, 65, 34, 206, 168, 193, 22, 244, 50, 51, 104,
+	153, 161, 106, 210, 74, 42, 175, 203, 143, 144, 14, 9, 161, 20, 113, 53, 252, 242, 165, 76, 191, 129, 219, 48,
+	138, 71, 160, 138, 73, 199, 124, 19, 14, 93, 197, 230, 97, 205, 85, 165, 204, 105, 230, 7, 5, 90, 91, 8, 17,
+	27, 246, 26, 98, 234, 87, 120, 248, 81, 25, 4, 54, 51, 241, 202, 184, 199, 86, 215, 86, 197, 163, 72, 81, 2,
+	74, 195, 17, 165, 150, 177, 205, 145, 155, 188, 164, 50, 38, 240, 186, 5, 127, 107, 87, 222, 47, 105, 85, 176,
+	130, 60, 56, 38, 222, 127, 96, 150, 193, 193, 182, 185, 184, 228, 6, 62, 22, 69, 192, 191, 243, 47, 128, 86, 26,
+	170, 149, 157, 151, 18, 15, 188, 46, 205, 157, 43, 226, 139, 208, 193, 120, 17, 220, 89, 168, 128, 73, 246, 216,
+	149, 46, 233, 160, 160, 32, 118, 147, 200, 156, 163, 173, 17, 151, 233, 191, 223, 192, 59, 233, 216, 69, 174,
+	168, 214, 99, 150, 146, 23, 227, 180, 148, 206, 233, 230, 82, 188, 159, 135, 19, 226, 253, 92, 177, 132, 56, 72,
+	244, 108, 58, 106, 176, 36, 208, 227, 213, 124, 164, 84, 84, 205, 189, 164, 20, 173, 170, 131, 95, 161, 71, 222,
+	180, 255, 183, 18, 156, 243, 168, 216, 103, 38, 160, 20, 71, 148
+}));
+
+//
+// Verifies numBatches batches of batchSize copies of the genesis proof, spread over numThreads threads.
+// Returns the wall time in seconds.
+//
+static double VerifyBatches(const size_t numThreads, const size_t numBatches, const size_t batchSize)
+{
+	const std::vector<Commitment> commitments(batchSize, GENESIS_COMMITMENT);
+	const std::vector<RangeProof> rangeProofs(batchSize, GENESIS_RANGE_PROOF);
+
+	std::atomic_bool valid = true;
+	std::atomic<size_t> nextBatch = 0;
+	std::vector<std::thread> threads;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < numThreads; i++)
+	{
+		threads.emplace_back([&commitments, &rangeProofs, &valid, &nextBatch, numBatches]
+		{
+			while (nextBatch++ < numBatches)
+			{
+				if (!Crypto::VerifyRangeProofs(commitments, rangeProofs))
+				{
+					valid = false;
+				}
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	REQUIRE(valid);
+	return std::chrono::duration<double>(end - start).count();
+}
+
+TEST_CASE("Crypto::VerifyRangeProofs")
+{
+	REQUIRE(Crypto::VerifyRangeProofs({ GENESIS_COMMITMENT }, { GENESIS_RANGE_PROOF }));
+	REQUIRE(Crypto::VerifyRangeProofs({ GENESIS_COMMITMENT, GENESIS_COMMITMENT }, { GENESIS_RANGE_PROOF, GENESIS_RANGE_PROOF }));
+	REQUIRE(Crypto::VerifyRangeProofs(std::vector<Commitment>(), std::vector<RangeProof>()));
+
+	const Commitment otherCommitment = *Crypto::CommitTransparent(1);
+	REQUIRE(!Crypto::VerifyRangeProofs({ otherCommitment }, { GENESIS_RANGE_PROOF }));
+	REQUIRE(!Crypto::VerifyRangeProofs({ GENESIS_COMMITMENT, otherCommitment }, { GENESIS_RANGE_PROOF, GENESIS_RANGE_PROOF }));
+	REQUIRE(!Crypto::VerifyRangeProofs({ GENESIS_COMMITMENT }, { GENESIS_RANGE_PROOF, GENESIS_RANGE_PROOF }));
+}
+
+TEST_CASE("Crypto::VerifyRangeProofs - Parallel speedup", "[.benchmark]")
+{
+	const size_t batchSize = 1024;
+	const size_t numThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+	const size_t numBatches = 2 * numThreads;
+
+	// Warm up the secp256k1 context and the pooled scratch spaces.
+	VerifyBatches(numThreads, numThreads, 1);
+
+	const double serialSeconds = VerifyBatches(1, numBatches, batchSize);
+	const double parallelSeconds = VerifyBatches(numThreads, numBatches, batchSize);
+
+	WARN("Verified " << (numBatches * batchSize) << " proofs in " << serialSeconds << "s on 1 thread, and in "
+		<< parallelSeconds << "s on " << numThreads << " threads (" << (serialSeconds / parallelSeconds) << "x speedup).");
+}
\ No newline at end of file
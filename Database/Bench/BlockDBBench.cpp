@@ -0,0 +1,358 @@
+//
+// Reproduces the chain database's workload against both the original column family profile (OptimizeForPointLookup, uncompressed)
+// and the tuned profiles from BlockDBOptions, so changes to either can be measured before they ship.
+//
+// Usage: Database_Bench <directory> [numBlocks] [numLookups] [NONE|LZ4|ZSTD]
+//
+// The workload mirrors a syncing node:
+//	1. Headers are written in batches, as the header syncer does.
+//	2. Each block is written in one batch along with its BlockSums and output positions.
+//	3. Headers, BlockSums and output positions are looked up at random (half of the output position lookups miss,
+//	   like the spent/unknown checks of transaction validation), with the occasional full block read.
+// The synthetic values have the same sizes and entropy as the real ones: hashes, commitments and proofs are random, while heights,
+// lengths and features are mostly zero bytes.
+//
+#include "../BlockDBOptions.h"
+
+#include <rocksdb/db.h>
+#include <rocksdb/table.h>
+#include <rocksdb/write_batch.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+static const size_t HEADER_BATCH_SIZE = 2000;
+static const size_t OUTPUTS_PER_BLOCK = 8;
+static const size_t INPUTS_PER_BLOCK = 8;
+static const size_t KERNELS_PER_BLOCK = 2;
+static const size_t RANGE_PROOF_SIZE = 675;
+
+class Workload
+{
+public:
+	Workload(const uint64_t numBlocks) : m_random(42)
+	{
+		for (uint64_t height = 0; height < numBlocks; height++)
+		{
+			m_blockHashes.push_back(RandomBytes(32));
+			for (size_t i = 0; i < OUTPUTS_PER_BLOCK; i++)
+			{
+				m_outputKeys.push_back(RandomBytes(32));
+			}
+		}
+	}
+
+	std::string RandomBytes(const size_t numBytes)
+	{
+		std::string bytes(numBytes, '\0');
+		for (char& byte : bytes)
+		{
+			byte = (char)(m_random() & 0xFF);
+		}
+
+		return bytes;
+	}
+
+	static std::string U64(const uint64_t value)
+	{
+		std::string bytes(8, '\0');
+		for (size_t i = 0; i < 8; i++)
+		{
+			bytes[7 - i] = (char)((value >> (i * 8)) & 0xFF);
+		}
+
+		return bytes;
+	}
+
+	std::string Header(const uint64_t height)
+	{
+		// Version, height, timestamp, previous hash, previous root, 3 MMR roots, kernel offset, 4 MMR sizes, difficulty, nonce, proof nonces
+		std::string header = std::string(2, '\0') + U64(height) + U64(1546300800 + height * 60);
+		header += RandomBytes(32 * 6);
+		header += U64(height * 17) + U64(height * 9) + U64(height * 17) + U64(height * 2);
+		header += U64(height * 1000) + U64(m_random());
+		header += RandomBytes(42 * 4);
+
+		return header;
+	}
+
+	std::string Block(const uint64_t height)
+	{
+		std::string block = Header(height);
+		block += U64(INPUTS_PER_BLOCK) + U64(OUTPUTS_PER_BLOCK) + U64(KERNELS_PER_BLOCK);
+		for (size_t i = 0; i < INPUTS_PER_BLOCK; i++)
+		{
+			block += std::string(1, '\0') + RandomBytes(33);
+		}
+
+		for (size_t i = 0; i < OUTPUTS_PER_BLOCK; i++)
+		{
+			block += std::string(1, '\0') + std::string(1, '\x09') + m_outputKeys[height * OUTPUTS_PER_BLOCK + i];
+			block += U64(RANGE_PROOF_SIZE) + RandomBytes(RANGE_PROOF_SIZE);
+		}
+
+		for (size_t i = 0; i < KERNELS_PER_BLOCK; i++)
+		{
+			block += std::string(1, '\0') + U64(8000000) + U64(0) + RandomBytes(33 + 64);
+		}
+
+		return block;
+	}
+
+	std::string BlockSums()
+	{
+		return RandomBytes(33 * 2);
+	}
+
+	std::mt19937_64& GetRandom() { return m_random; }
+	const std::vector<std::string>& GetBlockHashes() const { return m_blockHashes; }
+	const std::vector<std::string>& GetOutputKeys() const { return m_outputKeys; }
+
+private:
+	std::mt19937_64 m_random;
+	std::vector<std::string> m_blockHashes;
+	std::vector<std::string> m_outputKeys;
+};
+
+struct Profile
+{
+	std::string name;
+	DBOptions dbOptions;
+	ColumnFamilyOptions blockOptions;
+	ColumnFamilyOptions lookupOptions;
+};
+
+struct Latencies
+{
+	std::string name;
+	std::vector<uint64_t> nanos;
+
+	void Print()
+	{
+		if (nanos.empty())
+		{
+			return;
+		}
+
+		std::sort(nanos.begin(), nanos.end());
+		const uint64_t p50 = nanos[nanos.size() / 2];
+		const uint64_t p99 = nanos[std::min(nanos.size() - 1, (nanos.size() * 99) / 100)];
+		printf("  %-16s %10llu lookups  p50 %8.2f us  p99 %8.2f us\n", name.c_str(), (unsigned long long)nanos.size(), p50 / 1000.0, p99 / 1000.0);
+	}
+};
+
+static uint64_t GetFootprint(const std::string& directory)
+{
+	uint64_t totalSize = 0;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(directory))
+	{
+		if (entry.is_regular_file())
+		{
+			totalSize += entry.file_size();
+		}
+	}
+
+	return totalSize;
+}
+
+static bool RunProfile(const Profile& profile, const std::string& directory, const uint64_t numBlocks, const uint64_t numLookups)
+{
+	const std::string dbPath = directory + "/" + profile.name;
+	std::filesystem::remove_all(dbPath);
+	std::filesystem::create_directories(dbPath);
+
+	DBOptions dbOptions = profile.dbOptions;
+	dbOptions.create_if_missing = true;
+	dbOptions.create_missing_column_families = true;
+
+	std::vector<ColumnFamilyDescriptor> columnDescriptors({
+		ColumnFamilyDescriptor(kDefaultColumnFamilyName, profile.lookupOptions),
+		ColumnFamilyDescriptor("BLOCK", profile.blockOptions),
+		ColumnFamilyDescriptor("HEADER", profile.lookupOptions),
+		ColumnFamilyDescriptor("BLOCK_SUMS", profile.lookupOptions),
+		ColumnFamilyDescriptor("OUTPUT_POS", profile.lookupOptions)
+	});
+
+	DB* pDatabase = nullptr;
+	std::vector<ColumnFamilyHandle*> handles;
+	Status status = DB::Open(dbOptions, dbPath, columnDescriptors, &handles, &pDatabase);
+	if (!status.ok())
+	{
+		fprintf(stderr, "Failed to open %s: %s\n", dbPath.c_str(), status.ToString().c_str());
+		return false;
+	}
+
+	ColumnFamilyHandle* pBlockHandle = handles[1];
+	ColumnFamilyHandle* pHeaderHandle = handles[2];
+	ColumnFamilyHandle* pBlockSumsHandle = handles[3];
+	ColumnFamilyHandle* pOutputPosHandle = handles[4];
+
+	// Every profile sees the same data and the same lookups.
+	Workload workload(numBlocks);
+	const std::vector<std::string>& blockHashes = workload.GetBlockHashes();
+	const std::vector<std::string>& outputKeys = workload.GetOutputKeys();
+
+	const auto writeStart = std::chrono::steady_clock::now();
+
+	WriteBatch headerBatch;
+	for (uint64_t height = 0; height < numBlocks; height++)
+	{
+		headerBatch.Put(pHeaderHandle, blockHashes[height], workload.Header(height));
+		if (headerBatch.Count() >= HEADER_BATCH_SIZE || height + 1 == numBlocks)
+		{
+			status = pDatabase->Write(WriteOptions(), &headerBatch);
+			headerBatch.Clear();
+		}
+	}
+
+	for (uint64_t height = 0; status.ok() && height < numBlocks; height++)
+	{
+		WriteBatch blockBatch;
+		blockBatch.Put(pBlockHandle, blockHashes[height], workload.Block(height));
+		blockBatch.Put(pBlockSumsHandle, blockHashes[height], workload.BlockSums());
+		for (size_t i = 0; i < OUTPUTS_PER_BLOCK; i++)
+		{
+			const uint64_t mmrIndex = height * OUTPUTS_PER_BLOCK + i;
+			blockBatch.Put(pOutputPosHandle, outputKeys[mmrIndex], Workload::U64(mmrIndex));
+		}
+
+		status = pDatabase->Write(WriteOptions(), &blockBatch);
+	}
+
+	for (ColumnFamilyHandle* pHandle : handles)
+	{
+		if (status.ok())
+		{
+			status = pDatabase->Flush(FlushOptions(), pHandle);
+		}
+
+		if (status.ok())
+		{
+			status = pDatabase->CompactRange(CompactRangeOptions(), pHandle, nullptr, nullptr);
+		}
+	}
+
+	if (!status.ok())
+	{
+		fprintf(stderr, "Failed to write %s: %s\n", dbPath.c_str(), status.ToString().c_str());
+	}
+
+	const double writeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - writeStart).count();
+
+	Latencies headerLatencies{ "HEADER" };
+	Latencies blockSumsLatencies{ "BLOCK_SUMS" };
+	Latencies outputPosLatencies{ "OUTPUT_POS" };
+	Latencies blockLatencies{ "BLOCK" };
+
+	std::mt19937_64& random = workload.GetRandom();
+	for (uint64_t i = 0; status.ok() && i < numLookups; i++)
+	{
+		const uint64_t op = random() % 100;
+		const uint64_t height = random() % numBlocks;
+
+		ColumnFamilyHandle* pHandle = pOutputPosHandle;
+		Latencies* pLatencies = &outputPosLatencies;
+		std::string key;
+		if (op < 40)
+		{
+			key = (op % 2 == 0) ? outputKeys[random() % outputKeys.size()] : workload.RandomBytes(32);
+		}
+		else if (op < 80)
+		{
+			pHandle = pHeaderHandle;
+			pLatencies = &headerLatencies;
+			key = blockHashes[height];
+		}
+		else if (op < 95)
+		{
+			pHandle = pBlockSumsHandle;
+			pLatencies = &blockSumsLatencies;
+			key = blockHashes[height];
+		}
+		else
+		{
+			pHandle = pBlockHandle;
+			pLatencies = &blockLatencies;
+			key = blockHashes[height];
+		}
+
+		std::string value;
+		const auto lookupStart = std::chrono::steady_clock::now();
+		pDatabase->Get(ReadOptions(), pHandle, key, &value);
+		pLatencies->nanos.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - lookupStart).count());
+	}
+
+	for (ColumnFamilyHandle* pHandle : handles)
+	{
+		pDatabase->DestroyColumnFamilyHandle(pHandle);
+	}
+
+	delete pDatabase;
+
+	printf("%s\n", profile.name.c_str());
+	printf("  write + compact  %10.2f s\n", writeSeconds);
+	printf("  disk footprint   %10.2f MB\n", GetFootprint(dbPath) / (1024.0 * 1024.0));
+	headerLatencies.Print();
+	blockSumsLatencies.Print();
+	outputPosLatencies.Print();
+	blockLatencies.Print();
+
+	return status.ok();
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <directory> [numBlocks] [numLookups] [NONE|LZ4|ZSTD]\n", argv[0]);
+		return 1;
+	}
+
+	const std::string directory = argv[1];
+	const uint64_t numBlocks = std::max<uint64_t>(1, argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50000);
+	const uint64_t numLookups = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 500000;
+
+	EDBCompression compression = DatabaseConfig().GetBlockCompression();
+	if (argc > 4)
+	{
+		const std::string compressionArg = argv[4];
+		if (compressionArg == "LZ4")
+		{
+			compression = EDBCompression::LZ4;
+		}
+		else if (compressionArg == "ZSTD")
+		{
+			compression = EDBCompression::ZSTD;
+		}
+	}
+
+	// The profile every column family used before BlockDBOptions.
+	Profile legacy;
+	legacy.name = "legacy";
+	legacy.dbOptions.IncreaseParallelism();
+	legacy.blockOptions.OptimizeForPointLookup(1024);
+	legacy.blockOptions.compression = kNoCompression;
+	legacy.lookupOptions = legacy.blockOptions;
+
+	const DatabaseConfig defaultConfig;
+	const BlockDBOptions blockDBOptions(DatabaseConfig(defaultConfig.GetBlockCacheMB(), defaultConfig.GetBloomBitsPerKey(), compression));
+
+	Profile tuned;
+	tuned.name = "tuned";
+	tuned.dbOptions = blockDBOptions.GetDBOptions();
+	tuned.blockOptions = blockDBOptions.GetBlockOptions();
+	tuned.lookupOptions = blockDBOptions.GetLookupOptions();
+
+	printf("%llu blocks, %llu lookups\n\n", (unsigned long long)numBlocks, (unsigned long long)numLookups);
+
+	const bool legacySucceeded = RunProfile(legacy, directory, numBlocks, numLookups);
+	const bool tunedSucceeded = RunProfile(tuned, directory, numBlocks, numLookups);
+
+	return (legacySucceeded && tunedSucceeded) ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "BlockDBBatch.h"
+
+#include <Infrastructure/Logger.h>
+
+BlockDBBatch::BlockDBBatch(DB* pDatabase, ColumnFamilyHandle* pHeaderHandle, ColumnFamilyHandle* pBlockHandle, ColumnFamilyHandle* pBlockSumsHandle, ColumnFamilyHandle* pOutputPosHandle)
+	: m_pDatabase(pDatabase), m_pHeaderHandle(pHeaderHandle), m_pBlockHandle(pBlockHandle), m_pBlockSumsHandle(pBlockSumsHandle), m_pOutputPosHandle(pOutputPosHandle)
+{
+
+}
+
+// WriteBatch copies keys and values as they're added, so the serializers don't need to outlive the calls below.
+void BlockDBBatch::AddBlockHeader(const BlockHeader& blockHeader)
+{
+	const Hash& hash = blockHeader.GetHash();
+
+	Serializer serializer;
+	blockHeader.Serialize(serializer);
+
+	Slice key((const char*)&hash[0], hash.GetData().size());
+	Slice value((const char*)&serializer.GetBytes()[0], serializer.GetBytes().size());
+	m_batch.Put(m_pHeaderHandle, key, value);
+}
+
+void BlockDBBatch::AddBlock(const FullBlock& block)
+{
+	const Hash& hash = block.GetHash();
+
+	Serializer serializer;
+	block.Serialize(serializer);
+
+	Slice key((const char*)&hash[0], hash.GetData().size());
+	Slice value((const char*)&serializer.GetBytes()[0], serializer.GetBytes().size());
+	m_batch.Put(m_pBlockHandle, key, value);
+}
+
+void BlockDBBatch::AddBlockSums(const Hash& blockHash, const BlockSums& blockSums)
+{
+	Slice key((const char*)&blockHash[0], 32);
+
+	Serializer serializer;
+	blockSums.Serialize(serializer);
+	Slice value((const char*)&serializer.GetBytes()[0], serializer.GetBytes().size());
+
+	m_batch.Put(m_pBlockSumsHandle, key, value);
+}
+
+void BlockDBBatch::AddOutputPosition(const Commitment& outputCommitment, const uint64_t mmrIndex)
+{
+	Slice key((const char*)&outputCommitment.GetCommitmentBytes()[0], 32);
+
+	Serializer serializer;
+	serializer.Append<uint64_t>(mmrIndex);
+	Slice value((const char*)&serializer.GetBytes()[0], serializer.GetBytes().size());
+
+	m_batch.Put(m_pOutputPosHandle, key, value);
+}
+
+bool BlockDBBatch::Commit()
+{
+	if (m_batch.Count() == 0)
+	{
+		return true;
+	}
+
+	const Status status = m_pDatabase->Write(WriteOptions(), &m_batch);
+	if (!status.ok())
+	{
+		LoggerAPI::LogError("BlockDBBatch::Commit - Failed to write batch: " + status.ToString());
+		return false;
+	}
+
+	m_batch.Clear();
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <rocksdb/db.h>
+#include <rocksdb/write_batch.h>
+
+#include <Database/BlockDb.h>
+
+using namespace rocksdb;
+
+//
+// Collects writes to the BlockDB, so they can be applied atomically, in a single write, when the batch is committed.
+// Nothing is written if the batch is destroyed without being committed.
+//
+class BlockDBBatch
+{
+public:
+	BlockDBBatch(DB* pDatabase, ColumnFamilyHandle* pHeaderHandle, ColumnFamilyHandle* pBlockHandle, ColumnFamilyHandle* pBlockSumsHandle, ColumnFamilyHandle* pOutputPosHandle);
+
+	void AddBlockHeader(const BlockHeader& blockHeader);
+	void AddBlock(const FullBlock& block);
+	void AddBlockSums(const Hash& blockHash, const BlockSums& blockSums);
+	void AddOutputPosition(const Commitment& outputCommitment, const uint64_t mmrIndex);
+
+	bool Commit();
+
+private:
+	DB* m_pDatabase;
+	ColumnFamilyHandle* m_pHeaderHandle;
+	ColumnFamilyHandle* m_pBlockHandle;
+	ColumnFamilyHandle* m_pBlockSumsHandle;
+	ColumnFamilyHandle* m_pOutputPosHandle;
+
+	WriteBatch m_batch;
+};
\ No newline at end of file
@@ -1,78 +1,112 @@
 #include "BlockDBImpl.h"
+#include "BlockDBBatch.h"
+
+#include <rocksdb/sst_file_writer.h>
 
 #include <Infrastructure/Logger.h>
 #include <HexUtil.h>
 #include <StringUtil.h>
+#include <FileUtil.h>
+#include <algorithm>
+#include <cstring>
 #include <utility>
 #include <string>
 #include <filesystem>
 
-static ColumnFamilyDescriptor BLOCK_COLUMN = ColumnFamilyDescriptor("BLOCK", *ColumnFamilyOptions().OptimizeForPointLookup(1024));
-static ColumnFamilyDescriptor HEADER_COLUMN = ColumnFamilyDescriptor("HEADER", *ColumnFamilyOptions().OptimizeForPointLookup(1024));
-static ColumnFamilyDescriptor BLOCK_SUMS_COLUMN = ColumnFamilyDescriptor("BLOCK_SUMS", *ColumnFamilyOptions().OptimizeForPointLookup(1024));
-static ColumnFamilyDescriptor OUTPUT_POS_COLUMN = ColumnFamilyDescriptor("OUTPUT_POS", *ColumnFamilyOptions().OptimizeForPointLookup(1024));
+static const std::string BLOCK_COLUMN = "BLOCK";
+static const std::string HEADER_COLUMN = "HEADER";
+static const std::string BLOCK_SUMS_COLUMN = "BLOCK_SUMS";
+static const std::string OUTPUT_POS_COLUMN = "OUTPUT_POS";
 
-std::string kDBPath = "/tmp/rocksdb_simple_example";
+static const size_t LOAD_HEADERS_BATCH_SIZE = 10000;
+
+//
+// Values are deserialized straight out of the slice RocksDB returns (pinned in the block cache where possible), rather than from a copy.
+//
+static ByteSpan ToByteSpan(const Slice& slice)
+{
+	return ByteSpan((const unsigned char*)slice.data(), slice.size());
+}
 
 BlockDB::BlockDB(const Config& config)
-	: m_config(config)
+	: m_config(config),
+	m_options(config.GetDatabaseConfig()),
+	m_pDatabase(nullptr),
+	m_pDefaultHandle(nullptr),
+	m_pBlockHandle(nullptr),
+	m_pHeaderHandle(nullptr),
+	m_pBlockSumsHandle(nullptr),
+	m_pOutputPosHandle(nullptr)
 {
 
 }
 
-void BlockDB::OpenDB()
+//
+// Missing column families are created with the same options they're opened with,
+// so new and existing databases always end up with the same profiles.
+//
+bool BlockDB::OpenDB()
 {
-	Options options;
-	// Optimize RocksDB. This is the easiest way to get RocksDB to perform well
-	options.IncreaseParallelism();
-	//options.OptimizeLevelStyleCompaction();
-	// create the DB if it's not already present
-	options.create_if_missing = true;
-	options.compression = kNoCompression;
-
-	// open DB
 	const std::string dbPath = m_config.GetDatabaseDirectory() + "CHAIN/";
 	std::filesystem::create_directories(dbPath);
 
+	const ColumnFamilyOptions lookupOptions = m_options.GetLookupOptions();
+	std::vector<ColumnFamilyDescriptor> columnDescriptors({
+		ColumnFamilyDescriptor(kDefaultColumnFamilyName, lookupOptions),
+		ColumnFamilyDescriptor(BLOCK_COLUMN, m_options.GetBlockOptions()),
+		ColumnFamilyDescriptor(HEADER_COLUMN, lookupOptions),
+		ColumnFamilyDescriptor(BLOCK_SUMS_COLUMN, lookupOptions),
+		ColumnFamilyDescriptor(OUTPUT_POS_COLUMN, lookupOptions)
+	});
 
-	std::vector<std::string> columnFamilies;
-	DB::ListColumnFamilies(options, dbPath, &columnFamilies);
+	std::vector<ColumnFamilyHandle*> columnHandles;
+	Status status = DB::Open(m_options.GetDBOptions(), dbPath, columnDescriptors, &columnHandles, &m_pDatabase);
 
-	if (columnFamilies.size() <= 1)
+	// RocksDB refuses to open with a compression type it wasn't built with.
+	if (status.IsInvalidArgument() && m_options.GetBlockCompression() != EDBCompression::NONE)
 	{
-		std::vector<ColumnFamilyDescriptor> columnDescriptors({ ColumnFamilyDescriptor() });
-		std::vector<ColumnFamilyHandle*> columnHandles;
-		Status s = DB::Open(options, dbPath, columnDescriptors, &columnHandles, &m_pDatabase);
+		LoggerAPI::LogWarning("BlockDB::OpenDB - " + status.ToString() + ". Storing blocks uncompressed instead.");
 
-		m_pDefaultHandle = columnHandles[0];
-		m_pDatabase->CreateColumnFamily(BLOCK_COLUMN.options, BLOCK_COLUMN.name, &m_pBlockHandle);
-		m_pDatabase->CreateColumnFamily(HEADER_COLUMN.options, HEADER_COLUMN.name, &m_pHeaderHandle);
-		m_pDatabase->CreateColumnFamily(BLOCK_SUMS_COLUMN.options, BLOCK_SUMS_COLUMN.name, &m_pBlockSumsHandle);
-		m_pDatabase->CreateColumnFamily(OUTPUT_POS_COLUMN.options, OUTPUT_POS_COLUMN.name, &m_pOutputPosHandle);
+		columnDescriptors[1] = ColumnFamilyDescriptor(BLOCK_COLUMN, m_options.GetBlockOptions(true));
+		status = DB::Open(m_options.GetDBOptions(), dbPath, columnDescriptors, &columnHandles, &m_pDatabase);
 	}
-	else
+
+	if (!status.ok())
 	{
-		std::vector<ColumnFamilyDescriptor> columnDescriptors({ ColumnFamilyDescriptor(), BLOCK_COLUMN, HEADER_COLUMN, BLOCK_SUMS_COLUMN, OUTPUT_POS_COLUMN });
-		std::vector<ColumnFamilyHandle*> columnHandles;
-		Status s = DB::Open(options, dbPath, columnDescriptors, &columnHandles, &m_pDatabase);
-		m_pDefaultHandle = columnHandles[0];
-		m_pBlockHandle = columnHandles[1];
-		m_pHeaderHandle = columnHandles[2];
-		m_pBlockSumsHandle = columnHandles[3];
-		m_pOutputPosHandle = columnHandles[4];
+		LoggerAPI::LogError("BlockDB::OpenDB - Failed to open " + dbPath + ": " + status.ToString());
+		m_pDatabase = nullptr;
+		return false;
 	}
+
+	m_pDefaultHandle = columnHandles[0];
+	m_pBlockHandle = columnHandles[1];
+	m_pHeaderHandle = columnHandles[2];
+	m_pBlockSumsHandle = columnHandles[3];
+	m_pOutputPosHandle = columnHandles[4];
+
+	return true;
 }
 
 void BlockDB::CloseDB()
 {
-	delete m_pDefaultHandle;
-	delete m_pBlockHandle;
-	delete m_pHeaderHandle;
-	delete m_pBlockSumsHandle;
-	delete m_pOutputPosHandle;
+	if (m_pDatabase == nullptr)
+	{
+		return;
+	}
+
+	for (ColumnFamilyHandle* pHandle : { m_pDefaultHandle, m_pBlockHandle, m_pHeaderHandle, m_pBlockSumsHandle, m_pOutputPosHandle })
+	{
+		m_pDatabase->DestroyColumnFamilyHandle(pHandle);
+	}
+
 	delete m_pDatabase;
+	m_pDatabase = nullptr;
 }
 
+//
+// Headers are read with MultiGet in batches of LOAD_HEADERS_BATCH_SIZE, and aren't added to the block cache,
+// since the BlockStore keeps every one of them in memory anyway.
+//
 std::vector<BlockHeader*> BlockDB::LoadBlockHeaders(const std::vector<Hash>& hashes) const
 {
 	LoggerAPI::LogInfo("BlockDB::LoadBlockHeaders - Loading headers - " + std::to_string(hashes.size()));
@@ -80,17 +114,30 @@ std::vector<BlockHeader*> BlockDB::LoadBlockHeaders(const std::vector<Hash>& has
 	std::vector<BlockHeader*> blockHeaders;
 	blockHeaders.reserve(hashes.size());
 
-	for (const Hash& hash : hashes)
+	ReadOptions readOptions;
+	readOptions.fill_cache = false;
+
+	for (size_t batchStart = 0; batchStart < hashes.size(); batchStart += LOAD_HEADERS_BATCH_SIZE)
 	{
-		const Slice key((const char*)&hash[0], hash.GetData().size());
-		std::string value;
-		Status s = m_pDatabase->Get(ReadOptions(), m_pHeaderHandle, key, &value);
-		if (s.ok())
+		const size_t batchEnd = std::min(hashes.size(), batchStart + LOAD_HEADERS_BATCH_SIZE);
+
+		std::vector<Slice> keys;
+		keys.reserve(batchEnd - batchStart);
+		for (size_t i = batchStart; i < batchEnd; i++)
+		{
+			keys.emplace_back((const char*)&hashes[i][0], hashes[i].GetData().size());
+		}
+
+		std::vector<std::string> values;
+		const std::vector<ColumnFamilyHandle*> handles(keys.size(), m_pHeaderHandle);
+		const std::vector<Status> statuses = m_pDatabase->MultiGet(readOptions, handles, keys, &values);
+		for (size_t i = 0; i < statuses.size(); i++)
 		{
-			std::vector<unsigned char> data(value.data(), value.data() + value.size());
-			ByteBuffer byteBuffer(data);
-			BlockHeader* pBlockHeader = new BlockHeader(BlockHeader::Deserialize(byteBuffer));
-			blockHeaders.push_back(pBlockHeader);
+			if (statuses[i].ok())
+			{
+				ByteBuffer byteBuffer(ToByteSpan(values[i]));
+				blockHeaders.push_back(new BlockHeader(BlockHeader::Deserialize(byteBuffer)));
+			}
 		}
 	}
 
@@ -103,12 +150,11 @@ std::unique_ptr<BlockHeader> BlockDB::GetBlockHeader(const Hash& hash) const
 	std::unique_ptr<BlockHeader> pHeader = std::unique_ptr<BlockHeader>(nullptr);
 
 	Slice key((const char*)&hash[0], 32);
-	std::string value;
+	PinnableSlice value;
 	Status s = m_pDatabase->Get(ReadOptions(), m_pHeaderHandle, key, &value);
 	if (s.ok())
 	{
-		std::vector<unsigned char> data(value.data(), value.data() + value.size());
-		ByteBuffer byteBuffer(data);
+		ByteBuffer byteBuffer(ToByteSpan(value));
 		pHeader = std::make_unique<BlockHeader>(BlockHeader::Deserialize(byteBuffer));
 	}
 
@@ -117,45 +163,34 @@ std::unique_ptr<BlockHeader> BlockDB::GetBlockHeader(const Hash& hash) const
 
 void BlockDB::AddBlockHeader(const BlockHeader& blockHeader)
 {
-	const std::vector<unsigned char>& hash = blockHeader.GetHash().GetData();
-
-	Serializer serializer;
-	blockHeader.Serialize(serializer);
-
-	Slice key((const char*)&hash[0], hash.size());
-	Slice value((const char*)&serializer.GetBytes()[0], serializer.GetBytes().size());
-	m_pDatabase->Put(WriteOptions(), m_pHeaderHandle, Slice(key), value);
+	BlockDBBatch batch(m_pDatabase, m_pHeaderHandle, m_pBlockHandle, m_pBlockSumsHandle, m_pOutputPosHandle);
+	batch.AddBlockHeader(blockHeader);
+	batch.Commit();
 }
 
-void BlockDB::AddBlockHeaders(const std::vector<BlockHeader*>& blockHeaders)
+//
+// All of the headers are written in a single batch, so they share one write-ahead log record.
+//
+void BlockDB::AddBlockHeaders(const std::vector<const BlockHeader*>& blockHeaders)
 {
 	LoggerAPI::LogInfo("BlockDB::AddBlockHeaders - Adding headers - " + std::to_string(blockHeaders.size()));
 
+	BlockDBBatch batch(m_pDatabase, m_pHeaderHandle, m_pBlockHandle, m_pBlockSumsHandle, m_pOutputPosHandle);
 	for (const BlockHeader* pBlockHeader : blockHeaders)
 	{
-		const std::vector<unsigned char>& hash = pBlockHeader->GetHash().GetData();
-
-		Serializer serializer;
-		pBlockHeader->Serialize(serializer);
-
-		Slice key((const char*)&hash[0], hash.size());
-		Slice value((const char*)&serializer.GetBytes()[0], serializer.GetBytes().size());
-		m_pDatabase->Put(WriteOptions(), m_pHeaderHandle, key, value);
+		batch.AddBlockHeader(*pBlockHeader);
 	}
 
+	batch.Commit();
+
 	LoggerAPI::LogInfo("BlockDB::AddBlockHeaders - Finished adding headers.");
 }
 
 void BlockDB::AddBlock(const FullBlock& block)
 {
-	const std::vector<unsigned char>& hash = block.GetHash().GetData();
-
-	Serializer serializer;
-	block.Serialize(serializer);
-
-	Slice key((const char*)&hash[0], hash.size());
-	Slice value((const char*)&serializer.GetBytes()[0], serializer.GetBytes().size());
-	m_pDatabase->Put(WriteOptions(), m_pBlockHandle, Slice(key), value);
+	BlockDBBatch batch(m_pDatabase, m_pHeaderHandle, m_pBlockHandle, m_pBlockSumsHandle, m_pOutputPosHandle);
+	batch.AddBlock(block);
+	batch.Commit();
 }
 
 std::unique_ptr<FullBlock> BlockDB::GetBlock(const Hash& hash) const
@@ -163,12 +198,11 @@ std::unique_ptr<FullBlock> BlockDB::GetBlock(const Hash& hash) const
 	std::unique_ptr<FullBlock> pBlock = std::unique_ptr<FullBlock>(nullptr);
 
 	Slice key((const char*)&hash[0], 32);
-	std::string value;
+	PinnableSlice value;
 	Status s = m_pDatabase->Get(ReadOptions(), m_pBlockHandle, key, &value);
 	if (s.ok())
 	{
-		std::vector<unsigned char> data(value.data(), value.data() + value.size());
-		ByteBuffer byteBuffer(data);
+		ByteBuffer byteBuffer(ToByteSpan(value));
 		pBlock = std::make_unique<FullBlock>(FullBlock::Deserialize(byteBuffer));
 	}
 
@@ -179,15 +213,9 @@ void BlockDB::AddBlockSums(const Hash& blockHash, const BlockSums& blockSums)
 {
 	LoggerAPI::LogInfo("BlockDB::AddBlockSums - Adding BlockSums for block " + HexUtil::ConvertHash(blockHash));
 
-	Slice key((const char*)&blockHash[0], 32);
-
-	// Serializes the BlockSums object
-	Serializer serializer;
-	blockSums.Serialize(serializer);
-	Slice value((const char*)&serializer.GetBytes()[0], serializer.GetBytes().size());
-
-	// Insert BlockSums object
-	m_pDatabase->Put(WriteOptions(), m_pBlockSumsHandle, key, value);
+	BlockDBBatch batch(m_pDatabase, m_pHeaderHandle, m_pBlockHandle, m_pBlockSumsHandle, m_pOutputPosHandle);
+	batch.AddBlockSums(blockHash, blockSums);
+	batch.Commit();
 }
 
 std::unique_ptr<BlockSums> BlockDB::GetBlockSums(const Hash& blockHash) const
@@ -196,13 +224,12 @@ std::unique_ptr<BlockSums> BlockDB::GetBlockSums(const Hash& blockHash) const
 
 	// Read from DB
 	Slice key((const char*)&blockHash[0], 32);
-	std::string value;
+	PinnableSlice value;
 	const Status s = m_pDatabase->Get(ReadOptions(), m_pBlockSumsHandle, key, &value);
 	if (s.ok())
 	{
 		// Deserialize result
-		std::vector<unsigned char> data(value.data(), value.data() + value.size());
-		ByteBuffer byteBuffer(data);
+		ByteBuffer byteBuffer(ToByteSpan(value));
 		pBlockSums = std::make_unique<BlockSums>(BlockSums::Deserialize(byteBuffer));
 	}
 
@@ -212,18 +239,9 @@ std::unique_ptr<BlockSums> BlockDB::GetBlockSums(const Hash& blockHash) const
 
 void BlockDB::AddOutputPosition(const Commitment& outputCommitment, const uint64_t mmrIndex)
 {
-	const std::string outputHex = HexUtil::ConvertToHex(outputCommitment.GetCommitmentBytes().GetData(), false, false);
-	LoggerAPI::LogInfo(StringUtil::Format("BlockDB::AddOutputPosition - Adding position (%llu) for output (%s).", mmrIndex, outputHex.c_str()));
-
-	Slice key((const char*)&outputCommitment.GetCommitmentBytes()[0], 32);
-
-	// Serializes the output position
-	Serializer serializer;
-	serializer.Append<uint64_t>(mmrIndex);
-	Slice value((const char*)&serializer.GetBytes()[0], serializer.GetBytes().size());
-
-	// Insert the output position
-	m_pDatabase->Put(WriteOptions(), m_pOutputPosHandle, key, value);
+	BlockDBBatch batch(m_pDatabase, m_pHeaderHandle, m_pBlockHandle, m_pBlockSumsHandle, m_pOutputPosHandle);
+	batch.AddOutputPosition(outputCommitment, mmrIndex);
+	batch.Commit();
 }
 
 std::optional<uint64_t> BlockDB::GetOutputPosition(const Commitment& outputCommitment) const
@@ -233,15 +251,84 @@ std::optional<uint64_t> BlockDB::GetOutputPosition(const Commitment& outputCommi
 	Slice key((const char*)&outputCommitment.GetCommitmentBytes()[0], 32);
 
 	// Read from DB
-	std::string value;
+	PinnableSlice value;
 	const Status s = m_pDatabase->Get(ReadOptions(), m_pOutputPosHandle, key, &value);
 	if (s.ok())
 	{
 		// Deserialize result
-		std::vector<unsigned char> data(value.data(), value.data() + value.size());
-		ByteBuffer byteBuffer(data);
+		ByteBuffer byteBuffer(ToByteSpan(value));
 		outputPosition = std::make_optional<uint64_t>(byteBuffer.ReadU64());
 	}
 
 	return outputPosition;
+}
+
+//
+// Table files must be written in ascending key order without duplicates, so the positions are sorted by key first.
+// Once ingested, the file's entries take precedence over any older positions for the same outputs.
+//
+bool BlockDB::AddOutputPositions(const std::vector<std::pair<Commitment, uint64_t>>& outputPositions)
+{
+	if (outputPositions.empty())
+	{
+		return true;
+	}
+
+	LoggerAPI::LogInfo(StringUtil::Format("BlockDB::AddOutputPositions - Adding %llu output positions.", outputPositions.size()));
+
+	const auto compareKeys = [](const std::pair<Commitment, uint64_t>* pA, const std::pair<Commitment, uint64_t>* pB)
+	{
+		return memcmp(&pA->first.GetCommitmentBytes()[0], &pB->first.GetCommitmentBytes()[0], 32) < 0;
+	};
+
+	std::vector<const std::pair<Commitment, uint64_t>*> sortedPositions;
+	sortedPositions.reserve(outputPositions.size());
+	for (const std::pair<Commitment, uint64_t>& outputPosition : outputPositions)
+	{
+		sortedPositions.push_back(&outputPosition);
+	}
+
+	std::stable_sort(sortedPositions.begin(), sortedPositions.end(), compareKeys);
+
+	const std::string sstPath = m_config.GetDatabaseDirectory() + "OUTPUT_POS.sst";
+	SstFileWriter sstFileWriter(EnvOptions(), Options(m_options.GetDBOptions(), m_options.GetLookupOptions()), m_pOutputPosHandle);
+	Status status = sstFileWriter.Open(sstPath);
+
+	for (size_t i = 0; status.ok() && i < sortedPositions.size(); i++)
+	{
+		// Of positions with the same key, only the last survives.
+		if (i + 1 < sortedPositions.size() && !compareKeys(sortedPositions[i], sortedPositions[i + 1]))
+		{
+			continue;
+		}
+
+		Serializer serializer;
+		serializer.Append<uint64_t>(sortedPositions[i]->second);
+
+		Slice key((const char*)&sortedPositions[i]->first.GetCommitmentBytes()[0], 32);
+		Slice value((const char*)&serializer.GetBytes()[0], serializer.GetBytes().size());
+		status = sstFileWriter.Put(key, value);
+	}
+
+	if (status.ok())
+	{
+		status = sstFileWriter.Finish();
+	}
+
+	if (status.ok())
+	{
+		IngestExternalFileOptions ingestOptions;
+		ingestOptions.move_files = true;
+		status = m_pDatabase->IngestExternalFile(m_pOutputPosHandle, { sstPath }, ingestOptions);
+	}
+
+	FileUtil::RemoveFile(sstPath);
+
+	if (!status.ok())
+	{
+		LoggerAPI::LogError("BlockDB::AddOutputPositions - Failed to ingest output positions: " + status.ToString());
+		return false;
+	}
+
+	return true;
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <rocksdb/slice.h>
 #include <rocksdb/options.h>
 
+#include "BlockDBOptions.h"
+
 #include <Database/BlockDb.h>
 #include <Config/Config.h>
 #include <mutex>
@@ -17,14 +19,17 @@ public:
 	BlockDB(const Config& config);
 	~BlockDB() = default;
 
-	void OpenDB();
+	//
+	// Opens (or creates) the chain database, logging and returning false if RocksDB refuses to open it.
+	//
+	bool OpenDB();
 	void CloseDB();
 
 	virtual std::vector<BlockHeader*> LoadBlockHeaders(const std::vector<Hash>& hashes) const override final;
 	virtual std::unique_ptr<BlockHeader> GetBlockHeader(const Hash& hash) const override final;
 
 	virtual void AddBlockHeader(const BlockHeader& blockHeader) override final;
-	virtual void AddBlockHeaders(const std::vector<BlockHeader*>& blockHeaders) override final;
+	virtual void AddBlockHeaders(const std::vector<const BlockHeader*>& blockHeaders) override final;
 
 	virtual void AddBlock(const FullBlock& block) override final;
 	virtual std::unique_ptr<FullBlock> GetBlock(const Hash& hash) const override final;
@@ -34,9 +39,11 @@ public:
 
 	virtual void AddOutputPosition(const Commitment& outputCommitment, const uint64_t mmrIndex) override final;
 	virtual std::optional<uint64_t> GetOutputPosition(const Commitment& outputCommitment) const override final;
+	virtual bool AddOutputPositions(const std::vector<std::pair<Commitment, uint64_t>>& outputPositions) override final;
 
 private:
 	const Config& m_config;
+	const BlockDBOptions m_options;
 
 	DB* m_pDatabase;
 
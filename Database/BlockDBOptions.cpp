@@ -0,0 +1,72 @@
+#include "BlockDBOptions.h"
+
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/table.h>
+
+// Full blocks are tens of KB, so larger data blocks compress better and keep the index small.
+static const size_t BLOCK_COLUMN_BLOCK_SIZE = 64 * 1024;
+
+BlockDBOptions::BlockDBOptions(const DatabaseConfig& databaseConfig)
+	: m_databaseConfig(databaseConfig), m_pBlockCache(NewLRUCache((size_t)databaseConfig.GetBlockCacheMB() * 1024 * 1024))
+{
+
+}
+
+DBOptions BlockDBOptions::GetDBOptions() const
+{
+	DBOptions options;
+	options.IncreaseParallelism();
+	options.create_if_missing = true;
+	options.create_missing_column_families = true;
+
+	return options;
+}
+
+ColumnFamilyOptions BlockDBOptions::GetLookupOptions() const
+{
+	BlockBasedTableOptions tableOptions;
+	tableOptions.block_cache = m_pBlockCache;
+	tableOptions.cache_index_and_filter_blocks = true;
+	tableOptions.pin_l0_filter_and_index_blocks_in_cache = true;
+	if (m_databaseConfig.GetBloomBitsPerKey() > 0)
+	{
+		tableOptions.filter_policy.reset(NewBloomFilterPolicy((double)m_databaseConfig.GetBloomBitsPerKey(), false));
+	}
+
+	ColumnFamilyOptions options;
+	options.OptimizeLevelStyleCompaction();
+
+	// OptimizeLevelStyleCompaction compresses the lower levels, which would cost a decompression on most lookups.
+	options.compression_per_level.clear();
+	options.compression = kNoCompression;
+	options.table_factory.reset(NewBlockBasedTableFactory(tableOptions));
+
+	return options;
+}
+
+ColumnFamilyOptions BlockDBOptions::GetBlockOptions(const bool uncompressed) const
+{
+	BlockBasedTableOptions tableOptions;
+	tableOptions.block_cache = m_pBlockCache;
+	tableOptions.block_size = BLOCK_COLUMN_BLOCK_SIZE;
+
+	ColumnFamilyOptions options;
+	options.OptimizeLevelStyleCompaction();
+	options.compression_per_level.clear();
+	options.table_factory.reset(NewBlockBasedTableFactory(tableOptions));
+
+	switch (uncompressed ? EDBCompression::NONE : m_databaseConfig.GetBlockCompression())
+	{
+	case EDBCompression::NONE:
+		options.compression = kNoCompression;
+		break;
+	case EDBCompression::LZ4:
+		options.compression = kLZ4Compression;
+		break;
+	case EDBCompression::ZSTD:
+		options.compression = kZSTD;
+		break;
+	}
+
+	return options;
+}
\ No newline at end of file
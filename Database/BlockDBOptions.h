@@ -0,0 +1,34 @@
+#pragma once
+
+#include <rocksdb/cache.h>
+#include <rocksdb/options.h>
+
+#include <Config/DatabaseConfig.h>
+#include <memory>
+
+using namespace rocksdb;
+
+//
+// The RocksDB profiles used by the chain database. Every column family shares one LRU block cache.
+// Headers, block sums and output positions are small, hot values looked up by key, so they're left uncompressed,
+// and have bloom filters whose index and filter blocks are held in the cache.
+// Full blocks are large, written once in height order and rarely read, so they're compressed in larger blocks.
+//
+class BlockDBOptions
+{
+public:
+	BlockDBOptions(const DatabaseConfig& databaseConfig);
+
+	DBOptions GetDBOptions() const;
+	ColumnFamilyOptions GetLookupOptions() const;
+
+	//
+	// Uses the configured compression unless uncompressed is true.
+	//
+	ColumnFamilyOptions GetBlockOptions(const bool uncompressed = false) const;
+	inline EDBCompression GetBlockCompression() const { return m_databaseConfig.GetBlockCompression(); }
+
+private:
+	const DatabaseConfig m_databaseConfig;
+	std::shared_ptr<Cache> m_pBlockCache;
+};
\ No newline at end of file
@@ -3,8 +3,7 @@
 Database::Database(const Config& config)
 	: m_config(config), m_blockDB(config), m_peerDB(config)
 {
-	m_blockDB.OpenDB();
-	m_peerDB.OpenDB();
+
 }
 
 Database::~Database()
@@ -13,6 +12,11 @@ Database::~Database()
 	m_blockDB.CloseDB();
 }
 
+bool Database::Open()
+{
+	return m_blockDB.OpenDB() && m_peerDB.OpenDB();
+}
+
 IBlockDB& Database::GetBlockDB()
 {
 	return m_blockDB;
@@ -30,7 +34,13 @@ namespace DatabaseAPI
 	//
 	DATABASE_API IDatabase* OpenDatabase(const Config& config)
 	{
-		IDatabase* pDatabase = new Database(config);
+		Database* pDatabase = new Database(config);
+		if (!pDatabase->Open())
+		{
+			delete pDatabase;
+			return nullptr;
+		}
+
 		return pDatabase;
 	}
 
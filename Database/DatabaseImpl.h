@@ -11,6 +11,8 @@ public:
 	Database(const Config& config);
 	virtual ~Database();
 
+	bool Open();
+
 	virtual IBlockDB& GetBlockDB() override final;
 	virtual IPeerDB& GetPeerDB() override final;
 
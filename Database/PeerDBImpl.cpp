@@ -8,7 +8,7 @@
 #include <filesystem>
 
 PeerDB::PeerDB(const Config& config)
-	: m_config(config)
+	: m_config(config), m_pDatabase(nullptr)
 {
 
 }
@@ -18,12 +18,11 @@ PeerDB::~PeerDB()
 
 }
 
-void PeerDB::OpenDB()
+bool PeerDB::OpenDB()
 {
 	Options options;
 	// Optimize RocksDB. This is the easiest way to get RocksDB to perform well
 	options.IncreaseParallelism();
-	//options.OptimizeLevelStyleCompaction();
 	// create the DB if it's not already present
 	options.create_if_missing = true;
 	options.compression = kNoCompression;
@@ -32,12 +31,21 @@ void PeerDB::OpenDB()
 	const std::string dbPath = m_config.GetDatabaseDirectory() + "PEERS/";
 	std::filesystem::create_directories(dbPath);
 
-	Status s = DB::Open(options, dbPath, &m_pDatabase); // TODO: Define columns (Peer by address, Peer by capabilities, Peer by last contact, etc.)?
+	const Status status = DB::Open(options, dbPath, &m_pDatabase); // TODO: Define columns (Peer by address, Peer by capabilities, Peer by last contact, etc.)?
+	if (!status.ok())
+	{
+		LoggerAPI::LogError("PeerDB::OpenDB - Failed to open " + dbPath + ": " + status.ToString());
+		m_pDatabase = nullptr;
+		return false;
+	}
+
+	return true;
 }
 
 void PeerDB::CloseDB()
 {
-	//delete m_pDatabase;
+	delete m_pDatabase;
+	m_pDatabase = nullptr;
 }
 
 std::vector<Peer> PeerDB::LoadAllPeers()
@@ -49,11 +57,12 @@ std::vector<Peer> PeerDB::LoadAllPeers()
 	rocksdb::Iterator* it = m_pDatabase->NewIterator(rocksdb::ReadOptions());
 	for (it->SeekToFirst(); it->Valid(); it->Next())
 	{
-		std::vector<unsigned char> data(it->value().data(), it->value().data() + it->value().size());
-		ByteBuffer byteBuffer(data);
+		ByteBuffer byteBuffer(ByteSpan((const unsigned char*)it->value().data(), it->value().size()));
 		peers.emplace_back(Peer::Deserialize(byteBuffer));
 	}
 
+	delete it;
+
 	return peers;
 }
 
@@ -16,7 +16,7 @@ public:
 	PeerDB(const Config& config);
 	~PeerDB();
 
-	void OpenDB();
+	bool OpenDB();
 	void CloseDB();
 
 	virtual std::vector<Peer> LoadAllPeers() override final;
@@ -19,7 +19,7 @@ std::vector<CBigInteger<32>> BlockLocator::GetLocators() const
 	locators.reserve(locatorHeights.size());
 	for (const uint64_t locatorHeight : locatorHeights)
 	{
-		std::unique_ptr<BlockHeader> pHeader = m_blockChainServer.GetBlockHeaderByHeight(locatorHeight, EChainType::SYNC);
+		std::shared_ptr<const BlockHeader> pHeader = m_blockChainServer.GetBlockHeaderByHeight(locatorHeight, EChainType::SYNC);
 		if (pHeader != nullptr)
 		{
 			locators.push_back(pHeader->GetHash());
@@ -63,7 +63,7 @@ std::vector<BlockHeader> BlockLocator::LocateHeaders(const std::vector<CBigInteg
 {
 	std::vector<BlockHeader> blockHeaders;
 
-	std::unique_ptr<BlockHeader> pCommonHeader = FindCommonHeader(locatorHashes);
+	std::shared_ptr<const BlockHeader> pCommonHeader = FindCommonHeader(locatorHashes);
 	if (pCommonHeader != nullptr)
 	{
 		const uint64_t totalHeight = m_blockChainServer.GetHeight(EChainType::SYNC);
@@ -72,7 +72,7 @@ std::vector<BlockHeader> BlockLocator::LocateHeaders(const std::vector<CBigInteg
 
 		for (int i = 1; i <= numHeadersToSend; i++)
 		{
-			std::unique_ptr<BlockHeader> pHeader = m_blockChainServer.GetBlockHeaderByHeight(headerHeight + i, EChainType::SYNC);
+			std::shared_ptr<const BlockHeader> pHeader = m_blockChainServer.GetBlockHeaderByHeight(headerHeight + i, EChainType::SYNC);
 			if (pHeader == nullptr)
 			{
 				break;
@@ -85,16 +85,16 @@ std::vector<BlockHeader> BlockLocator::LocateHeaders(const std::vector<CBigInteg
 	return blockHeaders;
 }
 
-std::unique_ptr<BlockHeader> BlockLocator::FindCommonHeader(const std::vector<CBigInteger<32>>& locatorHashes) const
+std::shared_ptr<const BlockHeader> BlockLocator::FindCommonHeader(const std::vector<CBigInteger<32>>& locatorHashes) const
 {
 	for (CBigInteger<32> locatorHash : locatorHashes)
 	{
-		std::unique_ptr<BlockHeader> pHeader = m_blockChainServer.GetBlockHeaderByHash(locatorHash);
+		std::shared_ptr<const BlockHeader> pHeader = m_blockChainServer.GetBlockHeaderByHash(locatorHash);
 		if (pHeader != nullptr)
 		{
 			return pHeader;
 		}
 	}
 
-	return std::unique_ptr<BlockHeader>(nullptr);
+	return std::shared_ptr<const BlockHeader>(nullptr);
 }
\ No newline at end of file
@@ -13,7 +13,7 @@ public:
 
 private:
 	std::vector<uint64_t> GetLocatorHeights() const;
-	std::unique_ptr<BlockHeader> FindCommonHeader(const std::vector<CBigInteger<32>>& locatorHashes) const;
+	std::shared_ptr<const BlockHeader> FindCommonHeader(const std::vector<CBigInteger<32>>& locatorHashes) const;
 
 	IBlockChainServer& m_blockChainServer;
 };
\ No newline at end of file
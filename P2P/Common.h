@@ -20,6 +20,37 @@ namespace P2P
 	// Max theoretical size of a block filled with outputs.
 	static const uint64_t MAX_BLOCK_SIZE = ((Consensus::MAX_BLOCK_WEIGHT / Consensus::BLOCK_OUTPUT_WEIGHT) * 708);
 
+	// Max size of a message payload. Leaves headroom over MAX_BLOCK_SIZE for blocks made mostly of inputs and kernels.
+	static const uint64_t MAX_MESSAGE_LENGTH = 2 * MAX_BLOCK_SIZE;
+
+	// Max bytes queued for sending to a single peer. A peer that falls this far behind is disconnected.
+	static const uint64_t MAX_SEND_QUEUE_BYTES = 4 * MAX_MESSAGE_LENGTH;
+
+	// Max bytes of received messages waiting to be processed for a single peer. Reading from the peer pauses beyond this,
+	// leaving further data in the socket's receive buffer, until half of it has been processed.
+	static const uint64_t MAX_RECEIVE_QUEUE_BYTES = 2 * MAX_MESSAGE_LENGTH;
+
+	// Max number of block and transaction hashes remembered per peer to avoid relaying items the peer already has.
+	static const size_t MAX_KNOWN_INVENTORY = 20000;
+
+	// Max number of compact blocks kept while waiting for peers to send their missing transactions.
+	static const size_t MAX_PENDING_COMPACT_BLOCKS = 16;
+
+	// Max number of TxHashSet archives uploaded to peers at the same time.
+	static const size_t MAX_TXHASHSET_UPLOADS = 2;
+
+	// Minimum number of seconds between TxHashSet archives sent to the same peer.
+	static const int64_t TXHASHSET_UPLOAD_INTERVAL = 600;
+
+	// How often, in seconds, connected peers are pinged to measure their latency.
+	static const int64_t PING_INTERVAL = 10;
+
+	// A ping left unanswered for this many seconds counts as a timeout.
+	static const int64_t PING_TIMEOUT = 30;
+
+	// Connections whose PeerMetrics score falls below this are dropped, so the seeder can replace them with better peers.
+	static const int64_t MIN_PEER_SCORE = -1000;
+
 	// Maximum number of block headers a peer should ever send
 	static const uint32_t MAX_BLOCK_HEADERS = 512;
 
@@ -1,20 +1,24 @@
 #pragma once
 
-#include <P2P/peer.h>
+#include "Common.h"
+#include "SocketHelper.h"
+#include "SendQueue.h"
+#include "KnownInventory.h"
+#include "ConnectionMetrics.h"
 
-#define _WINSOCK_DEPRECATED_NO_WARNINGS
-#include <WinSock2.h>
+#include <P2P/peer.h>
+#include <memory>
 
 class ConnectedPeer
 {
 public:
 	ConnectedPeer(const SOCKET connection, const Peer& peer)
-		: m_connection(connection), m_peer(peer)
+		: m_connection(connection), m_peer(peer), m_pSendQueue(std::make_shared<SendQueue>(P2P::MAX_SEND_QUEUE_BYTES)), m_pKnownInventory(std::make_shared<KnownInventory>(P2P::MAX_KNOWN_INVENTORY / 2)), m_pMetrics(std::make_shared<ConnectionMetrics>(peer.GetMetrics()))
 	{
 
 	}
 	ConnectedPeer(const ConnectedPeer& peer)
-		: m_connection(peer.m_connection), m_peer(peer.m_peer), m_totalDifficulty(peer.m_totalDifficulty.load())
+		: m_connection(peer.m_connection), m_peer(peer.m_peer), m_pSendQueue(peer.m_pSendQueue), m_pKnownInventory(peer.m_pKnownInventory), m_pMetrics(peer.m_pMetrics), m_totalDifficulty(peer.m_totalDifficulty.load())
 	{
 
 	}
@@ -29,11 +33,16 @@ public:
 	inline const Peer& GetPeer() const { return m_peer; }
 	inline const uint64_t GetTotalDifficulty() const { return m_totalDifficulty; }
 	inline const uint64_t GetHeight() const { return m_height; }
+	inline SendQueue& GetSendQueue() const { return *m_pSendQueue; }
+	inline KnownInventory& GetKnownInventory() const { return *m_pKnownInventory; }
+	inline ConnectionMetrics& GetMetrics() const { return *m_pMetrics; }
 
 private:
 	const SOCKET m_connection;
 	const Peer m_peer;
+	std::shared_ptr<SendQueue> m_pSendQueue;
+	std::shared_ptr<KnownInventory> m_pKnownInventory;
+	std::shared_ptr<ConnectionMetrics> m_pMetrics;
 	std::atomic<uint64_t> m_totalDifficulty;
 	std::atomic<uint64_t> m_height;
-	// TODO: Add Connection Stats
 };
\ No newline at end of file
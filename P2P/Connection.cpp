@@ -1,11 +1,18 @@
 #include "Connection.h"
-#include "BaseMessageRetriever.h"
 #include "MessageProcessor.h"
 #include "MessageSender.h"
 #include "ConnectionManager.h"
 #include "Seed/PeerManager.h"
 
+#ifdef __linux__
+#include "SocketReactor.h"
+#else
+#include "BaseMessageRetriever.h"
+#endif
+
 #include <Infrastructure/ThreadManager.h>
+#include <Infrastructure/Logger.h>
+#include <StringUtil.h>
 #include <thread>
 #include <chrono>
 #include <memory>
@@ -23,6 +30,18 @@ bool Connection::Connect()
 		return true;
 	}
 
+#ifdef __linux__
+	SocketReactor& socketReactor = m_connectionManager.GetSocketReactor();
+	socketReactor.Unregister(m_connectionId);
+
+	m_terminate = false;
+
+	if (!socketReactor.Register(*this, m_connectedPeer.GetConnection()))
+	{
+		m_terminate = true;
+		return false;
+	}
+#else
 	m_terminate = true;
 	if (m_connectionThread.joinable())
 	{
@@ -33,6 +52,7 @@ bool Connection::Connect()
 
 	m_connectionThread = std::thread(Thread_ProcessConnection, std::ref(*this));
 	ThreadManagerAPI::SetThreadName(m_connectionThread.get_id(), "PEER_CONNECTION");
+#endif
 
 	return true;
 }
@@ -55,23 +75,98 @@ void Connection::Disconnect()
 {
 	m_terminate = true;
 
+#ifdef __linux__
+	m_connectionManager.GetSocketReactor().Unregister(m_connectionId);
+#else
 	if (m_connectionThread.joinable())
 	{
 		m_connectionThread.join();
 	}
+#endif
 }
 
 void Connection::Send(const IMessage& message)
 {
-	std::lock_guard<std::mutex> lockGuard(m_sendMutex);
-	m_sendQueue.emplace(message.Clone());
+	SendFrame(MessageSender(m_config).Serialize(message));
+}
+
+//
+// Queues an already serialized frame. The socket is written by the connection's own task (or thread), never by the caller.
+//
+void Connection::SendFrame(const SendQueue::Frame& pFrame)
+{
+	if (!m_connectedPeer.GetSendQueue().Push(pFrame))
+	{
+		LoggerAPI::LogWarning(StringUtil::Format("Connection::Send - Disconnecting slow peer (%llu) with %llu bytes queued.", m_connectionId, m_connectedPeer.GetSendQueue().GetQueuedBytes()));
+		m_terminate = true;
+		return;
+	}
+
+#ifdef __linux__
+	ScheduleFlush();
+#endif
+}
+
+bool Connection::SendFile(const SendQueue::Frame& pHeaderFrame, const std::string& filePath, const uint64_t fileSize, const std::shared_ptr<const void>& pOwner)
+{
+	if (m_terminate || !m_connectedPeer.GetSendQueue().PushFile(pHeaderFrame, filePath, fileSize, pOwner))
+	{
+		return false;
+	}
+
+#ifdef __linux__
+	ScheduleFlush();
+#endif
+
+	return true;
 }
 
+void Connection::ProcessMessage(const RawMessage& rawMessage)
+{
+	std::lock_guard<std::mutex> lockGuard(m_peerMutex);
+	if (m_terminate)
+	{
+		return;
+	}
+
+	m_connectedPeer.GetPeer().UpdateLastContactTime();
+
+	MessageProcessor messageProcessor(m_config, m_connectionManager, m_peerManager, m_blockChainServer);
+	if (messageProcessor.ProcessMessage(m_connectionId, m_connectedPeer, rawMessage) == MessageProcessor::BAN_PEER)
+	{
+		m_connectedPeer.GetMetrics().RecordInvalidData();
+	}
+
+#ifdef __linux__
+	// Replies are flushed while the message is processed, but a flush stops partway through a queued file,
+	// and the socket won't report being writable again if it never filled up.
+	if (!m_connectedPeer.GetSendQueue().IsEmpty())
+	{
+		ScheduleFlush();
+	}
+#endif
+}
+
+void Connection::OnSocketClosed()
+{
+	m_terminate = true;
+}
+
+#ifdef __linux__
+void Connection::OnSocketWritable()
+{
+	ScheduleFlush();
+}
+#endif
+
 Peer Connection::GetPeer() const
 {
 	std::lock_guard<std::mutex> lockGuard(m_peerMutex);
 
-	return m_connectedPeer.GetPeer();
+	Peer peer = m_connectedPeer.GetPeer();
+	peer.UpdateMetrics(m_connectedPeer.GetMetrics().GetPeerMetrics());
+
+	return peer;
 }
 
 uint64_t Connection::GetTotalDifficulty() const
@@ -89,6 +184,38 @@ Capabilities Connection::GetCapabilities() const
 	return m_connectedPeer.GetPeer().GetCapabilities();
 }
 
+#ifdef __linux__
+//
+// Flushes run as a task for this connection, so they are serialized with message processing, and at most one is queued at a time.
+//
+void Connection::ScheduleFlush()
+{
+	if (!m_flushScheduled.exchange(true))
+	{
+		if (!m_connectionManager.GetSocketReactor().Post(m_connectionId, [this] { FlushSendQueue(); }))
+		{
+			m_flushScheduled = false;
+		}
+	}
+}
+
+void Connection::FlushSendQueue()
+{
+	m_flushScheduled = false;
+
+	std::lock_guard<std::mutex> lockGuard(m_peerMutex);
+	const SendQueue::EStatus status = m_connectedPeer.GetSendQueue().Flush(m_connectedPeer.GetConnection());
+	if (status == SendQueue::SOCKET_FAILURE)
+	{
+		m_terminate = true;
+	}
+	else if (status == SendQueue::YIELDED)
+	{
+		// The socket is still writable, so no writable event will come. Queue behind the connection's other tasks instead.
+		ScheduleFlush();
+	}
+}
+#else
 //
 // Continuously checks for messages to send and/or receive until the connection is terminated.
 // This function runs in its own thread.
@@ -107,21 +234,20 @@ void Connection::Thread_ProcessConnection(Connection& connection)
 		if (pRawMessage.get() != nullptr)
 		{
 			const MessageProcessor::EStatus status = messageProcessor.ProcessMessage(connection.m_connectionId, connection.m_connectedPeer, *pRawMessage);
+			if (status == MessageProcessor::BAN_PEER)
+			{
+				connection.m_connectedPeer.GetMetrics().RecordInvalidData();
+			}
 		}
 
-		// Send the next message in the queue, if one exists.
-		std::unique_lock<std::mutex> sendLockGuard(connection.m_sendMutex);
-		if (!connection.m_sendQueue.empty())
+		// Send everything that's queued.
+		if (connection.m_connectedPeer.GetSendQueue().Flush(connection.m_connectedPeer.GetConnection()) == SendQueue::SOCKET_FAILURE)
 		{
-			std::unique_ptr<IMessage> pMessageToSend(connection.m_sendQueue.front());
-			connection.m_sendQueue.pop();
-
-			MessageSender(connection.m_config).Send(connection.m_connectedPeer, *pMessageToSend);
+			connection.m_terminate = true;
 		}
 
-		// TODO: If no message sent or received in last ~15 seconds, send ping.
-		sendLockGuard.unlock();
 		lockGuard.unlock();
 		std::this_thread::sleep_for(std::chrono::milliseconds(100));
 	}
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -2,11 +2,12 @@
 
 #include "ConnectedPeer.h"
 #include "Messages/Message.h"
+#include "Messages/RawMessage.h"
 
 #include <Config/Config.h>
 #include <mutex>
 #include <atomic>
-#include <queue>
+#include <thread>
 
 // Forward Declarations
 class IMessage;
@@ -16,8 +17,10 @@ class PeerManager;
 
 //
 // A Connection will be created for each ConnectedPeer.
-// Each Connection will run on its own thread, and will watch the socket for messages,
-// and will ping the peer when it hasn't been heard from in a while.
+// On Linux, the Connection's socket is watched by the ConnectionManager's SocketReactor,
+// which processes received messages and flushes the send queue on a shared pool of worker threads.
+// Elsewhere, each Connection will run on its own thread, and will watch the socket for messages.
+// Either way, the ConnectionManager pings the peer every P2P::PING_INTERVAL to measure its latency.
 //
 class Connection
 {
@@ -30,26 +33,50 @@ public:
 	void Disconnect();
 
 	void Send(const IMessage& message);
+	void SendFrame(const SendQueue::Frame& pFrame);
 
+	//
+	// Queues the header frame, followed by the raw contents of the file, which are streamed from disk as the socket accepts them.
+	// pOwner is released once the file has been sent, or the connection is gone.
+	//
+	bool SendFile(const SendQueue::Frame& pHeaderFrame, const std::string& filePath, const uint64_t fileSize, const std::shared_ptr<const void>& pOwner);
+
+	void ProcessMessage(const RawMessage& rawMessage);
+	void OnSocketClosed();
+#ifdef __linux__
+	void OnSocketWritable();
+#endif
+
+	//
+	// Returns the peer along with its latest metrics.
+	//
 	Peer GetPeer() const;
 	uint64_t GetTotalDifficulty() const;
 	uint64_t GetHeight() const;
 	Capabilities GetCapabilities() const;
+	inline KnownInventory& GetKnownInventory() const { return m_connectedPeer.GetKnownInventory(); }
+	inline ConnectionMetrics& GetMetrics() const { return m_connectedPeer.GetMetrics(); }
 
 private:
+#ifdef __linux__
+	void ScheduleFlush();
+	void FlushSendQueue();
+#else
 	static void Thread_ProcessConnection(Connection& connection);
+#endif
 
 	const Config& m_config;
 	IBlockChainServer& m_blockChainServer;
 	ConnectionManager& m_connectionManager;
 	PeerManager& m_peerManager;
 	std::atomic<bool> m_terminate = true;
+#ifdef __linux__
+	std::atomic<bool> m_flushScheduled = false;
+#else
 	std::thread m_connectionThread;
+#endif
 	const uint64_t m_connectionId;
 
 	mutable std::mutex m_peerMutex;
 	ConnectedPeer m_connectedPeer;
-
-	mutable std::mutex m_sendMutex;
-	std::queue<IMessage*> m_sendQueue;
 };
\ No newline at end of file
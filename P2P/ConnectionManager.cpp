@@ -1,22 +1,34 @@
 #include "ConnectionManager.h"
 #include "Seed/PeerManager.h"
+#include "MessageSender.h"
 #include "Messages/GetPeerAddressesMessage.h"
+#include "Messages/PingMessage.h"
 
 #include <thread>
 #include <chrono>
+#include <algorithm>
 #include <VectorUtil.h>
 #include <Infrastructure/ThreadManager.h>
 #include <Infrastructure/Logger.h>
 #include <StringUtil.h>
 
 ConnectionManager::ConnectionManager(const Config& config, PeerManager& peerManager, IBlockChainServer& blockChainServer)
-	: m_config(config), m_peerManager(peerManager), m_blockChainServer(blockChainServer), m_syncer(*this, blockChainServer), m_seeder(config, *this, peerManager, blockChainServer)
+	: m_config(config), m_peerManager(peerManager), m_blockChainServer(blockChainServer),
+#ifdef __linux__
+	m_socketReactor(config),
+#endif
+	m_pendingCompactBlocks(P2P::MAX_PENDING_COMPACT_BLOCKS), m_txHashSetSender(config, *this, blockChainServer), m_syncer(config, *this, blockChainServer), m_seeder(config, *this, peerManager, blockChainServer)
 {
 
 }
 
 void ConnectionManager::Start()
 {
+#ifdef __linux__
+	m_socketReactor.Start();
+#endif
+
+	m_txHashSetSender.Start();
 	m_seeder.Start();
 	m_syncer.Start();
 
@@ -34,8 +46,13 @@ void ConnectionManager::Stop()
 {
 	m_seeder.Stop();
 	m_syncer.Stop();
+	m_txHashSetSender.Stop();
 
-	m_terminate = true;
+	{
+		std::lock_guard<std::mutex> broadcastLock(m_broadcastMutex);
+		m_terminate = true;
+		m_broadcastCondition.notify_all();
+	}
 
 	if (m_broadcastThread.joinable())
 	{
@@ -43,6 +60,10 @@ void ConnectionManager::Stop()
 	}
 
 	PruneConnections(false);
+
+#ifdef __linux__
+	m_socketReactor.Stop();
+#endif
 }
 
 size_t ConnectionManager::GetNumberOfActiveConnections() const
@@ -55,7 +76,7 @@ std::vector<uint64_t> ConnectionManager::GetMostWorkPeers() const
 {
 	std::shared_lock<std::shared_mutex> readLock(m_connectionsMutex);
 
-	std::vector<uint64_t> mostWorkPeers;
+	std::vector<Connection*> mostWorkPeers;
 
 	Connection* pMostWorkPeer = GetMostWorkPeer();
 	if (pMostWorkPeer != nullptr)
@@ -65,12 +86,20 @@ std::vector<uint64_t> ConnectionManager::GetMostWorkPeers() const
 		{
 			if (pConnection->GetTotalDifficulty() >= totalDifficulty)
 			{
-				mostWorkPeers.push_back(pConnection->GetId());
+				mostWorkPeers.push_back(pConnection);
 			}
 		}
 	}
 
-	return mostWorkPeers;
+	std::stable_sort(mostWorkPeers.begin(), mostWorkPeers.end(), [](Connection* pA, Connection* pB) { return pA->GetMetrics().GetScore() > pB->GetMetrics().GetScore(); });
+
+	std::vector<uint64_t> mostWorkPeerIds;
+	for (Connection* pConnection : mostWorkPeers)
+	{
+		mostWorkPeerIds.push_back(pConnection->GetId());
+	}
+
+	return mostWorkPeerIds;
 }
 
 uint64_t ConnectionManager::GetMostWork() const
@@ -127,10 +156,26 @@ bool ConnectionManager::SendMessageToPeer(const IMessage& message, const uint64_
 	return false;
 }
 
-void ConnectionManager::BroadcastMessage(const IMessage& message, const uint64_t sourceId)
+bool ConnectionManager::SendFileToPeer(const uint64_t connectionId, const SendQueue::Frame& pHeaderFrame, const std::string& filePath, const uint64_t fileSize, const std::shared_ptr<const void>& pOwner)
+{
+	std::shared_lock<std::shared_mutex> readLock(m_connectionsMutex);
+
+	Connection* pConnection = GetConnectionById(connectionId);
+	if (pConnection != nullptr)
+	{
+		return pConnection->SendFile(pHeaderFrame, filePath, fileSize, pOwner);
+	}
+
+	return false;
+}
+
+void ConnectionManager::BroadcastMessage(const IMessage& message, const uint64_t sourceId, const Hash& inventoryHash)
 {
+	const SendQueue::Frame pFrame = MessageSender(m_config).Serialize(message);
+
 	std::unique_lock<std::mutex> writeLock(m_broadcastMutex);
-	m_sendQueue.emplace(MessageToBroadcast(sourceId, message.Clone()));
+	m_sendQueue.emplace(MessageToBroadcast(sourceId, pFrame, inventoryHash));
+	m_broadcastCondition.notify_one();
 }
 
 void ConnectionManager::AddConnection(Connection* pConnection)
@@ -153,17 +198,27 @@ void ConnectionManager::PruneConnections(const bool bInactiveOnly)
 			LoggerAPI::LogWarning(StringUtil::Format("ConnectionManager::BanConnection() - Banning peer (%d) at (%s).", pConnection->GetId(), pConnection->GetPeer().GetIPAddress().Format().c_str()));
 			pConnection->Disconnect();
 
+			// Saved so the peer's invalid data counts against it the next time a peer is chosen.
+			m_peerManager.UpdatePeer(pConnection->GetPeer());
+
 			VectorUtil::Remove<Connection*>(m_connections, i);
 			delete pConnection;
 
 			continue;
 		}
 
-		if (!bInactiveOnly || !pConnection->IsConnectionActive())
+		// Poorly scoring peers are dropped even when active, so the seeder can replace them with better peers.
+		const int64_t score = pConnection->GetMetrics().GetScore();
+		if (!bInactiveOnly || !pConnection->IsConnectionActive() || score < P2P::MIN_PEER_SCORE)
 		{
+			if (score < P2P::MIN_PEER_SCORE)
+			{
+				LoggerAPI::LogInfo(StringUtil::Format("ConnectionManager::PruneConnections() - Dropping peer (%llu) with score %lld.", pConnection->GetId(), score));
+			}
+
 			pConnection->Disconnect();
 
-			m_peerManager.UpdatePeer(pConnection->GetPeer()); // TODO: Also save connection stats.
+			m_peerManager.UpdatePeer(pConnection->GetPeer());
 
 			VectorUtil::Remove<Connection*>(m_connections, i);
 			delete pConnection;
@@ -175,7 +230,57 @@ void ConnectionManager::BanConnection(const uint64_t connectionId)
 {
 	std::unique_lock<std::shared_mutex> writeLock(m_connectionsMutex);
 
-	m_peersToBan.insert(connectionId);
+	Connection* pConnection = GetConnectionById(connectionId);
+	if (pConnection != nullptr && m_peersToBan.insert(connectionId).second)
+	{
+		pConnection->GetMetrics().RecordInvalidData();
+	}
+}
+
+void ConnectionManager::PingPeers()
+{
+	std::shared_lock<std::shared_mutex> readLock(m_connectionsMutex);
+
+	std::vector<Connection*> connectionsToPing;
+	for (Connection* pConnection : m_connections)
+	{
+		if (pConnection->GetMetrics().BeginPing())
+		{
+			connectionsToPing.push_back(pConnection);
+		}
+	}
+
+	if (!connectionsToPing.empty())
+	{
+		const PingMessage pingMessage(m_blockChainServer.GetTotalDifficulty(EChainType::CONFIRMED), m_blockChainServer.GetHeight(EChainType::CONFIRMED));
+		const SendQueue::Frame pFrame = MessageSender(m_config).Serialize(pingMessage);
+		for (Connection* pConnection : connectionsToPing)
+		{
+			pConnection->SendFrame(pFrame);
+		}
+	}
+}
+
+void ConnectionManager::RecordThroughput(const uint64_t connectionId, const double bytesPerSecond)
+{
+	std::shared_lock<std::shared_mutex> readLock(m_connectionsMutex);
+
+	Connection* pConnection = GetConnectionById(connectionId);
+	if (pConnection != nullptr)
+	{
+		pConnection->GetMetrics().RecordThroughput(bytesPerSecond);
+	}
+}
+
+void ConnectionManager::RecordTimeout(const uint64_t connectionId)
+{
+	std::shared_lock<std::shared_mutex> readLock(m_connectionsMutex);
+
+	Connection* pConnection = GetConnectionById(connectionId);
+	if (pConnection != nullptr)
+	{
+		pConnection->GetMetrics().RecordTimeout();
+	}
 }
 
 Connection* ConnectionManager::GetMostWorkPeer() const
@@ -201,9 +306,27 @@ Connection* ConnectionManager::GetMostWorkPeer() const
 		return nullptr;
 	}
 
-	const int index = std::rand() % mostWorkPeers.size();
+	// Of the peers with the most work, prefer the best scoring, choosing randomly between peers that score the same.
+	int64_t bestScore = INT64_MIN;
+	std::vector<Connection*> bestPeers;
+	for (Connection* pConnection : mostWorkPeers)
+	{
+		const int64_t score = pConnection->GetMetrics().GetScore();
+		if (score > bestScore)
+		{
+			bestScore = score;
+			bestPeers.clear();
+		}
+
+		if (score == bestScore)
+		{
+			bestPeers.push_back(pConnection);
+		}
+	}
+
+	const int index = std::rand() % bestPeers.size();
 
-	return mostWorkPeers[index];
+	return bestPeers[index];
 }
 
 Connection* ConnectionManager::GetConnectionById(const uint64_t connectionId) const
@@ -219,16 +342,18 @@ Connection* ConnectionManager::GetConnectionById(const uint64_t connectionId) co
 	return nullptr;
 }
 
+//
+// Relays queued broadcasts. Each broadcast is a single frame shared by the send queues of every peer it's relayed to.
+//
 void ConnectionManager::Thread_Broadcast(ConnectionManager& connectionManager)
 {
-	while (!connectionManager.m_terminate) 
+	while (true) 
 	{
 		std::unique_lock<std::mutex> messageWriteLock(connectionManager.m_broadcastMutex);
-		if (connectionManager.m_sendQueue.empty())
+		connectionManager.m_broadcastCondition.wait(messageWriteLock, [&connectionManager] { return connectionManager.m_terminate || !connectionManager.m_sendQueue.empty(); });
+		if (connectionManager.m_terminate)
 		{
-			messageWriteLock.unlock();
-			std::this_thread::sleep_for(std::chrono::milliseconds(100));
-			continue;
+			break;
 		}
 
 		MessageToBroadcast broadcastMessage(connectionManager.m_sendQueue.front());
@@ -239,12 +364,11 @@ void ConnectionManager::Thread_Broadcast(ConnectionManager& connectionManager)
 		// TODO: This should only broadcast to 8(?) peers. Should maybe be configurable.
 		for (Connection* pConnection : connectionManager.m_connections)
 		{
-			if (pConnection->GetId() != broadcastMessage.m_sourceId)
+			// Add returns false when the peer sent us the item or was already sent it.
+			if (pConnection->GetId() != broadcastMessage.m_sourceId && pConnection->GetKnownInventory().Add(broadcastMessage.m_inventoryHash))
 			{
-				pConnection->Send(*broadcastMessage.m_pMessage);
+				pConnection->SendFrame(broadcastMessage.m_pFrame);
 			}
 		}
-
-		delete broadcastMessage.m_pMessage;
 	}
 }
\ No newline at end of file
@@ -1,15 +1,23 @@
 #pragma once
 
 #include "Connection.h"
+#include "PendingCompactBlocks.h"
+#include "TxHashSetSender.h"
 #include "Sync/Syncer.h"
 #include "Seed/Seeder.h"
 
+#ifdef __linux__
+#include "SocketReactor.h"
+#endif
+
 #include <Config/Config.h>
 #include <BlockChainServer.h>
 #include <vector>
 #include <shared_mutex>
 #include <thread>
 #include <set>
+#include <queue>
+#include <condition_variable>
 
 // Forward Declarations
 class PeerManager;
@@ -23,20 +31,47 @@ public:
 	void Stop();
 
 	inline const SyncStatus& GetSyncStatus() const { return m_syncer.GetSyncStatus(); }
+	inline Syncer& GetSyncer() { return m_syncer; }
+	inline PendingCompactBlocks& GetPendingCompactBlocks() { return m_pendingCompactBlocks; }
+	inline TxHashSetSender& GetTxHashSetSender() { return m_txHashSetSender; }
 	size_t GetNumberOfActiveConnections() const;
+
+	//
+	// Returns the ids of every peer with the most work, best scoring first.
+	//
 	std::vector<uint64_t> GetMostWorkPeers() const;
 	uint64_t GetMostWork() const;
 	uint64_t GetHighestHeight() const;
 
 	uint64_t SendMessageToMostWorkPeer(const IMessage& message);
 	bool SendMessageToPeer(const IMessage& message, const uint64_t connectionId);
-	void BroadcastMessage(const IMessage& message, const uint64_t sourceId);
+
+	//
+	// Queues the header frame followed by the contents of the file for the peer. See Connection::SendFile.
+	//
+	bool SendFileToPeer(const uint64_t connectionId, const SendQueue::Frame& pHeaderFrame, const std::string& filePath, const uint64_t fileSize, const std::shared_ptr<const void>& pOwner);
+
+	//
+	// Serializes the message once and relays it to every peer other than the source that isn't already known to have the item identified by inventoryHash.
+	//
+	void BroadcastMessage(const IMessage& message, const uint64_t sourceId, const Hash& inventoryHash);
 
 	void PruneConnections(const bool bInactiveOnly);
 	void AddConnection(Connection* pConnection);
 
 	void BanConnection(const uint64_t connectionId);
 
+	//
+	// Pings every peer that's due, so its latency is kept up to date.
+	//
+	void PingPeers();
+	void RecordThroughput(const uint64_t connectionId, const double bytesPerSecond);
+	void RecordTimeout(const uint64_t connectionId);
+
+#ifdef __linux__
+	inline SocketReactor& GetSocketReactor() { return m_socketReactor; }
+#endif
+
 private:
 	Connection* GetMostWorkPeer() const;
 	Connection* GetConnectionById(const uint64_t connectionId) const;
@@ -49,15 +84,17 @@ private:
 
 	struct MessageToBroadcast
 	{
-		MessageToBroadcast(uint64_t sourceId, IMessage* pMessage)
-			: m_sourceId(sourceId), m_pMessage(pMessage)
+		MessageToBroadcast(uint64_t sourceId, const SendQueue::Frame& pFrame, const Hash& inventoryHash)
+			: m_sourceId(sourceId), m_pFrame(pFrame), m_inventoryHash(inventoryHash)
 		{
 
 		}
 		uint64_t m_sourceId;
-		IMessage* m_pMessage;
+		SendQueue::Frame m_pFrame;
+		Hash m_inventoryHash;
 	};
 	mutable std::mutex m_broadcastMutex;
+	std::condition_variable m_broadcastCondition;
 	std::queue<MessageToBroadcast> m_sendQueue;
 	std::thread m_broadcastThread;
 	std::atomic_bool m_terminate;
@@ -65,6 +102,11 @@ private:
 	const Config& m_config;
 	PeerManager& m_peerManager;
 	IBlockChainServer& m_blockChainServer;
+#ifdef __linux__
+	SocketReactor m_socketReactor;
+#endif
+	PendingCompactBlocks m_pendingCompactBlocks;
+	TxHashSetSender m_txHashSetSender;
 	Syncer m_syncer;
 	Seeder m_seeder;
 };
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "ConnectionMetrics.h"
+#include "Common.h"
+
+ConnectionMetrics::ConnectionMetrics(const PeerMetrics& metrics)
+	: m_metrics(metrics), m_lastPingTime(), m_pingOutstanding(false)
+{
+
+}
+
+bool ConnectionMetrics::BeginPing()
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+
+	const Clock::time_point now = Clock::now();
+	if (m_pingOutstanding)
+	{
+		if (now - m_lastPingTime < std::chrono::seconds(P2P::PING_TIMEOUT))
+		{
+			return false;
+		}
+
+		m_metrics.RecordTimeout();
+	}
+	else if (now - m_lastPingTime < std::chrono::seconds(P2P::PING_INTERVAL))
+	{
+		return false;
+	}
+
+	m_lastPingTime = now;
+	m_pingOutstanding = true;
+	return true;
+}
+
+void ConnectionMetrics::OnPong()
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+
+	// Only the first pong after our ping is measured. Unsolicited pongs are ignored.
+	if (m_pingOutstanding)
+	{
+		const auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - m_lastPingTime);
+		m_metrics.RecordLatency((uint32_t)latency.count());
+		m_pingOutstanding = false;
+	}
+}
+
+void ConnectionMetrics::RecordThroughput(const double bytesPerSecond)
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	m_metrics.RecordThroughput((uint64_t)bytesPerSecond);
+}
+
+void ConnectionMetrics::RecordTimeout()
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	m_metrics.RecordTimeout();
+}
+
+void ConnectionMetrics::RecordInvalidData()
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	m_metrics.RecordInvalidData();
+}
+
+PeerMetrics ConnectionMetrics::GetPeerMetrics() const
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	return m_metrics;
+}
+
+int64_t ConnectionMetrics::GetScore() const
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	return m_metrics.GetScore();
+}
\ No newline at end of file
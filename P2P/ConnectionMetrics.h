@@ -0,0 +1,38 @@
+#pragma once
+
+#include <P2P/PeerMetrics.h>
+#include <chrono>
+#include <mutex>
+
+//
+// The metrics of a connected peer, shared by every copy of its ConnectedPeer, and safe to update from any thread.
+// Starts from the metrics persisted for the peer, and is saved back to the PeerDB when the connection is pruned.
+// Round trip times are measured from pings, of which at most one is outstanding at a time.
+//
+class ConnectionMetrics
+{
+public:
+	ConnectionMetrics(const PeerMetrics& metrics);
+
+	//
+	// Returns true, and marks a ping as sent, if the peer is due to be pinged.
+	// A ping left unanswered for P2P::PING_TIMEOUT counts as a timeout, and is replaced by a new ping.
+	//
+	bool BeginPing();
+	void OnPong();
+
+	void RecordThroughput(const double bytesPerSecond);
+	void RecordTimeout();
+	void RecordInvalidData();
+
+	PeerMetrics GetPeerMetrics() const;
+	int64_t GetScore() const;
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	mutable std::mutex m_mutex;
+	PeerMetrics m_metrics;
+	Clock::time_point m_lastPingTime;
+	bool m_pingOutstanding;
+};
\ No newline at end of file
@@ -103,7 +103,7 @@ bool Dandelion::ProcessStemPhase()
 		m_relayNodeId = mostWorkPeers[index];
 	}
 
-	std::unique_ptr<BlockHeader> pConfirmedTipHeader = m_blockChainServer.GetTipBlockHeader(EChainType::CONFIRMED);
+	std::shared_ptr<const BlockHeader> pConfirmedTipHeader = m_blockChainServer.GetTipBlockHeader(EChainType::CONFIRMED);
 	std::unique_ptr<Transaction> pTransactionToStem = m_transactionPool.GetTransactionToStem(*pConfirmedTipHeader);
 	if (pTransactionToStem != nullptr)
 	{
@@ -121,7 +121,7 @@ bool Dandelion::ProcessStemPhase()
 			if (added)
 			{
 				const TransactionMessage transactionMessage(*pTransactionToStem);
-				m_connectionManager.BroadcastMessage(transactionMessage, 0);
+				m_connectionManager.BroadcastMessage(transactionMessage, 0, pTransactionToStem->GetHash());
 			}
 		}
 	}
@@ -131,7 +131,7 @@ bool Dandelion::ProcessStemPhase()
 
 bool Dandelion::ProcessFluffPhase()
 {
-	std::unique_ptr<BlockHeader> pConfirmedTipHeader = m_blockChainServer.GetTipBlockHeader(EChainType::CONFIRMED);
+	std::shared_ptr<const BlockHeader> pConfirmedTipHeader = m_blockChainServer.GetTipBlockHeader(EChainType::CONFIRMED);
 	std::unique_ptr<Transaction> pTransactionToFluff = m_transactionPool.GetTransactionToFluff(*pConfirmedTipHeader);
 	if (pTransactionToFluff != nullptr)
 	{
@@ -140,7 +140,7 @@ bool Dandelion::ProcessFluffPhase()
 		if (added)
 		{
 			const TransactionMessage transactionMessage(*pTransactionToFluff);
-			m_connectionManager.BroadcastMessage(transactionMessage, 0);
+			m_connectionManager.BroadcastMessage(transactionMessage, 0, pTransactionToFluff->GetHash());
 		}
 	}
 
@@ -149,7 +149,7 @@ bool Dandelion::ProcessFluffPhase()
 
 bool Dandelion::ProcessExpiredEntries()
 {
-	std::unique_ptr<BlockHeader> pConfirmedTipHeader = m_blockChainServer.GetTipBlockHeader(EChainType::CONFIRMED);
+	std::shared_ptr<const BlockHeader> pConfirmedTipHeader = m_blockChainServer.GetTipBlockHeader(EChainType::CONFIRMED);
 	const std::vector<Transaction> expiredTransactions = m_transactionPool.GetExpiredTransactions();
 	if (!expiredTransactions.empty())
 	{
@@ -159,7 +159,7 @@ bool Dandelion::ProcessExpiredEntries()
 			if (m_transactionPool.AddTransaction(transaction, EPoolType::MEMPOOL, *pConfirmedTipHeader))
 			{
 				const TransactionMessage transactionMessage(transaction);
-				m_connectionManager.BroadcastMessage(transactionMessage, 0);
+				m_connectionManager.BroadcastMessage(transactionMessage, 0, transaction.GetHash());
 			}
 		}
 	}
@@ -0,0 +1,24 @@
+#include "KnownInventory.h"
+
+KnownInventory::KnownInventory(const size_t maxGenerationSize)
+	: m_maxGenerationSize(maxGenerationSize)
+{
+
+}
+
+bool KnownInventory::Add(const Hash& hash)
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	if (m_previousGeneration.count(hash) > 0 || !m_currentGeneration.insert(hash).second)
+	{
+		return false;
+	}
+
+	if (m_currentGeneration.size() >= m_maxGenerationSize)
+	{
+		m_previousGeneration = std::move(m_currentGeneration);
+		m_currentGeneration = std::unordered_set<Hash>();
+	}
+
+	return true;
+}
\ No newline at end of file
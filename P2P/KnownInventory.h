@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Hash.h>
+#include <mutex>
+#include <unordered_set>
+
+//
+// The hashes of blocks and transactions a peer is known to have, either because the peer sent them to us or because we sent them to the peer.
+// Stem transactions aren't included, since they must still be relayed to the peer once fluffed.
+// Used to avoid relaying an item back to a peer that already has it.
+// Memory is bounded by keeping two generations of hashes and discarding the older generation once the newer one fills up.
+//
+class KnownInventory
+{
+public:
+	KnownInventory(const size_t maxGenerationSize);
+
+	//
+	// Returns true if the hash was not already known.
+	//
+	bool Add(const Hash& hash);
+
+private:
+	const size_t m_maxGenerationSize;
+
+	mutable std::mutex m_mutex;
+	std::unordered_set<Hash> m_currentGeneration;
+	std::unordered_set<Hash> m_previousGeneration;
+};
\ No newline at end of file
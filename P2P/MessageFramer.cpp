@@ -0,0 +1,80 @@
+#include "MessageFramer.h"
+#include "Common.h"
+
+#include <Serialization/ByteBuffer.h>
+
+MessageFramer::MessageFramer(const Config& config)
+	: m_config(config), m_headerBuffer(P2P::HEADER_LENGTH, 0), m_headerBytesReceived(0), m_payloadBytesReceived(0)
+{
+
+}
+
+size_t MessageFramer::GetBytesNeeded() const
+{
+	if (m_pMessageHeader == nullptr)
+	{
+		return P2P::HEADER_LENGTH - m_headerBytesReceived;
+	}
+
+	return m_payload.size() - m_payloadBytesReceived;
+}
+
+unsigned char* MessageFramer::GetReceiveBuffer()
+{
+	if (m_pMessageHeader == nullptr)
+	{
+		return m_headerBuffer.data() + m_headerBytesReceived;
+	}
+
+	return m_payload.data() + m_payloadBytesReceived;
+}
+
+MessageFramer::EStatus MessageFramer::OnBytesReceived(const size_t numBytes)
+{
+	if (m_pMessageHeader == nullptr)
+	{
+		m_headerBytesReceived += numBytes;
+		if (m_headerBytesReceived < P2P::HEADER_LENGTH)
+		{
+			return EStatus::INCOMPLETE;
+		}
+
+		ByteBuffer byteBuffer(m_headerBuffer);
+		m_pMessageHeader = std::make_unique<MessageHeader>(MessageHeader::Deserialize(byteBuffer));
+		if (!m_pMessageHeader->IsValid(m_config))
+		{
+			Reset();
+			return EStatus::INVALID_HEADER;
+		}
+
+		m_payload.resize(m_pMessageHeader->GetMessageLength());
+		m_payloadBytesReceived = 0;
+	}
+	else
+	{
+		m_payloadBytesReceived += numBytes;
+	}
+
+	return m_payloadBytesReceived == m_payload.size() ? EStatus::MESSAGE_READY : EStatus::INCOMPLETE;
+}
+
+std::unique_ptr<RawMessage> MessageFramer::TakeMessage()
+{
+	if (m_pMessageHeader == nullptr || m_payloadBytesReceived != m_payload.size())
+	{
+		return std::unique_ptr<RawMessage>(nullptr);
+	}
+
+	std::unique_ptr<RawMessage> pRawMessage = std::make_unique<RawMessage>(std::move(*m_pMessageHeader), std::move(m_payload));
+	Reset();
+
+	return pRawMessage;
+}
+
+void MessageFramer::Reset()
+{
+	m_headerBytesReceived = 0;
+	m_pMessageHeader.reset();
+	m_payload = std::vector<unsigned char>();
+	m_payloadBytesReceived = 0;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Messages/RawMessage.h"
+
+#include <Config/Config.h>
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+//
+// Assembles framed RawMessages from a stream of bytes received on a non-blocking socket.
+// The framer tells the caller how many bytes it needs next and exposes a buffer to receive them into,
+// so header bytes and payload bytes are read directly into place and never past the end of the current message.
+//
+class MessageFramer
+{
+public:
+	enum EStatus
+	{
+		INCOMPLETE,
+		MESSAGE_READY,
+		INVALID_HEADER
+	};
+
+	MessageFramer(const Config& config);
+
+	//
+	// Returns the number of bytes needed to finish the header or the payload currently being assembled.
+	//
+	size_t GetBytesNeeded() const;
+
+	//
+	// Returns a buffer with room for at least GetBytesNeeded() bytes.
+	//
+	unsigned char* GetReceiveBuffer();
+
+	//
+	// Records that numBytes were received into the buffer returned by GetReceiveBuffer().
+	// Returns MESSAGE_READY once a full message has been assembled, at which point it must be taken with TakeMessage().
+	//
+	EStatus OnBytesReceived(const size_t numBytes);
+
+	std::unique_ptr<RawMessage> TakeMessage();
+
+private:
+	void Reset();
+
+	const Config& m_config;
+
+	std::vector<unsigned char> m_headerBuffer;
+	size_t m_headerBytesReceived;
+
+	std::unique_ptr<MessageHeader> m_pMessageHeader;
+	std::vector<unsigned char> m_payload;
+	size_t m_payloadBytesReceived;
+};
\ No newline at end of file
@@ -21,6 +21,8 @@
 #include "Messages/GetBlockMessage.h"
 #include "Messages/CompactBlockMessage.h"
 #include "Messages/GetCompactBlockMessage.h"
+#include "Messages/GetBlockTransactionsMessage.h"
+#include "Messages/BlockTransactionsMessage.h"
 
 // Transaction Messages
 #include "Messages/TransactionMessage.h"
@@ -30,12 +32,10 @@
 
 #include <HexUtil.h>
 #include <StringUtil.h>
-#include <FileUtil.h>
 #include <BlockChainServer.h>
 #include <Infrastructure/Logger.h>
 #include <async++.h>
-#include <fstream>
-#include <filesystem>
+#include <chrono>
 
 static const int BUFFER_SIZE = 64 * 1024;
 
@@ -59,7 +59,8 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessage(const uint64_t connec
 		const std::string formattedIPAddress = connectedPeer.GetPeer().GetIPAddress().Format();
 		LoggerAPI::LogError(StringUtil::Format("MessageProcessor::ProcessMessage - Deserialization exception while processing message(%d) from %s.", messageType, formattedIPAddress.c_str()));
 
-		return EStatus::BAN_PEER;
+		// Unparseable messages may just come from a peer running a different protocol version, so they're not counted as invalid data.
+		return EStatus::UNKNOWN_ERROR;
 	}
 }
 
@@ -77,7 +78,7 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(const uint64_
 				const ErrorMessage errorMessage = ErrorMessage::Deserialize(byteBuffer);
 				LoggerAPI::LogWarning("Error message retrieved from peer(" + formattedIPAddress + "): " + errorMessage.GetErrorMessage());
 
-				return EStatus::BAN_PEER;
+				return EStatus::UNKNOWN_ERROR;
 			}
 			case BanReason:
 			{
@@ -85,7 +86,7 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(const uint64_
 				const BanReasonMessage banReasonMessage = BanReasonMessage::Deserialize(byteBuffer);
 				LoggerAPI::LogWarning("BanReason message retrieved from peer(" + formattedIPAddress + "): " + std::to_string(banReasonMessage.GetBanReason()));
 
-				return EStatus::BAN_PEER;
+				return EStatus::UNKNOWN_ERROR;
 			}
 			case Ping:
 			{
@@ -102,6 +103,7 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(const uint64_
 				ByteBuffer byteBuffer(rawMessage.GetPayload());
 				const PongMessage pongMessage = PongMessage::Deserialize(byteBuffer);
 				connectedPeer.UpdateTotals(pongMessage.GetTotalDifficulty(), pongMessage.GetHeight());
+				connectedPeer.GetMetrics().OnPong();
 
 				return EStatus::SUCCESS;
 			}
@@ -151,6 +153,7 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(const uint64_
 				ByteBuffer byteBuffer(rawMessage.GetPayload());
 				const HeaderMessage headerMessage = HeaderMessage::Deserialize(byteBuffer);
 				const BlockHeader& blockHeader = headerMessage.GetHeader();
+				connectedPeer.GetKnownInventory().Add(blockHeader.GetHash());
 
 				const EBlockChainStatus status = m_blockChainServer.AddBlockHeader(blockHeader);
 				if (status == EBlockChainStatus::SUCCESS)
@@ -170,14 +173,21 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(const uint64_
 			}
 			case Headers:
 			{
-				async::spawn([this, rawMessage, formattedIPAddress] {
+				// The MessageProcessor may not outlive the task, so only long-lived references are captured.
+				async::spawn([&blockChainServer = m_blockChainServer, &connectionManager = m_connectionManager, connectionId, rawMessage, formattedIPAddress] {
 					ByteBuffer byteBuffer(rawMessage.GetPayload());
 					const HeadersMessage headersMessage = HeadersMessage::Deserialize(byteBuffer);
 					const std::vector<BlockHeader>& blockHeaders = headersMessage.GetHeaders();
 
 					LoggerAPI::LogDebug(StringUtil::Format("MessageProcessor::ProcessMessageInternal - %lld headers received from %s.", blockHeaders.size(), formattedIPAddress.c_str()));
 
-					this->m_blockChainServer.AddBlockHeaders(blockHeaders);
+					// Headers requested during header sync are processed in height order by the scheduler.
+					HeaderDownloadScheduler& headerDownloadScheduler = connectionManager.GetSyncer().GetHeaderDownloadScheduler();
+					if (!headerDownloadScheduler.OnHeadersReceived(connectionId, blockHeaders))
+					{
+						blockChainServer.AddBlockHeaders(blockHeaders);
+					}
+
 					LoggerAPI::LogInfo(StringUtil::Format("MessageProcessor::ProcessMessageInternal - Headers message from %s finished processing.", formattedIPAddress.c_str()));
 				});
 
@@ -198,42 +208,109 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(const uint64_
 			}
 			case Block:
 			{
-				async::spawn([this, rawMessage, formattedIPAddress] {
+				async::spawn([&blockChainServer = m_blockChainServer, &connectionManager = m_connectionManager, connectionId, rawMessage] {
 					ByteBuffer byteBuffer(rawMessage.GetPayload());
 					const BlockMessage blockMessage = BlockMessage::Deserialize(byteBuffer);
 					const FullBlock& block = blockMessage.GetBlock();
 
-					m_blockChainServer.AddBlock(block);
+					// Blocks requested during block sync are processed in height order by the scheduler.
+					BlockDownloadScheduler& blockDownloadScheduler = connectionManager.GetSyncer().GetBlockDownloadScheduler();
+					if (!blockDownloadScheduler.OnBlockReceived(connectionId, block, rawMessage.GetPayload().size()))
+					{
+						blockChainServer.AddBlock(block);
+					}
 				});
 
 				return EStatus::SUCCESS;
 			}
 			case GetCompactBlock:
 			{
-				// TODO: Implement
-				return EStatus::SUCCESS;
+				ByteBuffer byteBuffer(rawMessage.GetPayload());
+				const GetCompactBlockMessage getCompactBlockMessage = GetCompactBlockMessage::Deserialize(byteBuffer);
+				std::unique_ptr<CompactBlock> pCompactBlock = m_blockChainServer.GetCompactBlockByHash(getCompactBlockMessage.GetHash());
+				if (pCompactBlock != nullptr)
+				{
+					const CompactBlockMessage compactBlockMessage(std::move(*pCompactBlock));
+					return MessageSender(m_config).Send(connectedPeer, compactBlockMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+				}
+
+				return EStatus::UNKNOWN_ERROR;
 			}
 			case CompactBlockMsg:
 			{
 				ByteBuffer byteBuffer(rawMessage.GetPayload());
 				const CompactBlockMessage compactBlockMessage = CompactBlockMessage::Deserialize(byteBuffer);
 				const CompactBlock& compactBlock = compactBlockMessage.GetCompactBlock();
+				connectedPeer.GetKnownInventory().Add(compactBlock.GetHash());
 
 				const EBlockChainStatus added = m_blockChainServer.AddCompactBlock(compactBlock);
 				if (added == EBlockChainStatus::SUCCESS)
 				{
 					const HeaderMessage headerMessage(compactBlock.GetBlockHeader());
-					m_connectionManager.BroadcastMessage(headerMessage, connectionId);
+					m_connectionManager.BroadcastMessage(headerMessage, connectionId, compactBlock.GetHash());
 					return EStatus::SUCCESS;
 				}
 				else if (added == EBlockChainStatus::TRANSACTIONS_MISSING)
 				{
+					// Ask only for the transactions the pool couldn't provide, if the peer can serve them. Otherwise, download the full block.
+					std::vector<ShortId> missingShortIds = m_blockChainServer.GetMissingShortIds(compactBlock);
+					if (!missingShortIds.empty() && connectedPeer.GetPeer().GetCapabilities().HasCapability(Capabilities::BLOCK_TRANSACTIONS))
+					{
+						LoggerAPI::LogDebug(StringUtil::Format("MessageProcessor::ProcessMessageInternal - Requesting %llu missing transactions of %s from %s.", missingShortIds.size(), compactBlock.GetBlockHeader().FormatHash().c_str(), formattedIPAddress.c_str()));
+
+						m_connectionManager.GetPendingCompactBlocks().Add(connectionId, compactBlock);
+						const GetBlockTransactionsMessage getBlockTransactionsMessage(compactBlock.GetHash(), compactBlock.GetNonce(), std::move(missingShortIds));
+						return MessageSender(m_config).Send(connectedPeer, getBlockTransactionsMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+					}
+
 					const GetBlockMessage getBlockMessage(compactBlock.GetHash());
 					return MessageSender(m_config).Send(connectedPeer, getBlockMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
 				}
 				else if (added == EBlockChainStatus::INVALID)
 				{
-					return EStatus::BAN_PEER;
+					// A block hydrated from our own pool can be invalid without the peer being at fault, so download the full block instead.
+					// If that block is invalid too, the peer gets banned when it's received.
+					const GetBlockMessage getBlockMessage(compactBlock.GetHash());
+					return MessageSender(m_config).Send(connectedPeer, getBlockMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+				}
+
+				return EStatus::UNKNOWN_ERROR;
+			}
+			case GetBlockTransactions:
+			{
+				ByteBuffer byteBuffer(rawMessage.GetPayload());
+				const GetBlockTransactionsMessage getBlockTransactionsMessage = GetBlockTransactionsMessage::Deserialize(byteBuffer);
+
+				// Respond even when nothing was found, so the peer can fall back to requesting the full block right away.
+				std::vector<Transaction> transactions = m_blockChainServer.GetTransactionsByShortId(getBlockTransactionsMessage.GetBlockHash(), getBlockTransactionsMessage.GetNonce(), getBlockTransactionsMessage.GetShortIds());
+				const BlockTransactionsMessage blockTransactionsMessage(getBlockTransactionsMessage.GetBlockHash(), std::move(transactions));
+				return MessageSender(m_config).Send(connectedPeer, blockTransactionsMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+			}
+			case BlockTransactions:
+			{
+				ByteBuffer byteBuffer(rawMessage.GetPayload());
+				const BlockTransactionsMessage blockTransactionsMessage = BlockTransactionsMessage::Deserialize(byteBuffer);
+
+				std::unique_ptr<CompactBlock> pCompactBlock = m_connectionManager.GetPendingCompactBlocks().Take(connectionId, blockTransactionsMessage.GetBlockHash());
+				if (pCompactBlock == nullptr)
+				{
+					LoggerAPI::LogDebug(StringUtil::Format("MessageProcessor::ProcessMessageInternal - Unrequested block transactions received from %s.", formattedIPAddress.c_str()));
+					return EStatus::UNKNOWN_ERROR;
+				}
+
+				const EBlockChainStatus added = m_blockChainServer.AddCompactBlock(*pCompactBlock, blockTransactionsMessage.GetTransactions());
+				if (added == EBlockChainStatus::SUCCESS)
+				{
+					const HeaderMessage headerMessage(pCompactBlock->GetBlockHeader());
+					m_connectionManager.BroadcastMessage(headerMessage, connectionId, pCompactBlock->GetHash());
+					return EStatus::SUCCESS;
+				}
+				else if (added == EBlockChainStatus::TRANSACTIONS_MISSING || added == EBlockChainStatus::INVALID)
+				{
+					// A block hydrated from our own pool can be invalid without the peer being at fault, so download the full block instead.
+					// If that block is invalid too, the peer gets banned when it's received.
+					const GetBlockMessage getBlockMessage(pCompactBlock->GetHash());
+					return MessageSender(m_config).Send(connectedPeer, getBlockMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
 				}
 
 				return EStatus::UNKNOWN_ERROR;
@@ -244,6 +321,8 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(const uint64_
 				const StemTransactionMessage transactionMessage = StemTransactionMessage::Deserialize(byteBuffer);
 				const Transaction& transaction = transactionMessage.GetTransaction();
 
+				// Not recorded as known inventory. Once the transaction is fluffed, the stem peer has to receive it like everyone else,
+				// or the missing relay would reveal which peer it came from.
 				const EBlockChainStatus added = m_blockChainServer.AddTransaction(transaction, EPoolType::STEMPOOL);
 
 				return added == EBlockChainStatus::SUCCESS ? EStatus::SUCCESS : EStatus::UNKNOWN_ERROR;
@@ -253,13 +332,14 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(const uint64_
 				ByteBuffer byteBuffer(rawMessage.GetPayload());
 				const TransactionMessage transactionMessage = TransactionMessage::Deserialize(byteBuffer);
 				const Transaction& transaction = transactionMessage.GetTransaction();
+				connectedPeer.GetKnownInventory().Add(transaction.GetHash());
 
 				// TODO: Check Sync status first
 				//const SyncStatus& syncStatus = m_connectionManager.GetSyncStatus();
 				const EBlockChainStatus added = m_blockChainServer.AddTransaction(transaction, EPoolType::MEMPOOL);
 				if (added == EBlockChainStatus::SUCCESS)
 				{
-					m_connectionManager.BroadcastMessage(transactionMessage, connectionId);
+					m_connectionManager.BroadcastMessage(transactionMessage, connectionId, transaction.GetHash());
 				}
 
 				return EStatus::SUCCESS;
@@ -291,9 +371,8 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(const uint64_
 
 MessageProcessor::EStatus MessageProcessor::SendTxHashSet(const uint64_t connectionId, ConnectedPeer& connectedPeer, const TxHashSetRequestMessage& txHashSetRequestMessage)
 {
-	LoggerAPI::LogInfo(StringUtil::Format("MessageProcessor::SendTxHashSet - Sending TxHashSet snapshot to %s.", connectedPeer.GetPeer().GetIPAddress().Format().c_str()));
+	m_connectionManager.GetTxHashSetSender().SendTxHashSet(connectionId, connectedPeer.GetPeer().GetIPAddress(), txHashSetRequestMessage);
 
-	// TODO: Implmement
 	return EStatus::SUCCESS;
 }
 
@@ -304,35 +383,32 @@ MessageProcessor::EStatus MessageProcessor::ReceiveTxHashSet(const uint64_t conn
 	const DWORD timeout = 25 * 1000;
 	setsockopt(connectedPeer.GetConnection(), SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout, sizeof(timeout));
 
-	const std::string hashStr = HexUtil::ConvertHash(txHashSetArchiveMessage.GetBlockHash());
-	const std::string txHashSetPath = m_config.GetTxHashSetDirectory() + StringUtil::Format("txhashset_%s.zip", hashStr.c_str());
-	std::ofstream fout;
-	fout.open(txHashSetPath, std::ios::binary | std::ios::out | std::ios::trunc);
-
-	size_t bytesReceived = 0;
-	std::vector<unsigned char> buffer(BUFFER_SIZE, 0);
-	while (bytesReceived < txHashSetArchiveMessage.GetZippedSize())
+	// The archive is extracted and its MMR hashes verified while it's still downloading, so it's never written to disk as a zip.
+	const SOCKET connection = connectedPeer.GetConnection();
+	const auto readChunk = [connection](unsigned char* pBuffer, const size_t bufferSize) -> size_t
 	{
-		const int expectedBytes = min((int)(txHashSetArchiveMessage.GetZippedSize() - bytesReceived), BUFFER_SIZE);
-		const int newBytesReceived = recv(connectedPeer.GetConnection(), (char*)&buffer[0], expectedBytes, 0);
-		if (newBytesReceived <= 0)
-		{
-			// Ban peer?
-			LoggerAPI::LogError("MessageProcessor::ReceiveTxHashSet - Transmission ended abruptly.");
-			fout.close();
-			FileUtil::RemoveFile(txHashSetPath);
-
-			return EStatus::BAN_PEER;
-		}
+		const int newBytesReceived = recv(connection, (char*)pBuffer, (int)std::min(bufferSize, (size_t)BUFFER_SIZE), 0);
+		return newBytesReceived > 0 ? (size_t)newBytesReceived : 0;
+	};
 
-		fout.write((char*)&buffer[0], newBytesReceived);
-		bytesReceived += newBytesReceived;
+	const auto startTime = std::chrono::steady_clock::now();
+	const EBlockChainStatus status = m_blockChainServer.ProcessTransactionHashSet(txHashSetArchiveMessage.GetBlockHash(), txHashSetArchiveMessage.GetZippedSize(), readChunk);
+	if (status == EBlockChainStatus::INVALID)
+	{
+		LoggerAPI::LogError(StringUtil::Format("MessageProcessor::ReceiveTxHashSet - Invalid TxHashSet received from %s.", connectedPeer.GetPeer().GetIPAddress().Format().c_str()));
+		return EStatus::BAN_PEER;
+	}
+	else if (status != EBlockChainStatus::SUCCESS)
+	{
+		// The transfer was interrupted or the TxHashSet couldn't be stored locally, which doesn't mean the peer misbehaved.
+		LoggerAPI::LogError(StringUtil::Format("MessageProcessor::ReceiveTxHashSet - Failed to download or store TxHashSet from %s.", connectedPeer.GetPeer().GetIPAddress().Format().c_str()));
+		return EStatus::UNKNOWN_ERROR;
 	}
 
-	fout.close();
+	// Validation mostly overlaps the download, so the elapsed time is close to the transfer time.
+	const double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	connectedPeer.GetMetrics().RecordThroughput(txHashSetArchiveMessage.GetZippedSize() / std::max(elapsedSeconds, 0.001));
 
 	LoggerAPI::LogInfo("MessageProcessor::ReceiveTxHashSet - Downloading successful.");
-	m_blockChainServer.ProcessTransactionHashSet(txHashSetArchiveMessage.GetBlockHash(), txHashSetPath);
-
 	return EStatus::SUCCESS;
 }
\ No newline at end of file
@@ -17,6 +17,9 @@ class PeerManager;
 class MessageProcessor
 {
 public:
+	//
+	// BAN_PEER is only returned when the peer is proven to have sent invalid data, since it counts against the peer's PeerMetrics.
+	//
 	enum EStatus
 	{
 		SUCCESS,
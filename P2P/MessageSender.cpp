@@ -1,7 +1,9 @@
 #include "MessageSender.h"
+#include "Common.h"
 
 #include <Infrastructure/Logger.h>
-#include <HexUtil.h>
+#include <Serialization/Serializer.h>
+#include <StringUtil.h>
 
 MessageSender::MessageSender(const Config& config)
 	: m_config(config)
@@ -9,28 +11,42 @@ MessageSender::MessageSender(const Config& config)
 
 }
 
+//
+// Queues the message on the peer's SendQueue and sends as much of the queue as the socket will take without blocking.
+// Anything left over is sent when the socket becomes writable again.
+//
 bool MessageSender::Send(ConnectedPeer& connectedPeer, const IMessage& message) const
 {
-	Serializer serializer;
-	serializer.AppendByteVector(m_config.GetEnvironment().GetMagicBytes());
-	serializer.Append<uint8_t>((uint8_t)message.GetMessageType());
+	SendQueue& sendQueue = connectedPeer.GetSendQueue();
+	if (!sendQueue.Push(Serialize(message)))
+	{
+		LoggerAPI::LogWarning(StringUtil::Format("MessageSender::Send - Send queue for %s is full.", connectedPeer.GetPeer().GetIPAddress().Format().c_str()));
+		return false;
+	}
 
-	Serializer bodySerializer;
-	message.SerializeBody(bodySerializer);
-
-	const uint64_t messageLength = bodySerializer.GetBytes().size();
-	serializer.Append<uint64_t>(messageLength);
-
-	serializer.AppendByteVector(bodySerializer.GetBytes());
+	// TODO: Update stats.
 
-	const std::vector<unsigned char>& serializedMessage = serializer.GetBytes();
+	return sendQueue.Flush(connectedPeer.GetConnection()) != SendQueue::SOCKET_FAILURE;
+}
 
-	const std::string hexMessage = HexUtil::ConvertToHex(serializedMessage, true, true);
-	//LoggerAPI::LogInfo(connectedPeer.GetPeer().GetIPAddress().Format() + "> Sent(" + std::to_string(message.GetMessageType()) + "): " + hexMessage);
+//
+// Serializes the header and body into a single buffer, filling in the body length once the body has been written.
+//
+SendQueue::Frame MessageSender::Serialize(const IMessage& message) const
+{
+	Serializer serializer;
+	serializer.AppendByteVector(m_config.GetEnvironment().GetMagicBytes());
+	serializer.Append<uint8_t>((uint8_t)message.GetMessageType());
+	serializer.Append<uint64_t>(0);
+	message.SerializeBody(serializer);
 
-	const int nSendBytes = send(connectedPeer.GetConnection(), (const char*)&serializedMessage[0], (int)serializedMessage.size(), 0);
+	std::vector<unsigned char> frame = serializer.TakeBytes();
 
-	// TODO: Update stats.
+	const uint64_t messageLength = frame.size() - P2P::HEADER_LENGTH;
+	for (size_t i = 0; i < sizeof(uint64_t); i++)
+	{
+		frame[P2P::HEADER_LENGTH - 1 - i] = (unsigned char)(messageLength >> (8 * i));
+	}
 
-	return nSendBytes != SOCKET_ERROR;
+	return std::make_shared<const std::vector<unsigned char>>(std::move(frame));
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ConnectedPeer.h"
+#include "SendQueue.h"
 #include "Messages/Message.h"
 
 #include <Config/Config.h>
@@ -11,6 +12,7 @@ public:
 	MessageSender(const Config& config);
 
 	bool Send(ConnectedPeer& connectedPeer, const IMessage& message) const;
+	SendQueue::Frame Serialize(const IMessage& message) const;
 
 private:
 	const Config& m_config;
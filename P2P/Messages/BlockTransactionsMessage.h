@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Message.h"
+
+#include <Hash.h>
+#include <Core/Transaction.h>
+
+//
+// The response to a GetBlockTransactionsMessage, carrying every requested transaction the peer could find.
+// Transactions the peer couldn't find are left out, so the requester should fall back to downloading the full block.
+//
+class BlockTransactionsMessage : public IMessage
+{
+public:
+	//
+	// Constructors
+	//
+	BlockTransactionsMessage(const Hash& blockHash, std::vector<Transaction>&& transactions)
+		: m_blockHash(blockHash), m_transactions(std::move(transactions))
+	{
+
+	}
+	BlockTransactionsMessage(const BlockTransactionsMessage& other) = default;
+	BlockTransactionsMessage(BlockTransactionsMessage&& other) noexcept = default;
+
+	//
+	// Destructor
+	//
+	virtual ~BlockTransactionsMessage() = default;
+
+	//
+	// Operators
+	//
+	BlockTransactionsMessage& operator=(const BlockTransactionsMessage& other) = default;
+	BlockTransactionsMessage& operator=(BlockTransactionsMessage&& other) noexcept = default;
+
+	//
+	// Clone
+	//
+	virtual BlockTransactionsMessage* Clone() const override final { return new BlockTransactionsMessage(*this); }
+
+	//
+	// Getters
+	//
+	virtual MessageTypes::EMessageType GetMessageType() const override final { return MessageTypes::BlockTransactions; }
+	inline const Hash& GetBlockHash() const { return m_blockHash; }
+	inline const std::vector<Transaction>& GetTransactions() const { return m_transactions; }
+
+	//
+	// Deserialization
+	//
+	static BlockTransactionsMessage Deserialize(ByteBuffer& byteBuffer)
+	{
+		Hash blockHash = byteBuffer.ReadBigInteger<32>();
+
+		const uint64_t numTransactions = byteBuffer.ReadU64();
+		std::vector<Transaction> transactions;
+		for (uint64_t i = 0; i < numTransactions; i++)
+		{
+			transactions.emplace_back(Transaction::Deserialize(byteBuffer));
+		}
+
+		return BlockTransactionsMessage(blockHash, std::move(transactions));
+	}
+
+protected:
+	virtual void SerializeBody(Serializer& serializer) const override final
+	{
+		serializer.AppendBigInteger<32>(m_blockHash);
+
+		serializer.Append<uint64_t>(m_transactions.size());
+		for (const Transaction& transaction : m_transactions)
+		{
+			transaction.Serialize(serializer);
+		}
+	}
+
+private:
+	Hash m_blockHash;
+	std::vector<Transaction> m_transactions;
+};
\ No newline at end of file
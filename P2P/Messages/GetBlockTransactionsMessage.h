@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Message.h"
+
+#include <Hash.h>
+#include <Core/ShortId.h>
+
+//
+// Requests the transactions of a compact block that couldn't be hydrated from the transaction pool, identified by their kernel short ids.
+// Only sent to peers advertising the BLOCK_TRANSACTIONS capability.
+//
+class GetBlockTransactionsMessage : public IMessage
+{
+public:
+	//
+	// Constructors
+	//
+	GetBlockTransactionsMessage(const Hash& blockHash, const uint64_t nonce, std::vector<ShortId>&& shortIds)
+		: m_blockHash(blockHash), m_nonce(nonce), m_shortIds(std::move(shortIds))
+	{
+
+	}
+	GetBlockTransactionsMessage(const GetBlockTransactionsMessage& other) = default;
+	GetBlockTransactionsMessage(GetBlockTransactionsMessage&& other) noexcept = default;
+
+	//
+	// Destructor
+	//
+	virtual ~GetBlockTransactionsMessage() = default;
+
+	//
+	// Operators
+	//
+	GetBlockTransactionsMessage& operator=(const GetBlockTransactionsMessage& other) = default;
+	GetBlockTransactionsMessage& operator=(GetBlockTransactionsMessage&& other) noexcept = default;
+
+	//
+	// Clone
+	//
+	virtual GetBlockTransactionsMessage* Clone() const override final { return new GetBlockTransactionsMessage(*this); }
+
+	//
+	// Getters
+	//
+	virtual MessageTypes::EMessageType GetMessageType() const override final { return MessageTypes::GetBlockTransactions; }
+	inline const Hash& GetBlockHash() const { return m_blockHash; }
+	inline uint64_t GetNonce() const { return m_nonce; }
+	inline const std::vector<ShortId>& GetShortIds() const { return m_shortIds; }
+
+	//
+	// Deserialization
+	//
+	static GetBlockTransactionsMessage Deserialize(ByteBuffer& byteBuffer)
+	{
+		Hash blockHash = byteBuffer.ReadBigInteger<32>();
+		const uint64_t nonce = byteBuffer.ReadU64();
+
+		const uint64_t numShortIds = byteBuffer.ReadU64();
+		std::vector<ShortId> shortIds;
+		for (uint64_t i = 0; i < numShortIds; i++)
+		{
+			shortIds.emplace_back(ShortId::Deserialize(byteBuffer));
+		}
+
+		return GetBlockTransactionsMessage(blockHash, nonce, std::move(shortIds));
+	}
+
+protected:
+	virtual void SerializeBody(Serializer& serializer) const override final
+	{
+		serializer.AppendBigInteger<32>(m_blockHash);
+		serializer.Append<uint64_t>(m_nonce);
+
+		serializer.Append<uint64_t>(m_shortIds.size());
+		for (const ShortId& shortId : m_shortIds)
+		{
+			shortId.Serialize(serializer);
+		}
+	}
+
+private:
+	Hash m_blockHash;
+	uint64_t m_nonce;
+	std::vector<ShortId> m_shortIds;
+};
\ No newline at end of file
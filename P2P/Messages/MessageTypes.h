@@ -26,9 +26,12 @@ namespace MessageTypes
 		TransactionMsg = 15,
 		TxHashSetRequest = 16,
 		TxHashSetArchive = 17,
-		BanReason = 18
-		// GetTransaction = 19,
-		// CompactTransaction = 20,
+		BanReason = 18,
+
+		// Only exchanged with peers advertising Capabilities::BLOCK_TRANSACTIONS.
+		// Numbered far above Grin's own message types, so they can't collide with types Grin adds later.
+		GetBlockTransactions = 128,
+		BlockTransactions = 129
 	};
 
 	//static uint64_t GetMaximumSize(const EMessageType messageType)
@@ -14,6 +14,11 @@ public:
 		: m_messageHeader(messageHeader), m_payload(payload)
 	{
 
+	}
+	RawMessage(MessageHeader&& messageHeader, std::vector<unsigned char>&& payload)
+		: m_messageHeader(std::move(messageHeader)), m_payload(std::move(payload))
+	{
+
 	}
 	RawMessage(const RawMessage& other) = default;
 	RawMessage(RawMessage&& other) noexcept = default;
@@ -38,6 +38,8 @@ public:
 	// Getters
 	//
 	virtual MessageTypes::EMessageType GetMessageType() const override final { return MessageTypes::TxHashSetRequest; }
+	inline const Hash& GetBlockHash() const { return m_blockHash; }
+	inline uint64_t GetBlockHeight() const { return m_blockHeight; }
 
 	//
 	// Deserialization
@@ -47,8 +47,7 @@ public:
 	{
 		if (m_magicBytes[0] == config.GetEnvironment().GetMagicBytes()[0] && m_magicBytes[1] == config.GetEnvironment().GetMagicBytes()[1])
 		{
-			// TODO: Check max length.
-			return true;
+			return m_messageLength <= P2P::MAX_MESSAGE_LENGTH;
 		}
 
 		return false;
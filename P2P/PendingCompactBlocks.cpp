@@ -0,0 +1,36 @@
+#include "PendingCompactBlocks.h"
+
+PendingCompactBlocks::PendingCompactBlocks(const size_t maxCompactBlocks)
+	: m_maxCompactBlocks(maxCompactBlocks)
+{
+
+}
+
+void PendingCompactBlocks::Add(const uint64_t connectionId, const CompactBlock& compactBlock)
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+
+	m_compactBlocks.emplace_back(connectionId, compactBlock);
+	while (m_compactBlocks.size() > m_maxCompactBlocks)
+	{
+		m_compactBlocks.pop_front();
+	}
+}
+
+std::unique_ptr<CompactBlock> PendingCompactBlocks::Take(const uint64_t connectionId, const Hash& blockHash)
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+
+	for (auto iter = m_compactBlocks.begin(); iter != m_compactBlocks.end(); iter++)
+	{
+		if (iter->first == connectionId && iter->second.GetHash() == blockHash)
+		{
+			std::unique_ptr<CompactBlock> pCompactBlock = std::make_unique<CompactBlock>(std::move(iter->second));
+			m_compactBlocks.erase(iter);
+
+			return pCompactBlock;
+		}
+	}
+
+	return std::unique_ptr<CompactBlock>(nullptr);
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Hash.h>
+#include <Core/CompactBlock.h>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+//
+// Compact blocks waiting on a BlockTransactions response, along with the peer they were requested from.
+// Only the most recent compact blocks are kept. If a peer never responds, the block is downloaded by block sync instead.
+//
+class PendingCompactBlocks
+{
+public:
+	PendingCompactBlocks(const size_t maxCompactBlocks);
+
+	void Add(const uint64_t connectionId, const CompactBlock& compactBlock);
+
+	//
+	// Removes and returns the compact block with the given hash that's waiting on the given peer, or null if there is none.
+	//
+	std::unique_ptr<CompactBlock> Take(const uint64_t connectionId, const Hash& blockHash);
+
+private:
+	const size_t m_maxCompactBlocks;
+
+	std::mutex m_mutex;
+	std::deque<std::pair<uint64_t, CompactBlock>> m_compactBlocks;
+};
\ No newline at end of file
@@ -78,7 +78,8 @@ bool ConnectionFactory::TransmitHandMessage(ConnectedPeer& connectedPeer) const
 	const uint16_t portNumber = portOptional.has_value() ? portOptional.value() : m_config.GetEnvironment().GetP2PPort();
 
 	const uint32_t version = P2P::PROTOCOL_VERSION;
-	const Capabilities capabilities(Capabilities::FAST_SYNC_NODE); // LIGHT_CLIENT: Read P2P Config once light-clients are supported
+	Capabilities capabilities(Capabilities::FAST_SYNC_NODE); // LIGHT_CLIENT: Read P2P Config once light-clients are supported
+	capabilities.AddCapability(Capabilities::BLOCK_TRANSACTIONS);
 	const uint64_t nonce = rand();
 	Hash hash = m_config.GetEnvironment().GetGenesisHash();
 	const uint64_t totalDifficulty = m_blockChainServer.GetTotalDifficulty(EChainType::CONFIRMED);
@@ -2,6 +2,7 @@
 #include "../Common.h"
 
 #include <Config/Config.h>
+#include <algorithm>
 
 PeerManager::PeerManager(const Config& config, IPeerDB& peerDB)
 	: m_config(config), m_peerDB(peerDB)
@@ -73,8 +74,11 @@ bool PeerManager::UpdatePeer(const Peer& peer)
 	std::unique_lock<std::shared_mutex> writeLock(m_peersMutex);
 
 	const IPAddress& address = peer.GetIPAddress();
-	if (m_peersByAddress.find(address) != m_peersByAddress.cend())
+	auto iter = m_peersByAddress.find(address);
+	if (iter != m_peersByAddress.cend())
 	{
+		// Peer isn't assignable, so the old entry is replaced rather than overwritten.
+		m_peersByAddress.erase(iter);
 		m_peersByAddress.emplace(address, peer);
 		m_peerDB.AddPeers(std::vector<Peer>({ peer }));
 
@@ -101,29 +105,32 @@ bool PeerManager::AddPeer(const Peer& peer)
 	return false;
 }
 
+//
+// Returns up to maxPeers peers with the capability that haven't already been served, best scoring first.
+//
 std::vector<Peer> PeerManager::GetPeersWithCapability(const Capabilities::ECapability& preferredCapability, const uint16_t maxPeers) const
 {
-	std::vector<Peer> peersFound;
+	std::vector<const Peer*> candidates;
 
 	for (auto iter = m_peersByAddress.cbegin(); iter != m_peersByAddress.cend(); iter++)
 	{
 		const Peer& peer = iter->second;
 
 		const bool hasCapability = peer.GetCapabilities().HasCapability(preferredCapability);
-		if (hasCapability)
+		if (hasCapability && m_peersServed.find(peer.GetIPAddress()) == m_peersServed.cend())
 		{
-			if (m_peersServed.find(peer.GetIPAddress()) == m_peersServed.cend())
-			{
-				m_peersServed.insert(peer.GetIPAddress());
-
-				peersFound.push_back(peer);
-				if (peersFound.size() == maxPeers)
-				{
-					return peersFound;
-				}
-			}
+			candidates.push_back(&peer);
 		}
 	}
 
+	std::stable_sort(candidates.begin(), candidates.end(), [](const Peer* pA, const Peer* pB) { return pA->GetMetrics().GetScore() > pB->GetMetrics().GetScore(); });
+
+	std::vector<Peer> peersFound;
+	for (size_t i = 0; i < candidates.size() && peersFound.size() < maxPeers; i++)
+	{
+		m_peersServed.insert(candidates[i]->GetIPAddress());
+		peersFound.push_back(*candidates[i]);
+	}
+
 	return peersFound;
 }
\ No newline at end of file
@@ -71,6 +71,7 @@ void Seeder::Stop()
 
 //
 // Continuously checks the number of connected peers, and connects to additional peers when the number of connections drops below the minimum.
+// The first seed thread also keeps the connected peers pinged, so their latency is known.
 // This function operates in its own thread.
 //
 void Seeder::Thread_Seed(Seeder& seeder, const uint8_t threadNumber)
@@ -85,6 +86,11 @@ void Seeder::Thread_Seed(Seeder& seeder, const uint8_t threadNumber)
 
 		seeder.m_connectionManager.PruneConnections(true);
 
+		if (threadNumber == 0)
+		{
+			seeder.m_connectionManager.PingPeers();
+		}
+
 		const size_t numConnections = seeder.m_connectionManager.GetNumberOfActiveConnections();
 		if (numConnections < minimumConnections)
 		{
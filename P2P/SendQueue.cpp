@@ -0,0 +1,353 @@
+#include "SendQueue.h"
+
+#include <Infrastructure/Logger.h>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+#ifndef _WIN32
+// Writing to a closed socket must fail with EPIPE rather than raise SIGPIPE. Platforms without MSG_NOSIGNAL set SO_NOSIGPIPE on the socket instead.
+#ifdef MSG_NOSIGNAL
+static const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static const int SEND_FLAGS = 0;
+#endif
+#endif
+
+// Frames gathered into a single send. Stays well under IOV_MAX.
+static const size_t MAX_FRAMES_PER_SEND = 64;
+
+// Max bytes of a queued file handed to the socket per send.
+static const size_t FILE_CHUNK_SIZE = 256 * 1024;
+
+// Max bytes of a queued file sent by a single Flush, so a fast peer downloading a large file can't hold the flushing thread.
+static const uint64_t MAX_FILE_BYTES_PER_FLUSH = 4 * 1024 * 1024;
+
+SendQueue::QueuedFile::QueuedFile(const std::string& filePath, const uint64_t fileSize, const std::shared_ptr<const void>& pOwner)
+	: m_filePath(filePath), m_fileSize(fileSize), m_pOwner(pOwner)
+#ifndef _WIN32
+	, m_fileDescriptor(-1)
+#endif
+{
+
+}
+
+SendQueue::QueuedFile::~QueuedFile()
+{
+#ifndef _WIN32
+	if (m_fileDescriptor >= 0)
+	{
+		close(m_fileDescriptor);
+	}
+#endif
+}
+
+SendQueue::SendQueue(const uint64_t maxQueuedBytes)
+	: m_maxQueuedBytes(maxQueuedBytes), m_frontOffset(0), m_queuedBytes(0)
+{
+
+}
+
+bool SendQueue::Push(const Frame& pFrame)
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	if (m_queuedBytes + pFrame->size() > m_maxQueuedBytes)
+	{
+		return false;
+	}
+
+	m_entries.push_back(Entry{ pFrame, nullptr });
+	m_queuedBytes += pFrame->size();
+
+	return true;
+}
+
+bool SendQueue::PushFile(const Frame& pHeaderFrame, const std::string& filePath, const uint64_t fileSize, const std::shared_ptr<const void>& pOwner)
+{
+	std::shared_ptr<QueuedFile> pFile = std::make_shared<QueuedFile>(filePath, fileSize, pOwner);
+
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	if (m_queuedBytes + pHeaderFrame->size() > m_maxQueuedBytes)
+	{
+		return false;
+	}
+
+	m_entries.push_back(Entry{ pHeaderFrame, nullptr });
+	m_queuedBytes += pHeaderFrame->size();
+
+	if (fileSize > 0)
+	{
+		m_entries.push_back(Entry{ nullptr, pFile });
+	}
+
+	return true;
+}
+
+SendQueue::EStatus SendQueue::Flush(const SOCKET socket)
+{
+	std::vector<std::pair<const unsigned char*, size_t>> buffers;
+	buffers.reserve(MAX_FRAMES_PER_SEND);
+
+	uint64_t fileBytesSent = 0;
+	while (true)
+	{
+		// Only the flushing thread pops entries, and pushing to a deque does not move existing elements,
+		// so the gathered buffers stay valid after the lock is released.
+		std::shared_ptr<QueuedFile> pFrontFile = nullptr;
+		uint64_t fileOffset = 0;
+		if (GatherBuffers(buffers, pFrontFile, fileOffset) == 0)
+		{
+			if (pFrontFile == nullptr)
+			{
+				return EStatus::DRAINED;
+			}
+
+			if (fileBytesSent >= MAX_FILE_BYTES_PER_FLUSH)
+			{
+				return EStatus::YIELDED;
+			}
+
+			size_t bytesSent = 0;
+			if (!SendFromFile(socket, *pFrontFile, fileOffset, bytesSent))
+			{
+				return EStatus::SOCKET_FAILURE;
+			}
+
+			if (bytesSent == 0)
+			{
+				return EStatus::WOULD_BLOCK;
+			}
+
+			fileBytesSent += bytesSent;
+			OnBytesSent(bytesSent);
+			continue;
+		}
+
+#ifdef _WIN32
+		std::vector<WSABUF> wsaBuffers(buffers.size());
+		for (size_t i = 0; i < buffers.size(); i++)
+		{
+			wsaBuffers[i].buf = (char*)buffers[i].first;
+			wsaBuffers[i].len = (ULONG)buffers[i].second;
+		}
+
+		DWORD bytesSent = 0;
+		if (WSASend(socket, wsaBuffers.data(), (DWORD)wsaBuffers.size(), &bytesSent, 0, nullptr, nullptr) == SOCKET_ERROR)
+		{
+			return WSAGetLastError() == WSAEWOULDBLOCK ? EStatus::WOULD_BLOCK : EStatus::SOCKET_FAILURE;
+		}
+#else
+		std::vector<iovec> iovecs(buffers.size());
+		for (size_t i = 0; i < buffers.size(); i++)
+		{
+			iovecs[i].iov_base = (void*)buffers[i].first;
+			iovecs[i].iov_len = buffers[i].second;
+		}
+
+		msghdr message = {};
+		message.msg_iov = iovecs.data();
+		message.msg_iovlen = iovecs.size();
+
+		const ssize_t bytesSent = sendmsg(socket, &message, SEND_FLAGS);
+		if (bytesSent < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return (errno == EAGAIN || errno == EWOULDBLOCK) ? EStatus::WOULD_BLOCK : EStatus::SOCKET_FAILURE;
+		}
+#endif
+
+		OnBytesSent((uint64_t)bytesSent);
+	}
+}
+
+uint64_t SendQueue::GetQueuedBytes() const
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	return m_queuedBytes;
+}
+
+bool SendQueue::IsEmpty() const
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	return m_entries.empty();
+}
+
+//
+// Gathers the frames at the front of the queue, stopping at the first file.
+// If the front of the queue is a file, no buffers are returned, and the file and the offset to resume from are returned instead.
+//
+size_t SendQueue::GatherBuffers(std::vector<std::pair<const unsigned char*, size_t>>& buffers, std::shared_ptr<QueuedFile>& pFrontFile, uint64_t& fileOffset) const
+{
+	buffers.clear();
+
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	if (!m_entries.empty() && m_entries.front().pFile != nullptr)
+	{
+		pFrontFile = m_entries.front().pFile;
+		fileOffset = m_frontOffset;
+		return 0;
+	}
+
+	for (size_t i = 0; i < m_entries.size() && m_entries[i].pFrame != nullptr && buffers.size() < MAX_FRAMES_PER_SEND; i++)
+	{
+		const size_t offset = (i == 0) ? (size_t)m_frontOffset : 0;
+		buffers.emplace_back(std::make_pair(m_entries[i].pFrame->data() + offset, m_entries[i].pFrame->size() - offset));
+	}
+
+	return buffers.size();
+}
+
+//
+// On Linux, the file is handed to the socket with sendfile, so it never passes through user space.
+// Elsewhere, it's read and sent in chunks.
+// Sets bytesSent to 0 if the socket would block. Returns false if the socket failed, or the file couldn't be read.
+//
+bool SendQueue::SendFromFile(const SOCKET socket, QueuedFile& file, const uint64_t fileOffset, size_t& bytesSent)
+{
+	bytesSent = 0;
+	const size_t bytesToSend = (size_t)std::min(file.m_fileSize - fileOffset, (uint64_t)FILE_CHUNK_SIZE);
+
+#ifdef _WIN32
+	if (!file.m_file.is_open())
+	{
+		file.m_file.open(file.m_filePath, std::ios::in | std::ios::binary);
+		if (!file.m_file.is_open())
+		{
+			LoggerAPI::LogError("SendQueue::SendFromFile - Failed to open " + file.m_filePath);
+			return false;
+		}
+
+		file.m_buffer.resize(FILE_CHUNK_SIZE);
+	}
+
+	// After a partial send, the unsent part of the chunk is simply read again.
+	if (!file.m_file.seekg(fileOffset) || !file.m_file.read((char*)file.m_buffer.data(), bytesToSend))
+	{
+		LoggerAPI::LogError("SendQueue::SendFromFile - Failed to read " + file.m_filePath);
+		return false;
+	}
+
+	const int result = send(socket, (const char*)file.m_buffer.data(), (int)bytesToSend, 0);
+	if (result == SOCKET_ERROR)
+	{
+		return WSAGetLastError() == WSAEWOULDBLOCK;
+	}
+
+	bytesSent = (size_t)result;
+	return true;
+#else
+	if (file.m_fileDescriptor < 0)
+	{
+		file.m_fileDescriptor = open(file.m_filePath.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file.m_fileDescriptor < 0)
+		{
+			LoggerAPI::LogError("SendQueue::SendFromFile - Failed to open " + file.m_filePath);
+			return false;
+		}
+
+#ifndef __linux__
+		file.m_buffer.resize(FILE_CHUNK_SIZE);
+#endif
+	}
+
+#ifdef __linux__
+	while (true)
+	{
+		off_t offset = (off_t)fileOffset;
+		const ssize_t result = sendfile(socket, file.m_fileDescriptor, &offset, bytesToSend);
+		if (result < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+		}
+
+		// Sending nothing means the file is shorter than the size that was advertised.
+		bytesSent = (size_t)result;
+		return result > 0;
+	}
+#else
+	// After a partial send, the unsent part of the chunk is simply read again.
+	ssize_t bytesRead = 0;
+	do
+	{
+		bytesRead = pread(file.m_fileDescriptor, file.m_buffer.data(), bytesToSend, (off_t)fileOffset);
+	} while (bytesRead < 0 && errno == EINTR);
+
+	// Reading nothing means the file is shorter than the size that was advertised.
+	if (bytesRead <= 0)
+	{
+		LoggerAPI::LogError("SendQueue::SendFromFile - Failed to read " + file.m_filePath);
+		return false;
+	}
+
+	while (true)
+	{
+		const ssize_t result = send(socket, file.m_buffer.data(), (size_t)bytesRead, SEND_FLAGS);
+		if (result < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+		}
+
+		bytesSent = (size_t)result;
+		return true;
+	}
+#endif
+#endif
+}
+
+void SendQueue::OnBytesSent(uint64_t bytesSent)
+{
+	// Popped files are released after the lock, since releasing the owner may do more than free memory.
+	std::vector<std::shared_ptr<QueuedFile>> finishedFiles;
+
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	while (bytesSent > 0)
+	{
+		const Entry& front = m_entries.front();
+		const uint64_t remainingInFront = front.GetSize() - m_frontOffset;
+		const uint64_t bytesSentFromFront = std::min(bytesSent, remainingInFront);
+		if (front.pFrame != nullptr)
+		{
+			m_queuedBytes -= bytesSentFromFront;
+		}
+
+		bytesSent -= bytesSentFromFront;
+		if (bytesSentFromFront < remainingInFront)
+		{
+			m_frontOffset += bytesSentFromFront;
+			return;
+		}
+
+		if (front.pFile != nullptr)
+		{
+			finishedFiles.push_back(front.pFile);
+		}
+
+		m_entries.pop_front();
+		m_frontOffset = 0;
+	}
+}
\ No newline at end of file
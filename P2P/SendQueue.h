@@ -0,0 +1,97 @@
+#pragma once
+
+#include "SocketHelper.h"
+
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+//
+// An outbound queue of fully serialized message frames for a single peer.
+// Frames can be pushed from any thread, but only one thread at a time may call Flush.
+// Flush hands as many queued frames as possible to the socket in a single gathered send,
+// so a burst of small messages goes out in one syscall, and resumes mid-frame after a partial send.
+// Files can also be queued, and are streamed to the socket from disk a piece at a time, in order with the frames around them.
+//
+class SendQueue
+{
+public:
+	typedef std::shared_ptr<const std::vector<unsigned char>> Frame;
+
+	enum EStatus
+	{
+		DRAINED,
+		WOULD_BLOCK,
+		SOCKET_FAILURE,
+
+		// A queued file is still being sent, but the flush stopped after MAX_FILE_BYTES_PER_FLUSH so other connections get a turn.
+		YIELDED
+	};
+
+	SendQueue(const uint64_t maxQueuedBytes);
+
+	//
+	// Returns false, without queueing the frame, if it would take the queue past maxQueuedBytes.
+	//
+	bool Push(const Frame& pFrame);
+
+	//
+	// Queues the header frame followed by the first fileSize bytes of the file, which is opened when the header has been sent.
+	// pOwner is held until the file has been sent, or the queue is destroyed.
+	// Only the header counts towards maxQueuedBytes. Returns false, without queueing anything, if the header doesn't fit.
+	//
+	bool PushFile(const Frame& pHeaderFrame, const std::string& filePath, const uint64_t fileSize, const std::shared_ptr<const void>& pOwner);
+
+	//
+	// Sends queued frames until the queue is empty, the socket would block, or the socket fails.
+	//
+	EStatus Flush(const SOCKET socket);
+
+	uint64_t GetQueuedBytes() const;
+	bool IsEmpty() const;
+
+private:
+	struct QueuedFile
+	{
+		QueuedFile(const std::string& filePath, const uint64_t fileSize, const std::shared_ptr<const void>& pOwner);
+		~QueuedFile();
+
+		const std::string m_filePath;
+		const uint64_t m_fileSize;
+		const std::shared_ptr<const void> m_pOwner;
+
+		// Only accessed by the flushing thread.
+#ifdef _WIN32
+		std::ifstream m_file;
+#else
+		int m_fileDescriptor;
+#endif
+#ifndef __linux__
+		std::vector<unsigned char> m_buffer;
+#endif
+	};
+
+	// Exactly one of pFrame and pFile is set.
+	struct Entry
+	{
+		Frame pFrame;
+		std::shared_ptr<QueuedFile> pFile;
+
+		uint64_t GetSize() const { return pFrame != nullptr ? pFrame->size() : pFile->m_fileSize; }
+	};
+
+	size_t GatherBuffers(std::vector<std::pair<const unsigned char*, size_t>>& buffers, std::shared_ptr<QueuedFile>& pFrontFile, uint64_t& fileOffset) const;
+	static bool SendFromFile(const SOCKET socket, QueuedFile& file, const uint64_t fileOffset, size_t& bytesSent);
+	void OnBytesSent(uint64_t bytesSent);
+
+	const uint64_t m_maxQueuedBytes;
+
+	mutable std::mutex m_mutex;
+	std::deque<Entry> m_entries;
+	uint64_t m_frontOffset;
+	uint64_t m_queuedBytes;
+};
\ No newline at end of file
@@ -3,7 +3,17 @@
 #include <P2P/IPAddress.h>
 
 #include <optional>
+
+#ifdef _WIN32
+#define _WINSOCK_DEPRECATED_NO_WARNINGS
 #include <WinSock2.h>
+#else
+#include <sys/socket.h>
+typedef int SOCKET;
+typedef sockaddr SOCKADDR;
+#define INVALID_SOCKET (-1)
+#define SOCKET_ERROR (-1)
+#endif
 
 class SocketHelper
 {
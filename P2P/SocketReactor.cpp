@@ -0,0 +1,458 @@
+#ifdef __linux__
+
+#include "SocketReactor.h"
+#include "Connection.h"
+
+#include <Infrastructure/Logger.h>
+#include <Infrastructure/ThreadManager.h>
+#include <StringUtil.h>
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+static const uint64_t WAKEUP_ID = UINT64_MAX;
+static const int MAX_EVENTS = 256;
+static const size_t MAX_TASKS_PER_TURN = 16;
+
+static bool SetNonBlocking(const SOCKET socket, const bool nonBlocking)
+{
+	const int flags = fcntl(socket, F_GETFL, 0);
+	if (flags == -1)
+	{
+		return false;
+	}
+
+	return fcntl(socket, F_SETFL, nonBlocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK)) != -1;
+}
+
+SocketReactor::SocketReactor(const Config& config)
+	: m_config(config), m_epollFD(-1), m_wakeupFD(-1), m_terminate(true)
+{
+
+}
+
+SocketReactor::~SocketReactor()
+{
+	Stop();
+}
+
+void SocketReactor::Start()
+{
+	if (!m_terminate)
+	{
+		return;
+	}
+
+	m_epollFD = epoll_create1(EPOLL_CLOEXEC);
+	m_wakeupFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	epoll_event wakeupEvent = {};
+	wakeupEvent.events = EPOLLIN;
+	wakeupEvent.data.u64 = WAKEUP_ID;
+	epoll_ctl(m_epollFD, EPOLL_CTL_ADD, m_wakeupFD, &wakeupEvent);
+
+	m_terminate = false;
+
+	m_pollThread = std::thread(Thread_Poll, std::ref(*this));
+	ThreadManagerAPI::SetThreadName(m_pollThread.get_id(), "SOCKET_REACTOR");
+
+	const size_t numWorkers = std::min(std::max((size_t)std::thread::hardware_concurrency(), (size_t)2), (size_t)8);
+	for (size_t i = 0; i < numWorkers; i++)
+	{
+		m_workerThreads.emplace_back(std::thread(Thread_Worker, std::ref(*this)));
+		ThreadManagerAPI::SetThreadName(m_workerThreads.back().get_id(), "PEER_WORKER");
+	}
+}
+
+void SocketReactor::Stop()
+{
+	if (m_terminate)
+	{
+		return;
+	}
+
+	m_terminate = true;
+
+	const uint64_t wakeup = 1;
+	write(m_wakeupFD, &wakeup, sizeof(wakeup));
+
+	{
+		std::lock_guard<std::mutex> readyLock(m_readyMutex);
+		m_readyCondition.notify_all();
+	}
+
+	if (m_pollThread.joinable())
+	{
+		m_pollThread.join();
+	}
+
+	for (std::thread& workerThread : m_workerThreads)
+	{
+		if (workerThread.joinable())
+		{
+			workerThread.join();
+		}
+	}
+
+	m_workerThreads.clear();
+	m_readyQueue.clear();
+
+	close(m_wakeupFD);
+	close(m_epollFD);
+	m_wakeupFD = -1;
+	m_epollFD = -1;
+}
+
+bool SocketReactor::Register(Connection& connection, const SOCKET socket)
+{
+	if (!SetNonBlocking(socket, true))
+	{
+		LoggerAPI::LogError(StringUtil::Format("SocketReactor::Register - Failed to make socket non-blocking for connection (%llu).", connection.GetId()));
+		return false;
+	}
+
+	// Messages are framed by the sender, so there's nothing to gain from Nagle's algorithm.
+	const int noDelay = 1;
+	setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+	std::shared_ptr<Registration> pRegistration = std::make_shared<Registration>(connection, socket, m_config);
+	{
+		std::lock_guard<std::mutex> registrationsLock(m_registrationsMutex);
+		m_registrations[connection.GetId()] = pRegistration;
+	}
+
+	if (!Attach(pRegistration))
+	{
+		LoggerAPI::LogError(StringUtil::Format("SocketReactor::Register - Failed to watch socket for connection (%llu).", connection.GetId()));
+
+		std::lock_guard<std::mutex> registrationsLock(m_registrationsMutex);
+		m_registrations.erase(connection.GetId());
+		return false;
+	}
+
+	return true;
+}
+
+void SocketReactor::Unregister(const uint64_t connectionId)
+{
+	std::shared_ptr<Registration> pRegistration = nullptr;
+	{
+		std::lock_guard<std::mutex> registrationsLock(m_registrationsMutex);
+		auto iter = m_registrations.find(connectionId);
+		if (iter == m_registrations.end())
+		{
+			return;
+		}
+
+		pRegistration = iter->second;
+		m_registrations.erase(iter);
+	}
+
+	{
+		std::lock_guard<std::mutex> taskLock(pRegistration->m_taskMutex);
+		pRegistration->m_closed = true;
+		pRegistration->m_tasks.clear();
+		pRegistration->m_queuedBytes = 0;
+		epoll_ctl(m_epollFD, EPOLL_CTL_DEL, pRegistration->m_socket, nullptr);
+	}
+
+	// Once the poll thread finishes its current batch of events, it can no longer find this registration.
+	{
+		std::lock_guard<std::mutex> pollLock(m_pollMutex);
+	}
+
+	std::unique_lock<std::mutex> taskLock(pRegistration->m_taskMutex);
+	pRegistration->m_idleCondition.wait(taskLock, [&pRegistration] { return !pRegistration->m_scheduled; });
+}
+
+bool SocketReactor::Post(const uint64_t connectionId, std::function<void()>&& task)
+{
+	std::shared_ptr<Registration> pRegistration = GetRegistration(connectionId);
+	if (pRegistration == nullptr)
+	{
+		return false;
+	}
+
+	return Enqueue(pRegistration, std::move(task));
+}
+
+std::shared_ptr<SocketReactor::Registration> SocketReactor::GetRegistration(const uint64_t connectionId) const
+{
+	std::lock_guard<std::mutex> registrationsLock(m_registrationsMutex);
+
+	auto iter = m_registrations.find(connectionId);
+	if (iter != m_registrations.end())
+	{
+		return iter->second;
+	}
+
+	return nullptr;
+}
+
+//
+// Reads from the socket until it would block, or until too many of the connection's messages are waiting to be processed.
+// Each recv asks for exactly the bytes the framer still needs, so a payload is received straight into the RawMessage's buffer,
+// and nothing past the end of a message is consumed.
+//
+void SocketReactor::OnReadable(const std::shared_ptr<Registration>& pRegistration)
+{
+	MessageFramer& framer = pRegistration->m_framer;
+	while (true)
+	{
+		{
+			std::lock_guard<std::mutex> taskLock(pRegistration->m_taskMutex);
+			if (pRegistration->m_readPaused)
+			{
+				return;
+			}
+		}
+
+		const ssize_t bytesReceived = recv(pRegistration->m_socket, framer.GetReceiveBuffer(), framer.GetBytesNeeded(), 0);
+		if (bytesReceived == 0)
+		{
+			OnSocketClosed(pRegistration);
+			return;
+		}
+		else if (bytesReceived < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				OnSocketClosed(pRegistration);
+			}
+
+			return;
+		}
+
+		const MessageFramer::EStatus status = framer.OnBytesReceived((size_t)bytesReceived);
+		if (status == MessageFramer::INVALID_HEADER)
+		{
+			LoggerAPI::LogError(StringUtil::Format("SocketReactor::OnReadable - Invalid message header received from %s.", pRegistration->m_connection.GetPeer().GetIPAddress().Format().c_str()));
+			pRegistration->m_connection.GetMetrics().RecordInvalidData();
+			OnSocketClosed(pRegistration);
+			return;
+		}
+		else if (status == MessageFramer::MESSAGE_READY)
+		{
+			std::shared_ptr<RawMessage> pRawMessage(framer.TakeMessage());
+			Connection* pConnection = &pRegistration->m_connection;
+
+			if (pRawMessage->GetMessageHeader().GetMessageType() == MessageTypes::TxHashSetArchive)
+			{
+				// The archive's zipped bytes follow the message outside of any framing, and are read directly from the socket
+				// while the message is processed. Stop watching the socket and make it blocking until that's done.
+				epoll_ctl(m_epollFD, EPOLL_CTL_DEL, pRegistration->m_socket, nullptr);
+				SetNonBlocking(pRegistration->m_socket, false);
+
+				std::weak_ptr<Registration> pWeakRegistration = pRegistration;
+				Enqueue(pRegistration, [this, pConnection, pRawMessage, pWeakRegistration] {
+					pConnection->ProcessMessage(*pRawMessage);
+
+					std::shared_ptr<Registration> pDetached = pWeakRegistration.lock();
+					if (pDetached != nullptr && (!SetNonBlocking(pDetached->m_socket, true) || !Attach(pDetached)))
+					{
+						pConnection->OnSocketClosed();
+					}
+				});
+
+				return;
+			}
+
+			const size_t numBytes = (size_t)P2P::HEADER_LENGTH + pRawMessage->GetPayload().size();
+			Enqueue(pRegistration, [pConnection, pRawMessage] { pConnection->ProcessMessage(*pRawMessage); }, numBytes);
+		}
+	}
+}
+
+void SocketReactor::OnSocketClosed(const std::shared_ptr<Registration>& pRegistration)
+{
+	epoll_ctl(m_epollFD, EPOLL_CTL_DEL, pRegistration->m_socket, nullptr);
+	pRegistration->m_connection.OnSocketClosed();
+}
+
+bool SocketReactor::Enqueue(const std::shared_ptr<Registration>& pRegistration, std::function<void()>&& task, const size_t numBytes)
+{
+	{
+		std::lock_guard<std::mutex> taskLock(pRegistration->m_taskMutex);
+		if (pRegistration->m_closed)
+		{
+			return false;
+		}
+
+		pRegistration->m_tasks.emplace_back(Task{ std::move(task), numBytes });
+		pRegistration->m_queuedBytes += numBytes;
+		if (pRegistration->m_queuedBytes >= P2P::MAX_RECEIVE_QUEUE_BYTES)
+		{
+			pRegistration->m_readPaused = true;
+		}
+
+		if (pRegistration->m_scheduled)
+		{
+			return true;
+		}
+
+		pRegistration->m_scheduled = true;
+	}
+
+	std::lock_guard<std::mutex> readyLock(m_readyMutex);
+	m_readyQueue.push_back(pRegistration);
+	m_readyCondition.notify_one();
+
+	return true;
+}
+
+//
+// Runs a bounded number of the connection's queued tasks, then puts the connection back at the end of the ready queue
+// if it still has work, so that one busy peer can't monopolize a worker.
+//
+void SocketReactor::RunTasks(const std::shared_ptr<Registration>& pRegistration)
+{
+	Task task{ nullptr, 0 };
+	for (size_t i = 0; i < MAX_TASKS_PER_TURN; i++)
+	{
+		{
+			std::lock_guard<std::mutex> taskLock(pRegistration->m_taskMutex);
+			OnTaskFinished_Locked(*pRegistration, task);
+			if (pRegistration->m_tasks.empty())
+			{
+				pRegistration->m_scheduled = false;
+				pRegistration->m_idleCondition.notify_all();
+				return;
+			}
+
+			task = std::move(pRegistration->m_tasks.front());
+			pRegistration->m_tasks.pop_front();
+		}
+
+		task.m_function();
+	}
+
+	{
+		std::lock_guard<std::mutex> taskLock(pRegistration->m_taskMutex);
+		OnTaskFinished_Locked(*pRegistration, task);
+		if (pRegistration->m_tasks.empty() || m_terminate)
+		{
+			pRegistration->m_scheduled = false;
+			pRegistration->m_idleCondition.notify_all();
+			return;
+		}
+	}
+
+	std::lock_guard<std::mutex> readyLock(m_readyMutex);
+	m_readyQueue.push_back(pRegistration);
+	m_readyCondition.notify_one();
+}
+
+//
+// Releases the bytes of a processed message, and resumes reading once half of the connection's receive queue has drained.
+// The socket is re-armed rather than read here, so reads stay on the poll thread. Modifying an edge-triggered registration
+// reports the socket as readable again if data was left in its receive buffer.
+//
+void SocketReactor::OnTaskFinished_Locked(Registration& registration, const Task& task)
+{
+	if (task.m_numBytes == 0 || registration.m_closed)
+	{
+		return;
+	}
+
+	registration.m_queuedBytes -= std::min(task.m_numBytes, registration.m_queuedBytes);
+	if (registration.m_readPaused && registration.m_queuedBytes <= P2P::MAX_RECEIVE_QUEUE_BYTES / 2)
+	{
+		registration.m_readPaused = false;
+
+		epoll_event event = {};
+		event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+		event.data.u64 = registration.m_connection.GetId();
+		epoll_ctl(m_epollFD, EPOLL_CTL_MOD, registration.m_socket, &event);
+	}
+}
+
+bool SocketReactor::Attach(const std::shared_ptr<Registration>& pRegistration)
+{
+	std::lock_guard<std::mutex> taskLock(pRegistration->m_taskMutex);
+	if (pRegistration->m_closed)
+	{
+		return true;
+	}
+
+	epoll_event event = {};
+	event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+	event.data.u64 = pRegistration->m_connection.GetId();
+
+	return epoll_ctl(m_epollFD, EPOLL_CTL_ADD, pRegistration->m_socket, &event) == 0;
+}
+
+void SocketReactor::Thread_Poll(SocketReactor& socketReactor)
+{
+	std::vector<epoll_event> events(MAX_EVENTS);
+	while (!socketReactor.m_terminate)
+	{
+		const int numEvents = epoll_wait(socketReactor.m_epollFD, events.data(), MAX_EVENTS, -1);
+		if (numEvents < 0)
+		{
+			if (errno != EINTR)
+			{
+				LoggerAPI::LogError(StringUtil::Format("SocketReactor::Thread_Poll - epoll_wait failed with error %d.", errno));
+			}
+
+			continue;
+		}
+
+		std::lock_guard<std::mutex> pollLock(socketReactor.m_pollMutex);
+		for (int i = 0; i < numEvents; i++)
+		{
+			if (events[i].data.u64 == WAKEUP_ID)
+			{
+				continue;
+			}
+
+			std::shared_ptr<Registration> pRegistration = socketReactor.GetRegistration(events[i].data.u64);
+			if (pRegistration == nullptr)
+			{
+				continue;
+			}
+
+			// A send that would have blocked is resumed once the socket has room again.
+			if ((events[i].events & EPOLLOUT) != 0)
+			{
+				pRegistration->m_connection.OnSocketWritable();
+			}
+
+			// Drain any data that arrived before the peer hung up, then report the closure.
+			if ((events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0)
+			{
+				socketReactor.OnReadable(pRegistration);
+			}
+		}
+	}
+}
+
+void SocketReactor::Thread_Worker(SocketReactor& socketReactor)
+{
+	while (true)
+	{
+		std::unique_lock<std::mutex> readyLock(socketReactor.m_readyMutex);
+		socketReactor.m_readyCondition.wait(readyLock, [&socketReactor] { return socketReactor.m_terminate || !socketReactor.m_readyQueue.empty(); });
+		if (socketReactor.m_terminate)
+		{
+			return;
+		}
+
+		std::shared_ptr<Registration> pRegistration = socketReactor.m_readyQueue.front();
+		socketReactor.m_readyQueue.pop_front();
+		readyLock.unlock();
+
+		socketReactor.RunTasks(pRegistration);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+
+#ifdef __linux__
+
+#include "ConnectedPeer.h"
+#include "MessageFramer.h"
+
+#include <Config/Config.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Forward Declarations
+class Connection;
+
+//
+// Owns the sockets of all active connections on Linux.
+// A single poll thread waits on an edge-triggered epoll instance and reads every readable socket until it would block,
+// assembling RawMessages with a MessageFramer per connection. Reading stops early once P2P::MAX_RECEIVE_QUEUE_BYTES of a connection's
+// messages are waiting to be processed, and the socket is re-armed when the workers catch up.
+// Received messages, and any tasks posted for a connection, run on a small pool of worker threads.
+// When a socket that filled up becomes writable again, the connection is told so it can resume flushing its SendQueue.
+// Tasks for the same connection always run one at a time, in the order they were queued.
+//
+class SocketReactor
+{
+public:
+	SocketReactor(const Config& config);
+	~SocketReactor();
+
+	void Start();
+	void Stop();
+
+	//
+	// Switches the socket to non-blocking mode and starts dispatching its messages to connection.ProcessMessage.
+	//
+	bool Register(Connection& connection, const SOCKET socket);
+
+	//
+	// Stops watching the connection's socket, drops any tasks not yet started,
+	// and waits for the task currently running for the connection, if any, to finish.
+	// Must not be called from one of the connection's own tasks.
+	//
+	void Unregister(const uint64_t connectionId);
+
+	//
+	// Queues a task to run on the worker pool after all previously queued tasks for the connection.
+	//
+	bool Post(const uint64_t connectionId, std::function<void()>&& task);
+
+private:
+	struct Task
+	{
+		std::function<void()> m_function;
+
+		// Size of the received message the task processes, if any.
+		size_t m_numBytes;
+	};
+
+	struct Registration
+	{
+		Registration(Connection& connection, const SOCKET socket, const Config& config)
+			: m_connection(connection), m_socket(socket), m_framer(config), m_queuedBytes(0), m_readPaused(false), m_scheduled(false), m_closed(false)
+		{
+
+		}
+
+		Connection& m_connection;
+		const SOCKET m_socket;
+
+		// Only accessed from the poll thread.
+		MessageFramer m_framer;
+
+		std::mutex m_taskMutex;
+		std::condition_variable m_idleCondition;
+		std::deque<Task> m_tasks;
+		size_t m_queuedBytes;
+		bool m_readPaused;
+		bool m_scheduled;
+		bool m_closed;
+	};
+
+	std::shared_ptr<Registration> GetRegistration(const uint64_t connectionId) const;
+	void OnReadable(const std::shared_ptr<Registration>& pRegistration);
+	void OnSocketClosed(const std::shared_ptr<Registration>& pRegistration);
+	bool Enqueue(const std::shared_ptr<Registration>& pRegistration, std::function<void()>&& task, const size_t numBytes = 0);
+	void RunTasks(const std::shared_ptr<Registration>& pRegistration);
+	void OnTaskFinished_Locked(Registration& registration, const Task& task);
+	bool Attach(const std::shared_ptr<Registration>& pRegistration);
+
+	static void Thread_Poll(SocketReactor& socketReactor);
+	static void Thread_Worker(SocketReactor& socketReactor);
+
+	const Config& m_config;
+	int m_epollFD;
+	int m_wakeupFD;
+	std::atomic_bool m_terminate;
+	std::thread m_pollThread;
+	std::vector<std::thread> m_workerThreads;
+
+	// Held by the poll thread while it handles a batch of events, so Unregister can wait out any in-progress reads.
+	std::mutex m_pollMutex;
+
+	mutable std::mutex m_registrationsMutex;
+	std::unordered_map<uint64_t, std::shared_ptr<Registration>> m_registrations;
+
+	std::mutex m_readyMutex;
+	std::condition_variable m_readyCondition;
+	std::deque<std::shared_ptr<Registration>> m_readyQueue;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,349 @@
+#include "BlockDownloadScheduler.h"
+#include "../ConnectionManager.h"
+#include "../Messages/GetBlockMessage.h"
+
+#include <BlockChainServer.h>
+#include <Infrastructure/Logger.h>
+#include <StringUtil.h>
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+// How far past the confirmed tip blocks may be requested. Bounds the memory used by blocks waiting on earlier heights.
+static const uint64_t MAX_LOOKAHEAD = 1024;
+static const size_t MAX_READY_BYTES = 256 * 1024 * 1024;
+
+static const size_t INITIAL_WINDOW = 4;
+static const size_t MIN_WINDOW = 2;
+static const size_t MAX_WINDOW = 128;
+
+// Keeping twice the bandwidth-delay product in flight lets a window grow until the peer's throughput stops increasing.
+static const double WINDOW_GAIN = 2.0;
+static const double EWMA_WEIGHT = 0.25;
+static const std::chrono::seconds MIN_LATENCY_WINDOW(10);
+
+static const std::chrono::seconds MIN_TIMEOUT(2);
+static const std::chrono::seconds MAX_TIMEOUT(30);
+static const std::chrono::seconds DEFAULT_TIMEOUT(10);
+
+BlockDownloadScheduler::PeerStats::PeerStats()
+	: m_inFlight(0), m_minLatencySeconds(0.0), m_bytesPerSecond(0.0), m_averageBlockBytes(0.0)
+{
+
+}
+
+//
+// The window is the number of blocks the peer can deliver in one round trip at its measured throughput (its bandwidth-delay product), times WINDOW_GAIN.
+// Latency is the minimum observed over the last MIN_LATENCY_WINDOW, so time spent queued behind earlier requests doesn't inflate it.
+//
+size_t BlockDownloadScheduler::PeerStats::GetWindowSize() const
+{
+	if (m_bytesPerSecond <= 0.0 || m_averageBlockBytes <= 0.0)
+	{
+		return INITIAL_WINDOW;
+	}
+
+	const double bandwidthDelayBlocks = (m_bytesPerSecond * m_minLatencySeconds) / m_averageBlockBytes;
+	const size_t windowSize = (size_t)std::ceil(WINDOW_GAIN * bandwidthDelayBlocks);
+
+	return std::min(std::max(windowSize, MIN_WINDOW), MAX_WINDOW);
+}
+
+//
+// A request is considered stalled once it has taken 4 times as long as the peer should need to deliver it and everything queued ahead of it.
+//
+BlockDownloadScheduler::Clock::duration BlockDownloadScheduler::PeerStats::GetTimeout() const
+{
+	if (m_bytesPerSecond <= 0.0)
+	{
+		return DEFAULT_TIMEOUT;
+	}
+
+	const double expectedSeconds = m_minLatencySeconds + ((m_inFlight + 1) * m_averageBlockBytes) / m_bytesPerSecond;
+	const Clock::duration timeout = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(4.0 * expectedSeconds));
+
+	return std::min(std::max(timeout, Clock::duration(MIN_TIMEOUT)), Clock::duration(MAX_TIMEOUT));
+}
+
+double BlockDownloadScheduler::PeerStats::OnBlockReceived(const Clock::duration latency, const size_t numBytes, const Clock::time_point now)
+{
+	const double latencySeconds = std::chrono::duration<double>(latency).count();
+	if (m_averageBlockBytes == 0.0 || latencySeconds < m_minLatencySeconds || (now - m_minLatencyTime) > MIN_LATENCY_WINDOW)
+	{
+		m_minLatencySeconds = latencySeconds;
+		m_minLatencyTime = now;
+	}
+
+	// While a request is outstanding, the gap since the previous delivery can't exceed this request's latency.
+	double intervalSeconds = latencySeconds;
+	if (m_averageBlockBytes > 0.0)
+	{
+		intervalSeconds = std::min(intervalSeconds, std::chrono::duration<double>(now - m_lastReceived).count());
+	}
+
+	const double bytesPerSecond = numBytes / std::max(intervalSeconds, 0.001);
+	if (m_averageBlockBytes == 0.0)
+	{
+		m_bytesPerSecond = bytesPerSecond;
+		m_averageBlockBytes = (double)numBytes;
+	}
+	else
+	{
+		m_bytesPerSecond += EWMA_WEIGHT * (bytesPerSecond - m_bytesPerSecond);
+		m_averageBlockBytes += EWMA_WEIGHT * (numBytes - m_averageBlockBytes);
+	}
+
+	m_lastReceived = now;
+
+	return bytesPerSecond;
+}
+
+void BlockDownloadScheduler::PeerStats::OnTimeout()
+{
+	m_bytesPerSecond /= 2.0;
+}
+
+BlockDownloadScheduler::BlockDownloadScheduler(ConnectionManager& connectionManager, IBlockChainServer& blockChainServer)
+	: m_connectionManager(connectionManager), m_blockChainServer(blockChainServer), m_readyBytes(0), m_processing(false)
+{
+
+}
+
+size_t BlockDownloadScheduler::RequestBlocks()
+{
+	const std::vector<uint64_t> mostWorkPeers = m_connectionManager.GetMostWorkPeers();
+	if (mostWorkPeers.empty())
+	{
+		LoggerAPI::LogWarning("BlockDownloadScheduler::RequestBlocks - No most-work peers found.");
+		return 0;
+	}
+
+	const std::vector<std::pair<uint64_t, Hash>> blocksNeeded = m_blockChainServer.GetBlocksNeeded(MAX_LOOKAHEAD);
+
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	const Clock::time_point now = Clock::now();
+
+	const std::unordered_set<uint64_t> activePeers(mostWorkPeers.cbegin(), mostWorkPeers.cend());
+	for (const uint64_t connectionId : mostWorkPeers)
+	{
+		m_peers.emplace(connectionId, PeerStats());
+	}
+
+	// Pull back requests that stalled or whose peer is gone, remembering who had them.
+	std::vector<std::pair<Hash, Request>> stalledRequests;
+	for (auto iter = m_requests.begin(); iter != m_requests.end();)
+	{
+		const Request& request = iter->second;
+		if (activePeers.count(request.m_connectionId) == 0 || now > request.m_deadline)
+		{
+			auto peerIter = m_peers.find(request.m_connectionId);
+			if (peerIter != m_peers.end())
+			{
+				peerIter->second.m_inFlight--;
+				peerIter->second.OnTimeout();
+			}
+
+			if (now > request.m_deadline)
+			{
+				m_connectionManager.RecordTimeout(request.m_connectionId);
+			}
+
+			stalledRequests.emplace_back(*iter);
+			iter = m_requests.erase(iter);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+
+	for (auto iter = m_peers.begin(); iter != m_peers.end();)
+	{
+		iter = (activePeers.count(iter->first) == 0 && iter->second.m_inFlight == 0) ? m_peers.erase(iter) : std::next(iter);
+	}
+
+	size_t blocksRequested = 0;
+
+	// Stalled requests go to the fastest other peer with room, ahead of anything new.
+	std::sort(stalledRequests.begin(), stalledRequests.end(), [](const auto& a, const auto& b) { return a.second.m_height < b.second.m_height; });
+	for (const auto& stalledRequest : stalledRequests)
+	{
+		const uint64_t connectionId = GetFastestAvailablePeer_Locked(mostWorkPeers, stalledRequest.second.m_connectionId);
+		if (connectionId != 0 && SendRequest_Locked(stalledRequest.second.m_height, stalledRequest.first, connectionId, now))
+		{
+			blocksRequested++;
+		}
+	}
+
+	if (!stalledRequests.empty())
+	{
+		LoggerAPI::LogDebug(StringUtil::Format("BlockDownloadScheduler::RequestBlocks - %llu requests stalled.", stalledRequests.size()));
+	}
+
+	for (const auto& blockNeeded : blocksNeeded)
+	{
+		// The cap only applies above the next height to confirm. If the blocks waiting on that height filled the buffer
+		// and it was never requested, nothing could ever be processed to make room.
+		if (m_readyBytes >= MAX_READY_BYTES && blockNeeded.first != blocksNeeded.front().first)
+		{
+			break;
+		}
+
+		if (m_requests.count(blockNeeded.second) > 0 || m_readyBlocks.count(blockNeeded.first) > 0)
+		{
+			continue;
+		}
+
+		const uint64_t connectionId = GetFastestAvailablePeer_Locked(mostWorkPeers, 0);
+		if (connectionId == 0 || !SendRequest_Locked(blockNeeded.first, blockNeeded.second, connectionId, now))
+		{
+			break;
+		}
+
+		blocksRequested++;
+	}
+
+	if (blocksRequested > 0)
+	{
+		LoggerAPI::LogDebug(StringUtil::Format("BlockDownloadScheduler::RequestBlocks - %llu blocks requested. %llu in flight across %llu peers, %llu waiting to be processed.", blocksRequested, m_requests.size(), mostWorkPeers.size(), m_readyBlocks.size()));
+	}
+
+	return blocksRequested;
+}
+
+bool BlockDownloadScheduler::OnBlockReceived(const uint64_t connectionId, const FullBlock& block, const size_t numBytes)
+{
+	{
+		std::lock_guard<std::mutex> lockGuard(m_mutex);
+
+		auto requestIter = m_requests.find(block.GetHash());
+		if (requestIter == m_requests.end())
+		{
+			return false;
+		}
+
+		// A stalled request may have been reassigned, so the block is accepted from whichever peer delivers it first.
+		const Request request = requestIter->second;
+		m_requests.erase(requestIter);
+
+		auto peerIter = m_peers.find(request.m_connectionId);
+		if (peerIter != m_peers.end())
+		{
+			peerIter->second.m_inFlight--;
+			if (request.m_connectionId == connectionId)
+			{
+				const Clock::time_point now = Clock::now();
+				const double bytesPerSecond = peerIter->second.OnBlockReceived(now - request.m_requestTime, numBytes, now);
+				m_connectionManager.RecordThroughput(connectionId, bytesPerSecond);
+			}
+		}
+
+		if (m_readyBlocks.count(request.m_height) == 0)
+		{
+			m_readyBlocks.emplace(request.m_height, ReadyBlock{ block, connectionId, numBytes });
+			m_readyBytes += numBytes;
+		}
+	}
+
+	ProcessReadyBlocks();
+
+	return true;
+}
+
+bool BlockDownloadScheduler::SendRequest_Locked(const uint64_t height, const Hash& hash, const uint64_t connectionId, const Clock::time_point now)
+{
+	const GetBlockMessage getBlockMessage(hash);
+	if (!m_connectionManager.SendMessageToPeer(getBlockMessage, connectionId))
+	{
+		return false;
+	}
+
+	PeerStats& peerStats = m_peers[connectionId];
+	m_requests[hash] = Request{ height, connectionId, now, now + peerStats.GetTimeout() };
+	peerStats.m_inFlight++;
+
+	return true;
+}
+
+//
+// Returns the id of the peer with the highest measured throughput that has room in its window, or 0 if every peer's window is full.
+//
+uint64_t BlockDownloadScheduler::GetFastestAvailablePeer_Locked(const std::vector<uint64_t>& peers, const uint64_t excludedId) const
+{
+	uint64_t fastestId = 0;
+	double fastestBytesPerSecond = -1.0;
+	for (const uint64_t connectionId : peers)
+	{
+		auto iter = m_peers.find(connectionId);
+		if (connectionId == excludedId || iter == m_peers.end() || iter->second.m_inFlight >= iter->second.GetWindowSize())
+		{
+			continue;
+		}
+
+		if (iter->second.GetBytesPerSecond() > fastestBytesPerSecond)
+		{
+			fastestId = connectionId;
+			fastestBytesPerSecond = iter->second.GetBytesPerSecond();
+		}
+	}
+
+	// A stalled request goes back to the same peer only if it's the only one with room.
+	if (fastestId == 0 && excludedId != 0)
+	{
+		return GetFastestAvailablePeer_Locked(peers, 0);
+	}
+
+	return fastestId;
+}
+
+//
+// Hands buffered blocks to the block chain in height order, starting from the block after the confirmed tip.
+// Only one thread processes at a time. Blocks that arrive meanwhile are picked up by that thread before it finishes.
+//
+void BlockDownloadScheduler::ProcessReadyBlocks()
+{
+	{
+		std::lock_guard<std::mutex> lockGuard(m_mutex);
+		if (m_processing)
+		{
+			return;
+		}
+
+		m_processing = true;
+	}
+
+	while (true)
+	{
+		const uint64_t nextHeight = m_blockChainServer.GetHeight(EChainType::CONFIRMED) + 1;
+
+		std::unique_lock<std::mutex> lockGuard(m_mutex);
+		while (!m_readyBlocks.empty() && m_readyBlocks.begin()->first < nextHeight)
+		{
+			m_readyBytes -= m_readyBlocks.begin()->second.m_numBytes;
+			m_readyBlocks.erase(m_readyBlocks.begin());
+		}
+
+		if (m_readyBlocks.empty() || m_readyBlocks.begin()->first != nextHeight)
+		{
+			m_processing = false;
+			return;
+		}
+
+		const ReadyBlock readyBlock = std::move(m_readyBlocks.begin()->second);
+		m_readyBytes -= readyBlock.m_numBytes;
+		m_readyBlocks.erase(m_readyBlocks.begin());
+		lockGuard.unlock();
+
+		const EBlockChainStatus status = m_blockChainServer.AddBlock(readyBlock.m_block);
+		if (status == EBlockChainStatus::INVALID)
+		{
+			LoggerAPI::LogWarning(StringUtil::Format("BlockDownloadScheduler::ProcessReadyBlocks - Invalid block %s received from peer (%llu).", readyBlock.m_block.GetBlockHeader().FormatHash().c_str(), readyBlock.m_connectionId));
+			m_connectionManager.BanConnection(readyBlock.m_connectionId);
+		}
+		else if (status != EBlockChainStatus::SUCCESS && status != EBlockChainStatus::ALREADY_EXISTS)
+		{
+			// The block will be requested again, since it's neither confirmed nor in flight.
+			LoggerAPI::LogWarning(StringUtil::Format("BlockDownloadScheduler::ProcessReadyBlocks - Failed to process block %s.", readyBlock.m_block.GetBlockHeader().FormatHash().c_str()));
+		}
+	}
+}
\ No newline at end of file
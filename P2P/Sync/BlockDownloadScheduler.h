@@ -0,0 +1,92 @@
+#pragma once
+
+#include <Hash.h>
+#include <Core/FullBlock.h>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Forward Declarations
+class ConnectionManager;
+class IBlockChainServer;
+
+//
+// Schedules block downloads across all most-work peers during block sync.
+// Each peer has a sliding window of in-flight requests, sized from that peer's measured latency and throughput,
+// so fast peers are kept busy without overloading slow ones. Requests that stall are reassigned to the fastest peer with room in its window.
+// Blocks that arrive ahead of the next height to confirm are held until every block before them has arrived,
+// and are then handed to the block chain in height order, instead of being processed as orphans.
+//
+class BlockDownloadScheduler
+{
+public:
+	BlockDownloadScheduler(ConnectionManager& connectionManager, IBlockChainServer& blockChainServer);
+
+	//
+	// Reassigns stalled requests, then fills every peer's window with the lowest needed heights not yet requested.
+	// Returns the number of requests sent.
+	//
+	size_t RequestBlocks();
+
+	//
+	// Returns false if the block wasn't requested by the scheduler, in which case the caller should process it directly.
+	//
+	bool OnBlockReceived(const uint64_t connectionId, const FullBlock& block, const size_t numBytes);
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	class PeerStats
+	{
+	public:
+		PeerStats();
+
+		size_t GetWindowSize() const;
+		Clock::duration GetTimeout() const;
+		inline double GetBytesPerSecond() const { return m_bytesPerSecond; }
+
+		// Returns the throughput measured for this block, in bytes per second.
+		double OnBlockReceived(const Clock::duration latency, const size_t numBytes, const Clock::time_point now);
+		void OnTimeout();
+
+		size_t m_inFlight;
+
+	private:
+		double m_minLatencySeconds;
+		Clock::time_point m_minLatencyTime;
+		double m_bytesPerSecond;
+		double m_averageBlockBytes;
+		Clock::time_point m_lastReceived;
+	};
+
+	struct Request
+	{
+		uint64_t m_height;
+		uint64_t m_connectionId;
+		Clock::time_point m_requestTime;
+		Clock::time_point m_deadline;
+	};
+
+	struct ReadyBlock
+	{
+		FullBlock m_block;
+		uint64_t m_connectionId;
+		size_t m_numBytes;
+	};
+
+	bool SendRequest_Locked(const uint64_t height, const Hash& hash, const uint64_t connectionId, const Clock::time_point now);
+	uint64_t GetFastestAvailablePeer_Locked(const std::vector<uint64_t>& peers, const uint64_t excludedId) const;
+	void ProcessReadyBlocks();
+
+	ConnectionManager& m_connectionManager;
+	IBlockChainServer& m_blockChainServer;
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<Hash, Request> m_requests;
+	std::unordered_map<uint64_t, PeerStats> m_peers;
+	std::map<uint64_t, ReadyBlock> m_readyBlocks;
+	size_t m_readyBytes;
+	bool m_processing;
+};
\ No newline at end of file
@@ -1,26 +1,19 @@
 #pragma once
 
-#include <chrono>
-
 // Forward Declarations
 class ConnectionManager;
 class IBlockChainServer;
+class BlockDownloadScheduler;
 
 class BlockSyncer
 {
 public:
-	BlockSyncer(ConnectionManager& connectionManager, IBlockChainServer& blockChainServer);
+	BlockSyncer(ConnectionManager& connectionManager, IBlockChainServer& blockChainServer, BlockDownloadScheduler& blockDownloadScheduler);
 
 	bool SyncBlocks();
 
 private:
-	bool IsBlockSyncDue();
-	bool RequestBlocks();
-
 	ConnectionManager & m_connectionManager;
 	IBlockChainServer& m_blockChainServer;
-
-	std::chrono::time_point<std::chrono::system_clock> m_timeout;
-	uint64_t m_lastHeight;
-	uint64_t m_highestRequested;
+	BlockDownloadScheduler& m_blockDownloadScheduler;
 };
\ No newline at end of file
@@ -0,0 +1,420 @@
+#include "HeaderDownloadScheduler.h"
+#include "../BlockLocator.h"
+#include "../Common.h"
+#include "../ConnectionManager.h"
+#include "../Messages/GetHeadersMessage.h"
+
+#include <BlockChainServer.h>
+#include <Infrastructure/Logger.h>
+#include <StringUtil.h>
+#include <algorithm>
+
+// Bounds the memory used by segments waiting on the segments before them. The frontier segment is never held back.
+static const size_t MAX_BUFFERED_HEADERS = 64 * P2P::MAX_BLOCK_HEADERS;
+static const std::chrono::seconds REQUEST_TIMEOUT(10);
+
+HeaderDownloadScheduler::HeaderDownloadScheduler(const Config& config, ConnectionManager& connectionManager, IBlockChainServer& blockChainServer)
+	: m_config(config), m_connectionManager(connectionManager), m_blockChainServer(blockChainServer), m_processing(false)
+{
+
+}
+
+size_t HeaderDownloadScheduler::RequestHeaders()
+{
+	const std::vector<uint64_t> mostWorkPeers = m_connectionManager.GetMostWorkPeers();
+	if (mostWorkPeers.empty())
+	{
+		LoggerAPI::LogWarning("HeaderDownloadScheduler::RequestHeaders - No most-work peers found.");
+		return 0;
+	}
+
+	const uint64_t height = m_blockChainServer.GetHeight(EChainType::CANDIDATE);
+	const uint64_t highestHeight = m_connectionManager.GetHighestHeight();
+
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	const Clock::time_point now = Clock::now();
+
+	if (m_segments.empty())
+	{
+		CreateSegments_Locked(height, highestHeight);
+	}
+
+	// Take back requests that stalled or whose peer is gone. Each peer has at most one request in flight, so responses can be matched to segments.
+	const std::unordered_set<uint64_t> activePeers(mostWorkPeers.cbegin(), mostWorkPeers.cend());
+	std::unordered_set<uint64_t> busyPeers;
+	for (auto& entry : m_segments)
+	{
+		Segment& segment = entry.second;
+		if (segment.m_connectionId == 0)
+		{
+			continue;
+		}
+
+		if (activePeers.count(segment.m_connectionId) == 0 || now > segment.m_deadline)
+		{
+			LoggerAPI::LogWarning(StringUtil::Format("HeaderDownloadScheduler::RequestHeaders - Request for headers after %llu timed out. Requesting from another peer.", segment.m_anchorHeight));
+			if (now > segment.m_deadline)
+			{
+				m_connectionManager.RecordTimeout(segment.m_connectionId);
+			}
+
+			segment.m_failedPeers.insert(segment.m_connectionId);
+			AbandonRequest_Locked(segment);
+		}
+		else
+		{
+			busyPeers.insert(segment.m_connectionId);
+		}
+	}
+
+	for (auto iter = m_staleRequests.begin(); iter != m_staleRequests.end();)
+	{
+		iter = (activePeers.count(iter->first) == 0) ? m_staleRequests.erase(iter) : std::next(iter);
+	}
+
+	const size_t bufferedHeaders = GetBufferedHeaders_Locked();
+
+	size_t numRequested = 0;
+	for (auto iter = m_segments.begin(); iter != m_segments.end(); iter++)
+	{
+		Segment& segment = iter->second;
+		if (segment.m_complete || segment.m_connectionId != 0)
+		{
+			continue;
+		}
+
+		if (iter != m_segments.begin() && bufferedHeaders >= MAX_BUFFERED_HEADERS)
+		{
+			break;
+		}
+
+		// Once every peer has failed a segment, they're all given another chance.
+		bool allFailed = true;
+		for (const uint64_t connectionId : mostWorkPeers)
+		{
+			allFailed = allFailed && segment.m_failedPeers.count(connectionId) > 0;
+		}
+
+		if (allFailed)
+		{
+			segment.m_failedPeers.clear();
+		}
+
+		for (const uint64_t connectionId : mostWorkPeers)
+		{
+			if (busyPeers.count(connectionId) == 0 && segment.m_failedPeers.count(connectionId) == 0)
+			{
+				if (SendRequest_Locked(segment, connectionId, now))
+				{
+					busyPeers.insert(connectionId);
+					numRequested++;
+				}
+
+				break;
+			}
+		}
+	}
+
+	if (numRequested > 0)
+	{
+		LoggerAPI::LogDebug(StringUtil::Format("HeaderDownloadScheduler::RequestHeaders - Headers requested for %llu segments. %llu segments remaining, %llu headers waiting to be processed.", numRequested, m_segments.size(), bufferedHeaders));
+	}
+
+	return numRequested;
+}
+
+bool HeaderDownloadScheduler::OnHeadersReceived(const uint64_t connectionId, const std::vector<BlockHeader>& headers)
+{
+	bool banPeer = false;
+
+	{
+		std::lock_guard<std::mutex> lockGuard(m_mutex);
+
+		auto iter = m_segments.begin();
+		while (iter != m_segments.end() && iter->second.m_connectionId != connectionId)
+		{
+			iter++;
+		}
+
+		// A peer whose earlier request timed out or was reset may still answer it.
+		// That late reply won't build on the peer's current request, if it has one, and is dropped rather than treated as invalid.
+		auto staleIter = m_staleRequests.find(connectionId);
+		const bool mayBeStale = (staleIter != m_staleRequests.end());
+		const bool isStale = mayBeStale && (iter == m_segments.end() || !IsReplyToRequest(iter->second, headers));
+		if (isStale && --staleIter->second == 0)
+		{
+			m_staleRequests.erase(staleIter);
+		}
+
+		if (iter == m_segments.end())
+		{
+			return false;
+		}
+
+		if (isStale)
+		{
+			LoggerAPI::LogDebug(StringUtil::Format("HeaderDownloadScheduler::OnHeadersReceived - Ignoring late reply from peer (%llu).", connectionId));
+			return true;
+		}
+
+		Segment& segment = iter->second;
+		segment.m_connectionId = 0;
+		segment.m_locators.clear();
+
+		if (headers.empty())
+		{
+			// A peer with nothing after the last segment's anchor has given us all the headers it has.
+			// For any other segment, the peer doesn't know the anchor or is behind the checkpoint that ends it.
+			if (segment.m_endHeight == UINT64_MAX)
+			{
+				segment.m_complete = true;
+			}
+			else
+			{
+				segment.m_failedPeers.insert(connectionId);
+			}
+		}
+		else if (!IsReplyToRequest(segment, headers) || !IsContinuous(segment, headers))
+		{
+			LoggerAPI::LogWarning(StringUtil::Format("HeaderDownloadScheduler::OnHeadersReceived - Peer (%llu) sent headers that don't connect.", connectionId));
+			segment.m_failedPeers.insert(connectionId);
+			banPeer = true;
+		}
+		else
+		{
+			const uint64_t firstHeight = headers.front().GetHeight();
+			const uint64_t lastHeight = headers.back().GetHeight();
+
+			// The next segment covers everything after the checkpoint, so the batch is cut off there.
+			size_t numHeaders = headers.size();
+			if (lastHeight >= segment.m_endHeight)
+			{
+				numHeaders = (firstHeight <= segment.m_endHeight) ? (size_t)(segment.m_endHeight - firstHeight + 1) : 0;
+				if (numHeaders > 0 && headers[numHeaders - 1].GetHash() != segment.m_endHash)
+				{
+					LoggerAPI::LogWarning(StringUtil::Format("HeaderDownloadScheduler::OnHeadersReceived - Peer (%llu) sent headers that don't match the checkpoint at height %llu.", connectionId, segment.m_endHeight));
+					segment.m_failedPeers.insert(connectionId);
+					banPeer = true;
+				}
+			}
+
+			if (!banPeer)
+			{
+				segment.m_complete = (lastHeight >= segment.m_endHeight) || (segment.m_endHeight == UINT64_MAX && headers.size() < P2P::MAX_BLOCK_HEADERS);
+				if (numHeaders > 0)
+				{
+					segment.m_anchorHeight = headers[numHeaders - 1].GetHeight();
+					segment.m_anchorHash = headers[numHeaders - 1].GetHash();
+					segment.m_batches.emplace_back(Batch{ std::vector<BlockHeader>(headers.cbegin(), headers.cbegin() + numHeaders), connectionId });
+				}
+
+				// Ask for the next batch right away, so the peer keeps sending while this one is processed.
+				const bool isFrontier = (iter == m_segments.begin());
+				if (!segment.m_complete && (isFrontier || GetBufferedHeaders_Locked() < MAX_BUFFERED_HEADERS))
+				{
+					SendRequest_Locked(segment, connectionId, Clock::now());
+				}
+			}
+		}
+	}
+
+	if (banPeer)
+	{
+		m_connectionManager.BanConnection(connectionId);
+		return true;
+	}
+
+	ProcessReadyHeaders();
+
+	return true;
+}
+
+//
+// Splits the headers still needed at every checkpoint between the candidate tip and the most-work peer's height.
+// The first segment starts from the block locators, so it also resolves any fork between our chain and the peers' chains.
+//
+void HeaderDownloadScheduler::CreateSegments_Locked(const uint64_t height, const uint64_t highestHeight)
+{
+	Segment* pPrevious = &m_segments[height];
+	*pPrevious = Segment{ height, ZERO_HASH, UINT64_MAX, ZERO_HASH, 0, Clock::time_point(), {}, {}, {}, false };
+
+	for (const auto& checkpoint : m_config.GetP2PConfig().GetHeaderCheckpoints())
+	{
+		if (checkpoint.first <= height || checkpoint.first >= highestHeight)
+		{
+			continue;
+		}
+
+		pPrevious->m_endHeight = checkpoint.first;
+		pPrevious->m_endHash = checkpoint.second;
+
+		pPrevious = &m_segments[checkpoint.first];
+		*pPrevious = Segment{ checkpoint.first, checkpoint.second, UINT64_MAX, ZERO_HASH, 0, Clock::time_point(), {}, {}, {}, false };
+	}
+
+	LoggerAPI::LogInfo(StringUtil::Format("HeaderDownloadScheduler::CreateSegments_Locked - Syncing headers %llu to %llu in %llu segments.", height, highestHeight, m_segments.size()));
+}
+
+bool HeaderDownloadScheduler::SendRequest_Locked(Segment& segment, const uint64_t connectionId, const Clock::time_point now)
+{
+	std::vector<CBigInteger<32>> locators;
+	if (segment.m_anchorHash == ZERO_HASH)
+	{
+		locators = BlockLocator(m_blockChainServer).GetLocators();
+	}
+	else
+	{
+		locators.push_back(segment.m_anchorHash);
+	}
+
+	std::vector<CBigInteger<32>> hashes = locators;
+	const GetHeadersMessage getHeadersMessage(std::move(hashes));
+	if (!m_connectionManager.SendMessageToPeer(getHeadersMessage, connectionId))
+	{
+		return false;
+	}
+
+	segment.m_connectionId = connectionId;
+	segment.m_deadline = now + REQUEST_TIMEOUT;
+	segment.m_locators = std::move(locators);
+
+	return true;
+}
+
+//
+// Takes the segment's request back from its peer, remembering that the peer may still reply to it.
+//
+void HeaderDownloadScheduler::AbandonRequest_Locked(Segment& segment)
+{
+	if (segment.m_connectionId != 0)
+	{
+		m_staleRequests[segment.m_connectionId]++;
+		segment.m_connectionId = 0;
+		segment.m_locators.clear();
+	}
+}
+
+//
+// Peers reply to a GetHeaders request with the headers after the first locator they know, so a non-empty reply must build on one of them.
+//
+bool HeaderDownloadScheduler::IsReplyToRequest(const Segment& segment, const std::vector<BlockHeader>& headers) const
+{
+	if (headers.empty())
+	{
+		return true;
+	}
+
+	const Hash& previousHash = headers.front().GetPreviousBlockHash();
+	return std::find(segment.m_locators.cbegin(), segment.m_locators.cend(), previousHash) != segment.m_locators.cend();
+}
+
+//
+// Checks that each header builds on the one before it, and that the first builds on the segment's anchor.
+// This doesn't validate the headers themselves, which is left to the block chain, but lets batches be buffered without it.
+//
+bool HeaderDownloadScheduler::IsContinuous(const Segment& segment, const std::vector<BlockHeader>& headers) const
+{
+	if (segment.m_anchorHash != ZERO_HASH)
+	{
+		if (headers.front().GetHeight() != segment.m_anchorHeight + 1 || headers.front().GetPreviousBlockHash() != segment.m_anchorHash)
+		{
+			return false;
+		}
+	}
+
+	for (size_t i = 1; i < headers.size(); i++)
+	{
+		if (headers[i].GetHeight() != headers[i - 1].GetHeight() + 1 || headers[i].GetPreviousBlockHash() != headers[i - 1].GetHash())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+size_t HeaderDownloadScheduler::GetBufferedHeaders_Locked() const
+{
+	size_t bufferedHeaders = 0;
+	for (const auto& entry : m_segments)
+	{
+		for (const Batch& batch : entry.second.m_batches)
+		{
+			bufferedHeaders += batch.m_headers.size();
+		}
+	}
+
+	return bufferedHeaders;
+}
+
+//
+// Discards the frontier segment's progress so it's downloaded again from the block locators.
+// A response to a request still in flight is no longer matched to the segment.
+//
+void HeaderDownloadScheduler::ResetFrontier_Locked()
+{
+	if (!m_segments.empty())
+	{
+		Segment& frontier = m_segments.begin()->second;
+		AbandonRequest_Locked(frontier);
+		frontier.m_anchorHash = ZERO_HASH;
+		frontier.m_batches.clear();
+		frontier.m_complete = false;
+	}
+}
+
+//
+// Hands buffered batches to the block chain in height order, starting with the frontier segment.
+// Once the frontier is complete and drained, the segment after it has become the next needed, and its batches are processed next.
+// Only one thread processes at a time. Batches that arrive meanwhile are picked up by that thread before it finishes.
+//
+void HeaderDownloadScheduler::ProcessReadyHeaders()
+{
+	{
+		std::lock_guard<std::mutex> lockGuard(m_mutex);
+		if (m_processing)
+		{
+			return;
+		}
+
+		m_processing = true;
+	}
+
+	while (true)
+	{
+		std::unique_lock<std::mutex> lockGuard(m_mutex);
+		while (!m_segments.empty() && m_segments.begin()->second.m_complete && m_segments.begin()->second.m_batches.empty())
+		{
+			m_segments.erase(m_segments.begin());
+		}
+
+		if (m_segments.empty() || m_segments.begin()->second.m_batches.empty())
+		{
+			m_processing = false;
+			return;
+		}
+
+		const Batch batch = std::move(m_segments.begin()->second.m_batches.front());
+		m_segments.begin()->second.m_batches.pop_front();
+		lockGuard.unlock();
+
+		const EBlockChainStatus status = m_blockChainServer.AddBlockHeaders(batch.m_headers);
+		if (status == EBlockChainStatus::SUCCESS || status == EBlockChainStatus::ALREADY_EXISTS)
+		{
+			continue;
+		}
+
+		if (status == EBlockChainStatus::INVALID)
+		{
+			LoggerAPI::LogWarning(StringUtil::Format("HeaderDownloadScheduler::ProcessReadyHeaders - Invalid headers received from peer (%llu).", batch.m_connectionId));
+			m_connectionManager.BanConnection(batch.m_connectionId);
+		}
+		else
+		{
+			LoggerAPI::LogWarning(StringUtil::Format("HeaderDownloadScheduler::ProcessReadyHeaders - Failed to process headers %llu to %llu.", batch.m_headers.front().GetHeight(), batch.m_headers.back().GetHeight()));
+		}
+
+		lockGuard.lock();
+		ResetFrontier_Locked();
+	}
+}
\ No newline at end of file
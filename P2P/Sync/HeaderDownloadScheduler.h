@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Hash.h>
+#include <Config/Config.h>
+#include <Core/BlockHeader.h>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Forward Declarations
+class ConnectionManager;
+class IBlockChainServer;
+
+//
+// Schedules header downloads across all most-work peers during header sync.
+// The headers still needed are split into segments at the configured header checkpoints, and each segment is downloaded from a different peer at the same time.
+// Within a segment, the next batch is requested from the last header received as soon as a batch arrives, rather than after the chain has processed it,
+// so a peer is never left idle while headers are being validated.
+// Batches are checked for continuity on the thread that received them, and are then handed to the block chain in height order by a single thread.
+//
+class HeaderDownloadScheduler
+{
+public:
+	HeaderDownloadScheduler(const Config& config, ConnectionManager& connectionManager, IBlockChainServer& blockChainServer);
+
+	//
+	// Reassigns stalled segments, then requests the next batch of every segment that has none in flight.
+	// Returns the number of requests sent.
+	//
+	size_t RequestHeaders();
+
+	//
+	// Returns false if the headers weren't requested by the scheduler, in which case the caller should process them directly.
+	//
+	bool OnHeadersReceived(const uint64_t connectionId, const std::vector<BlockHeader>& headers);
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Batch
+	{
+		std::vector<BlockHeader> m_headers;
+		uint64_t m_connectionId;
+	};
+
+	struct Segment
+	{
+		// The last header received, or the checkpoint the segment starts from. A zero hash means the segment starts from the block locators.
+		uint64_t m_anchorHeight;
+		Hash m_anchorHash;
+
+		// The checkpoint that ends the segment. The last segment has no end, and is complete once a peer has no more headers to give.
+		uint64_t m_endHeight;
+		Hash m_endHash;
+
+		uint64_t m_connectionId;
+		Clock::time_point m_deadline;
+
+		// The locators sent with the request in flight. A reply to it must build on one of them.
+		std::vector<Hash> m_locators;
+		std::unordered_set<uint64_t> m_failedPeers;
+
+		// Batches received but not yet handed to the block chain, in height order.
+		std::deque<Batch> m_batches;
+		bool m_complete;
+	};
+
+	void CreateSegments_Locked(const uint64_t height, const uint64_t highestHeight);
+	bool SendRequest_Locked(Segment& segment, const uint64_t connectionId, const Clock::time_point now);
+	void AbandonRequest_Locked(Segment& segment);
+	bool IsReplyToRequest(const Segment& segment, const std::vector<BlockHeader>& headers) const;
+	bool IsContinuous(const Segment& segment, const std::vector<BlockHeader>& headers) const;
+	size_t GetBufferedHeaders_Locked() const;
+	void ResetFrontier_Locked();
+	void ProcessReadyHeaders();
+
+	const Config& m_config;
+	ConnectionManager& m_connectionManager;
+	IBlockChainServer& m_blockChainServer;
+
+	mutable std::mutex m_mutex;
+	std::map<uint64_t, Segment> m_segments;
+
+	// The number of requests taken back from each peer that it may still reply to.
+	std::unordered_map<uint64_t, size_t> m_staleRequests;
+	bool m_processing;
+};
\ No newline at end of file
@@ -1,27 +1,19 @@
 #pragma once
 
-#include <chrono>
-
 // Forward Declarations
 class ConnectionManager;
 class IBlockChainServer;
+class HeaderDownloadScheduler;
 
 class HeaderSyncer
 {
 public:
-	HeaderSyncer(ConnectionManager& connectionManager, IBlockChainServer& blockChainServer);
+	HeaderSyncer(ConnectionManager& connectionManager, IBlockChainServer& blockChainServer, HeaderDownloadScheduler& headerDownloadScheduler);
 
 	bool SyncHeaders();
 
 private:
-	bool IsHeaderSyncDue();
-	bool RequestHeaders();
-
 	ConnectionManager & m_connectionManager;
 	IBlockChainServer& m_blockChainServer;
-
-	std::chrono::time_point<std::chrono::system_clock> m_timeout;
-	uint64_t m_lastHeight;
-	uint64_t m_connectionId;
-	uint8_t m_consecutiveTimeouts;
+	HeaderDownloadScheduler& m_headerDownloadScheduler;
 };
\ No newline at end of file
@@ -11,6 +11,7 @@ StateSyncer::StateSyncer(ConnectionManager& connectionManager, IBlockChainServer
 {
 	m_timeout = std::chrono::system_clock::now();
 	m_requestedHeight = 0;
+	m_connectionId = 0;
 }
 
 bool StateSyncer::SyncState()
@@ -73,14 +74,20 @@ bool StateSyncer::RequestState()
 	const uint64_t requestedHeight = headerHeight - Consensus::STATE_SYNC_THRESHOLD;
 	Hash hash = m_blockChainServer.GetBlockHeaderByHeight(requestedHeight, EChainType::CANDIDATE)->GetHash();
 
+	// State sync is only requested again once the previous request has timed out.
+	if (m_connectionId != 0)
+	{
+		m_connectionManager.RecordTimeout(m_connectionId);
+	}
+
 	const TxHashSetRequestMessage txHashSetRequestMessage(std::move(hash), requestedHeight);
-	const bool requested = m_connectionManager.SendMessageToMostWorkPeer(txHashSetRequestMessage);
+	m_connectionId = m_connectionManager.SendMessageToMostWorkPeer(txHashSetRequestMessage);
 
-	if (requested)
+	if (m_connectionId != 0)
 	{
 		m_timeout = std::chrono::system_clock::now() + std::chrono::minutes(10);
 		m_requestedHeight = requestedHeight;
 	}
 
-	return requested;
+	return m_connectionId != 0;
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ private:
 
 	std::chrono::time_point<std::chrono::system_clock> m_timeout;
 	uint64_t m_requestedHeight;
+	uint64_t m_connectionId;
 
 	ConnectionManager & m_connectionManager;
 	IBlockChainServer& m_blockChainServer;
@@ -9,8 +9,9 @@
 #include <Infrastructure/ThreadManager.h>
 #include <Infrastructure/Logger.h>
 
-Syncer::Syncer(ConnectionManager& connectionManager, IBlockChainServer& blockChainServer)
-	: m_connectionManager(connectionManager), m_blockChainServer(blockChainServer)
+Syncer::Syncer(const Config& config, ConnectionManager& connectionManager, IBlockChainServer& blockChainServer)
+	: m_connectionManager(connectionManager), m_blockChainServer(blockChainServer),
+	m_headerDownloadScheduler(config, connectionManager, blockChainServer), m_blockDownloadScheduler(connectionManager, blockChainServer)
 {
 
 }
@@ -43,9 +44,9 @@ void Syncer::Thread_Sync(Syncer& syncer)
 
 	LoggerAPI::LogInfo("Syncer::Thread_Sync() - BEGIN");
 
-	HeaderSyncer headerSyncer(syncer.m_connectionManager, syncer.m_blockChainServer);
+	HeaderSyncer headerSyncer(syncer.m_connectionManager, syncer.m_blockChainServer, syncer.m_headerDownloadScheduler);
 	StateSyncer stateSyncer(syncer.m_connectionManager, syncer.m_blockChainServer);
-	BlockSyncer blockSyncer(syncer.m_connectionManager, syncer.m_blockChainServer);
+	BlockSyncer blockSyncer(syncer.m_connectionManager, syncer.m_blockChainServer, syncer.m_blockDownloadScheduler);
 
 	while (!syncer.m_terminate)
 	{
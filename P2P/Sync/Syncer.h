@@ -1,5 +1,8 @@
 #pragma once
 
+#include "HeaderDownloadScheduler.h"
+#include "BlockDownloadScheduler.h"
+
 #include <P2P/SyncStatus.h>
 #include <atomic>
 #include <thread>
@@ -12,12 +15,14 @@ class SyncStatus;
 class Syncer
 {
 public:
-	Syncer(ConnectionManager& connectionManager, IBlockChainServer& blockChainServer);
+	Syncer(const Config& config, ConnectionManager& connectionManager, IBlockChainServer& blockChainServer);
 
 	void Start();
 	void Stop();
 
 	inline const SyncStatus& GetSyncStatus() const { return m_syncStatus; }
+	inline HeaderDownloadScheduler& GetHeaderDownloadScheduler() { return m_headerDownloadScheduler; }
+	inline BlockDownloadScheduler& GetBlockDownloadScheduler() { return m_blockDownloadScheduler; }
 
 private:
 	static void Thread_Sync(Syncer& syncer);
@@ -26,6 +31,8 @@ private:
 	ConnectionManager& m_connectionManager;
 	IBlockChainServer& m_blockChainServer;
 	SyncStatus m_syncStatus;
+	HeaderDownloadScheduler m_headerDownloadScheduler;
+	BlockDownloadScheduler m_blockDownloadScheduler;
 
 	std::atomic<bool> m_terminate;
 	std::thread m_syncThread;
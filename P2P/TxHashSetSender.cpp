@@ -0,0 +1,165 @@
+#include "TxHashSetSender.h"
+#include "ConnectionManager.h"
+#include "MessageSender.h"
+#include "Common.h"
+#include "Messages/TxHashSetArchiveMessage.h"
+
+#include <BlockChainServer.h>
+#include <PMMR/TxHashSetSnapshot.h>
+#include <Infrastructure/Logger.h>
+#include <StringUtil.h>
+
+//
+// Keeps the snapshot alive, and holds one of the upload slots, until the archive has been sent or the connection is gone.
+//
+class ActiveUpload
+{
+public:
+	ActiveUpload(const std::shared_ptr<const TxHashSetSnapshot>& pSnapshot, const std::shared_ptr<std::atomic<size_t>>& pActiveUploads)
+		: m_pSnapshot(pSnapshot), m_pActiveUploads(pActiveUploads)
+	{
+
+	}
+
+	~ActiveUpload()
+	{
+		--(*m_pActiveUploads);
+	}
+
+private:
+	const std::shared_ptr<const TxHashSetSnapshot> m_pSnapshot;
+	const std::shared_ptr<std::atomic<size_t>> m_pActiveUploads;
+};
+
+TxHashSetSender::TxHashSetSender(const Config& config, ConnectionManager& connectionManager, IBlockChainServer& blockChainServer)
+	: m_config(config), m_connectionManager(connectionManager), m_blockChainServer(blockChainServer), m_pActiveUploads(std::make_shared<std::atomic<size_t>>(0)), m_terminate(true)
+{
+
+}
+
+TxHashSetSender::~TxHashSetSender()
+{
+	Stop();
+}
+
+void TxHashSetSender::Start()
+{
+	if (m_sendThread.joinable())
+	{
+		m_sendThread.join();
+	}
+
+	m_terminate = false;
+	m_sendThread = std::thread(Thread_Send, std::ref(*this));
+}
+
+void TxHashSetSender::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lockGuard(m_mutex);
+		m_terminate = true;
+
+		*m_pActiveUploads -= m_requests.size();
+		m_requests.clear();
+
+		m_requestCondition.notify_all();
+	}
+
+	if (m_sendThread.joinable())
+	{
+		m_sendThread.join();
+	}
+}
+
+void TxHashSetSender::SendTxHashSet(const uint64_t connectionId, const IPAddress& ipAddress, const TxHashSetRequestMessage& txHashSetRequestMessage)
+{
+	if (!BeginUpload(ipAddress))
+	{
+		LoggerAPI::LogInfo(StringUtil::Format("TxHashSetSender::SendTxHashSet - Ignoring TxHashSet request from %s.", ipAddress.Format().c_str()));
+		return;
+	}
+
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	if (m_terminate)
+	{
+		--(*m_pActiveUploads);
+		return;
+	}
+
+	m_requests.emplace_back(Request{ connectionId, ipAddress, txHashSetRequestMessage.GetBlockHeight() });
+	m_requestCondition.notify_one();
+}
+
+bool TxHashSetSender::BeginUpload(const IPAddress& ipAddress)
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+
+	const Clock::time_point now = Clock::now();
+	const Clock::duration uploadInterval = std::chrono::seconds(P2P::TXHASHSET_UPLOAD_INTERVAL);
+
+	auto iter = m_lastUploads.begin();
+	while (iter != m_lastUploads.end())
+	{
+		iter = (iter->second + uploadInterval <= now) ? m_lastUploads.erase(iter) : std::next(iter);
+	}
+
+	if (*m_pActiveUploads >= P2P::MAX_TXHASHSET_UPLOADS || m_lastUploads.find(ipAddress) != m_lastUploads.end())
+	{
+		return false;
+	}
+
+	++(*m_pActiveUploads);
+	m_lastUploads[ipAddress] = now;
+	return true;
+}
+
+//
+// Takes ownership of the request's upload slot, which is released as soon as the request fails,
+// or once the archive is no longer queued for the peer.
+//
+void TxHashSetSender::ServeRequest(const Request& request)
+{
+	const std::string formattedIPAddress = request.m_ipAddress.Format();
+	const std::shared_ptr<const TxHashSetSnapshot> pSnapshot = m_blockChainServer.GetTxHashSetSnapshot(request.m_blockHeight);
+	if (pSnapshot == nullptr)
+	{
+		LoggerAPI::LogWarning(StringUtil::Format("TxHashSetSender::ServeRequest - No TxHashSet snapshot available for height %llu.", request.m_blockHeight));
+		--(*m_pActiveUploads);
+		return;
+	}
+
+	const BlockHeader& header = pSnapshot->GetHeader();
+	const TxHashSetArchiveMessage archiveMessage(Hash(header.GetHash()), header.GetHeight(), pSnapshot->GetZippedSize());
+	const SendQueue::Frame pFrame = MessageSender(m_config).Serialize(archiveMessage);
+
+	const std::shared_ptr<const void> pUpload = std::make_shared<ActiveUpload>(pSnapshot, m_pActiveUploads);
+	if (m_connectionManager.SendFileToPeer(request.m_connectionId, pFrame, pSnapshot->GetZipPath(), pSnapshot->GetZippedSize(), pUpload))
+	{
+		LoggerAPI::LogInfo(StringUtil::Format("TxHashSetSender::ServeRequest - Sending TxHashSet snapshot at block %s to %s.", header.FormatHash().c_str(), formattedIPAddress.c_str()));
+	}
+	else
+	{
+		LoggerAPI::LogWarning(StringUtil::Format("TxHashSetSender::ServeRequest - Failed to queue TxHashSet snapshot for %s.", formattedIPAddress.c_str()));
+	}
+}
+
+void TxHashSetSender::Thread_Send(TxHashSetSender& txHashSetSender)
+{
+	while (true)
+	{
+		Request request;
+		{
+			std::unique_lock<std::mutex> lockGuard(txHashSetSender.m_mutex);
+			txHashSetSender.m_requestCondition.wait(lockGuard, [&txHashSetSender] { return txHashSetSender.m_terminate || !txHashSetSender.m_requests.empty(); });
+			if (txHashSetSender.m_terminate)
+			{
+				return;
+			}
+
+			request = txHashSetSender.m_requests.front();
+			txHashSetSender.m_requests.pop_front();
+		}
+
+		txHashSetSender.ServeRequest(request);
+	}
+}
\ No newline at end of file
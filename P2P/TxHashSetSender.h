@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Messages/TxHashSetRequestMessage.h"
+
+#include <Config/Config.h>
+#include <P2P/IPAddress.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Forward Declarations
+class IBlockChainServer;
+class ConnectionManager;
+
+//
+// Serves TxHashSet archives to peers performing state sync.
+// Requests are served on the sender's own thread, since fetching the BlockChainServer's cached snapshot may mean taking and zipping a new one.
+// The archive is then queued on the peer's SendQueue, which streams it from the zip file as the socket accepts it.
+// Uploads are capped at P2P::MAX_TXHASHSET_UPLOADS at a time, and each peer is sent at most one archive per P2P::TXHASHSET_UPLOAD_INTERVAL.
+//
+class TxHashSetSender
+{
+public:
+	TxHashSetSender(const Config& config, ConnectionManager& connectionManager, IBlockChainServer& blockChainServer);
+	~TxHashSetSender();
+
+	void Start();
+	void Stop();
+
+	//
+	// Queues the request to be served by the sender's thread. Requests that are refused are logged and ignored.
+	//
+	void SendTxHashSet(const uint64_t connectionId, const IPAddress& ipAddress, const TxHashSetRequestMessage& txHashSetRequestMessage);
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Request
+	{
+		uint64_t m_connectionId;
+		IPAddress m_ipAddress;
+		uint64_t m_blockHeight;
+	};
+
+	bool BeginUpload(const IPAddress& ipAddress);
+	void ServeRequest(const Request& request);
+
+	static void Thread_Send(TxHashSetSender& txHashSetSender);
+
+	const Config& m_config;
+	ConnectionManager& m_connectionManager;
+	IBlockChainServer& m_blockChainServer;
+
+	// Counts queued requests and archives not yet fully sent. Shared with the uploads, which may outlive the sender in a peer's SendQueue.
+	const std::shared_ptr<std::atomic<size_t>> m_pActiveUploads;
+
+	std::mutex m_mutex;
+	std::condition_variable m_requestCondition;
+	std::deque<Request> m_requests;
+	std::map<IPAddress, Clock::time_point> m_lastUploads;
+	std::thread m_sendThread;
+	std::atomic_bool m_terminate;
+};
\ No newline at end of file
@@ -37,9 +37,13 @@ public:
 		return m_file.GetSize() / NUM_BYTES;
 	}
 
-	inline bool GetDataAt(const uint64_t position, std::vector<unsigned char>& data) const
+	//
+	// Returns a view of the data at the given position without copying it.
+	// The view is only valid until the file is next modified.
+	//
+	inline ByteSpan GetDataAt(const uint64_t position) const
 	{
-		return m_file.Read(position * NUM_BYTES, NUM_BYTES, data);
+		return m_file.Read(position * NUM_BYTES, NUM_BYTES);
 	}
 
 	inline void AddData(const std::vector<unsigned char>& data)
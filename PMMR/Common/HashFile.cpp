@@ -36,10 +36,10 @@ uint64_t HashFile::GetSize() const
 
 Hash HashFile::GetHashAt(const uint64_t mmrIndex) const
 {
-	std::vector<unsigned char> data;
-	if (m_file.Read(mmrIndex * HASH_SIZE, HASH_SIZE, data))
+	const ByteSpan data = m_file.Read(mmrIndex * HASH_SIZE, HASH_SIZE);
+	if (data.size() == HASH_SIZE)
 	{
-		return Hash(std::move(data));
+		return Hash(data.data());
 	}
 
 	return ZERO_HASH;
@@ -47,7 +47,7 @@ Hash HashFile::GetHashAt(const uint64_t mmrIndex) const
 
 void HashFile::AddHash(const Hash& hash)
 {
-	m_file.Append(hash.GetData());
+	m_file.Append(hash.ToSpan());
 }
 
 void HashFile::AddHashes(const std::vector<Hash>& hashes)
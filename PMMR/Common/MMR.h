@@ -3,6 +3,7 @@
 #include <Hash.h>
 #include <stdint.h>
 #include <memory>
+#include <optional>
 
 class MMR
 {
@@ -19,9 +20,9 @@ public:
 
 	//
 	// Gets the Hash at the mmr index.
-	// Returns NULL if the node has been pruned.
+	// Returns std::nullopt if the node has been pruned.
 	//
-	virtual std::unique_ptr<Hash> GetHashAt(const uint64_t mmrIndex) const = 0;
+	virtual std::optional<Hash> GetHashAt(const uint64_t mmrIndex) const = 0;
 
 	//
 	// Rewinds the MMR to the given size, ie. the index of the last node in the MMR.
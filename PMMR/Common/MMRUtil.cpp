@@ -178,7 +178,7 @@ uint64_t MMRUtil::GetPMMRIndex(const uint64_t leafIndex)
 
 Hash MMRUtil::HashParentWithIndex(const Hash& leftChild, const Hash& rightChild, const uint64_t parentIndex)
 {
-	Serializer serializer;
+	Serializer serializer(sizeof(uint64_t) + 2 * HASH_SIZE);
 	serializer.Append<uint64_t>(parentIndex);
 	serializer.AppendBigInteger<32>(leftChild);
 	serializer.AppendBigInteger<32>(rightChild);
@@ -38,9 +38,7 @@ std::unique_ptr<TransactionKernel> KernelMMR::GetKernelAt(const uint64_t mmrInde
 	{
 		const uint64_t numLeaves = MMRUtil::GetNumLeaves(mmrIndex);
 
-		std::vector<unsigned char> data;
-		m_dataFile.GetDataAt(numLeaves - 1, data);
-
+		const ByteSpan data = m_dataFile.GetDataAt(numLeaves - 1);
 		if (data.size() == KERNEL_SIZE)
 		{
 			ByteBuffer byteBuffer(data);
@@ -21,7 +21,7 @@ public:
 
 	virtual Hash Root(const uint64_t lastMMRIndex) const override final;
 	virtual uint64_t GetSize() const override final { return m_hashFile.GetSize(); }
-	virtual std::unique_ptr<Hash> GetHashAt(const uint64_t mmrIndex) const override final { return std::make_unique<Hash>(m_hashFile.GetHashAt(mmrIndex)); }
+	virtual std::optional<Hash> GetHashAt(const uint64_t mmrIndex) const override final { return std::make_optional<Hash>(m_hashFile.GetHashAt(mmrIndex)); }
 
 	virtual bool Rewind(const uint64_t lastMMRIndex) override final;
 	virtual bool Flush() override final;
@@ -6,18 +6,48 @@
 #include <Infrastructure/Logger.h>
 #include <HexUtil.h>
 #include <Crypto.h>
+#include <async++.h>
+#include <atomic>
+#include <algorithm>
 
+// Number of consecutive MMR nodes (roughly half as many kernels) whose signatures are verified by one task.
+static const uint64_t KERNEL_BATCH_MMR_SIZE = 2048;
+
+//
+// Splits the kernel MMR into ranges and verifies the signatures of each range on the Async++ threadpool.
+//
 bool KernelSignatureValidator::ValidateKernelSignatures(const KernelMMR& kernelMMR) const
 {
-	uint64_t validatedKernels = 0;
 	const uint64_t mmrSize = kernelMMR.GetSize();
-	const uint64_t numKernels = MMRUtil::GetNumLeaves(mmrSize);
-	for (uint64_t i = 0; i < mmrSize; i++)
+	const uint64_t numBatches = (mmrSize + KERNEL_BATCH_MMR_SIZE - 1) / KERNEL_BATCH_MMR_SIZE;
+
+	std::atomic_bool valid = true;
+	async::parallel_for(async::irange((uint64_t)0, numBatches), [this, &kernelMMR, mmrSize, &valid](const uint64_t batch)
+	{
+		if (valid)
+		{
+			const uint64_t firstIndex = batch * KERNEL_BATCH_MMR_SIZE;
+			const uint64_t lastIndex = std::min(mmrSize, firstIndex + KERNEL_BATCH_MMR_SIZE);
+			if (!this->ValidateKernelSignatureRange(kernelMMR, firstIndex, lastIndex))
+			{
+				valid = false;
+			}
+		}
+	});
+
+	return valid;
+}
+
+bool KernelSignatureValidator::ValidateKernelSignatureRange(const KernelMMR& kernelMMR, const uint64_t firstIndex, const uint64_t lastIndex) const
+{
+	std::vector<TransactionKernel> kernels;
+	kernels.reserve((size_t)(lastIndex - firstIndex));
+
+	for (uint64_t i = firstIndex; i < lastIndex; i++)
 	{
 		std::unique_ptr<TransactionKernel> pKernel = kernelMMR.GetKernelAt(i);
 		if (pKernel != nullptr)
 		{
-
 			// TODO: Verify the following:
 			//let valid_features = match features{
 			//KernelFeatures::COINBASE = > fee == 0 && lock_height == 0,
@@ -29,17 +59,16 @@ bool KernelSignatureValidator::ValidateKernelSignatures(const KernelMMR& kernelM
 			//	return Err(Error::InvalidKernelFeatures);
 			//}
 
-			const Commitment& publicKey = pKernel->GetExcessCommitment();
-			const Signature& signature = pKernel->GetExcessSignature();
-			const Hash signatureMessage = pKernel->GetSignatureMessage();
-
-			if (!Crypto::VerifyKernelSignature(signature, publicKey, signatureMessage))
-			{
-				LoggerAPI::LogError("KernelSignatureValidator::ValidateKernelSignatures - Failed to verify kernel " + HexUtil::ConvertHash(pKernel->GetHash()));
-				return false;
-			}
+			kernels.emplace_back(std::move(*pKernel));
+		}
+	}
 
-			++validatedKernels;
+	for (const TransactionKernel& kernel : kernels)
+	{
+		if (!Crypto::VerifyKernelSignature(kernel.GetExcessSignature(), kernel.GetExcessCommitment(), kernel.GetSignatureMessage()))
+		{
+			LoggerAPI::LogError("KernelSignatureValidator::ValidateKernelSignatures - Failed to verify kernel " + HexUtil::ConvertHash(kernel.GetHash()));
+			return false;
 		}
 	}
 
@@ -6,4 +6,7 @@ class KernelSignatureValidator
 {
 public:
 	bool ValidateKernelSignatures(const KernelMMR& kernelMMR) const;
+
+private:
+	bool ValidateKernelSignatureRange(const KernelMMR& kernelMMR, const uint64_t firstIndex, const uint64_t lastIndex) const;
 };
\ No newline at end of file
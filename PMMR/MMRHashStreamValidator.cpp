@@ -0,0 +1,99 @@
+#include "MMRHashStreamValidator.h"
+#include "Common/MMRUtil.h"
+
+#include <Infrastructure/Logger.h>
+#include <algorithm>
+
+MMRHashStreamValidator::MMRHashStreamValidator(const uint64_t mmrSize, const PruneList* pPruneList)
+	: m_mmrSize(mmrSize), m_pPruneList(pPruneList), m_nextIndex(0), m_valid(true)
+{
+	m_partialHash.reserve(HASH_SIZE);
+	SkipPrunedPositions();
+}
+
+bool MMRHashStreamValidator::Append(const unsigned char* pData, const size_t numBytes)
+{
+	size_t offset = 0;
+
+	// Complete a hash that was split across calls.
+	if (!m_partialHash.empty())
+	{
+		const size_t bytesToCopy = std::min(numBytes, HASH_SIZE - m_partialHash.size());
+		m_partialHash.insert(m_partialHash.end(), pData, pData + bytesToCopy);
+		offset += bytesToCopy;
+
+		if (m_partialHash.size() < HASH_SIZE)
+		{
+			return m_valid;
+		}
+
+		const Hash hash(&m_partialHash[0]);
+		m_partialHash.clear();
+		if (!AddHash(hash))
+		{
+			return false;
+		}
+	}
+
+	while (offset + HASH_SIZE <= numBytes)
+	{
+		if (!AddHash(Hash(pData + offset)))
+		{
+			return false;
+		}
+
+		offset += HASH_SIZE;
+	}
+
+	m_partialHash.insert(m_partialHash.end(), pData + offset, pData + numBytes);
+	return m_valid;
+}
+
+bool MMRHashStreamValidator::AddHash(const Hash& hash)
+{
+	if (!m_valid || m_nextIndex >= m_mmrSize)
+	{
+		return m_valid;
+	}
+
+	const uint64_t height = MMRUtil::GetHeight(m_nextIndex);
+	const bool prunedRoot = m_pPruneList != nullptr && m_pPruneList->IsPrunedRoot(m_nextIndex);
+	if (height > 0 && !prunedRoot)
+	{
+		if (m_peaks.size() < 2)
+		{
+			LoggerAPI::LogError("MMRHashStreamValidator::AddHash - Missing children at index " + std::to_string(m_nextIndex));
+			m_valid = false;
+			return false;
+		}
+
+		const Hash rightHash = m_peaks.back();
+		m_peaks.pop_back();
+		const Hash leftHash = m_peaks.back();
+		m_peaks.pop_back();
+
+		if (hash != MMRUtil::HashParentWithIndex(leftHash, rightHash, m_nextIndex))
+		{
+			LoggerAPI::LogError("MMRHashStreamValidator::AddHash - Invalid parent hash at index " + std::to_string(m_nextIndex));
+			m_valid = false;
+			return false;
+		}
+	}
+
+	m_peaks.push_back(hash);
+	m_nextIndex++;
+	SkipPrunedPositions();
+
+	return true;
+}
+
+void MMRHashStreamValidator::SkipPrunedPositions()
+{
+	if (m_pPruneList != nullptr)
+	{
+		while (m_nextIndex < m_mmrSize && m_pPruneList->IsPruned(m_nextIndex) && !m_pPruneList->IsPrunedRoot(m_nextIndex))
+		{
+			m_nextIndex++;
+		}
+	}
+}
\ No newline at end of file
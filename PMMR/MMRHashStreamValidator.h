@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Common/PruneList.h"
+
+#include <Hash.h>
+#include <vector>
+#include <stdint.h>
+
+//
+// Verifies the parent hashes of an MMR in a single pass over its hash file, while the file is still being received.
+// Hashes are stored in postorder, so the children of each parent are always the two most recent subtrees on the stack of peaks,
+// and verifying a hash never needs anything that's been written to disk.
+// For a pruned MMR, the prune list is used to skip the positions that were compacted out of the hash file.
+// Pruned subtree roots are accepted as they are, since their children are no longer available.
+//
+class MMRHashStreamValidator
+{
+public:
+	MMRHashStreamValidator(const uint64_t mmrSize, const PruneList* pPruneList);
+
+	//
+	// Verifies the next bytes of the hash file. Any bytes past the given MMR size are ignored.
+	// Returns false once an invalid parent hash is found.
+	//
+	bool Append(const unsigned char* pData, const size_t numBytes);
+
+	//
+	// Indicates whether every hash up to the MMR size was verified.
+	//
+	inline bool IsComplete() const { return m_valid && m_nextIndex >= m_mmrSize; }
+
+private:
+	bool AddHash(const Hash& hash);
+	void SkipPrunedPositions();
+
+	const uint64_t m_mmrSize;
+	const PruneList* m_pPruneList;
+	uint64_t m_nextIndex;
+	bool m_valid;
+	std::vector<Hash> m_peaks;
+	std::vector<unsigned char> m_partialHash;
+};
\ No newline at end of file
@@ -43,16 +43,16 @@ Hash OutputPMMR::Root(const uint64_t size) const
 	const std::vector<uint64_t> peakIndices = MMRUtil::GetPeakIndices(size);
 	for (auto iter = peakIndices.crbegin(); iter != peakIndices.crend(); iter++)
 	{
-		std::unique_ptr<Hash> pHash = GetHashAt(*iter);
-		if (pHash != nullptr)
+		const std::optional<Hash> peakHash = GetHashAt(*iter);
+		if (peakHash.has_value())
 		{
 			if (hash == ZERO_HASH)
 			{
-				hash = *pHash;
+				hash = peakHash.value();
 			}
 			else
 			{
-				hash = MMRUtil::HashParentWithIndex(*pHash, hash, size);
+				hash = MMRUtil::HashParentWithIndex(peakHash.value(), hash, size);
 			}
 		}
 	}
@@ -60,17 +60,17 @@ Hash OutputPMMR::Root(const uint64_t size) const
 	return hash;
 }
 
-std::unique_ptr<Hash> OutputPMMR::GetHashAt(const uint64_t mmrIndex) const
+std::optional<Hash> OutputPMMR::GetHashAt(const uint64_t mmrIndex) const
 {
 	if (m_pruneList.IsPruned(mmrIndex) && !m_pruneList.IsPrunedRoot(mmrIndex))
 	{
-		return std::unique_ptr<Hash>(nullptr);
+		return std::nullopt;
 	}
 
 	const uint64_t shift = m_pruneList.GetShift(mmrIndex);
 	const uint64_t shiftedIndex = (mmrIndex - shift);
 
-	return std::make_unique<Hash>(m_hashFile.GetHashAt(shiftedIndex));
+	return std::make_optional<Hash>(m_hashFile.GetHashAt(shiftedIndex));
 }
 
 std::unique_ptr<OutputIdentifier> OutputPMMR::GetOutputAt(const uint64_t mmrIndex) const
@@ -88,9 +88,7 @@ std::unique_ptr<OutputIdentifier> OutputPMMR::GetOutputAt(const uint64_t mmrInde
 			const uint64_t numLeaves = MMRUtil::GetNumLeaves(mmrIndex);
 			const uint64_t shiftedIndex = ((numLeaves - 1) - shift);
 
-			std::vector<unsigned char> data;
-			m_dataFile.GetDataAt(shiftedIndex, data);
-
+			const ByteSpan data = m_dataFile.GetDataAt(shiftedIndex);
 			if (data.size() == OUTPUT_SIZE)
 			{
 				ByteBuffer byteBuffer(data);
@@ -129,6 +127,11 @@ bool OutputPMMR::Flush()
 	return hashFlush && dataFlush && leafSetFlush && pruneFlush;
 }
 
+bool OutputPMMR::Snapshot(const Hash& blockHash)
+{
+	return m_leafSet.Snapshot(blockHash);
+}
+
 Roaring OutputPMMR::DetermineLeavesToRemove(const uint64_t cutoffSize, const Roaring& rewindRmPos) const
 {	
 	return m_leafSet.CalculatePrunedPositions(cutoffSize, rewindRmPos, m_pruneList);
@@ -21,12 +21,17 @@ public:
 	void Compact();
 
 	virtual Hash Root(const uint64_t mmrIndex) const override final;
-	virtual std::unique_ptr<Hash> GetHashAt(const uint64_t mmrIndex) const override final;
+	virtual std::optional<Hash> GetHashAt(const uint64_t mmrIndex) const override final;
 	virtual uint64_t GetSize() const override final;
 
 	virtual bool Rewind(const uint64_t lastMMRIndex) override final;
 	virtual bool Flush() override final;
 
+	//
+	// Saves a copy of the leaf set, named after the given block, alongside the live leaf set.
+	//
+	bool Snapshot(const Hash& blockHash);
+
 	std::unique_ptr<OutputIdentifier> GetOutputAt(const uint64_t mmrIndex) const;
 
 private:
@@ -43,16 +43,16 @@ Hash RangeProofPMMR::Root(const uint64_t size) const
 	const std::vector<uint64_t> peakIndices = MMRUtil::GetPeakIndices(size);
 	for (auto iter = peakIndices.crbegin(); iter != peakIndices.crend(); iter++)
 	{
-		std::unique_ptr<Hash> pHash = GetHashAt(*iter);
-		if (pHash != nullptr)
+		const std::optional<Hash> peakHash = GetHashAt(*iter);
+		if (peakHash.has_value())
 		{
 			if (hash == ZERO_HASH)
 			{
-				hash = *pHash;
+				hash = peakHash.value();
 			}
 			else
 			{
-				hash = MMRUtil::HashParentWithIndex(*pHash, hash, size);
+				hash = MMRUtil::HashParentWithIndex(peakHash.value(), hash, size);
 			}
 		}
 	}
@@ -60,17 +60,44 @@ Hash RangeProofPMMR::Root(const uint64_t size) const
 	return hash;
 }
 
-std::unique_ptr<Hash> RangeProofPMMR::GetHashAt(const uint64_t mmrIndex) const
+std::optional<Hash> RangeProofPMMR::GetHashAt(const uint64_t mmrIndex) const
 {
 	if (m_pruneList.IsPruned(mmrIndex) && !m_pruneList.IsPrunedRoot(mmrIndex))
 	{
-		return std::unique_ptr<Hash>(nullptr);
+		return std::nullopt;
 	}
 
 	const uint64_t shift = m_pruneList.GetShift(mmrIndex);
 	const uint64_t shiftedIndex = (mmrIndex - shift);
 
-	return std::make_unique<Hash>(m_hashFile.GetHashAt(shiftedIndex));
+	return std::make_optional<Hash>(m_hashFile.GetHashAt(shiftedIndex));
+}
+
+std::unique_ptr<RangeProof> RangeProofPMMR::GetRangeProofAt(const uint64_t mmrIndex) const
+{
+	if (MMRUtil::IsLeaf(mmrIndex))
+	{
+		if (m_leafSet.Contains(mmrIndex))
+		{
+			if (m_pruneList.IsPruned(mmrIndex) && !m_pruneList.IsPrunedRoot(mmrIndex))
+			{
+				return std::unique_ptr<RangeProof>(nullptr);
+			}
+
+			const uint64_t shift = m_pruneList.GetLeafShift(mmrIndex);
+			const uint64_t numLeaves = MMRUtil::GetNumLeaves(mmrIndex);
+			const uint64_t shiftedIndex = ((numLeaves - 1) - shift);
+
+			const ByteSpan data = m_dataFile.GetDataAt(shiftedIndex);
+			if (data.size() == RANGE_PROOF_SIZE)
+			{
+				ByteBuffer byteBuffer(data);
+				return std::make_unique<RangeProof>(RangeProof::Deserialize(byteBuffer));
+			}
+		}
+	}
+
+	return std::unique_ptr<RangeProof>(nullptr);
 }
 
 uint64_t RangeProofPMMR::GetSize() const
@@ -98,4 +125,9 @@ bool RangeProofPMMR::Flush()
 	const bool pruneFlush = m_pruneList.Flush();
 
 	return hashFlush && dataFlush && leafSetFlush && pruneFlush;
+}
+
+bool RangeProofPMMR::Snapshot(const Hash& blockHash)
+{
+	return m_leafSet.Snapshot(blockHash);
 }
\ No newline at end of file
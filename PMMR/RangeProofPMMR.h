@@ -7,6 +7,7 @@
 #include "Common/HashFile.h"
 #include "Common/DataFile.h"
 
+#include <Crypto/RangeProof.h>
 #include <Config/Config.h>
 
 #define RANGE_PROOF_SIZE 683
@@ -17,12 +18,19 @@ public:
 	static RangeProofPMMR* Load(const Config& config);
 
 	virtual Hash Root(const uint64_t mmrIndex) const override final;
-	virtual std::unique_ptr<Hash> GetHashAt(const uint64_t mmrIndex) const override final;
+	virtual std::optional<Hash> GetHashAt(const uint64_t mmrIndex) const override final;
 	virtual uint64_t GetSize() const override final;
 
 	virtual bool Rewind(const uint64_t lastMMRIndex) override final;
 	virtual bool Flush() override final;
 
+	//
+	// Saves a copy of the leaf set, named after the given block, alongside the live leaf set.
+	//
+	bool Snapshot(const Hash& blockHash);
+
+	std::unique_ptr<RangeProof> GetRangeProofAt(const uint64_t mmrIndex) const;
+
 private:
 	RangeProofPMMR(const Config& config, HashFile&& hashFile, LeafSet&& leafSet, PruneList&& pruneList, DataFile<RANGE_PROOF_SIZE>&& dataFile);
 
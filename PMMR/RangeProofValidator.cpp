@@ -0,0 +1,66 @@
+#include "RangeProofValidator.h"
+
+#include <Infrastructure/Logger.h>
+#include <Crypto.h>
+#include <async++.h>
+#include <atomic>
+#include <algorithm>
+
+// Number of consecutive output MMR nodes (roughly half as many outputs) whose range proofs are verified together.
+static const uint64_t RANGE_PROOF_BATCH_MMR_SIZE = 2048;
+
+//
+// Splits the output MMR into ranges and verifies the range proofs of each range's unspent outputs with a single
+// bulletproof multi-verification on the Async++ threadpool.
+//
+bool RangeProofValidator::ValidateRangeProofs(const OutputPMMR& outputPMMR, const RangeProofPMMR& rangeProofPMMR, const uint64_t mmrSize) const
+{
+	const uint64_t numBatches = (mmrSize + RANGE_PROOF_BATCH_MMR_SIZE - 1) / RANGE_PROOF_BATCH_MMR_SIZE;
+
+	std::atomic_bool valid = true;
+	async::parallel_for(async::irange((uint64_t)0, numBatches), [this, &outputPMMR, &rangeProofPMMR, mmrSize, &valid](const uint64_t batch)
+	{
+		if (valid)
+		{
+			const uint64_t firstIndex = batch * RANGE_PROOF_BATCH_MMR_SIZE;
+			const uint64_t lastIndex = std::min(mmrSize, firstIndex + RANGE_PROOF_BATCH_MMR_SIZE);
+			if (!this->ValidateRangeProofRange(outputPMMR, rangeProofPMMR, firstIndex, lastIndex))
+			{
+				valid = false;
+			}
+		}
+	});
+
+	return valid;
+}
+
+bool RangeProofValidator::ValidateRangeProofRange(const OutputPMMR& outputPMMR, const RangeProofPMMR& rangeProofPMMR, const uint64_t firstIndex, const uint64_t lastIndex) const
+{
+	std::vector<Commitment> commitments;
+	std::vector<RangeProof> rangeProofs;
+
+	for (uint64_t i = firstIndex; i < lastIndex; i++)
+	{
+		std::unique_ptr<OutputIdentifier> pOutput = outputPMMR.GetOutputAt(i);
+		if (pOutput != nullptr)
+		{
+			std::unique_ptr<RangeProof> pRangeProof = rangeProofPMMR.GetRangeProofAt(i);
+			if (pRangeProof == nullptr)
+			{
+				LoggerAPI::LogError("RangeProofValidator::ValidateRangeProofs - No range proof found for output at index " + std::to_string(i));
+				return false;
+			}
+
+			commitments.push_back(pOutput->GetCommitment());
+			rangeProofs.emplace_back(std::move(*pRangeProof));
+		}
+	}
+
+	if (!Crypto::VerifyRangeProofs(commitments, rangeProofs))
+	{
+		LoggerAPI::LogError("RangeProofValidator::ValidateRangeProofs - Failed to verify range proofs between indices " + std::to_string(firstIndex) + " and " + std::to_string(lastIndex));
+		return false;
+	}
+
+	return true;
+}
\ No newline at end of file
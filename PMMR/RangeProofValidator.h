@@ -0,0 +1,13 @@
+#pragma once
+
+#include "OutputPMMR.h"
+#include "RangeProofPMMR.h"
+
+class RangeProofValidator
+{
+public:
+	bool ValidateRangeProofs(const OutputPMMR& outputPMMR, const RangeProofPMMR& rangeProofPMMR, const uint64_t mmrSize) const;
+
+private:
+	bool ValidateRangeProofRange(const OutputPMMR& outputPMMR, const RangeProofPMMR& rangeProofPMMR, const uint64_t firstIndex, const uint64_t lastIndex) const;
+};
\ No newline at end of file
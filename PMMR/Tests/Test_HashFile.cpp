@@ -0,0 +1,116 @@
+#include <Catch2/catch.hpp>
+
+#include "../Common/HashFile.h"
+
+#include <chrono>
+#include <filesystem>
+
+static std::string GetTestFilePath(const std::string& fileName)
+{
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / fileName;
+	std::filesystem::remove(path);
+
+	return path.string();
+}
+
+static Hash CreateHash(const uint64_t value)
+{
+	Hash hash;
+	for (size_t i = 0; i < sizeof(uint64_t); i++)
+	{
+		hash[(int)(HASH_SIZE - 1 - i)] = (unsigned char)(value >> (8 * i));
+	}
+
+	return hash;
+}
+
+TEST_CASE("HashFile - Append, Flush, Rewind and Reload")
+{
+	const std::string path = GetTestFilePath("Test_HashFile.bin");
+
+	{
+		HashFile hashFile(path);
+		REQUIRE(!hashFile.Load());
+
+		std::vector<Hash> hashes;
+		for (uint64_t i = 0; i < 100; i++)
+		{
+			hashes.push_back(CreateHash(i));
+		}
+
+		hashFile.AddHashes(hashes);
+		REQUIRE(hashFile.GetSize() == 100);
+		REQUIRE(hashFile.GetHashAt(42) == CreateHash(42));
+
+		REQUIRE(hashFile.Flush());
+		REQUIRE(hashFile.GetSize() == 100);
+		REQUIRE(hashFile.GetHashAt(42) == CreateHash(42));
+		REQUIRE(hashFile.GetHashAt(99) == CreateHash(99));
+
+		hashFile.AddHash(CreateHash(1000));
+		REQUIRE(hashFile.GetHashAt(100) == CreateHash(1000));
+		REQUIRE(hashFile.Flush());
+
+		REQUIRE(hashFile.Rewind(50));
+		hashFile.AddHash(CreateHash(2000));
+		REQUIRE(hashFile.Flush());
+		REQUIRE(hashFile.GetSize() == 51);
+		REQUIRE(hashFile.GetHashAt(49) == CreateHash(49));
+		REQUIRE(hashFile.GetHashAt(50) == CreateHash(2000));
+	}
+
+	HashFile reloaded(path);
+	REQUIRE(reloaded.Load());
+	REQUIRE(reloaded.GetSize() == 51);
+	REQUIRE(reloaded.GetHashAt(0) == CreateHash(0));
+	REQUIRE(reloaded.GetHashAt(50) == CreateHash(2000));
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("HashFile - AddHashes and Flush 10M hashes", "[.benchmark]")
+{
+	const std::string path = GetTestFilePath("Bench_HashFile.bin");
+
+	const uint64_t totalHashes = 10000000;
+	const uint64_t hashesPerFlush = 10000;
+
+	std::vector<Hash> hashes;
+	hashes.reserve(hashesPerFlush);
+
+	HashFile hashFile(path);
+	hashFile.Load();
+
+	std::chrono::nanoseconds addDuration(0);
+	std::chrono::nanoseconds flushDuration(0);
+	std::chrono::nanoseconds maxFlushDuration(0);
+	for (uint64_t i = 0; i < totalHashes; i += hashesPerFlush)
+	{
+		hashes.clear();
+		for (uint64_t j = i; j < i + hashesPerFlush; j++)
+		{
+			hashes.push_back(CreateHash(j));
+		}
+
+		const auto addStart = std::chrono::steady_clock::now();
+		hashFile.AddHashes(hashes);
+		const auto flushStart = std::chrono::steady_clock::now();
+		REQUIRE(hashFile.Flush());
+		const auto flushEnd = std::chrono::steady_clock::now();
+
+		addDuration += (flushStart - addStart);
+		flushDuration += (flushEnd - flushStart);
+		maxFlushDuration = std::max(maxFlushDuration, std::chrono::nanoseconds(flushEnd - flushStart));
+	}
+
+	REQUIRE(hashFile.GetSize() == totalHashes);
+	REQUIRE(hashFile.GetHashAt(totalHashes - 1) == CreateHash(totalHashes - 1));
+
+	const uint64_t numFlushes = totalHashes / hashesPerFlush;
+	WARN("AddHashes: " << std::chrono::duration_cast<std::chrono::milliseconds>(addDuration).count() << "ms total");
+	WARN("Flush: " << std::chrono::duration_cast<std::chrono::milliseconds>(flushDuration).count() << "ms total, "
+		<< std::chrono::duration_cast<std::chrono::microseconds>(flushDuration).count() / numFlushes << "us average, "
+		<< std::chrono::duration_cast<std::chrono::microseconds>(maxFlushDuration).count() << "us max");
+
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,116 @@
+#include <Catch2/catch.hpp>
+
+#include "../MMRHashStreamValidator.h"
+#include "../Common/MMRUtil.h"
+
+#include <filesystem>
+
+static Hash CreateHash(const uint64_t value)
+{
+	Hash hash;
+	for (size_t i = 0; i < sizeof(uint64_t); i++)
+	{
+		hash[(int)(HASH_SIZE - 1 - i)] = (unsigned char)(value >> (8 * i));
+	}
+
+	return hash;
+}
+
+static std::vector<Hash> BuildMMR(const uint64_t size)
+{
+	std::vector<Hash> hashes;
+	for (uint64_t i = 0; i < size; i++)
+	{
+		const uint64_t height = MMRUtil::GetHeight(i);
+		if (height == 0)
+		{
+			hashes.push_back(CreateHash(i));
+		}
+		else
+		{
+			const Hash& left = hashes[MMRUtil::GetLeftChildIndex(i, height)];
+			const Hash& right = hashes[MMRUtil::GetRightChildIndex(i)];
+			hashes.push_back(MMRUtil::HashParentWithIndex(left, right, i));
+		}
+	}
+
+	return hashes;
+}
+
+static std::vector<unsigned char> Serialize(const std::vector<Hash>& hashes, const size_t firstIndex)
+{
+	std::vector<unsigned char> bytes;
+	for (size_t i = firstIndex; i < hashes.size(); i++)
+	{
+		bytes.insert(bytes.end(), hashes[i].GetData().cbegin(), hashes[i].GetData().cend());
+	}
+
+	return bytes;
+}
+
+static bool AppendInChunks(MMRHashStreamValidator& validator, const std::vector<unsigned char>& bytes, const size_t chunkSize)
+{
+	for (size_t offset = 0; offset < bytes.size(); offset += chunkSize)
+	{
+		if (!validator.Append(&bytes[offset], std::min(chunkSize, bytes.size() - offset)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+TEST_CASE("MMRHashStreamValidator - Unpruned")
+{
+	// 26 leaves (peaks of height 4, 3 and 1)
+	const std::vector<Hash> hashes = BuildMMR(49);
+	const std::vector<unsigned char> bytes = Serialize(hashes, 0);
+
+	for (const size_t chunkSize : { (size_t)7, (size_t)32, (size_t)100, bytes.size() })
+	{
+		MMRHashStreamValidator validator(hashes.size(), nullptr);
+		REQUIRE(AppendInChunks(validator, bytes, chunkSize));
+		REQUIRE(validator.IsComplete());
+	}
+
+	// Hashes past the MMR size are ignored.
+	MMRHashStreamValidator partialValidator(46, nullptr);
+	REQUIRE(AppendInChunks(partialValidator, bytes, 64));
+	REQUIRE(partialValidator.IsComplete());
+
+	// Missing hashes
+	MMRHashStreamValidator incompleteValidator(hashes.size(), nullptr);
+	REQUIRE(incompleteValidator.Append(&bytes[0], bytes.size() - HASH_SIZE));
+	REQUIRE(!incompleteValidator.IsComplete());
+}
+
+TEST_CASE("MMRHashStreamValidator - Invalid parent")
+{
+	std::vector<Hash> hashes = BuildMMR(49);
+	hashes[29] = CreateHash(12345);
+	const std::vector<unsigned char> bytes = Serialize(hashes, 0);
+
+	MMRHashStreamValidator validator(hashes.size(), nullptr);
+	REQUIRE(!AppendInChunks(validator, bytes, 100));
+	REQUIRE(!validator.IsComplete());
+}
+
+TEST_CASE("MMRHashStreamValidator - Pruned")
+{
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "Test_MMRHashStreamValidator_prun.bin";
+	std::filesystem::remove(path);
+
+	// Pruning the first two leaves leaves their parent (index 2) as a pruned root.
+	PruneList pruneList = PruneList::Load(path.string());
+	pruneList.Add(0);
+	pruneList.Add(1);
+	REQUIRE(pruneList.IsPrunedRoot(2));
+
+	const std::vector<Hash> hashes = BuildMMR(15);
+	const std::vector<unsigned char> bytes = Serialize(hashes, 2);
+
+	MMRHashStreamValidator validator(hashes.size(), &pruneList);
+	REQUIRE(AppendInChunks(validator, bytes, 20));
+	REQUIRE(validator.IsComplete());
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include <Catch2/catch.hpp>
+
+#include "../RangeProofValidator.h"
+#include "../Common/MMRUtil.h"
+
+#include <Config/Genesis.h>
+#include <Serialization/Serializer.h>
+#include <FileUtil.h>
+#include <BitUtil.h>
+#include <Crypto.h>
+#include <filesystem>
+#include <memory>
+#include <set>
+
+static Config CreateConfig(const std::string& testName)
+{
+	const std::string dataPath = (std::filesystem::temp_directory_path() / testName).string() + "/";
+	std::filesystem::remove_all(dataPath);
+
+	const Environment environment(EEnvironmentType::FLOONET, Genesis::FLOONET_GENESIS, { 83, 59 }, 13414, BitUtil::ConvertToU32(0x03, 0x3C, 0x04, 0xA4), BitUtil::ConvertToU32(0x03, 0x3C, 0x08, 0xDF));
+	return Config(EClientMode::FAST_SYNC, environment, dataPath, DandelionConfig(10, 180, 15, 90), P2PConfig(), DatabaseConfig());
+}
+
+//
+// Writes the data files and leaf sets of an output PMMR and a rangeproof PMMR with one leaf per commitment, all sharing the genesis range proof.
+// Spent leaves are left out of both leaf sets, and leaves in missingProofs are left out of the rangeproof leaf set only.
+// Returns the size of the MMRs.
+//
+static uint64_t WriteMMRs(const Config& config, const std::vector<Commitment>& commitments, const std::set<uint64_t>& spent, const std::set<uint64_t>& missingProofs)
+{
+	const TransactionOutput& genesisOutput = Genesis::MAINNET_GENESIS.GetTransactionBody().GetOutputs().front();
+	const std::string txHashSetDir = config.GetTxHashSetDirectory();
+
+	Serializer outputSerializer;
+	Serializer rangeProofSerializer;
+	LeafSet outputLeafSet(txHashSetDir + "output/pmmr_leaf.bin");
+	LeafSet rangeProofLeafSet(txHashSetDir + "rangeproof/pmmr_leaf.bin");
+
+	for (uint64_t leafIndex = 0; leafIndex < commitments.size(); leafIndex++)
+	{
+		OutputIdentifier(genesisOutput.GetFeatures(), Commitment(commitments[leafIndex])).Serialize(outputSerializer);
+		genesisOutput.GetRangeProof().Serialize(rangeProofSerializer);
+
+		const uint32_t mmrIndex = (uint32_t)MMRUtil::GetPMMRIndex(leafIndex);
+		if (spent.count(leafIndex) == 0)
+		{
+			outputLeafSet.Add(mmrIndex);
+			if (missingProofs.count(leafIndex) == 0)
+			{
+				rangeProofLeafSet.Add(mmrIndex);
+			}
+		}
+	}
+
+	REQUIRE(FileUtil::SafeWriteToFile(txHashSetDir + "output/pmmr_data.bin", outputSerializer.GetBytes()));
+	REQUIRE(FileUtil::SafeWriteToFile(txHashSetDir + "rangeproof/pmmr_data.bin", rangeProofSerializer.GetBytes()));
+	REQUIRE(outputLeafSet.Flush());
+	REQUIRE(rangeProofLeafSet.Flush());
+
+	return MMRUtil::GetPMMRIndex(commitments.size());
+}
+
+static bool ValidateRangeProofs(const Config& config, const uint64_t mmrSize)
+{
+	std::unique_ptr<OutputPMMR> pOutputPMMR(OutputPMMR::Load(config));
+	std::unique_ptr<RangeProofPMMR> pRangeProofPMMR(RangeProofPMMR::Load(config));
+
+	return RangeProofValidator().ValidateRangeProofs(*pOutputPMMR, *pRangeProofPMMR, mmrSize);
+}
+
+TEST_CASE("RangeProofPMMR::GetRangeProofAt")
+{
+	const Config config = CreateConfig("Test_GetRangeProofAt");
+	const TransactionOutput& genesisOutput = Genesis::MAINNET_GENESIS.GetTransactionBody().GetOutputs().front();
+
+	const std::vector<Commitment> commitments(3, genesisOutput.GetCommitment());
+	WriteMMRs(config, commitments, { 1 }, {});
+
+	std::unique_ptr<RangeProofPMMR> pRangeProofPMMR(RangeProofPMMR::Load(config));
+
+	// Leaves 0 and 2 are at MMR indices 0 and 3, with leaf 1 at index 1 and their parent at index 2.
+	std::unique_ptr<RangeProof> pRangeProof = pRangeProofPMMR->GetRangeProofAt(0);
+	REQUIRE(pRangeProof != nullptr);
+	REQUIRE(pRangeProof->GetProofBytes() == genesisOutput.GetRangeProof().GetProofBytes());
+
+	pRangeProof = pRangeProofPMMR->GetRangeProofAt(3);
+	REQUIRE(pRangeProof != nullptr);
+	REQUIRE(pRangeProof->GetProofBytes() == genesisOutput.GetRangeProof().GetProofBytes());
+
+	REQUIRE(pRangeProofPMMR->GetRangeProofAt(1) == nullptr);
+	REQUIRE(pRangeProofPMMR->GetRangeProofAt(2) == nullptr);
+	REQUIRE(pRangeProofPMMR->GetRangeProofAt(4) == nullptr);
+}
+
+TEST_CASE("RangeProofValidator::ValidateRangeProofs")
+{
+	const Config config = CreateConfig("Test_ValidateRangeProofs");
+	const TransactionOutput& genesisOutput = Genesis::MAINNET_GENESIS.GetTransactionBody().GetOutputs().front();
+	const Commitment otherCommitment = *Crypto::CommitTransparent(1);
+
+	// Enough outputs to be split across several batches.
+	const size_t numLeaves = 2500;
+	std::vector<Commitment> commitments(numLeaves, genesisOutput.GetCommitment());
+
+	SECTION("Valid")
+	{
+		const uint64_t mmrSize = WriteMMRs(config, commitments, { 0, 7, 1500 }, {});
+		REQUIRE(ValidateRangeProofs(config, mmrSize));
+	}
+
+	SECTION("Empty")
+	{
+		REQUIRE(ValidateRangeProofs(config, 0));
+	}
+
+	SECTION("Invalid proof of a spent output is ignored")
+	{
+		commitments[2000] = otherCommitment;
+		const uint64_t mmrSize = WriteMMRs(config, commitments, { 2000 }, {});
+		REQUIRE(ValidateRangeProofs(config, mmrSize));
+	}
+
+	SECTION("Invalid proof in a later batch")
+	{
+		commitments[2000] = otherCommitment;
+		const uint64_t mmrSize = WriteMMRs(config, commitments, {}, {});
+		REQUIRE(!ValidateRangeProofs(config, mmrSize));
+	}
+
+	SECTION("Missing proof")
+	{
+		const uint64_t mmrSize = WriteMMRs(config, commitments, {}, { 10 });
+		REQUIRE(!ValidateRangeProofs(config, mmrSize));
+	}
+}
\ No newline at end of file
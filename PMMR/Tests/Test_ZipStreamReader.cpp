@@ -0,0 +1,177 @@
+#include <Catch2/catch.hpp>
+
+#include "../Zip/ZipStreamReader.h"
+#include "minizip/zip.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+class TestEntryHandler : public IZipEntryHandler
+{
+public:
+	virtual bool OnEntryBegin(const std::string& path) override final
+	{
+		m_currentPath = path;
+		m_entries[path] = std::vector<unsigned char>();
+		return true;
+	}
+
+	virtual bool OnEntryData(const unsigned char* pData, const size_t numBytes) override final
+	{
+		std::vector<unsigned char>& entry = m_entries[m_currentPath];
+		entry.insert(entry.end(), pData, pData + numBytes);
+		return true;
+	}
+
+	virtual bool OnEntryEnd(const std::string& path) override final
+	{
+		m_completed.push_back(path);
+		return path == m_currentPath;
+	}
+
+	std::string m_currentPath;
+	std::map<std::string, std::vector<unsigned char>> m_entries;
+	std::vector<std::string> m_completed;
+};
+
+static std::vector<unsigned char> CreateData(const size_t size, const bool compressible)
+{
+	std::vector<unsigned char> data(size);
+	uint32_t state = 12345;
+	for (size_t i = 0; i < size; i++)
+	{
+		state = state * 1103515245 + 12345;
+		data[i] = compressible ? (unsigned char)(i / 100) : (unsigned char)(state >> 16);
+	}
+
+	return data;
+}
+
+static std::vector<unsigned char> CreateArchive(const std::vector<std::pair<std::string, std::vector<unsigned char>>>& entries, const int method)
+{
+	const std::string zipPath = (std::filesystem::temp_directory_path() / "Test_ZipStreamReader.zip").string();
+	std::filesystem::remove(zipPath);
+
+	zipFile pZipFile = zipOpen64(zipPath.c_str(), APPEND_STATUS_CREATE);
+	REQUIRE(pZipFile != NULL);
+
+	for (const auto& entry : entries)
+	{
+		zip_fileinfo fileInfo = {};
+		const int level = (method == Z_DEFLATED) ? Z_BEST_SPEED : 0;
+		REQUIRE(zipOpenNewFileInZip64(pZipFile, entry.first.c_str(), &fileInfo, NULL, 0, NULL, 0, NULL, method, level, 0) == ZIP_OK);
+		if (!entry.second.empty())
+		{
+			REQUIRE(zipWriteInFileInZip(pZipFile, entry.second.data(), (unsigned int)entry.second.size()) == ZIP_OK);
+		}
+
+		REQUIRE(zipCloseFileInZip(pZipFile) == ZIP_OK);
+	}
+
+	REQUIRE(zipClose(pZipFile, NULL) == ZIP_OK);
+
+	std::ifstream file(zipPath, std::ios::in | std::ios::binary);
+	const std::vector<unsigned char> archive((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	file.close();
+
+	std::filesystem::remove(zipPath);
+	return archive;
+}
+
+static bool StreamArchive(const std::vector<unsigned char>& archive, const size_t chunkSize, ZipStreamReader& reader)
+{
+	for (size_t offset = 0; offset < archive.size(); offset += chunkSize)
+	{
+		if (!reader.Write(archive.data() + offset, std::min(chunkSize, archive.size() - offset)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static const std::vector<std::pair<std::string, std::vector<unsigned char>>> ENTRIES = {
+	{ "kernel/pmmr_data.bin", CreateData(200000, false) },
+	{ "kernel/pmmr_hash.bin", CreateData(150000, true) },
+	{ "output/pmmr_prun.bin", std::vector<unsigned char>() },
+	{ "output/pmmr_leaf.bin.0123456789abcdef", CreateData(33, false) }
+};
+
+TEST_CASE("ZipStreamReader - Extracts minizip archives in any chunk size")
+{
+	// 30 and 31 split every local header, and 1 splits everything.
+	const std::vector<size_t> chunkSizes = { 1, 2, 7, 30, 31, 4096, 65536, 1000000 };
+
+	for (const int method : { Z_DEFLATED, 0 })
+	{
+		const std::vector<unsigned char> archive = CreateArchive(ENTRIES, method);
+
+		for (const size_t chunkSize : chunkSizes)
+		{
+			TestEntryHandler handler;
+			ZipStreamReader reader(handler);
+			REQUIRE(StreamArchive(archive, chunkSize, reader));
+			REQUIRE(reader.IsComplete());
+
+			REQUIRE(handler.m_completed.size() == ENTRIES.size());
+			for (size_t i = 0; i < ENTRIES.size(); i++)
+			{
+				REQUIRE(handler.m_completed[i] == ENTRIES[i].first);
+				REQUIRE(handler.m_entries[ENTRIES[i].first] == ENTRIES[i].second);
+			}
+		}
+	}
+}
+
+TEST_CASE("ZipStreamReader - Truncated archive is incomplete")
+{
+	const std::vector<unsigned char> archive = CreateArchive(ENTRIES, Z_DEFLATED);
+	const std::vector<unsigned char> truncated(archive.begin(), archive.begin() + archive.size() / 2);
+
+	TestEntryHandler handler;
+	ZipStreamReader reader(handler);
+	REQUIRE(StreamArchive(truncated, 4096, reader));
+	REQUIRE(!reader.IsComplete());
+	REQUIRE(handler.m_completed.size() < ENTRIES.size());
+}
+
+TEST_CASE("ZipStreamReader - Corrupt entry data is rejected")
+{
+	for (const int method : { Z_DEFLATED, 0 })
+	{
+		std::vector<unsigned char> archive = CreateArchive(ENTRIES, method);
+
+		// Flip a byte in the middle of the first entry's data, so either inflating it or checking its CRC fails.
+		archive[1000] ^= 0xFF;
+
+		TestEntryHandler handler;
+		ZipStreamReader reader(handler);
+		REQUIRE(!StreamArchive(archive, 7, reader));
+		REQUIRE(!reader.IsComplete());
+		REQUIRE(handler.m_completed.empty());
+	}
+}
+
+TEST_CASE("ZipStreamReader - Entry larger than its declared size is rejected")
+{
+	for (const int method : { Z_DEFLATED, 0 })
+	{
+		std::vector<unsigned char> archive = CreateArchive(ENTRIES, method);
+
+		// Shrink the first entry's declared uncompressed size to 1000 bytes.
+		archive[22] = 0xE8;
+		archive[23] = 0x03;
+		archive[24] = 0x00;
+		archive[25] = 0x00;
+
+		TestEntryHandler handler;
+		ZipStreamReader reader(handler);
+		REQUIRE(!StreamArchive(archive, 4096, reader));
+		REQUIRE(!reader.IsComplete());
+		REQUIRE(handler.m_entries[ENTRIES[0].first].size() <= 1000);
+		REQUIRE(handler.m_completed.empty());
+	}
+}
\ No newline at end of file
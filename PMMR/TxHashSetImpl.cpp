@@ -26,14 +26,14 @@ bool TxHashSet::IsUnspent(const OutputIdentifier& output) const
 	const std::optional<uint64_t> mmrIndex = m_blockDB.GetOutputPosition(output.GetCommitment());
 	if (mmrIndex.has_value())
 	{
-		std::unique_ptr<Hash> pMMRHash = m_pOutputPMMR->GetHashAt(mmrIndex.value());
-		if (pMMRHash != nullptr)
+		const std::optional<Hash> mmrHash = m_pOutputPMMR->GetHashAt(mmrIndex.value());
+		if (mmrHash.has_value())
 		{
 			Serializer serializer;
 			output.Serialize(serializer);
 			const Hash outputHash = Crypto::Blake2b(serializer.GetBytes());
 
-			if (outputHash == *pMMRHash)
+			if (outputHash == mmrHash.value())
 			{
 				return true;
 			}
@@ -43,16 +43,32 @@ bool TxHashSet::IsUnspent(const OutputIdentifier& output) const
 	return false;
 }
 
+// Checks that all inputs are in the current UTXO set, and that no output is already in it.
 bool TxHashSet::IsValid(const Transaction& transaction) const
 {
-	// TODO: Implement
+	for (const TransactionInput& input : transaction.GetBody().GetInputs())
+	{
+		if (!IsUnspent(OutputIdentifier(input.GetFeatures(), Commitment(input.GetCommitment()))))
+		{
+			return false;
+		}
+	}
+
+	for (const TransactionOutput& output : transaction.GetBody().GetOutputs())
+	{
+		if (IsUnspent(OutputIdentifier(output.GetFeatures(), Commitment(output.GetCommitment()))))
+		{
+			return false;
+		}
+	}
+
 	return true;
 }
 
-bool TxHashSet::Validate(const BlockHeader& header, const IBlockChainServer& blockChainServer, Commitment& outputSumOut, Commitment& kernelSumOut)
+bool TxHashSet::Validate(const BlockHeader& header, const IBlockChainServer& blockChainServer, const bool mmrHashesVerified, Commitment& outputSumOut, Commitment& kernelSumOut)
 {
 	LoggerAPI::LogInfo("TxHashSet::Validate - Validating TxHashSet for block " + HexUtil::ConvertHash(header.GetHash()));
-	const TxHashSetValidationResult result = TxHashSetValidator(blockChainServer).Validate(*this, header, outputSumOut, kernelSumOut);
+	const TxHashSetValidationResult result = TxHashSetValidator(blockChainServer).Validate(*this, header, mmrHashesVerified, outputSumOut, kernelSumOut);
 	if (result.Successful())
 	{
 		LoggerAPI::LogInfo("TxHashSet::Validate - Successfully validated TxHashSet.");
@@ -84,24 +100,49 @@ bool TxHashSet::ApplyBlock(const FullBlock& block)
 	return true;
 }
 
+//
+// Positions are bulk loaded in chunks, which bounds memory use while keeping the number of table files ingested small.
+//
 bool TxHashSet::SaveOutputPositions()
 {
+	static const size_t POSITIONS_PER_CHUNK = 1024 * 1024;
+
+	std::vector<std::pair<Commitment, uint64_t>> outputPositions;
+	outputPositions.reserve(POSITIONS_PER_CHUNK);
+
 	const uint64_t size = m_pOutputPMMR->GetSize();
 	for (uint64_t mmrIndex = 0; mmrIndex < size; mmrIndex++)
 	{
 		std::unique_ptr<OutputIdentifier> pOutput = m_pOutputPMMR->GetOutputAt(mmrIndex);
 		if (pOutput != nullptr)
 		{
-			m_blockDB.AddOutputPosition(pOutput->GetCommitment(), mmrIndex);
+			outputPositions.emplace_back(pOutput->GetCommitment(), mmrIndex);
+		}
+
+		if (outputPositions.size() == POSITIONS_PER_CHUNK || (mmrIndex + 1 == size && !outputPositions.empty()))
+		{
+			if (!m_blockDB.AddOutputPositions(outputPositions))
+			{
+				return false;
+			}
+
+			outputPositions.clear();
 		}
 	}
 
 	return true;
 }
 
+//
+// The hash, data and prune files can be copied as they are, but leaf sets can't be rewound,
+// so the output and rangeproof leaf sets are saved as pmmr_leaf.bin.<block hash>.
+//
 bool TxHashSet::Snapshot(const BlockHeader& header)
 {
-	return true;
+	const bool outputSnapshot = m_pOutputPMMR->Snapshot(header.GetHash());
+	const bool rangeProofSnapshot = m_pRangeProofPMMR->Snapshot(header.GetHash());
+
+	return outputSnapshot && rangeProofSnapshot;
 }
 
 bool TxHashSet::Rewind(const BlockHeader& header)
@@ -2,10 +2,17 @@
 
 #include "TxHashSetImpl.h"
 #include "Zip/TxHashSetZip.h"
+#include "Zip/TxHashSetZipStream.h"
 
 #include <FileUtil.h>
+#include <HexUtil.h>
 #include <StringUtil.h>
 #include <Infrastructure/Logger.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+static const size_t COPY_BUFFER_SIZE = 1024 * 1024;
 
 TxHashSetManager::TxHashSetManager(const Config& config, IBlockDB& blockDB)
 	: m_config(config), m_blockDB(blockDB), m_pTxHashSet(nullptr)
@@ -42,22 +49,73 @@ ITxHashSet* TxHashSetManager::LoadFromZip(const Config& config, IBlockDB& blockD
 		LoggerAPI::LogInfo(StringUtil::Format("TxHashSetAPI::LoadFromZip - %s extracted successfully.", zipFilePath.c_str()));
 		FileUtil::RemoveFile(zipFilePath);
 
-		KernelMMR* pKernelMMR = KernelMMR::Load(config);
-		pKernelMMR->Rewind(blockHeader.GetKernelMMRSize());
-		pKernelMMR->Flush();
+		return LoadExtracted(config, blockDB, blockHeader);
+	}
+
+	return nullptr;
+}
 
-		OutputPMMR* pOutputPMMR = OutputPMMR::Load(config);
-		pOutputPMMR->Rewind(blockHeader.GetOutputMMRSize());
-		pOutputPMMR->Flush();
+// Size of the chunks handed from the downloading thread to the extraction thread.
+static const size_t STREAM_CHUNK_SIZE = 65536;
 
-		RangeProofPMMR* pRangeProofPMMR = RangeProofPMMR::Load(config);
-		pRangeProofPMMR->Rewind(blockHeader.GetOutputMMRSize());
-		pRangeProofPMMR->Flush();
+ITxHashSet* TxHashSetManager::LoadFromStream(const Config& config, IBlockDB& blockDB, const BlockHeader& blockHeader, const uint64_t zippedSize, const std::function<size_t(unsigned char*, const size_t)>& readChunk, EStreamFailure& failure)
+{
+	TxHashSetZipStream zipStream(config, blockHeader);
+	if (!zipStream.Open())
+	{
+		failure = EStreamFailure::LOCAL_FAILURE;
+		return nullptr;
+	}
 
-		return new TxHashSet(blockDB, pKernelMMR, pOutputPMMR, pRangeProofPMMR); // TODO: Just call Rewind(BlockHeader) on TxHashSet instead of each MMR
+	uint64_t bytesReceived = 0;
+	while (bytesReceived < zippedSize)
+	{
+		std::vector<unsigned char> chunk((size_t)std::min((uint64_t)STREAM_CHUNK_SIZE, zippedSize - bytesReceived));
+		const size_t chunkSize = readChunk(chunk.data(), chunk.size());
+		if (chunkSize == 0)
+		{
+			LoggerAPI::LogError("TxHashSetManager::LoadFromStream - Transmission ended abruptly.");
+			failure = EStreamFailure::TRANSFER_FAILED;
+			return nullptr;
+		}
+
+		chunk.resize(chunkSize);
+		bytesReceived += chunkSize;
+
+		// Stop downloading as soon as the archive is known to be bad.
+		if (!zipStream.Write(std::move(chunk)))
+		{
+			LoggerAPI::LogError("TxHashSetManager::LoadFromStream - Extraction failed.");
+			failure = zipStream.HasLocalFailure() ? EStreamFailure::LOCAL_FAILURE : EStreamFailure::INVALID_ARCHIVE;
+			return nullptr;
+		}
 	}
 
-	return nullptr;
+	if (!zipStream.Finish())
+	{
+		failure = zipStream.HasLocalFailure() ? EStreamFailure::LOCAL_FAILURE : EStreamFailure::INVALID_ARCHIVE;
+		return nullptr;
+	}
+
+	LoggerAPI::LogInfo(StringUtil::Format("TxHashSetManager::LoadFromStream - %llu bytes extracted successfully.", zippedSize));
+	return LoadExtracted(config, blockDB, blockHeader);
+}
+
+ITxHashSet* TxHashSetManager::LoadExtracted(const Config& config, IBlockDB& blockDB, const BlockHeader& blockHeader)
+{
+	KernelMMR* pKernelMMR = KernelMMR::Load(config);
+	pKernelMMR->Rewind(blockHeader.GetKernelMMRSize());
+	pKernelMMR->Flush();
+
+	OutputPMMR* pOutputPMMR = OutputPMMR::Load(config);
+	pOutputPMMR->Rewind(blockHeader.GetOutputMMRSize());
+	pOutputPMMR->Flush();
+
+	RangeProofPMMR* pRangeProofPMMR = RangeProofPMMR::Load(config);
+	pRangeProofPMMR->Rewind(blockHeader.GetOutputMMRSize());
+	pRangeProofPMMR->Flush();
+
+	return new TxHashSet(blockDB, pKernelMMR, pOutputPMMR, pRangeProofPMMR); // TODO: Just call Rewind(BlockHeader) on TxHashSet instead of each MMR
 }
 
 ITxHashSet* TxHashSetManager::GetTxHashSet()
@@ -81,6 +139,114 @@ void TxHashSetManager::DestroyTxHashSet(ITxHashSet* pTxHashSet)
 	delete pTxHashSet;
 }
 
+bool TxHashSetManager::SaveSnapshot(const BlockHeader& header, const std::string& snapshotDir, std::vector<std::pair<std::string, uint64_t>>& filesToCopy)
+{
+	if (m_pTxHashSet == nullptr)
+	{
+		return false;
+	}
+
+	m_pTxHashSet->Commit();
+	if (!m_pTxHashSet->Snapshot(header))
+	{
+		LoggerAPI::LogError("TxHashSetManager::SaveSnapshot - Failed to snapshot leaf sets for " + header.FormatHash());
+		return false;
+	}
+
+	std::error_code errorCode;
+	std::filesystem::remove_all(snapshotDir, errorCode);
+
+	filesToCopy.clear();
+
+	const std::string txHashSetDir = m_config.GetTxHashSetDirectory();
+	const std::string leafFile = "pmmr_leaf.bin." + HexUtil::ConvertHash(header.GetHash());
+	for (const std::string& folder : { "kernel/", "output/", "rangeproof/" })
+	{
+		if (!std::filesystem::create_directories(snapshotDir + folder, errorCode))
+		{
+			LoggerAPI::LogError("TxHashSetManager::SaveSnapshot - Failed to create " + snapshotDir + folder);
+			return false;
+		}
+
+		for (const std::string& file : { "pmmr_data.bin", "pmmr_hash.bin" })
+		{
+			const uint64_t fileSize = std::filesystem::file_size(txHashSetDir + folder + file, errorCode);
+			if (errorCode)
+			{
+				LoggerAPI::LogError("TxHashSetManager::SaveSnapshot - Failed to read size of " + folder + file);
+				return false;
+			}
+
+			filesToCopy.emplace_back(std::make_pair(folder + file, fileSize));
+		}
+
+		if (folder != "kernel/")
+		{
+			// The prune list is only written once something has been pruned, but archives must always include one.
+			const std::string pruneFile = folder + "pmmr_prun.bin";
+			if (std::filesystem::exists(txHashSetDir + pruneFile))
+			{
+				std::filesystem::copy_file(txHashSetDir + pruneFile, snapshotDir + pruneFile, errorCode);
+			}
+			else
+			{
+				PruneList::Load(snapshotDir + pruneFile).Flush();
+			}
+
+			// The leaf set snapshot is moved, not copied, so it doesn't linger in the live TxHashSet directory.
+			if (!FileUtil::RenameFile(txHashSetDir + folder + leafFile, snapshotDir + folder + leafFile) || !std::filesystem::exists(snapshotDir + pruneFile))
+			{
+				LoggerAPI::LogError("TxHashSetManager::SaveSnapshot - Failed to copy " + folder + " leaf set or prune list.");
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool TxHashSetManager::CopySnapshotFiles(const Config& config, const std::string& snapshotDir, const std::vector<std::pair<std::string, uint64_t>>& filesToCopy)
+{
+	const std::string txHashSetDir = config.GetTxHashSetDirectory();
+	std::vector<char> buffer(COPY_BUFFER_SIZE);
+
+	for (const std::pair<std::string, uint64_t>& fileToCopy : filesToCopy)
+	{
+		std::ifstream inFile(txHashSetDir + fileToCopy.first, std::ios::in | std::ios::binary);
+		std::ofstream outFile(snapshotDir + fileToCopy.first, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!inFile.is_open() || !outFile.is_open())
+		{
+			LoggerAPI::LogError("TxHashSetManager::CopySnapshotFiles - Failed to open " + fileToCopy.first);
+			return false;
+		}
+
+		uint64_t bytesCopied = 0;
+		while (bytesCopied < fileToCopy.second)
+		{
+			const size_t bytesToCopy = (size_t)std::min((uint64_t)buffer.size(), fileToCopy.second - bytesCopied);
+			if (!inFile.read(buffer.data(), bytesToCopy) || !outFile.write(buffer.data(), bytesToCopy))
+			{
+				LoggerAPI::LogError("TxHashSetManager::CopySnapshotFiles - Failed to copy " + fileToCopy.first);
+				return false;
+			}
+
+			bytesCopied += bytesToCopy;
+		}
+	}
+
+	return true;
+}
+
+bool TxHashSetManager::ZipSnapshot(const Config& config, const BlockHeader& header, const std::string& snapshotDir, const std::string& zipPath)
+{
+	const bool compressed = TxHashSetZip(config).Compress(snapshotDir, zipPath, header);
+
+	std::error_code errorCode;
+	std::filesystem::remove_all(snapshotDir, errorCode);
+
+	return compressed;
+}
+
 void TxHashSetManager::Close()
 {
 	delete m_pTxHashSet;
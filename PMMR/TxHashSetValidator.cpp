@@ -5,11 +5,14 @@
 #include "Common/MMRUtil.h"
 #include "KernelSumValidator.h"
 #include "KernelSignatureValidator.h"
+#include "RangeProofValidator.h"
 
 #include <HexUtil.h>
 #include <Infrastructure/Logger.h>
 #include <BlockChainServer.h>
 #include <async++.h>
+#include <atomic>
+#include <algorithm>
 
 TxHashSetValidator::TxHashSetValidator(const IBlockChainServer& blockChainServer)
 	: m_blockChainServer(blockChainServer)
@@ -18,7 +21,7 @@ TxHashSetValidator::TxHashSetValidator(const IBlockChainServer& blockChainServer
 }
 
 // TODO: Where do we validate the data in MMR actually hashes to HashFile's hash?
-TxHashSetValidationResult TxHashSetValidator::Validate(TxHashSet& txHashSet, const BlockHeader& blockHeader, Commitment& outputSumOut, Commitment& kernelSumOut) const
+TxHashSetValidationResult TxHashSetValidator::Validate(TxHashSet& txHashSet, const BlockHeader& blockHeader, const bool mmrHashesVerified, Commitment& outputSumOut, Commitment& kernelSumOut) const
 {
 	const KernelMMR& kernelMMR = *txHashSet.GetKernelMMR();
 	const OutputPMMR& outputPMMR = *txHashSet.GetOutputPMMR();
@@ -31,20 +34,23 @@ TxHashSetValidationResult TxHashSetValidator::Validate(TxHashSet& txHashSet, con
 		return TxHashSetValidationResult::Fail();
 	}
 
-	// Validate MMR hashes in parallel
-	async::task<bool> kernelTask = async::spawn([this, &kernelMMR] { return this->ValidateMMRHashes(kernelMMR); });
-	async::task<bool> outputTask = async::spawn([this, &outputPMMR] { return this->ValidateMMRHashes(outputPMMR); });
-	async::task<bool> rangeProofTask = async::spawn([this, &rangeProofPMMR] { return this->ValidateMMRHashes(rangeProofPMMR); });
-
-	const bool mmrHashesValidated = async::when_all(kernelTask, outputTask, rangeProofTask).then(
-		[](std::tuple<async::task<bool>, async::task<bool>, async::task<bool>> results) -> bool {
-		return std::get<0>(results).get() && std::get<1>(results).get() && std::get<2>(results).get();
-	}).get();
-	
-	if (!mmrHashesValidated)
+	// Validate MMR hashes in parallel, unless they were already verified during extraction
+	if (!mmrHashesVerified)
 	{
-		LoggerAPI::LogError("TxHashSetValidator::Validate - Invalid MMR hashes.");
-		return TxHashSetValidationResult::Fail();
+		async::task<bool> kernelTask = async::spawn([this, &kernelMMR] { return this->ValidateMMRHashes(kernelMMR); });
+		async::task<bool> outputTask = async::spawn([this, &outputPMMR] { return this->ValidateMMRHashes(outputPMMR); });
+		async::task<bool> rangeProofTask = async::spawn([this, &rangeProofPMMR] { return this->ValidateMMRHashes(rangeProofPMMR); });
+
+		const bool mmrHashesValidated = async::when_all(kernelTask, outputTask, rangeProofTask).then(
+			[](std::tuple<async::task<bool>, async::task<bool>, async::task<bool>> results) -> bool {
+			return std::get<0>(results).get() && std::get<1>(results).get() && std::get<2>(results).get();
+		}).get();
+
+		if (!mmrHashesValidated)
+		{
+			LoggerAPI::LogError("TxHashSetValidator::Validate - Invalid MMR hashes.");
+			return TxHashSetValidationResult::Fail();
+		}
 	}
 
 	// Validate root for each MMR matches blockHeader
@@ -62,7 +68,7 @@ TxHashSetValidationResult TxHashSetValidator::Validate(TxHashSet& txHashSet, con
 	}
 
 	// Validate kernel sums
-	const std::unique_ptr<BlockHeader> pGenesisHeader = m_blockChainServer.GetBlockHeaderByHeight(0, EChainType::CANDIDATE);
+	const std::shared_ptr<const BlockHeader> pGenesisHeader = m_blockChainServer.GetBlockHeaderByHeight(0, EChainType::CANDIDATE);
 	const bool genesisHasReward = pGenesisHeader->GetKernelMMRSize() > 0;
 	Commitment outputSum(CBigInteger<33>::ValueOf(0));
 	Commitment kernelSum(CBigInteger<33>::ValueOf(0));
@@ -72,8 +78,8 @@ TxHashSetValidationResult TxHashSetValidator::Validate(TxHashSet& txHashSet, con
 		return TxHashSetValidationResult::Fail();
 	}
 
-	// TODO: Validate the rangeproof associated with each unspent output.
-	if (!ValidateRangeProofs(txHashSet, blockHeader))
+	// Validate the rangeproof associated with each unspent output.
+	if (!RangeProofValidator().ValidateRangeProofs(*txHashSet.GetOutputPMMR(), *txHashSet.GetRangeProofPMMR(), blockHeader.GetOutputMMRSize()))
 	{
 		LoggerAPI::LogError("TxHashSetValidator::Validate - Invalid range proof.");
 		return TxHashSetValidationResult::Fail();
@@ -113,27 +119,55 @@ bool TxHashSetValidator::ValidateSizes(TxHashSet& txHashSet, const BlockHeader&
 	return true;
 }
 
+// Number of consecutive MMR nodes verified by a single parallel task.
+static const uint64_t MMR_HASH_CHUNK_SIZE = 16384;
+
+//
+// Splits the MMR into fixed-size ranges of node indices and verifies them on the Async++ work-stealing threadpool.
+// Each parent hash only depends on its two children, so the ranges can be verified independently of one another.
+//
 bool TxHashSetValidator::ValidateMMRHashes(const MMR& mmr) const
 {
 	const uint64_t size = mmr.GetSize();
-	for (uint64_t i = 0; i < size; i++)
+	const uint64_t numChunks = (size + MMR_HASH_CHUNK_SIZE - 1) / MMR_HASH_CHUNK_SIZE;
+
+	std::atomic_bool valid = true;
+	async::parallel_for(async::irange((uint64_t)0, numChunks), [this, &mmr, size, &valid](const uint64_t chunk)
+	{
+		if (valid)
+		{
+			const uint64_t firstIndex = chunk * MMR_HASH_CHUNK_SIZE;
+			const uint64_t lastIndex = std::min(size, firstIndex + MMR_HASH_CHUNK_SIZE);
+			if (!this->ValidateMMRHashRange(mmr, firstIndex, lastIndex))
+			{
+				valid = false;
+			}
+		}
+	});
+
+	return valid;
+}
+
+bool TxHashSetValidator::ValidateMMRHashRange(const MMR& mmr, const uint64_t firstIndex, const uint64_t lastIndex) const
+{
+	for (uint64_t i = firstIndex; i < lastIndex; i++)
 	{
 		const uint64_t height = MMRUtil::GetHeight(i);
 		if (height > 0)
 		{
-			const std::unique_ptr<Hash> pParentHash = mmr.GetHashAt(i);
-			if (pParentHash != nullptr)
+			const std::optional<Hash> parentHash = mmr.GetHashAt(i);
+			if (parentHash.has_value())
 			{
 				const uint64_t leftIndex = MMRUtil::GetLeftChildIndex(i, height);
-				const std::unique_ptr<Hash> pLeftHash = mmr.GetHashAt(leftIndex);
+				const std::optional<Hash> leftHash = mmr.GetHashAt(leftIndex);
 
 				const uint64_t rightIndex = MMRUtil::GetRightChildIndex(i);
-				const std::unique_ptr<Hash> pRightHash = mmr.GetHashAt(rightIndex);
+				const std::optional<Hash> rightHash = mmr.GetHashAt(rightIndex);
 
-				if (pLeftHash != nullptr && pRightHash != nullptr)
+				if (leftHash.has_value() && rightHash.has_value())
 				{
-					const Hash expectedHash = MMRUtil::HashParentWithIndex(*pLeftHash, *pRightHash, i);
-					if (*pParentHash != expectedHash)
+					const Hash expectedHash = MMRUtil::HashParentWithIndex(leftHash.value(), rightHash.value(), i);
+					if (parentHash.value() != expectedHash)
 					{
 						LoggerAPI::LogError("TxHashSetValidator::ValidateMMRHashes - Invalid parent hash at index " + std::to_string(i));
 						return false;
@@ -173,7 +207,7 @@ bool TxHashSetValidator::ValidateKernelHistory(const KernelMMR& kernelMMR, const
 {
 	for (uint64_t height = 0; height <= blockHeader.GetHeight(); height++)
 	{
-		std::unique_ptr<BlockHeader> pHeader = m_blockChainServer.GetBlockHeaderByHeight(height, EChainType::CANDIDATE);
+		std::shared_ptr<const BlockHeader> pHeader = m_blockChainServer.GetBlockHeaderByHeight(height, EChainType::CANDIDATE);
 		if (pHeader == nullptr)
 		{
 			LoggerAPI::LogError("TxHashSetValidator::ValidateKernelHistory - No header found at height " + std::to_string(height));
@@ -187,11 +221,5 @@ bool TxHashSetValidator::ValidateKernelHistory(const KernelMMR& kernelMMR, const
 		}
 	}
 
-	return true;
-}
-
-bool TxHashSetValidator::ValidateRangeProofs(TxHashSet& txHashSet, const BlockHeader& blockHeader) const
-{
-	// TODO: Implement
 	return true;
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 class HashFile;
 class TxHashSet;
 class KernelMMR;
+class OutputPMMR;
+class RangeProofPMMR;
 class IBlockChainServer;
 class MMR;
 class Commitment;
@@ -17,15 +19,15 @@ class TxHashSetValidator
 public:
 	TxHashSetValidator(const IBlockChainServer& blockChainServer);
 
-	TxHashSetValidationResult Validate(TxHashSet& txHashSet, const BlockHeader& blockHeader, Commitment& outputSumOut, Commitment& kernelSumOut) const;
+	TxHashSetValidationResult Validate(TxHashSet& txHashSet, const BlockHeader& blockHeader, const bool mmrHashesVerified, Commitment& outputSumOut, Commitment& kernelSumOut) const;
 
 private:
 	bool ValidateSizes(TxHashSet& txHashSet, const BlockHeader& blockHeader) const;
 	bool ValidateMMRHashes(const MMR& mmr) const;
+	bool ValidateMMRHashRange(const MMR& mmr, const uint64_t firstIndex, const uint64_t lastIndex) const;
 	bool ValidateRoots(TxHashSet& txHashSet, const BlockHeader& blockHeader) const;
 
 	bool ValidateKernelHistory(const KernelMMR& kernelMMR, const BlockHeader& blockHeader) const;
-	bool ValidateRangeProofs(TxHashSet& txHashSet, const BlockHeader& blockHeader) const;
 	bool ValidateKernelSignatures(TxHashSet& txHashSet, const BlockHeader& blockHeader) const;
 
 	const IBlockChainServer& m_blockChainServer;
@@ -5,6 +5,7 @@
 #include <FileUtil.h>
 #include <Infrastructure/Logger.h>
 #include <filesystem>
+#include <fstream>
 
 TxHashSetZip::TxHashSetZip(const Config& config)
 	: m_config(config)
@@ -147,4 +148,75 @@ bool TxHashSetZip::ExtractRangeProofFolder(const ZipFile& zipFile, const BlockHe
 	FileUtil::RenameFile(rangeProofDir + "/pmmr_leaf.bin." + HexUtil::ConvertHash(header.GetHash()), rangeProofDir + "/pmmr_leaf.bin");
 
 	return true;
+}
+
+bool TxHashSetZip::Compress(const std::string& snapshotDir, const std::string& zipPath, const BlockHeader& header) const
+{
+	const std::string leafFile = "pmmr_leaf.bin." + HexUtil::ConvertHash(header.GetHash());
+	const std::vector<std::string> entries = {
+		"kernel/pmmr_data.bin", "kernel/pmmr_hash.bin",
+		"output/pmmr_data.bin", "output/pmmr_hash.bin", "output/pmmr_prun.bin", "output/" + leafFile,
+		"rangeproof/pmmr_data.bin", "rangeproof/pmmr_hash.bin", "rangeproof/pmmr_prun.bin", "rangeproof/" + leafFile
+	};
+
+	zipFile pZipFile = zipOpen64(zipPath.c_str(), APPEND_STATUS_CREATE);
+	if (pZipFile == NULL)
+	{
+		LoggerAPI::LogError("TxHashSetZip::Compress - Failed to create " + zipPath);
+		return false;
+	}
+
+	bool success = true;
+	for (const std::string& entry : entries)
+	{
+		if (!AddFile(pZipFile, snapshotDir + entry, entry))
+		{
+			LoggerAPI::LogError("TxHashSetZip::Compress - Failed to add file (" + entry + ").");
+			success = false;
+			break;
+		}
+	}
+
+	if (zipClose(pZipFile, NULL) != ZIP_OK || !success)
+	{
+		FileUtil::RemoveFile(zipPath);
+		return false;
+	}
+
+	LoggerAPI::LogInfo("TxHashSetZip::Compress - Successfully created " + zipPath);
+	return true;
+}
+
+bool TxHashSetZip::AddFile(zipFile pZipFile, const std::string& sourcePath, const std::string& entryPath) const
+{
+	std::ifstream file(sourcePath, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	// Files of 4GB or more need zip64 extensions.
+	const uint64_t fileSize = (uint64_t)file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	// Hashes and range proofs barely compress, so favor speed.
+	zip_fileinfo fileInfo = {};
+	if (zipOpenNewFileInZip64(pZipFile, entryPath.c_str(), &fileInfo, NULL, 0, NULL, 0, NULL, Z_DEFLATED, Z_BEST_SPEED, fileSize >= 0xffffffff ? 1 : 0) != ZIP_OK)
+	{
+		return false;
+	}
+
+	std::vector<char> buffer(65536);
+	bool success = true;
+	while (success && file.good())
+	{
+		file.read(buffer.data(), buffer.size());
+		const std::streamsize bytesRead = file.gcount();
+		if (bytesRead > 0)
+		{
+			success = zipWriteInFileInZip(pZipFile, buffer.data(), (unsigned int)bytesRead) == ZIP_OK;
+		}
+	}
+
+	return zipCloseFileInZip(pZipFile) == ZIP_OK && success;
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "minizip/zip.h"
+
 #include <Core/BlockHeader.h>
 #include <Config/Config.h>
 #include <string>
@@ -14,7 +16,14 @@ public:
 
 	bool Extract(const std::string& path, const BlockHeader& header) const;
 
+	//
+	// Zips the TxHashSet files in snapshotDir, laid out the same way as the TxHashSet directory, into an archive that Extract can read.
+	//
+	bool Compress(const std::string& snapshotDir, const std::string& zipPath, const BlockHeader& header) const;
+
 private:
+	bool AddFile(zipFile pZipFile, const std::string& sourcePath, const std::string& entryPath) const;
+
 	bool ExtractKernelFolder(const ZipFile& zipFile) const;
 	bool ExtractOutputFolder(const ZipFile& zipFile, const BlockHeader& header) const;
 	bool ExtractRangeProofFolder(const ZipFile& zipFile, const BlockHeader& header) const;
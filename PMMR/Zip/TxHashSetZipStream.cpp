@@ -0,0 +1,331 @@
+#include "TxHashSetZipStream.h"
+#include "../KernelMMR.h"
+#include "../OutputPMMR.h"
+#include "../RangeProofPMMR.h"
+
+#include <HexUtil.h>
+#include <Infrastructure/Logger.h>
+#include <filesystem>
+
+// Chunks of the archive that can be waiting for extraction before the download is throttled.
+static const size_t MAX_QUEUED_CHUNKS = 256;
+static const size_t READ_BUFFER_SIZE = 65536;
+
+static const std::string KERNEL_FOLDER = "kernel";
+static const std::string OUTPUT_FOLDER = "output";
+static const std::string RANGE_PROOF_FOLDER = "rangeproof";
+static const std::string HASH_FILE = "pmmr_hash.bin";
+static const std::string PRUNE_FILE = "pmmr_prun.bin";
+
+//
+// Largest portable roaring bitmap of positions below mmrSize: one container per 2^16 positions, each at most a full 8KB bitset plus its headers.
+//
+static uint64_t GetMaxBitmapSize(const uint64_t mmrSize)
+{
+	const uint64_t numContainers = (mmrSize >> 16) + 1;
+	return 16 + numContainers * (8192 + 9);
+}
+
+static std::string GetFileName(const std::string& path)
+{
+	const size_t separator = path.find('/');
+	return separator == std::string::npos ? path : path.substr(separator + 1);
+}
+
+TxHashSetZipStream::TxHashSetZipStream(const Config& config, const BlockHeader& header)
+	: m_config(config), m_header(header), m_zipReader(*this), m_currentFileSize(0), m_currentMaxFileSize(0), m_pCurrentValidator(nullptr), m_closed(false), m_failed(false), m_localFailure(false)
+{
+	const std::string txHashSetDir = m_config.GetTxHashSetDirectory();
+	const std::string leafFile = "pmmr_leaf.bin." + HexUtil::ConvertHash(header.GetHash());
+
+	m_destinations[KERNEL_FOLDER + "/pmmr_data.bin"] = txHashSetDir + KERNEL_FOLDER + "/pmmr_data.bin";
+	m_destinations[KERNEL_FOLDER + "/" + HASH_FILE] = txHashSetDir + KERNEL_FOLDER + "/" + HASH_FILE;
+
+	for (const std::string& folder : { OUTPUT_FOLDER, RANGE_PROOF_FOLDER })
+	{
+		m_destinations[folder + "/pmmr_data.bin"] = txHashSetDir + folder + "/pmmr_data.bin";
+		m_destinations[folder + "/" + HASH_FILE] = txHashSetDir + folder + "/" + HASH_FILE;
+		m_destinations[folder + "/" + PRUNE_FILE] = txHashSetDir + folder + "/" + PRUNE_FILE;
+		m_destinations[folder + "/" + leafFile] = txHashSetDir + folder + "/pmmr_leaf.bin";
+	}
+
+	// Caps on each extracted file, so a malicious archive can't fill the disk. An MMR has at most one leaf per node.
+	const uint64_t kernelMMRSize = header.GetKernelMMRSize();
+	const uint64_t outputMMRSize = header.GetOutputMMRSize();
+	m_maxFileSizes[KERNEL_FOLDER + "/pmmr_data.bin"] = kernelMMRSize * KERNEL_SIZE;
+	m_maxFileSizes[KERNEL_FOLDER + "/" + HASH_FILE] = kernelMMRSize * 32;
+	m_maxFileSizes[OUTPUT_FOLDER + "/pmmr_data.bin"] = outputMMRSize * OUTPUT_SIZE;
+	m_maxFileSizes[RANGE_PROOF_FOLDER + "/pmmr_data.bin"] = outputMMRSize * RANGE_PROOF_SIZE;
+	for (const std::string& folder : { OUTPUT_FOLDER, RANGE_PROOF_FOLDER })
+	{
+		m_maxFileSizes[folder + "/" + HASH_FILE] = outputMMRSize * 32;
+		m_maxFileSizes[folder + "/" + PRUNE_FILE] = GetMaxBitmapSize(outputMMRSize);
+		m_maxFileSizes[folder + "/" + leafFile] = GetMaxBitmapSize(outputMMRSize);
+	}
+
+	m_mmrStates.emplace(KERNEL_FOLDER, MMRState(header.GetKernelMMRSize(), false));
+	m_mmrStates.emplace(OUTPUT_FOLDER, MMRState(header.GetOutputMMRSize(), true));
+	m_mmrStates.emplace(RANGE_PROOF_FOLDER, MMRState(header.GetOutputMMRSize(), true));
+}
+
+TxHashSetZipStream::~TxHashSetZipStream()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_queueMutex);
+		m_closed = true;
+		m_queue.clear();
+	}
+
+	Stop();
+}
+
+bool TxHashSetZipStream::Open()
+{
+	for (const std::string& folder : { KERNEL_FOLDER, OUTPUT_FOLDER, RANGE_PROOF_FOLDER })
+	{
+		if (!PrepareFolder(folder))
+		{
+			m_localFailure = true;
+			return false;
+		}
+	}
+
+	m_extractThread = std::thread(Thread_Extract, std::ref(*this));
+	return true;
+}
+
+bool TxHashSetZipStream::Write(std::vector<unsigned char>&& chunk)
+{
+	std::unique_lock<std::mutex> lock(m_queueMutex);
+	m_queueCondition.wait(lock, [this] { return m_failed || m_queue.size() < MAX_QUEUED_CHUNKS; });
+	if (m_failed)
+	{
+		return false;
+	}
+
+	m_queue.emplace_back(std::move(chunk));
+	m_queueCondition.notify_all();
+	return true;
+}
+
+bool TxHashSetZipStream::Finish()
+{
+	Stop();
+
+	if (m_failed)
+	{
+		LoggerAPI::LogError("TxHashSetZipStream::Finish - Failed to extract archive.");
+		return false;
+	}
+
+	if (!m_zipReader.IsComplete())
+	{
+		LoggerAPI::LogError("TxHashSetZipStream::Finish - Archive is incomplete.");
+		return false;
+	}
+
+	for (const auto& destination : m_destinations)
+	{
+		if (m_extracted.find(destination.first) == m_extracted.end())
+		{
+			LoggerAPI::LogError("TxHashSetZipStream::Finish - Archive is missing " + destination.first);
+			return false;
+		}
+	}
+
+	// A pruned hash file can only be verified while streaming if its prune list came first in the archive.
+	for (auto& mmrState : m_mmrStates)
+	{
+		if (!mmrState.second.m_hashesVerified && !VerifyHashFile(mmrState.first, mmrState.second))
+		{
+			LoggerAPI::LogError("TxHashSetZipStream::Finish - Invalid " + mmrState.first + " hashes.");
+			return false;
+		}
+	}
+
+	LoggerAPI::LogInfo("TxHashSetZipStream::Finish - Successfully extracted archive.");
+	return true;
+}
+
+bool TxHashSetZipStream::OnEntryBegin(const std::string& path)
+{
+	auto iter = m_destinations.find(path);
+	if (iter == m_destinations.end())
+	{
+		LoggerAPI::LogDebug("TxHashSetZipStream::OnEntryBegin - Skipping " + path);
+		return true;
+	}
+
+	m_currentFile.open(iter->second, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!m_currentFile.is_open())
+	{
+		LoggerAPI::LogError("TxHashSetZipStream::OnEntryBegin - Failed to open " + iter->second);
+		m_localFailure = true;
+		return false;
+	}
+
+	m_currentFileSize = 0;
+	m_currentMaxFileSize = m_maxFileSizes[path];
+
+	MMRState* pMMRState = GetMMRState(path);
+	if (pMMRState != nullptr && GetFileName(path) == HASH_FILE)
+	{
+		if (!pMMRState->m_pruned || pMMRState->m_pruneList.has_value())
+		{
+			const PruneList* pPruneList = pMMRState->m_pruned ? &pMMRState->m_pruneList.value() : nullptr;
+			pMMRState->m_pValidator = std::make_unique<MMRHashStreamValidator>(pMMRState->m_size, pPruneList);
+			m_pCurrentValidator = pMMRState->m_pValidator.get();
+		}
+	}
+
+	return true;
+}
+
+bool TxHashSetZipStream::OnEntryData(const unsigned char* pData, const size_t numBytes)
+{
+	if (!m_currentFile.is_open())
+	{
+		return true;
+	}
+
+	m_currentFileSize += numBytes;
+	if (m_currentFileSize > m_currentMaxFileSize)
+	{
+		LoggerAPI::LogError("TxHashSetZipStream::OnEntryData - File exceeds the size allowed by the header's MMR sizes.");
+		return false;
+	}
+
+	m_currentFile.write((const char*)pData, numBytes);
+	if (!m_currentFile.good())
+	{
+		LoggerAPI::LogError("TxHashSetZipStream::OnEntryData - Failed to write file.");
+		m_localFailure = true;
+		return false;
+	}
+
+	return m_pCurrentValidator == nullptr || m_pCurrentValidator->Append(pData, numBytes);
+}
+
+bool TxHashSetZipStream::OnEntryEnd(const std::string& path)
+{
+	if (!m_currentFile.is_open())
+	{
+		return true;
+	}
+
+	m_currentFile.close();
+	m_extracted.insert(path);
+
+	MMRState* pMMRState = GetMMRState(path);
+	if (pMMRState != nullptr)
+	{
+		if (GetFileName(path) == PRUNE_FILE)
+		{
+			pMMRState->m_pruneList.emplace(PruneList::Load(m_destinations[path]));
+		}
+
+		if (m_pCurrentValidator != nullptr)
+		{
+			m_pCurrentValidator = nullptr;
+			if (!pMMRState->m_pValidator->IsComplete())
+			{
+				LoggerAPI::LogError("TxHashSetZipStream::OnEntryEnd - Hash file is incomplete: " + path);
+				return false;
+			}
+
+			pMMRState->m_hashesVerified = true;
+		}
+	}
+
+	return true;
+}
+
+void TxHashSetZipStream::Thread_Extract(TxHashSetZipStream& zipStream)
+{
+	while (true)
+	{
+		std::vector<unsigned char> chunk;
+
+		{
+			std::unique_lock<std::mutex> lock(zipStream.m_queueMutex);
+			zipStream.m_queueCondition.wait(lock, [&zipStream] { return zipStream.m_closed || !zipStream.m_queue.empty(); });
+			if (zipStream.m_queue.empty())
+			{
+				break;
+			}
+
+			chunk = std::move(zipStream.m_queue.front());
+			zipStream.m_queue.pop_front();
+			zipStream.m_queueCondition.notify_all();
+		}
+
+		if (!zipStream.m_zipReader.Write(chunk.data(), chunk.size()))
+		{
+			std::unique_lock<std::mutex> lock(zipStream.m_queueMutex);
+			zipStream.m_failed = true;
+			zipStream.m_queue.clear();
+			zipStream.m_queueCondition.notify_all();
+			break;
+		}
+	}
+}
+
+bool TxHashSetZipStream::PrepareFolder(const std::string& folder) const
+{
+	const std::filesystem::path folderPath(m_config.GetTxHashSetDirectory() + folder);
+	if (std::filesystem::exists(folderPath))
+	{
+		LoggerAPI::LogDebug("TxHashSetZipStream::PrepareFolder - " + folder + " folder exists. Deleting its contents now.");
+		std::error_code errorCode;
+		const uint64_t removedFiles = std::filesystem::remove_all(folderPath, errorCode);
+		LoggerAPI::LogDebug("TxHashSetZipStream::PrepareFolder - " + std::to_string(removedFiles) + " files removed with error_code " + std::to_string(errorCode.value()));
+	}
+
+	if (!std::filesystem::create_directories(folderPath))
+	{
+		LoggerAPI::LogError("TxHashSetZipStream::PrepareFolder - Failed to create " + folder + " folder.");
+		return false;
+	}
+
+	return true;
+}
+
+TxHashSetZipStream::MMRState* TxHashSetZipStream::GetMMRState(const std::string& path)
+{
+	auto iter = m_mmrStates.find(path.substr(0, path.find('/')));
+	return iter != m_mmrStates.end() ? &iter->second : nullptr;
+}
+
+bool TxHashSetZipStream::VerifyHashFile(const std::string& folder, MMRState& mmrState) const
+{
+	const PruneList* pPruneList = mmrState.m_pruned ? &mmrState.m_pruneList.value() : nullptr;
+	MMRHashStreamValidator validator(mmrState.m_size, pPruneList);
+
+	std::ifstream file(m_config.GetTxHashSetDirectory() + folder + "/" + HASH_FILE, std::ios::in | std::ios::binary);
+	std::vector<unsigned char> buffer(READ_BUFFER_SIZE);
+	while (file.good())
+	{
+		file.read((char*)buffer.data(), buffer.size());
+		if (!validator.Append(buffer.data(), (size_t)file.gcount()))
+		{
+			return false;
+		}
+	}
+
+	mmrState.m_hashesVerified = validator.IsComplete();
+	return mmrState.m_hashesVerified;
+}
+
+void TxHashSetZipStream::Stop()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_queueMutex);
+		m_closed = true;
+		m_queueCondition.notify_all();
+	}
+
+	if (m_extractThread.joinable())
+	{
+		m_extractThread.join();
+	}
+}
\ No newline at end of file
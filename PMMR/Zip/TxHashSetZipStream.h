@@ -0,0 +1,103 @@
+#pragma once
+
+#include "ZipStreamReader.h"
+#include "../MMRHashStreamValidator.h"
+#include "../Common/PruneList.h"
+
+#include <Core/BlockHeader.h>
+#include <Config/Config.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <optional>
+#include <memory>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//
+// Extracts a TxHashSet zip archive into the TxHashSet directory while it's being downloaded.
+// Chunks of the archive are queued by the downloading thread and inflated on a separate thread straight into the PMMR files,
+// so the archive is never written to disk. The hash file of each MMR is verified as it's extracted.
+//
+class TxHashSetZipStream : public IZipEntryHandler
+{
+public:
+	TxHashSetZipStream(const Config& config, const BlockHeader& header);
+	~TxHashSetZipStream();
+
+	//
+	// Clears the kernel, output and rangeproof folders and starts the extraction thread.
+	//
+	bool Open();
+
+	//
+	// Queues the next chunk of the archive for extraction, blocking while the queue is full.
+	// Returns false once extraction has failed, so the download can be abandoned early.
+	//
+	bool Write(std::vector<unsigned char>&& chunk);
+
+	//
+	// Waits for the queued chunks to be extracted.
+	// Returns true only if the archive was complete, every PMMR file was extracted, and the MMR hashes were all valid.
+	//
+	bool Finish();
+
+	//
+	// Indicates whether extraction failed because of a local error, like a file that couldn't be created or written,
+	// rather than because of the archive's contents.
+	//
+	inline bool HasLocalFailure() const { return m_localFailure; }
+
+	virtual bool OnEntryBegin(const std::string& path) override final;
+	virtual bool OnEntryData(const unsigned char* pData, const size_t numBytes) override final;
+	virtual bool OnEntryEnd(const std::string& path) override final;
+
+private:
+	struct MMRState
+	{
+		MMRState(const uint64_t size, const bool pruned)
+			: m_size(size), m_pruned(pruned), m_hashesVerified(false)
+		{
+
+		}
+
+		uint64_t m_size;
+		bool m_pruned;
+		std::optional<PruneList> m_pruneList;
+		std::unique_ptr<MMRHashStreamValidator> m_pValidator;
+		bool m_hashesVerified;
+	};
+
+	static void Thread_Extract(TxHashSetZipStream& zipStream);
+	bool PrepareFolder(const std::string& folder) const;
+	MMRState* GetMMRState(const std::string& path);
+	bool VerifyHashFile(const std::string& folder, MMRState& mmrState) const;
+	void Stop();
+
+	const Config& m_config;
+	const BlockHeader& m_header;
+
+	// Archive entry path -> destination path
+	std::map<std::string, std::string> m_destinations;
+	std::map<std::string, uint64_t> m_maxFileSizes;
+	std::set<std::string> m_extracted;
+	std::map<std::string, MMRState> m_mmrStates;
+
+	ZipStreamReader m_zipReader;
+	std::ofstream m_currentFile;
+	uint64_t m_currentFileSize;
+	uint64_t m_currentMaxFileSize;
+	MMRHashStreamValidator* m_pCurrentValidator;
+
+	std::mutex m_queueMutex;
+	std::condition_variable m_queueCondition;
+	std::deque<std::vector<unsigned char>> m_queue;
+	bool m_closed;
+	bool m_failed;
+	bool m_localFailure;
+	std::thread m_extractThread;
+};
\ No newline at end of file
@@ -0,0 +1,390 @@
+#include "ZipStreamReader.h"
+
+#include <Infrastructure/Logger.h>
+#include <algorithm>
+
+static const uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+static const uint32_t DATA_DESCRIPTOR_SIGNATURE = 0x08074b50;
+static const uint32_t CENTRAL_DIRECTORY_SIGNATURE = 0x02014b50;
+static const uint32_t END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+
+static const size_t SIGNATURE_SIZE = 4;
+static const size_t LOCAL_HEADER_SIZE = 30;
+static const uint16_t ZIP64_EXTRA_FIELD_ID = 0x0001;
+static const uint16_t DATA_DESCRIPTOR_FLAG = 0x0008;
+static const uint16_t METHOD_STORED = 0;
+static const uint16_t METHOD_DEFLATED = 8;
+static const size_t OUTPUT_BUFFER_SIZE = 65536;
+
+static uint16_t ReadUInt16(const unsigned char* pData)
+{
+	return (uint16_t)pData[0] | ((uint16_t)pData[1] << 8);
+}
+
+static uint32_t ReadUInt32(const unsigned char* pData)
+{
+	return (uint32_t)ReadUInt16(pData) | ((uint32_t)ReadUInt16(pData + 2) << 16);
+}
+
+static uint64_t ReadUInt64(const unsigned char* pData)
+{
+	return (uint64_t)ReadUInt32(pData) | ((uint64_t)ReadUInt32(pData + 4) << 32);
+}
+
+ZipStreamReader::ZipStreamReader(IZipEntryHandler& handler)
+	: m_handler(handler),
+	m_state(EState::LOCAL_HEADER),
+	m_flags(0),
+	m_method(0),
+	m_crc(0),
+	m_compressedSize(0),
+	m_uncompressedSize(0),
+	m_fileNameLength(0),
+	m_extraFieldLength(0),
+	m_zip64(false),
+	m_isDirectory(false),
+	m_storedBytesRemaining(0),
+	m_runningCrc(0),
+	m_bytesExtracted(0),
+	m_inflateInitialized(false),
+	m_outputBuffer(OUTPUT_BUFFER_SIZE)
+{
+	m_inflateStream = z_stream();
+}
+
+ZipStreamReader::~ZipStreamReader()
+{
+	if (m_inflateInitialized)
+	{
+		inflateEnd(&m_inflateStream);
+	}
+}
+
+bool ZipStreamReader::Write(const unsigned char* pData, const size_t numBytes)
+{
+	size_t offset = 0;
+	while (offset < numBytes)
+	{
+		switch (m_state)
+		{
+			case EState::LOCAL_HEADER:
+			{
+				offset += BufferHeader(pData + offset, numBytes - offset, SIGNATURE_SIZE);
+				if (m_headerBuffer.size() < SIGNATURE_SIZE)
+				{
+					break;
+				}
+
+				const uint32_t signature = ReadUInt32(&m_headerBuffer[0]);
+				if (signature == CENTRAL_DIRECTORY_SIGNATURE || signature == END_OF_CENTRAL_DIRECTORY_SIGNATURE)
+				{
+					m_headerBuffer.clear();
+					m_state = EState::COMPLETE;
+					return true;
+				}
+				else if (signature != LOCAL_HEADER_SIGNATURE)
+				{
+					return Fail("Unexpected signature " + std::to_string(signature));
+				}
+
+				offset += BufferHeader(pData + offset, numBytes - offset, LOCAL_HEADER_SIZE);
+				if (m_headerBuffer.size() == LOCAL_HEADER_SIZE && !ParseLocalHeader())
+				{
+					return false;
+				}
+
+				break;
+			}
+			case EState::FILE_NAME:
+			{
+				offset += BufferHeader(pData + offset, numBytes - offset, m_fileNameLength + m_extraFieldLength);
+				if (m_headerBuffer.size() == (m_fileNameLength + m_extraFieldLength) && !BeginEntry())
+				{
+					return false;
+				}
+
+				break;
+			}
+			case EState::ENTRY_DATA:
+			{
+				const size_t bytesRead = (m_method == METHOD_STORED) ? ReadStored(pData + offset, numBytes - offset) : Inflate(pData + offset, numBytes - offset);
+				if (m_state == EState::FAILED)
+				{
+					return false;
+				}
+
+				offset += bytesRead;
+				break;
+			}
+			case EState::DATA_DESCRIPTOR:
+			{
+				offset += BufferHeader(pData + offset, numBytes - offset, SIGNATURE_SIZE);
+				if (m_headerBuffer.size() < SIGNATURE_SIZE)
+				{
+					break;
+				}
+
+				// The data descriptor signature is optional.
+				const bool hasSignature = ReadUInt32(&m_headerBuffer[0]) == DATA_DESCRIPTOR_SIGNATURE;
+				const size_t descriptorSize = (hasSignature ? SIGNATURE_SIZE : 0) + 4 + (m_zip64 ? 16 : 8);
+
+				offset += BufferHeader(pData + offset, numBytes - offset, descriptorSize);
+				if (m_headerBuffer.size() == descriptorSize && !ParseDataDescriptor())
+				{
+					return false;
+				}
+
+				break;
+			}
+			case EState::COMPLETE:
+			{
+				return true;
+			}
+			case EState::FAILED:
+			{
+				return false;
+			}
+		}
+	}
+
+	return m_state != EState::FAILED;
+}
+
+size_t ZipStreamReader::BufferHeader(const unsigned char* pData, const size_t numBytes, const size_t headerSize)
+{
+	if (m_headerBuffer.size() >= headerSize)
+	{
+		return 0;
+	}
+
+	const size_t bytesToCopy = std::min(numBytes, headerSize - m_headerBuffer.size());
+	m_headerBuffer.insert(m_headerBuffer.end(), pData, pData + bytesToCopy);
+	return bytesToCopy;
+}
+
+bool ZipStreamReader::ParseLocalHeader()
+{
+	const unsigned char* pHeader = &m_headerBuffer[0];
+	m_flags = ReadUInt16(pHeader + 6);
+	m_method = ReadUInt16(pHeader + 8);
+	m_crc = ReadUInt32(pHeader + 14);
+	m_compressedSize = ReadUInt32(pHeader + 18);
+	m_uncompressedSize = ReadUInt32(pHeader + 22);
+	m_fileNameLength = ReadUInt16(pHeader + 26);
+	m_extraFieldLength = ReadUInt16(pHeader + 28);
+	m_zip64 = false;
+
+	m_headerBuffer.clear();
+	m_state = EState::FILE_NAME;
+
+	if (m_fileNameLength + m_extraFieldLength == 0)
+	{
+		return Fail("Entry has no name");
+	}
+
+	return true;
+}
+
+bool ZipStreamReader::BeginEntry()
+{
+	m_path = std::string((const char*)&m_headerBuffer[0], m_fileNameLength);
+
+	// The zip64 extended information only contains the sizes that didn't fit in the local header.
+	size_t extraOffset = m_fileNameLength;
+	const size_t extraEnd = m_fileNameLength + m_extraFieldLength;
+	while (extraOffset + 4 <= extraEnd)
+	{
+		const uint16_t fieldId = ReadUInt16(&m_headerBuffer[extraOffset]);
+		const size_t fieldSize = ReadUInt16(&m_headerBuffer[extraOffset + 2]);
+		const size_t fieldEnd = extraOffset + 4 + fieldSize;
+		if (fieldEnd > extraEnd)
+		{
+			return Fail("Invalid extra field for " + m_path);
+		}
+
+		if (fieldId == ZIP64_EXTRA_FIELD_ID)
+		{
+			m_zip64 = true;
+
+			size_t fieldOffset = extraOffset + 4;
+			if (m_uncompressedSize == UINT32_MAX && fieldOffset + 8 <= fieldEnd)
+			{
+				m_uncompressedSize = ReadUInt64(&m_headerBuffer[fieldOffset]);
+				fieldOffset += 8;
+			}
+
+			if (m_compressedSize == UINT32_MAX && fieldOffset + 8 <= fieldEnd)
+			{
+				m_compressedSize = ReadUInt64(&m_headerBuffer[fieldOffset]);
+			}
+		}
+
+		extraOffset = fieldEnd;
+	}
+
+	m_headerBuffer.clear();
+	m_isDirectory = !m_path.empty() && m_path.back() == '/';
+	m_runningCrc = crc32(0L, Z_NULL, 0);
+	m_bytesExtracted = 0;
+
+	if (!m_isDirectory && !m_handler.OnEntryBegin(m_path))
+	{
+		return Fail("Entry rejected: " + m_path);
+	}
+
+	m_state = EState::ENTRY_DATA;
+	if (m_method == METHOD_STORED)
+	{
+		// Without a compressed size, there's no way to tell where stored data ends.
+		if ((m_flags & DATA_DESCRIPTOR_FLAG) != 0)
+		{
+			return Fail("Stored entry without size: " + m_path);
+		}
+
+		m_storedBytesRemaining = m_compressedSize;
+		if (m_storedBytesRemaining == 0)
+		{
+			return FinishEntryData();
+		}
+	}
+	else if (m_method == METHOD_DEFLATED)
+	{
+		const int result = m_inflateInitialized ? inflateReset(&m_inflateStream) : inflateInit2(&m_inflateStream, -MAX_WBITS);
+		if (result != Z_OK)
+		{
+			return Fail("Failed to initialize inflate for " + m_path);
+		}
+
+		m_inflateInitialized = true;
+	}
+	else
+	{
+		return Fail("Unsupported compression method " + std::to_string(m_method) + " for " + m_path);
+	}
+
+	return true;
+}
+
+size_t ZipStreamReader::ReadStored(const unsigned char* pData, const size_t numBytes)
+{
+	const size_t bytesToRead = (size_t)std::min((uint64_t)numBytes, m_storedBytesRemaining);
+	if (!EmitData(pData, bytesToRead))
+	{
+		return 0;
+	}
+
+	m_storedBytesRemaining -= bytesToRead;
+	if (m_storedBytesRemaining == 0)
+	{
+		FinishEntryData();
+	}
+
+	return bytesToRead;
+}
+
+size_t ZipStreamReader::Inflate(const unsigned char* pData, const size_t numBytes)
+{
+	m_inflateStream.next_in = const_cast<Bytef*>(pData);
+	m_inflateStream.avail_in = (uInt)numBytes;
+
+	int result = Z_OK;
+	do
+	{
+		m_inflateStream.next_out = &m_outputBuffer[0];
+		m_inflateStream.avail_out = (uInt)m_outputBuffer.size();
+
+		result = inflate(&m_inflateStream, Z_NO_FLUSH);
+		if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+		{
+			Fail("Failed to inflate " + m_path);
+			return 0;
+		}
+
+		const size_t bytesInflated = m_outputBuffer.size() - m_inflateStream.avail_out;
+		if (bytesInflated == 0 && result == Z_BUF_ERROR)
+		{
+			break;
+		}
+
+		if (!EmitData(&m_outputBuffer[0], bytesInflated))
+		{
+			return 0;
+		}
+	} while (result != Z_STREAM_END && (m_inflateStream.avail_in > 0 || m_inflateStream.avail_out == 0));
+
+	const size_t bytesRead = numBytes - m_inflateStream.avail_in;
+	if (result == Z_STREAM_END)
+	{
+		FinishEntryData();
+	}
+
+	return bytesRead;
+}
+
+bool ZipStreamReader::EmitData(const unsigned char* pData, const size_t numBytes)
+{
+	if (numBytes == 0)
+	{
+		return true;
+	}
+
+	m_runningCrc = crc32(m_runningCrc, pData, (uInt)numBytes);
+	m_bytesExtracted += numBytes;
+
+	// Without a data descriptor, the local header's size is known up front, so an entry inflating past it is rejected before it's written.
+	if ((m_flags & DATA_DESCRIPTOR_FLAG) == 0 && m_bytesExtracted > m_uncompressedSize)
+	{
+		return Fail("Entry exceeds its declared size: " + m_path);
+	}
+
+	if (!m_isDirectory && !m_handler.OnEntryData(pData, numBytes))
+	{
+		return Fail("Failed to write " + m_path);
+	}
+
+	return true;
+}
+
+bool ZipStreamReader::FinishEntryData()
+{
+	if ((m_flags & DATA_DESCRIPTOR_FLAG) != 0)
+	{
+		m_state = EState::DATA_DESCRIPTOR;
+		return true;
+	}
+
+	return EndEntry(m_crc, m_uncompressedSize);
+}
+
+bool ZipStreamReader::ParseDataDescriptor()
+{
+	const size_t offset = (ReadUInt32(&m_headerBuffer[0]) == DATA_DESCRIPTOR_SIGNATURE) ? SIGNATURE_SIZE : 0;
+	const uint32_t crc = ReadUInt32(&m_headerBuffer[offset]);
+	const uint64_t uncompressedSize = m_zip64 ? ReadUInt64(&m_headerBuffer[offset + 12]) : ReadUInt32(&m_headerBuffer[offset + 8]);
+
+	m_headerBuffer.clear();
+	return EndEntry(crc, uncompressedSize);
+}
+
+bool ZipStreamReader::EndEntry(const uint32_t expectedCrc, const uint64_t expectedSize)
+{
+	if (m_runningCrc != expectedCrc || m_bytesExtracted != expectedSize)
+	{
+		return Fail("Checksum or size mismatch for " + m_path);
+	}
+
+	if (!m_isDirectory && !m_handler.OnEntryEnd(m_path))
+	{
+		return Fail("Entry rejected: " + m_path);
+	}
+
+	m_state = EState::LOCAL_HEADER;
+	return true;
+}
+
+bool ZipStreamReader::Fail(const std::string& message)
+{
+	LoggerAPI::LogError("ZipStreamReader::Write - " + message);
+	m_state = EState::FAILED;
+	return false;
+}
\ No newline at end of file
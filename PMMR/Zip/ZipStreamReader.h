@@ -0,0 +1,86 @@
+#pragma once
+
+#include <zlib.h>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+//
+// Receives the entries of a zip archive as they're extracted by a ZipStreamReader.
+// Returning false from any of these rejects the archive.
+//
+class IZipEntryHandler
+{
+public:
+	virtual bool OnEntryBegin(const std::string& path) = 0;
+	virtual bool OnEntryData(const unsigned char* pData, const size_t numBytes) = 0;
+	virtual bool OnEntryEnd(const std::string& path) = 0;
+};
+
+//
+// Extracts a zip archive while its bytes arrive, so the archive itself never needs to be written to disk.
+// Entries are read sequentially using their local file headers, and everything from the central directory on is ignored.
+// Only stored and deflated entries are supported, and the CRC-32 of every entry is checked.
+//
+class ZipStreamReader
+{
+public:
+	ZipStreamReader(IZipEntryHandler& handler);
+	~ZipStreamReader();
+
+	//
+	// Consumes the next bytes of the archive.
+	// Returns false if the archive is malformed or was rejected by the handler.
+	//
+	bool Write(const unsigned char* pData, const size_t numBytes);
+
+	//
+	// Indicates whether all entries were extracted and the central directory was reached.
+	//
+	inline bool IsComplete() const { return m_state == EState::COMPLETE; }
+
+private:
+	enum class EState
+	{
+		LOCAL_HEADER,
+		FILE_NAME,
+		ENTRY_DATA,
+		DATA_DESCRIPTOR,
+		COMPLETE,
+		FAILED
+	};
+
+	size_t BufferHeader(const unsigned char* pData, const size_t numBytes, const size_t headerSize);
+	bool ParseLocalHeader();
+	bool BeginEntry();
+	size_t ReadStored(const unsigned char* pData, const size_t numBytes);
+	size_t Inflate(const unsigned char* pData, const size_t numBytes);
+	bool EmitData(const unsigned char* pData, const size_t numBytes);
+	bool FinishEntryData();
+	bool ParseDataDescriptor();
+	bool EndEntry(const uint32_t expectedCrc, const uint64_t expectedSize);
+	bool Fail(const std::string& message);
+
+	IZipEntryHandler& m_handler;
+	EState m_state;
+	std::vector<unsigned char> m_headerBuffer;
+
+	// Current entry
+	std::string m_path;
+	uint16_t m_flags;
+	uint16_t m_method;
+	uint32_t m_crc;
+	uint64_t m_compressedSize;
+	uint64_t m_uncompressedSize;
+	size_t m_fileNameLength;
+	size_t m_extraFieldLength;
+	bool m_zip64;
+	bool m_isDirectory;
+	uint64_t m_storedBytesRemaining;
+	uint32_t m_runningCrc;
+	uint64_t m_bytesExtracted;
+
+	z_stream m_inflateStream;
+	bool m_inflateInitialized;
+	std::vector<unsigned char> m_outputBuffer;
+};
\ No newline at end of file
@@ -11,4 +11,14 @@ PoWManager::PoWManager(const Config& config)
 bool PoWManager::IsPoWValid(const BlockHeader& header, const BlockHeader& previousHeader) const
 {
 	return PoWValidator(m_config).IsPoWValid(header, previousHeader);
+}
+
+bool PoWManager::IsDifficultyValid(const BlockHeader& header, const BlockHeader& previousHeader) const
+{
+	return PoWValidator(m_config).IsDifficultyValid(header, previousHeader);
+}
+
+bool PoWManager::IsProofValid(const BlockHeader& header) const
+{
+	return PoWValidator(m_config).IsProofValid(header);
 }
\ No newline at end of file
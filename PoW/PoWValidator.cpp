@@ -14,6 +14,11 @@ PoWValidator::PoWValidator(const Config& config)
 }
 
 bool PoWValidator::IsPoWValid(const BlockHeader& header, const BlockHeader& previousHeader) const
+{
+	return IsDifficultyValid(header, previousHeader) && IsProofValid(header);
+}
+
+bool PoWValidator::IsDifficultyValid(const BlockHeader& header, const BlockHeader& previousHeader) const
 {
 	// Validate Total Difficulty
 	if (header.GetTotalDifficulty() <= previousHeader.GetTotalDifficulty())
@@ -43,6 +48,11 @@ bool PoWValidator::IsPoWValid(const BlockHeader& header, const BlockHeader& prev
 	//	return Err(ErrorKind::InvalidScaling.into());
 	//}
 
+	return true;
+}
+
+bool PoWValidator::IsProofValid(const BlockHeader& header) const
+{
 	const ProofOfWork& proofOfWork = header.GetProofOfWork();
 	const EPoWType powType = PoWUtil(m_config).DeterminePoWType(proofOfWork.GetEdgeBits());
 	if (powType == EPoWType::CUCKAROO)
@@ -9,6 +9,8 @@ public:
 	PoWValidator(const Config& config);
 
 	bool IsPoWValid(const BlockHeader& header, const BlockHeader& previousHeader) const;
+	bool IsDifficultyValid(const BlockHeader& header, const BlockHeader& previousHeader) const;
+	bool IsProofValid(const BlockHeader& header) const;
 
 private:
 	uint64_t GetMaximumDifficulty(const BlockHeader& header) const;
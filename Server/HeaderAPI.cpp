@@ -19,7 +19,7 @@
 int HeaderAPI::GetHeader_Handler(struct mg_connection* conn, void* pBlockChainServer)
 {
 	const std::string requestedHeader = RestUtil::GetURIParam(conn, "/v1/headers/");
-	std::unique_ptr<BlockHeader> pBlockHeader = GetHeader(requestedHeader, (IBlockChainServer*)pBlockChainServer);
+	std::shared_ptr<const BlockHeader> pBlockHeader = GetHeader(requestedHeader, (IBlockChainServer*)pBlockChainServer);
 
 	if (nullptr != pBlockHeader)
 	{
@@ -33,14 +33,14 @@ int HeaderAPI::GetHeader_Handler(struct mg_connection* conn, void* pBlockChainSe
 	}
 }
 
-std::unique_ptr<BlockHeader> HeaderAPI::GetHeader(const std::string& requestedHeader, IBlockChainServer* pBlockChainServer)
+std::shared_ptr<const BlockHeader> HeaderAPI::GetHeader(const std::string& requestedHeader, IBlockChainServer* pBlockChainServer)
 {
 	if (requestedHeader.length() == 64 && HexUtil::IsValidHex(requestedHeader))
 	{
 		try
 		{
 			const Hash hash = Hash::FromHex(requestedHeader);
-			std::unique_ptr<BlockHeader> pHeader = pBlockChainServer->GetBlockHeaderByHash(hash);
+			std::shared_ptr<const BlockHeader> pHeader = pBlockChainServer->GetBlockHeaderByHash(hash);
 			if (pHeader != nullptr)
 			{
 				LoggerAPI::LogInfo(StringUtil::Format("BlockAPI::GetHeader - Found header with hash %s.", requestedHeader.c_str()));
@@ -68,7 +68,7 @@ std::unique_ptr<BlockHeader> HeaderAPI::GetHeader(const std::string& requestedHe
 			std::string::size_type sz = 0;
 			const uint64_t height = std::stoull(requestedHeader, &sz, 0);
 
-			std::unique_ptr<BlockHeader> pHeader = pBlockChainServer->GetBlockHeaderByHeight(height, EChainType::CANDIDATE);
+			std::shared_ptr<const BlockHeader> pHeader = pBlockChainServer->GetBlockHeaderByHeight(height, EChainType::CANDIDATE);
 			if (pHeader != nullptr)
 			{
 				LoggerAPI::LogInfo(StringUtil::Format("BlockAPI::GetHeader - Found header at height %s.", requestedHeader.c_str()));
@@ -85,5 +85,5 @@ std::unique_ptr<BlockHeader> HeaderAPI::GetHeader(const std::string& requestedHe
 		}
 	}
 
-	return std::unique_ptr<BlockHeader>(nullptr);
+	return std::shared_ptr<const BlockHeader>(nullptr);
 }
\ No newline at end of file
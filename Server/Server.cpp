@@ -48,6 +48,13 @@ void Server::Run()
 
 	m_config = ConfigManager::LoadConfig();
 	m_pDatabase = DatabaseAPI::OpenDatabase(m_config);
+	if (m_pDatabase == nullptr)
+	{
+		std::cout << "Failed to open the database. See the log for details.\n";
+		LoggerAPI::Flush();
+		return;
+	}
+
 	m_pBlockChainServer = BlockChainAPI::StartBlockChainServer(m_config, *m_pDatabase);
 	m_pP2PServer = P2PAPI::StartP2PServer(m_config, *m_pBlockChainServer, *m_pDatabase);
 
@@ -3,28 +3,129 @@
 #include "TransactionAggregator.h"
 
 #include <VectorUtil.h>
+#include <HexUtil.h>
+#include <Consensus/BlockWeight.h>
+#include <Infrastructure/Logger.h>
+#include <StringUtil.h>
 #include <algorithm>
 
+// Room left in every block template for the coinbase output and kernel.
+static const uint64_t COINBASE_RESERVED_WEIGHT = Consensus::BLOCK_OUTPUT_WEIGHT + Consensus::BLOCK_KERNEL_WEIGHT;
+
+// Returns the weight available for transactions in a block template of the given maximum weight.
+static uint64_t GetAvailableWeight(const uint64_t maxWeight)
+{
+	return maxWeight > COINBASE_RESERVED_WEIGHT ? (maxWeight - COINBASE_RESERVED_WEIGHT) : 0;
+}
+
+// Multiplies two 64-bit values into a 128-bit product, split into its high and low halves.
+static void Multiply128(const uint64_t a, const uint64_t b, uint64_t& high, uint64_t& low)
+{
+	const uint64_t aLow = a & 0xFFFFFFFF;
+	const uint64_t aHigh = a >> 32;
+	const uint64_t bLow = b & 0xFFFFFFFF;
+	const uint64_t bHigh = b >> 32;
+
+	const uint64_t lowLow = aLow * bLow;
+	const uint64_t lowHigh = aLow * bHigh;
+	const uint64_t highLow = aHigh * bLow;
+	const uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFF) + (highLow & 0xFFFFFFFF);
+
+	low = (middle << 32) | (lowLow & 0xFFFFFFFF);
+	high = (aHigh * bHigh) + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+}
+
+// Returns true if fee1/weight1 is lower than fee2/weight2.
+// The cross products are compared in 128 bits, since fees are arbitrary 64-bit values and would overflow.
+static bool IsLowerFeeRate(const uint64_t fee1, const uint64_t weight1, const uint64_t fee2, const uint64_t weight2)
+{
+	uint64_t high1 = 0;
+	uint64_t low1 = 0;
+	Multiply128(fee1, weight2, high1, low1);
+
+	uint64_t high2 = 0;
+	uint64_t low2 = 0;
+	Multiply128(fee2, weight1, high2, low2);
+
+	return high1 < high2 || (high1 == high2 && low1 < low2);
+}
+
+// Removes the index entry for the key only if it refers to the given pool entry.
+template<typename K, typename I>
+static void EraseIfMatches(std::unordered_map<K, I>& index, const K& key, const I& iter)
+{
+	auto found = index.find(key);
+	if (found != index.end() && found->second == iter)
+	{
+		index.erase(found);
+	}
+}
+
+Pool::Pool(VerifierCache& verifierCache, const uint64_t maxWeight)
+	: m_verifierCache(verifierCache),
+	m_totalWeight(0),
+	m_maxWeight(maxWeight),
+	m_templateValid(false),
+	m_templateMaxWeight(0),
+	m_templateWeight(0),
+	m_templateMinFee(0),
+	m_templateMinWeight(1),
+	m_shortIdIndexValid(false),
+	m_shortIdNonce(0)
+{
+
+}
+
+bool Pool::FeeRateComparator::operator()(const EntryIter& lhs, const EntryIter& rhs) const
+{
+	if (IsLowerFeeRate(lhs->GetFee(), lhs->GetWeight(), rhs->GetFee(), rhs->GetWeight()))
+	{
+		return true;
+	}
+
+	if (IsLowerFeeRate(rhs->GetFee(), rhs->GetWeight(), lhs->GetFee(), lhs->GetWeight()))
+	{
+		return false;
+	}
+
+	return lhs->GetTransaction().GetHash() < rhs->GetTransaction().GetHash();
+}
+
 // Query the tx pool for all known txs based on kernel short_ids from the provided compact_block.
 // Note: does not validate that we return the full set of required txs. The caller will need to validate that themselves.
 std::vector<Transaction> Pool::GetTransactionsByShortId(const Hash& hash, const uint64_t nonce, const std::set<ShortId>& missingShortIds) const
 {
 	std::shared_lock<std::shared_mutex> lockGuard(m_transactionsMutex);
+	std::lock_guard<std::mutex> shortIdLockGuard(m_shortIdMutex);
 
-	std::vector<Transaction> transactionsFound;
-	for (const TxPoolEntry& txPoolEntry : m_transactions)
+	// Short ids only need to be calculated for every kernel in the pool once per compact block.
+	if (!m_shortIdIndexValid || m_shortIdBlockHash != hash || m_shortIdNonce != nonce)
 	{
-		for (const TransactionKernel& kernel : txPoolEntry.GetTransaction().GetBody().GetKernels())
+		m_transactionsByShortId.clear();
+		for (auto iter = m_transactions.cbegin(); iter != m_transactions.cend(); iter++)
 		{
-			const ShortId shortId = ShortId::Create(kernel.GetHash(), hash, nonce);
-			if (missingShortIds.find(shortId) != missingShortIds.cend())
+			for (const TransactionKernel& kernel : iter->GetTransaction().GetBody().GetKernels())
 			{
-				transactionsFound.push_back(txPoolEntry.GetTransaction());
+				m_transactionsByShortId.emplace(ShortId::Create(kernel.GetHash(), hash, nonce), iter);
+			}
+		}
 
-				if (transactionsFound.size() == missingShortIds.size())
-				{
-					return transactionsFound;
-				}
+		m_shortIdBlockHash = hash;
+		m_shortIdNonce = nonce;
+		m_shortIdIndexValid = true;
+	}
+
+	std::set<Hash> transactionHashesFound;
+	std::vector<Transaction> transactionsFound;
+	for (const ShortId& shortId : missingShortIds)
+	{
+		auto found = m_transactionsByShortId.find(shortId);
+		if (found != m_transactionsByShortId.cend())
+		{
+			const Transaction& transaction = found->second->GetTransaction();
+			if (transactionHashesFound.insert(transaction.GetHash()).second)
+			{
+				transactionsFound.push_back(transaction);
 			}
 		}
 	}
@@ -36,13 +137,32 @@ bool Pool::AddTransaction(const Transaction& transaction, const EDandelionStatus
 {
 	std::lock_guard<std::shared_mutex> lockGuard(m_transactionsMutex);
 
-	if (TransactionValidator().ValidateTransaction(transaction))
+	if (m_transactionsByHash.find(transaction.GetHash()) != m_transactionsByHash.cend())
 	{
-		m_transactions.emplace_back(TxPoolEntry(transaction, status, std::time_t()));
-		return true;
+		return false;
 	}
 
-	return false;
+	if (IsConflicting_Locked(transaction))
+	{
+		return false;
+	}
+
+	if (!TransactionValidator(m_verifierCache).ValidateTransaction(transaction))
+	{
+		return false;
+	}
+
+	TxPoolEntry entry(transaction, status, std::time_t());
+	if (!MakeRoom_Locked(entry))
+	{
+		LoggerAPI::LogDebug("Pool::AddTransaction - Pool is full, and transaction's fee rate is too low " + HexUtil::ConvertHash(transaction.GetHash()));
+		return false;
+	}
+
+	AddEntry_Locked(std::move(entry));
+	ExtendBlockTemplate_Locked(m_transactionsByHash.at(transaction.GetHash()));
+
+	return true;
 }
 
 std::vector<Transaction> Pool::FindTransactionsByKernel(const std::set<TransactionKernel>& kernels) const
@@ -50,14 +170,12 @@ std::vector<Transaction> Pool::FindTransactionsByKernel(const std::set<Transacti
 	std::shared_lock<std::shared_mutex> lockGuard(m_transactionsMutex);
 
 	std::set<Transaction> transactionSet;
-	for (const TxPoolEntry& txPoolEntry : m_transactions)
+	for (const TransactionKernel& kernel : kernels)
 	{
-		for (const TransactionKernel& kernel : txPoolEntry.GetTransaction().GetBody().GetKernels())
+		auto found = m_transactionsByKernel.find(kernel.GetHash());
+		if (found != m_transactionsByKernel.cend())
 		{
-			if (kernels.count(kernel) > 0)
-			{
-				transactionSet.insert(txPoolEntry.GetTransaction());
-			}
+			transactionSet.insert(found->second->GetTransaction());
 		}
 	}
 
@@ -105,33 +223,19 @@ void Pool::RemoveTransactions(const std::vector<Transaction>& transactions)
 {
 	std::lock_guard<std::shared_mutex> lockGuard(m_transactionsMutex);
 
-	auto iter = m_transactions.begin();
-	while (iter != m_transactions.end())
+	for (const Transaction& transaction : transactions)
 	{
-		bool remove = false;
-		for (const Transaction& transaction : transactions)
-		{
-			if (transaction == iter->GetTransaction())
-			{
-				remove = true;
-				break;
-			}
-		}
-
-		if (remove)
+		auto found = m_transactionsByHash.find(transaction.GetHash());
+		if (found != m_transactionsByHash.end())
 		{
-			m_transactions.erase(iter++);
-		}
-		else
-		{
-			++iter;
+			RemoveEntry_Locked(found->second);
 		}
 	}
 }
 
 // Quick reconciliation step - we can evict any txs in the pool where
 // inputs or kernels intersect with the block.
-void Pool::ReconcileBlock(const FullBlock& block)
+std::vector<Transaction> Pool::ReconcileBlock(const FullBlock& block)
 {
 	std::lock_guard<std::shared_mutex> lockGuard(m_transactionsMutex);
 
@@ -139,35 +243,106 @@ void Pool::ReconcileBlock(const FullBlock& block)
 	// Reject any txs where we see a matching tx kernel in the block.
 	// Also reject any txs where we see a conflicting tx,
 	// where an input is spent in a different tx.
-	auto iter = m_transactions.begin();
-	while (iter != m_transactions.end())
+	std::set<Hash> transactionsToEvict;
+	for (const TransactionInput& input : block.GetTransactionBody().GetInputs())
+	{
+		auto found = m_transactionsByInput.find(input.GetCommitment());
+		if (found != m_transactionsByInput.end())
+		{
+			transactionsToEvict.insert(found->second->GetTransaction().GetHash());
+		}
+	}
+
+	std::set<Hash> confirmedHashes;
+	std::vector<Transaction> confirmedTransactions;
+	for (const TransactionKernel& kernel : block.GetTransactionBody().GetKernels())
 	{
-		if (ShouldEvict_Locked(iter->GetTransaction(), block))
+		auto found = m_transactionsByKernel.find(kernel.GetHash());
+		if (found != m_transactionsByKernel.end())
 		{
-			m_transactions.erase(iter++);
+			const Transaction& transaction = found->second->GetTransaction();
+			if (confirmedHashes.insert(transaction.GetHash()).second)
+			{
+				transactionsToEvict.insert(transaction.GetHash());
+				confirmedTransactions.push_back(transaction);
+			}
 		}
-		else
+	}
+
+	for (const Hash& transactionHash : transactionsToEvict)
+	{
+		RemoveEntry_Locked(m_transactionsByHash.at(transactionHash));
+	}
+
+	return confirmedTransactions;
+}
+
+std::unique_ptr<Transaction> Pool::Aggregate() const
+{
+	std::shared_lock<std::shared_mutex> lockGuard(m_transactionsMutex);
+	if (m_transactions.empty())
+	{
+		return std::unique_ptr<Transaction>(nullptr);
+	}
+
+	std::vector<Transaction> transactions;
+	transactions.reserve(m_transactions.size());
+	for (const TxPoolEntry& entry : m_transactions)
+	{
+		transactions.push_back(entry.GetTransaction());
+	}
+
+	std::unique_ptr<Transaction> pAggregateTransaction = TransactionAggregator::Aggregate(transactions);
+	if (pAggregateTransaction != nullptr)
+	{
+		if (!TransactionValidator(m_verifierCache).ValidateTransaction(*pAggregateTransaction))
 		{
-			++iter;
+			return std::unique_ptr<Transaction>(nullptr);
 		}
 	}
+
+	return pAggregateTransaction;
+}
+
+std::unique_ptr<Transaction> Pool::BuildBlockTemplate(const uint64_t maxWeight)
+{
+	std::lock_guard<std::shared_mutex> lockGuard(m_transactionsMutex);
+
+	const uint64_t blockWeight = std::min<uint64_t>(maxWeight, Consensus::MAX_BLOCK_WEIGHT);
+	if (!m_templateValid || m_templateMaxWeight != blockWeight)
+	{
+		RebuildBlockTemplate_Locked(blockWeight);
+	}
+
+	if (m_pTemplateTransaction == nullptr)
+	{
+		return std::unique_ptr<Transaction>(nullptr);
+	}
+
+	return std::make_unique<Transaction>(*m_pTemplateTransaction);
+}
+
+uint64_t Pool::GetTotalWeight() const
+{
+	std::shared_lock<std::shared_mutex> lockGuard(m_transactionsMutex);
+
+	return m_totalWeight;
 }
 
-bool Pool::ShouldEvict_Locked(const Transaction& transaction, const FullBlock& block) const
+// Rejects transactions that spend an input already spent by, or create an output already created by, a transaction in the pool.
+bool Pool::IsConflicting_Locked(const Transaction& transaction) const
 {
-	const std::vector<TransactionInput>& blockInputs = block.GetTransactionBody().GetInputs();
 	for (const TransactionInput& input : transaction.GetBody().GetInputs())
 	{
-		if (std::find(blockInputs.begin(), blockInputs.end(), input) != blockInputs.end())
+		if (m_transactionsByInput.find(input.GetCommitment()) != m_transactionsByInput.cend())
 		{
 			return true;
 		}
 	}
 
-	const std::vector<TransactionKernel>& blockKernels = block.GetTransactionBody().GetKernels();
-	for (const TransactionKernel& kernel : transaction.GetBody().GetKernels())
+	for (const TransactionOutput& output : transaction.GetBody().GetOutputs())
 	{
-		if (std::find(blockKernels.begin(), blockKernels.end(), kernel) != blockKernels.end())
+		if (m_transactionsByOutput.find(output.GetCommitment()) != m_transactionsByOutput.cend())
 		{
 			return true;
 		}
@@ -176,25 +351,347 @@ bool Pool::ShouldEvict_Locked(const Transaction& transaction, const FullBlock& b
 	return false;
 }
 
-std::unique_ptr<Transaction> Pool::Aggregate() const
+// Evicts the lowest fee rate entries, along with their descendants, until the entry fits within the pool's maximum weight.
+// Returns false, without evicting anything, if the entry can't be made to fit by evicting only entries with a lower fee rate than its own,
+// or if doing so would evict one of the entry's own ancestors.
+bool Pool::MakeRoom_Locked(const TxPoolEntry& entry)
 {
-	std::shared_lock<std::shared_mutex> lockGuard(m_transactionsMutex);
-	if (m_transactions.empty())
+	if (m_totalWeight + entry.GetWeight() <= m_maxWeight)
 	{
-		return std::unique_ptr<Transaction>(nullptr);
+		return true;
+	}
+
+	if (entry.GetWeight() > m_maxWeight)
+	{
+		return false;
+	}
+
+	std::set<EntryIter, FeeRateComparator> entriesToEvict;
+	uint64_t weightToEvict = 0;
+	for (auto iter = m_transactionsByFeeRate.cbegin(); iter != m_transactionsByFeeRate.cend(); iter++)
+	{
+		if (m_totalWeight - weightToEvict + entry.GetWeight() <= m_maxWeight)
+		{
+			break;
+		}
+
+		if (entriesToEvict.count(*iter) > 0)
+		{
+			continue;
+		}
+
+		if (!IsLowerFeeRate((*iter)->GetFee(), (*iter)->GetWeight(), entry.GetFee(), entry.GetWeight()))
+		{
+			return false;
+		}
+
+		std::set<EntryIter, FeeRateComparator> descendants;
+		descendants.insert(*iter);
+		GetDescendants_Locked(*iter, descendants);
+		for (const EntryIter& descendant : descendants)
+		{
+			if (entriesToEvict.insert(descendant).second)
+			{
+				weightToEvict += descendant->GetWeight();
+			}
+		}
+	}
+
+	if (m_totalWeight - weightToEvict + entry.GetWeight() > m_maxWeight)
+	{
+		return false;
+	}
+
+	std::vector<EntryIter> ancestors = GetParents_Locked(entry.GetTransaction());
+	while (!ancestors.empty())
+	{
+		const EntryIter ancestor = ancestors.back();
+		ancestors.pop_back();
+
+		if (entriesToEvict.count(ancestor) > 0)
+		{
+			return false;
+		}
+
+		const std::vector<EntryIter> parents = GetParents_Locked(ancestor->GetTransaction());
+		ancestors.insert(ancestors.end(), parents.cbegin(), parents.cend());
+	}
+
+	LoggerAPI::LogDebug(StringUtil::Format("Pool::MakeRoom - Evicting %llu transactions with weight %llu", (uint64_t)entriesToEvict.size(), weightToEvict));
+	for (const EntryIter& iter : entriesToEvict)
+	{
+		RemoveEntry_Locked(iter);
+	}
+
+	return true;
+}
+
+void Pool::AddEntry_Locked(TxPoolEntry&& entry)
+{
+	const EntryIter iter = m_transactions.emplace(m_transactions.end(), std::move(entry));
+	const TransactionBody& body = iter->GetTransaction().GetBody();
+
+	m_transactionsByHash.emplace(iter->GetTransaction().GetHash(), iter);
+	m_transactionsByFeeRate.insert(iter);
+	m_totalWeight += iter->GetWeight();
+
+	for (const TransactionKernel& kernel : body.GetKernels())
+	{
+		m_transactionsByKernel.emplace(kernel.GetHash(), iter);
+	}
+
+	for (const TransactionInput& input : body.GetInputs())
+	{
+		m_transactionsByInput.emplace(input.GetCommitment(), iter);
+	}
+
+	for (const TransactionOutput& output : body.GetOutputs())
+	{
+		m_transactionsByOutput.emplace(output.GetCommitment(), iter);
+	}
+
+	std::lock_guard<std::mutex> shortIdLockGuard(m_shortIdMutex);
+	if (m_shortIdIndexValid)
+	{
+		for (const TransactionKernel& kernel : body.GetKernels())
+		{
+			m_transactionsByShortId.emplace(ShortId::Create(kernel.GetHash(), m_shortIdBlockHash, m_shortIdNonce), iter);
+		}
+	}
+}
+
+void Pool::RemoveEntry_Locked(const EntryIter& iter)
+{
+	const TransactionBody& body = iter->GetTransaction().GetBody();
+
+	if (m_templateTransactions.count(iter->GetTransaction().GetHash()) > 0)
+	{
+		m_templateValid = false;
+	}
+
+	m_transactionsByHash.erase(iter->GetTransaction().GetHash());
+	m_transactionsByFeeRate.erase(iter);
+	m_totalWeight -= iter->GetWeight();
+
+	for (const TransactionKernel& kernel : body.GetKernels())
+	{
+		EraseIfMatches(m_transactionsByKernel, kernel.GetHash(), iter);
+	}
+
+	for (const TransactionInput& input : body.GetInputs())
+	{
+		EraseIfMatches(m_transactionsByInput, input.GetCommitment(), iter);
+	}
+
+	for (const TransactionOutput& output : body.GetOutputs())
+	{
+		EraseIfMatches(m_transactionsByOutput, output.GetCommitment(), iter);
+	}
+
+	{
+		std::lock_guard<std::mutex> shortIdLockGuard(m_shortIdMutex);
+		if (m_shortIdIndexValid)
+		{
+			for (const TransactionKernel& kernel : body.GetKernels())
+			{
+				auto found = m_transactionsByShortId.find(ShortId::Create(kernel.GetHash(), m_shortIdBlockHash, m_shortIdNonce));
+				if (found != m_transactionsByShortId.end() && found->second == iter)
+				{
+					m_transactionsByShortId.erase(found);
+				}
+			}
+		}
+	}
+
+	m_transactions.erase(iter);
+}
+
+// Returns the pool entries whose outputs are spent by the transaction.
+std::vector<Pool::EntryIter> Pool::GetParents_Locked(const Transaction& transaction) const
+{
+	std::vector<EntryIter> parents;
+	for (const TransactionInput& input : transaction.GetBody().GetInputs())
+	{
+		auto found = m_transactionsByOutput.find(input.GetCommitment());
+		if (found != m_transactionsByOutput.cend())
+		{
+			parents.push_back(found->second);
+		}
+	}
+
+	return parents;
+}
+
+// Adds every pool entry that spends an output of the given entry, directly or indirectly, to descendants.
+void Pool::GetDescendants_Locked(const EntryIter& iter, std::set<EntryIter, FeeRateComparator>& descendants) const
+{
+	for (const TransactionOutput& output : iter->GetTransaction().GetBody().GetOutputs())
+	{
+		auto found = m_transactionsByInput.find(output.GetCommitment());
+		if (found != m_transactionsByInput.cend() && descendants.insert(found->second).second)
+		{
+			GetDescendants_Locked(found->second, descendants);
+		}
+	}
+}
+
+// Returns the entry along with its in-pool ancestors that aren't excluded, ordered so that parents always come before their children.
+Pool::Package Pool::GetPackage_Locked(const EntryIter& iter, const std::unordered_set<Hash>& excluded) const
+{
+	Package package{ std::vector<EntryIter>(), 0, 0 };
+	if (excluded.count(iter->GetTransaction().GetHash()) > 0)
+	{
+		return package;
+	}
+
+	std::unordered_set<Hash> visited;
+	std::vector<std::pair<EntryIter, bool>> stack({ std::make_pair(iter, false) });
+	while (!stack.empty())
+	{
+		const std::pair<EntryIter, bool> next = stack.back();
+		stack.pop_back();
+
+		const Hash& hash = next.first->GetTransaction().GetHash();
+		if (next.second)
+		{
+			// All of its ancestors have been added.
+			package.entries.push_back(next.first);
+			package.fee += next.first->GetFee();
+			package.weight += next.first->GetWeight();
+		}
+		else if (visited.insert(hash).second)
+		{
+			stack.push_back(std::make_pair(next.first, true));
+			for (const EntryIter& parent : GetParents_Locked(next.first->GetTransaction()))
+			{
+				if (excluded.count(parent->GetTransaction().GetHash()) == 0 && visited.count(parent->GetTransaction().GetHash()) == 0)
+				{
+					stack.push_back(std::make_pair(parent, false));
+				}
+			}
+		}
+	}
+
+	return package;
+}
+
+// Appends a newly added entry (and any of its ancestors not already included) to the cached block template if it fits.
+// If it doesn't fit but pays a higher fee rate than something already in the template, the template is rebuilt on next use.
+void Pool::ExtendBlockTemplate_Locked(const EntryIter& iter)
+{
+	if (!m_templateValid)
+	{
+		return;
+	}
+
+	const Package package = GetPackage_Locked(iter, m_templateTransactions);
+	if (package.entries.empty())
+	{
+		return;
+	}
+
+	if (m_templateWeight + package.weight > GetAvailableWeight(m_templateMaxWeight))
+	{
+		if (m_templateTransactions.empty() || IsLowerFeeRate(m_templateMinFee, m_templateMinWeight, package.fee, package.weight))
+		{
+			m_templateValid = false;
+		}
+
+		return;
 	}
 
 	std::vector<Transaction> transactions;
-	for (const TxPoolEntry& entry : m_transactions)
+	transactions.reserve(package.entries.size() + 1);
+	if (!m_templateTransactions.empty())
 	{
-		transactions.push_back(entry.GetTransaction());
+		transactions.push_back(*m_pTemplateTransaction);
 	}
 
-	std::unique_ptr<Transaction> pAggregateTransaction = TransactionAggregator::Aggregate(transactions);
-	if (pAggregateTransaction != nullptr)
+	for (const EntryIter& entry : package.entries)
 	{
-		// TODO: tx.validate(self.verifier_cache.clone()) ? ;
+		transactions.push_back(entry->GetTransaction());
 	}
 
-	return pAggregateTransaction;
+	std::unique_ptr<Transaction> pTemplateTransaction = TransactionAggregator::Aggregate(transactions);
+	if (pTemplateTransaction == nullptr)
+	{
+		m_templateValid = false;
+		return;
+	}
+
+	for (const EntryIter& entry : package.entries)
+	{
+		m_templateTransactions.insert(entry->GetTransaction().GetHash());
+	}
+
+	if (m_templateTransactions.size() == package.entries.size() || IsLowerFeeRate(package.fee, package.weight, m_templateMinFee, m_templateMinWeight))
+	{
+		m_templateMinFee = package.fee;
+		m_templateMinWeight = package.weight;
+	}
+
+	m_templateWeight += package.weight;
+	m_pTemplateTransaction = std::move(pTemplateTransaction);
+}
+
+// Greedily selects packages (entries plus their in-pool ancestors) in order of their combined fee rate until the block is full.
+void Pool::RebuildBlockTemplate_Locked(const uint64_t maxWeight)
+{
+	m_templateValid = false;
+	m_templateMaxWeight = maxWeight;
+	m_templateWeight = 0;
+	m_templateMinFee = 0;
+	m_templateMinWeight = 1;
+	m_templateTransactions.clear();
+	m_pTemplateTransaction.reset();
+
+	const uint64_t availableWeight = GetAvailableWeight(maxWeight);
+
+	std::vector<Package> packages;
+	packages.reserve(m_transactions.size());
+	for (auto iter = m_transactions.begin(); iter != m_transactions.end(); iter++)
+	{
+		packages.emplace_back(GetPackage_Locked(iter, m_templateTransactions));
+	}
+
+	std::stable_sort(packages.begin(), packages.end(), [](const Package& lhs, const Package& rhs)
+	{
+		return IsLowerFeeRate(rhs.fee, rhs.weight, lhs.fee, lhs.weight);
+	});
+
+	std::vector<Transaction> transactions;
+	for (const Package& candidate : packages)
+	{
+		// Ancestors selected as part of an earlier package no longer count towards this one.
+		const Package package = GetPackage_Locked(candidate.entries.back(), m_templateTransactions);
+		if (package.entries.empty() || m_templateWeight + package.weight > availableWeight)
+		{
+			continue;
+		}
+
+		for (const EntryIter& entry : package.entries)
+		{
+			transactions.push_back(entry->GetTransaction());
+			m_templateTransactions.insert(entry->GetTransaction().GetHash());
+		}
+
+		if (transactions.size() == package.entries.size() || IsLowerFeeRate(package.fee, package.weight, m_templateMinFee, m_templateMinWeight))
+		{
+			m_templateMinFee = package.fee;
+			m_templateMinWeight = package.weight;
+		}
+
+		m_templateWeight += package.weight;
+	}
+
+	m_pTemplateTransaction = TransactionAggregator::Aggregate(transactions);
+	if (m_pTemplateTransaction == nullptr)
+	{
+		LoggerAPI::LogError("Pool::BuildBlockTemplate - Failed to aggregate block template transactions.");
+		m_templateTransactions.clear();
+		m_templateWeight = 0;
+		return;
+	}
+
+	m_templateValid = true;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "TxPoolEntry.h"
+#include "VerifierCache.h"
 
 #include <TxPool/DandelionStatus.h>
 #include <Core/Transaction.h>
@@ -8,16 +9,41 @@
 #include <Core/FullBlock.h>
 #include <Core/ShortId.h>
 #include <Hash.h>
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
 
+//
+// Entries are kept in insertion order, and indexed by transaction hash, kernel hash, input commitment and output commitment,
+// so lookups, removals and block reconciliation cost proportional to the number of items looked up, not to the size of the pool.
+//
+// Entries are also ordered by fee rate (fee per unit of block weight). When adding a transaction would push the pool over its
+// maximum weight, the lowest fee rate entries (along with any entries spending their outputs) are evicted to make room,
+// provided they pay a lower fee rate than the new transaction.
+//
+// A block template (an aggregate of the most profitable transactions that fit in a block) is cached and extended as transactions arrive.
+// It's only rebuilt when a template transaction is removed, or when a new transaction should displace something already in it.
+//
+// Kernel short ids depend on the block hash and nonce of the compact block being hydrated, so that index is built lazily
+// on the first lookup for a given (block hash, nonce) pair and then reused for the rest of the compact block.
+//
 class Pool
 {
 public:
+	Pool(VerifierCache& verifierCache, const uint64_t maxWeight);
+
 	bool AddTransaction(const Transaction& transaction, const EDandelionStatus status);
 	void RemoveTransactions(const std::vector<Transaction>& transactions);
-	void ReconcileBlock(const FullBlock& block);
+	//
+	// Evicts every transaction that shares a kernel or spends an input with the block.
+	// Returns the evicted transactions whose kernels are in the block, which are the ones the block confirmed.
+	//
+	std::vector<Transaction> ReconcileBlock(const FullBlock& block);
 
 	std::vector<Transaction> GetTransactionsByShortId(const Hash& hash, const uint64_t nonce, const std::set<ShortId>& missingShortIds) const;
 	std::vector<Transaction> FindTransactionsByKernel(const std::set<TransactionKernel>& kernels) const;
@@ -26,9 +52,69 @@ public:
 
 	std::unique_ptr<Transaction> Aggregate() const;
 
+	//
+	// Returns an aggregate, with cut-through applied, of the highest fee rate transactions (and their in-pool ancestors)
+	// that fit within maxWeight, leaving room for the coinbase output and kernel. maxWeight is capped at Consensus::MAX_BLOCK_WEIGHT.
+	//
+	std::unique_ptr<Transaction> BuildBlockTemplate(const uint64_t maxWeight);
+
+	uint64_t GetTotalWeight() const;
+
 private:
-	bool ShouldEvict_Locked(const Transaction& transaction, const FullBlock& block) const;
+	typedef std::list<TxPoolEntry>::iterator EntryIter;
+	typedef std::list<TxPoolEntry>::const_iterator ConstEntryIter;
+
+	// Orders entries from lowest to highest fee rate.
+	struct FeeRateComparator
+	{
+		bool operator()(const EntryIter& lhs, const EntryIter& rhs) const;
+	};
+
+	// The combined fee and weight of an entry and its in-pool ancestors.
+	struct Package
+	{
+		std::vector<EntryIter> entries;
+		uint64_t fee;
+		uint64_t weight;
+	};
+
+	bool IsConflicting_Locked(const Transaction& transaction) const;
+	bool MakeRoom_Locked(const TxPoolEntry& entry);
+	void AddEntry_Locked(TxPoolEntry&& entry);
+	void RemoveEntry_Locked(const EntryIter& iter);
+
+	std::vector<EntryIter> GetParents_Locked(const Transaction& transaction) const;
+	void GetDescendants_Locked(const EntryIter& iter, std::set<EntryIter, FeeRateComparator>& descendants) const;
+	Package GetPackage_Locked(const EntryIter& iter, const std::unordered_set<Hash>& excluded) const;
+
+	void ExtendBlockTemplate_Locked(const EntryIter& iter);
+	void RebuildBlockTemplate_Locked(const uint64_t maxWeight);
+
+	VerifierCache& m_verifierCache;
 
 	mutable std::shared_mutex m_transactionsMutex;
-	std::vector<TxPoolEntry> m_transactions;
+	std::list<TxPoolEntry> m_transactions;
+	std::unordered_map<Hash, EntryIter> m_transactionsByHash;
+	std::unordered_map<Hash, EntryIter> m_transactionsByKernel;
+	std::unordered_map<Commitment, EntryIter> m_transactionsByInput;
+	std::unordered_map<Commitment, EntryIter> m_transactionsByOutput;
+	std::set<EntryIter, FeeRateComparator> m_transactionsByFeeRate;
+	uint64_t m_totalWeight;
+	const uint64_t m_maxWeight;
+
+	// Cached block template. Guarded by m_transactionsMutex.
+	bool m_templateValid;
+	uint64_t m_templateMaxWeight;
+	uint64_t m_templateWeight;
+	uint64_t m_templateMinFee;
+	uint64_t m_templateMinWeight;
+	std::unordered_set<Hash> m_templateTransactions;
+	std::unique_ptr<Transaction> m_pTemplateTransaction;
+
+	// Lazily built short id index. Guarded by m_shortIdMutex, and only touched while m_transactionsMutex is also held (shared or exclusive).
+	mutable std::mutex m_shortIdMutex;
+	mutable bool m_shortIdIndexValid;
+	mutable Hash m_shortIdBlockHash;
+	mutable uint64_t m_shortIdNonce;
+	mutable std::unordered_map<ShortId, ConstEntryIter> m_transactionsByShortId;
 };
\ No newline at end of file
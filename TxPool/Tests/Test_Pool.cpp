@@ -0,0 +1,248 @@
+#include <Catch2/catch.hpp>
+
+#include "../Pool.h"
+
+#include <Crypto.h>
+#include <Consensus/BlockWeight.h>
+#include <algorithm>
+
+// Weight of a transaction with a single output and kernel.
+static const uint64_t TX_WEIGHT = Consensus::BLOCK_OUTPUT_WEIGHT + Consensus::BLOCK_KERNEL_WEIGHT;
+
+// Weight of a transaction with a single input, output and kernel.
+static const uint64_t CHILD_TX_WEIGHT = Consensus::BLOCK_INPUT_WEIGHT + TX_WEIGHT;
+
+// Room the block template leaves for the coinbase output and kernel.
+static const uint64_t COINBASE_WEIGHT = Consensus::BLOCK_OUTPUT_WEIGHT + Consensus::BLOCK_KERNEL_WEIGHT;
+
+static Commitment Commit(const uint64_t value, const unsigned char blind)
+{
+	return *Crypto::CommitBlinded(value, BlindingFactor(CBigInteger<32>::ValueOf(blind)));
+}
+
+//
+// Creates a transaction with a single output (committing to the given value and blind) and kernel, optionally spending the given input.
+// The kernel excess and offset balance the transaction, so its kernel sums are valid. Its range proof and signature are made up,
+// so they're added to the verifier cache, which is what lets the pool accept it.
+//
+static Transaction CreateTransaction(VerifierCache& verifierCache, const uint64_t fee, const unsigned char blind, const Commitment* pInput = nullptr)
+{
+	std::vector<TransactionInput> inputs;
+	std::vector<Commitment> inputCommitments;
+	if (pInput != nullptr)
+	{
+		inputs.emplace_back(TransactionInput(EOutputFeatures::DEFAULT_OUTPUT, Commitment(*pInput)));
+		inputCommitments.push_back(*pInput);
+	}
+
+	const Commitment outputCommitment = Commit(1000, blind);
+	std::vector<TransactionOutput> outputs;
+	outputs.emplace_back(TransactionOutput(EOutputFeatures::DEFAULT_OUTPUT, Commitment(outputCommitment), RangeProof(std::vector<unsigned char>(675, blind))));
+
+	// Nonzero offsets, since the block template sums them.
+	BlindingFactor offset(CBigInteger<32>::ValueOf(blind + 100));
+	inputCommitments.push_back(Commit(0, blind + 100));
+
+	std::unique_ptr<Commitment> pExcess = Crypto::AddCommitments({ outputCommitment, *Crypto::CommitTransparent(fee) }, inputCommitments);
+	std::vector<TransactionKernel> kernels;
+	kernels.emplace_back(TransactionKernel(EKernelFeatures::DEFAULT_KERNEL, fee, 0, Commitment(*pExcess), Signature(CBigInteger<64>::ValueOf(blind))));
+
+	verifierCache.AddVerifiedRangeProofs(outputs);
+	verifierCache.AddVerifiedKernels(kernels);
+
+	return Transaction(std::move(offset), TransactionBody(std::move(inputs), std::move(outputs), std::move(kernels)));
+}
+
+static bool Contains(const Pool& pool, const Transaction& transaction)
+{
+	return !pool.FindTransactionsByKernel({ transaction.GetBody().GetKernels().front() }).empty();
+}
+
+static std::vector<TransactionKernel> GetKernels(const std::vector<Transaction>& transactions)
+{
+	std::vector<TransactionKernel> kernels;
+	for (const Transaction& transaction : transactions)
+	{
+		kernels.push_back(transaction.GetBody().GetKernels().front());
+	}
+
+	std::sort(kernels.begin(), kernels.end());
+	return kernels;
+}
+
+TEST_CASE("Pool - Evicts lowest fee rate")
+{
+	VerifierCache verifierCache(100, 100);
+	Pool pool(verifierCache, 3 * TX_WEIGHT);
+
+	const Transaction transaction1 = CreateTransaction(verifierCache, 10, 1);
+	const Transaction transaction2 = CreateTransaction(verifierCache, 30, 2);
+	const Transaction transaction3 = CreateTransaction(verifierCache, 20, 3);
+	REQUIRE(pool.AddTransaction(transaction1, EDandelionStatus::FLUFFED));
+	REQUIRE(pool.AddTransaction(transaction2, EDandelionStatus::FLUFFED));
+	REQUIRE(pool.AddTransaction(transaction3, EDandelionStatus::FLUFFED));
+	REQUIRE(pool.GetTotalWeight() == 3 * TX_WEIGHT);
+
+	SECTION("Higher fee rate replaces lowest")
+	{
+		const Transaction transaction4 = CreateTransaction(verifierCache, 15, 4);
+		REQUIRE(pool.AddTransaction(transaction4, EDandelionStatus::FLUFFED));
+		REQUIRE(pool.GetTotalWeight() == 3 * TX_WEIGHT);
+		REQUIRE(!Contains(pool, transaction1));
+		REQUIRE(Contains(pool, transaction2));
+		REQUIRE(Contains(pool, transaction3));
+		REQUIRE(Contains(pool, transaction4));
+	}
+
+	SECTION("Lower fee rate rejected")
+	{
+		const Transaction transaction4 = CreateTransaction(verifierCache, 5, 4);
+		REQUIRE(!pool.AddTransaction(transaction4, EDandelionStatus::FLUFFED));
+		REQUIRE(!Contains(pool, transaction4));
+		REQUIRE(Contains(pool, transaction1));
+		REQUIRE(Contains(pool, transaction2));
+		REQUIRE(Contains(pool, transaction3));
+	}
+
+	SECTION("Equal fee rate rejected")
+	{
+		REQUIRE(!pool.AddTransaction(CreateTransaction(verifierCache, 10, 4), EDandelionStatus::FLUFFED));
+		REQUIRE(Contains(pool, transaction1));
+	}
+}
+
+TEST_CASE("Pool - Evicts descendants of evicted transactions")
+{
+	VerifierCache verifierCache(100, 100);
+	Pool pool(verifierCache, (2 * TX_WEIGHT) + CHILD_TX_WEIGHT);
+
+	const Transaction parent = CreateTransaction(verifierCache, 10, 1);
+	const Transaction child = CreateTransaction(verifierCache, 100, 2, &parent.GetBody().GetOutputs().front().GetCommitment());
+	const Transaction other = CreateTransaction(verifierCache, 50, 3);
+	REQUIRE(pool.AddTransaction(parent, EDandelionStatus::FLUFFED));
+	REQUIRE(pool.AddTransaction(child, EDandelionStatus::FLUFFED));
+	REQUIRE(pool.AddTransaction(other, EDandelionStatus::FLUFFED));
+
+	const Transaction transaction = CreateTransaction(verifierCache, 20, 4);
+	REQUIRE(pool.AddTransaction(transaction, EDandelionStatus::FLUFFED));
+	REQUIRE(pool.GetTotalWeight() == 2 * TX_WEIGHT);
+	REQUIRE(!Contains(pool, parent));
+	REQUIRE(!Contains(pool, child));
+	REQUIRE(Contains(pool, other));
+	REQUIRE(Contains(pool, transaction));
+}
+
+TEST_CASE("Pool - Doesn't evict ancestors of new transaction")
+{
+	VerifierCache verifierCache(100, 100);
+	Pool pool(verifierCache, (2 * TX_WEIGHT) + CHILD_TX_WEIGHT - 1);
+
+	const Transaction parent = CreateTransaction(verifierCache, 10, 1);
+	const Transaction other = CreateTransaction(verifierCache, 50, 2);
+	REQUIRE(pool.AddTransaction(parent, EDandelionStatus::FLUFFED));
+	REQUIRE(pool.AddTransaction(other, EDandelionStatus::FLUFFED));
+
+	// Making room for the child would require evicting its own parent.
+	const Transaction child = CreateTransaction(verifierCache, 100, 3, &parent.GetBody().GetOutputs().front().GetCommitment());
+	REQUIRE(!pool.AddTransaction(child, EDandelionStatus::FLUFFED));
+	REQUIRE(Contains(pool, parent));
+	REQUIRE(Contains(pool, other));
+	REQUIRE(pool.GetTotalWeight() == 2 * TX_WEIGHT);
+}
+
+TEST_CASE("Pool - Fee rates don't overflow")
+{
+	VerifierCache verifierCache(100, 100);
+	Pool pool(verifierCache, 2 * TX_WEIGHT);
+
+	// fee * weight overflows 64 bits for this fee.
+	const Transaction highFee = CreateTransaction(verifierCache, 1ull << 62, 1);
+	const Transaction lowFee = CreateTransaction(verifierCache, 1, 2);
+	REQUIRE(pool.AddTransaction(highFee, EDandelionStatus::FLUFFED));
+	REQUIRE(pool.AddTransaction(lowFee, EDandelionStatus::FLUFFED));
+
+	const Transaction transaction = CreateTransaction(verifierCache, 2, 3);
+	REQUIRE(pool.AddTransaction(transaction, EDandelionStatus::FLUFFED));
+	REQUIRE(Contains(pool, highFee));
+	REQUIRE(!Contains(pool, lowFee));
+	REQUIRE(Contains(pool, transaction));
+}
+
+TEST_CASE("Pool::BuildBlockTemplate - Weight limit")
+{
+	VerifierCache verifierCache(100, 100);
+	Pool pool(verifierCache, Consensus::MAX_BLOCK_WEIGHT);
+
+	const Transaction transaction1 = CreateTransaction(verifierCache, 10, 1);
+	const Transaction transaction2 = CreateTransaction(verifierCache, 40, 2);
+	const Transaction transaction3 = CreateTransaction(verifierCache, 20, 3);
+	const Transaction transaction4 = CreateTransaction(verifierCache, 30, 4);
+	for (const Transaction& transaction : { transaction1, transaction2, transaction3, transaction4 })
+	{
+		REQUIRE(pool.AddTransaction(transaction, EDandelionStatus::FLUFFED));
+	}
+
+	// Only the two highest fee rate transactions fit, once the coinbase is accounted for.
+	std::unique_ptr<Transaction> pTemplate = pool.BuildBlockTemplate(COINBASE_WEIGHT + (3 * TX_WEIGHT) - 1);
+	REQUIRE(pTemplate != nullptr);
+	REQUIRE(pTemplate->GetBody().GetKernels() == GetKernels({ transaction2, transaction4 }));
+	REQUIRE(pTemplate->GetBody().GetOutputs().size() == 2);
+
+	// A new transaction with a higher fee rate displaces the lowest one in the template.
+	const Transaction transaction5 = CreateTransaction(verifierCache, 35, 5);
+	REQUIRE(pool.AddTransaction(transaction5, EDandelionStatus::FLUFFED));
+	pTemplate = pool.BuildBlockTemplate(COINBASE_WEIGHT + (3 * TX_WEIGHT) - 1);
+	REQUIRE(pTemplate != nullptr);
+	REQUIRE(pTemplate->GetBody().GetKernels() == GetKernels({ transaction2, transaction5 }));
+
+	// A template with room for everything includes everything.
+	pTemplate = pool.BuildBlockTemplate(Consensus::MAX_BLOCK_WEIGHT);
+	REQUIRE(pTemplate != nullptr);
+	REQUIRE(pTemplate->GetBody().GetKernels() == GetKernels({ transaction1, transaction2, transaction3, transaction4, transaction5 }));
+
+	// No room for anything but the coinbase.
+	pTemplate = pool.BuildBlockTemplate(COINBASE_WEIGHT);
+	REQUIRE(pTemplate != nullptr);
+	REQUIRE(pTemplate->GetBody().GetKernels().empty());
+}
+
+TEST_CASE("Pool::BuildBlockTemplate - Dependencies")
+{
+	VerifierCache verifierCache(100, 100);
+	Pool pool(verifierCache, Consensus::MAX_BLOCK_WEIGHT);
+
+	// The child's fee pays for its low fee parent: (1 + 100) / (24 + 25) is a higher fee rate than 30 / 24.
+	const Transaction parent = CreateTransaction(verifierCache, 1, 1);
+	const Transaction child = CreateTransaction(verifierCache, 100, 2, &parent.GetBody().GetOutputs().front().GetCommitment());
+	const Transaction other = CreateTransaction(verifierCache, 30, 3);
+	REQUIRE(pool.AddTransaction(parent, EDandelionStatus::FLUFFED));
+	REQUIRE(pool.AddTransaction(child, EDandelionStatus::FLUFFED));
+	REQUIRE(pool.AddTransaction(other, EDandelionStatus::FLUFFED));
+
+	SECTION("Child included with its parent")
+	{
+		std::unique_ptr<Transaction> pTemplate = pool.BuildBlockTemplate(COINBASE_WEIGHT + TX_WEIGHT + CHILD_TX_WEIGHT);
+		REQUIRE(pTemplate != nullptr);
+		REQUIRE(pTemplate->GetBody().GetKernels() == GetKernels({ parent, child }));
+
+		// The parent's output is spent by the child, so cut-through removes it.
+		REQUIRE(pTemplate->GetBody().GetInputs().empty());
+		REQUIRE(pTemplate->GetBody().GetOutputs() == child.GetBody().GetOutputs());
+	}
+
+	SECTION("Child never included without its parent")
+	{
+		std::unique_ptr<Transaction> pTemplate = pool.BuildBlockTemplate(COINBASE_WEIGHT + CHILD_TX_WEIGHT);
+		REQUIRE(pTemplate != nullptr);
+		REQUIRE(pTemplate->GetBody().GetKernels() == GetKernels({ other }));
+	}
+
+	SECTION("Everything")
+	{
+		std::unique_ptr<Transaction> pTemplate = pool.BuildBlockTemplate(Consensus::MAX_BLOCK_WEIGHT);
+		REQUIRE(pTemplate != nullptr);
+		REQUIRE(pTemplate->GetBody().GetKernels() == GetKernels({ parent, child, other }));
+		REQUIRE(pTemplate->GetBody().GetInputs().empty());
+		REQUIRE(pTemplate->GetBody().GetOutputs().size() == 2);
+	}
+}
\ No newline at end of file
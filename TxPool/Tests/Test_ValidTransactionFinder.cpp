@@ -0,0 +1,189 @@
+#include <Catch2/catch.hpp>
+
+#include "../ValidTransactionFinder.h"
+
+#include <Config/Genesis.h>
+#include <Core/OutputIdentifier.h>
+#include <Crypto.h>
+#include <BitUtil.h>
+#include <filesystem>
+#include <set>
+
+static Config CreateConfig(const std::string& testName)
+{
+	const std::string dataPath = (std::filesystem::temp_directory_path() / testName).string() + "/";
+	std::filesystem::remove_all(dataPath);
+
+	const Environment environment(EEnvironmentType::FLOONET, Genesis::FLOONET_GENESIS, { 83, 59 }, 13414, BitUtil::ConvertToU32(0x03, 0x3C, 0x04, 0xA4), BitUtil::ConvertToU32(0x03, 0x3C, 0x08, 0xDF));
+	return Config(EClientMode::FAST_SYNC, environment, dataPath, DandelionConfig(10, 180, 15, 90), P2PConfig(), DatabaseConfig());
+}
+
+//
+// A UTXO set holding only the given commitments.
+//
+class TestTxHashSet : public ITxHashSet
+{
+public:
+	TestTxHashSet(const std::set<Commitment>& unspent) : m_unspent(unspent) { }
+
+	virtual bool IsUnspent(const OutputIdentifier& output) const override final { return m_unspent.count(output.GetCommitment()) > 0; }
+	virtual bool IsValid(const Transaction&) const override final { return false; }
+	virtual bool Validate(const BlockHeader&, const IBlockChainServer&, const bool, Commitment&, Commitment&) override final { return false; }
+	virtual bool ApplyBlock(const FullBlock&) override final { return false; }
+	virtual bool SaveOutputPositions() override final { return false; }
+	virtual bool Snapshot(const BlockHeader&) override final { return false; }
+	virtual bool Rewind(const BlockHeader&) override final { return false; }
+	virtual bool Commit() override final { return false; }
+	virtual bool Discard() override final { return false; }
+	virtual bool Compact() override final { return false; }
+
+private:
+	std::set<Commitment> m_unspent;
+};
+
+//
+// Serves the same BlockSums for every block.
+//
+class TestBlockDB : public IBlockDB
+{
+public:
+	TestBlockDB(const BlockSums& blockSums) : m_blockSums(blockSums) { }
+
+	virtual std::vector<BlockHeader*> LoadBlockHeaders(const std::vector<Hash>&) const override final { return std::vector<BlockHeader*>(); }
+	virtual std::unique_ptr<BlockHeader> GetBlockHeader(const Hash&) const override final { return std::unique_ptr<BlockHeader>(nullptr); }
+	virtual void AddBlockHeader(const BlockHeader&) override final { }
+	virtual void AddBlockHeaders(const std::vector<const BlockHeader*>&) override final { }
+	virtual void AddBlock(const FullBlock&) override final { }
+	virtual std::unique_ptr<FullBlock> GetBlock(const Hash&) const override final { return std::unique_ptr<FullBlock>(nullptr); }
+	virtual void AddBlockSums(const Hash&, const BlockSums&) override final { }
+	virtual std::unique_ptr<BlockSums> GetBlockSums(const Hash&) const override final { return std::make_unique<BlockSums>(m_blockSums); }
+	virtual void AddOutputPosition(const Commitment&, const uint64_t) override final { }
+	virtual std::optional<uint64_t> GetOutputPosition(const Commitment&) const override final { return std::nullopt; }
+	virtual bool AddOutputPositions(const std::vector<std::pair<Commitment, uint64_t>>&) override final { return false; }
+
+private:
+	BlockSums m_blockSums;
+};
+
+static Commitment Commit(const uint64_t value, const unsigned char blind)
+{
+	return *Crypto::CommitBlinded(value, BlindingFactor(CBigInteger<32>::ValueOf(blind)));
+}
+
+//
+// Creates a transaction spending the given commitment into a new output (committing to the given value and blind).
+// The kernel excess balances the transaction against its offset, so its kernel sums are valid. Its range proof and
+// signature are made up, so they're added to the verifier cache, which is what lets it pass validation.
+//
+static Transaction CreateTransaction(VerifierCache& verifierCache, const Commitment& input, const unsigned char blind, const uint64_t fee = 10)
+{
+	std::vector<TransactionInput> inputs({ TransactionInput(EOutputFeatures::DEFAULT_OUTPUT, Commitment(input)) });
+
+	const Commitment outputCommitment = Commit(1000, blind);
+	std::vector<TransactionOutput> outputs({ TransactionOutput(EOutputFeatures::DEFAULT_OUTPUT, Commitment(outputCommitment), RangeProof(std::vector<unsigned char>(675, blind))) });
+
+	BlindingFactor offset(CBigInteger<32>::ValueOf(blind + 100));
+	std::unique_ptr<Commitment> pExcess = Crypto::AddCommitments({ outputCommitment, *Crypto::CommitTransparent(fee) }, { input, Commit(0, blind + 100) });
+	std::vector<TransactionKernel> kernels({ TransactionKernel(EKernelFeatures::DEFAULT_KERNEL, fee, 0, Commitment(*pExcess), Signature(CBigInteger<64>::ValueOf(blind))) });
+
+	verifierCache.AddVerifiedRangeProofs(outputs);
+	verifierCache.AddVerifiedKernels(kernels);
+
+	return Transaction(std::move(offset), TransactionBody(std::move(inputs), std::move(outputs), std::move(kernels)));
+}
+
+static const Commitment& GetOutput(const Transaction& transaction)
+{
+	return transaction.GetBody().GetOutputs().front().GetCommitment();
+}
+
+static std::vector<Hash> GetHashes(const std::vector<Transaction>& transactions)
+{
+	std::vector<Hash> hashes;
+	for (const Transaction& transaction : transactions)
+	{
+		hashes.push_back(transaction.GetHash());
+	}
+
+	return hashes;
+}
+
+TEST_CASE("ValidTransactionFinder")
+{
+	const Config config = CreateConfig("Test_ValidTransactionFinder");
+
+	// The genesis header has a zero total kernel offset, so any block sums with equal output and kernel sums are balanced.
+	const BlockHeader& header = Genesis::MAINNET_GENESIS.GetBlockHeader();
+	const BlockSums blockSums(Commit(5, 7), Commit(5, 7));
+	TestBlockDB blockDB(blockSums);
+
+	const Commitment utxo1 = Commit(1000, 1);
+	const Commitment utxo2 = Commit(1000, 2);
+	TxHashSetManager txHashSetManager(config, blockDB);
+	txHashSetManager.SetTxHashSet(new TestTxHashSet({ utxo1, utxo2 }));
+
+	VerifierCache verifierCache(100, 100);
+	const ValidTransactionFinder finder(txHashSetManager, blockDB, verifierCache);
+
+	SECTION("Parent and child")
+	{
+		const Transaction parent = CreateTransaction(verifierCache, utxo1, 11);
+		const Transaction child = CreateTransaction(verifierCache, GetOutput(parent), 12);
+		const Transaction grandchild = CreateTransaction(verifierCache, GetOutput(child), 13);
+
+		const std::vector<Transaction> valid = finder.FindValidTransactions({ parent, child, grandchild }, nullptr, header);
+		REQUIRE(GetHashes(valid) == GetHashes({ parent, child, grandchild }));
+
+		// A child can't come before its parent.
+		REQUIRE(GetHashes(finder.FindValidTransactions({ child, parent }, nullptr, header)) == GetHashes({ parent }));
+	}
+
+	SECTION("Child of extra transaction")
+	{
+		const std::unique_ptr<Transaction> pExtraTransaction = std::make_unique<Transaction>(CreateTransaction(verifierCache, utxo1, 11));
+		const Transaction child = CreateTransaction(verifierCache, GetOutput(*pExtraTransaction), 12);
+
+		const std::vector<Transaction> valid = finder.FindValidTransactions({ child }, pExtraTransaction, header);
+		REQUIRE(GetHashes(valid) == GetHashes({ child }));
+	}
+
+	SECTION("Double spend")
+	{
+		const Transaction transaction1 = CreateTransaction(verifierCache, utxo1, 11);
+		const Transaction transaction2 = CreateTransaction(verifierCache, utxo1, 12);
+		const Transaction transaction3 = CreateTransaction(verifierCache, utxo2, 13);
+
+		const std::vector<Transaction> valid = finder.FindValidTransactions({ transaction1, transaction2, transaction3 }, nullptr, header);
+		REQUIRE(GetHashes(valid) == GetHashes({ transaction1, transaction3 }));
+
+		// Spending an output of an accepted transaction twice.
+		const Transaction child1 = CreateTransaction(verifierCache, GetOutput(transaction1), 14);
+		const Transaction child2 = CreateTransaction(verifierCache, GetOutput(transaction1), 15);
+		REQUIRE(GetHashes(finder.FindValidTransactions({ transaction1, child1, child2 }, nullptr, header)) == GetHashes({ transaction1, child1 }));
+	}
+
+	SECTION("Not in UTXO set")
+	{
+		const Transaction missingInput = CreateTransaction(verifierCache, Commit(1000, 3), 11);
+		const Transaction duplicateOutput = CreateTransaction(verifierCache, utxo1, 2);
+		const Transaction transaction = CreateTransaction(verifierCache, utxo2, 12);
+
+		const std::vector<Transaction> valid = finder.FindValidTransactions({ missingInput, duplicateOutput, transaction }, nullptr, header);
+		REQUIRE(GetHashes(valid) == GetHashes({ transaction }));
+	}
+
+	SECTION("Bad offset")
+	{
+		const Transaction transaction = CreateTransaction(verifierCache, utxo1, 11);
+		BlindingFactor badOffset(CBigInteger<32>::ValueOf(50));
+		TransactionBody body = transaction.GetBody();
+		const Transaction badTransaction(std::move(badOffset), std::move(body));
+
+		const Transaction other = CreateTransaction(verifierCache, utxo2, 12);
+
+		const std::vector<Transaction> valid = finder.FindValidTransactions({ badTransaction, other, transaction }, nullptr, header);
+		REQUIRE(GetHashes(valid) == GetHashes({ other, transaction }));
+	}
+
+	txHashSetManager.Close();
+}
\ No newline at end of file
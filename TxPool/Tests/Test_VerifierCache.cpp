@@ -0,0 +1,58 @@
+#include <Catch2/catch.hpp>
+
+#include "../VerifierCache.h"
+
+#include <Config/Genesis.h>
+
+TEST_CASE("VerifierCache - Filter and Add")
+{
+	const TransactionBody& body = Genesis::MAINNET_GENESIS.GetTransactionBody();
+	const std::vector<TransactionOutput>& outputs = body.GetOutputs();
+	const std::vector<TransactionKernel>& kernels = body.GetKernels();
+
+	VerifierCache verifierCache(10, 10);
+	REQUIRE(verifierCache.FilterUnverifiedRangeProofs(outputs).size() == outputs.size());
+	REQUIRE(verifierCache.FilterUnverifiedKernels(kernels).size() == kernels.size());
+
+	verifierCache.AddVerifiedRangeProofs(outputs);
+	verifierCache.AddVerifiedKernels(kernels);
+	REQUIRE(verifierCache.FilterUnverifiedRangeProofs(outputs).empty());
+	REQUIRE(verifierCache.FilterUnverifiedKernels(kernels).empty());
+
+	REQUIRE(verifierCache.GetRangeProofHits() == outputs.size());
+	REQUIRE(verifierCache.GetRangeProofMisses() == outputs.size());
+	REQUIRE(verifierCache.GetKernelHits() == kernels.size());
+	REQUIRE(verifierCache.GetKernelMisses() == kernels.size());
+
+	// The same commitment with a different proof must still be verified.
+	const TransactionOutput& output = outputs.front();
+	std::vector<unsigned char> proofBytes = output.GetRangeProof().GetProofBytes();
+	proofBytes[0] ^= 1;
+	const TransactionOutput modifiedOutput(output.GetFeatures(), Commitment(output.GetCommitment()), RangeProof(std::move(proofBytes)));
+	REQUIRE(modifiedOutput.GetHash() == output.GetHash());
+	REQUIRE(verifierCache.FilterUnverifiedRangeProofs({ modifiedOutput }).size() == 1);
+}
+
+TEST_CASE("VerifierCache - Evicts least recently used")
+{
+	const TransactionOutput& output = Genesis::MAINNET_GENESIS.GetTransactionBody().GetOutputs().front();
+
+	std::vector<TransactionOutput> outputs;
+	for (unsigned char i = 0; i < 3; i++)
+	{
+		std::vector<unsigned char> proofBytes = output.GetRangeProof().GetProofBytes();
+		proofBytes[0] = i;
+		outputs.emplace_back(TransactionOutput(output.GetFeatures(), Commitment(output.GetCommitment()), RangeProof(std::move(proofBytes))));
+	}
+
+	VerifierCache verifierCache(2, 2);
+	verifierCache.AddVerifiedRangeProofs({ outputs[0], outputs[1] });
+
+	// Touch outputs[0] so outputs[1] is the least recently used.
+	REQUIRE(verifierCache.FilterUnverifiedRangeProofs({ outputs[0] }).empty());
+
+	verifierCache.AddVerifiedRangeProofs({ outputs[2] });
+	REQUIRE(verifierCache.FilterUnverifiedRangeProofs({ outputs[0] }).empty());
+	REQUIRE(verifierCache.FilterUnverifiedRangeProofs({ outputs[2] }).empty());
+	REQUIRE(verifierCache.FilterUnverifiedRangeProofs({ outputs[1] }).size() == 1);
+}
\ No newline at end of file
@@ -79,8 +79,11 @@ void TransactionAggregator::PerformCutThrough(std::vector<TransactionInput>& inp
 	}
 
 	auto filterInputs = [outputCommitments](TransactionInput& input) -> bool { return outputCommitments.count(input.GetCommitment()) > 0; };
-	FunctionalUtil::filter(inputs, filterInputs);
+	inputs = FunctionalUtil::filterNot(inputs, filterInputs);
 
 	auto filterOutputs = [inputCommitments](TransactionOutput& output) -> bool { return inputCommitments.count(output.GetCommitment()) > 0; };
-	FunctionalUtil::filter(outputs, filterOutputs);
+	outputs = FunctionalUtil::filterNot(outputs, filterOutputs);
+
+	std::sort(inputs.begin(), inputs.end());
+	std::sort(outputs.begin(), outputs.end());
 }
\ No newline at end of file
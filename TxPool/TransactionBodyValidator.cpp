@@ -6,6 +6,12 @@
 #include <Crypto.h>
 #include <set>
 
+TransactionBodyValidator::TransactionBodyValidator(VerifierCache& verifierCache)
+	: m_verifierCache(verifierCache)
+{
+
+}
+
 // Validates all relevant parts of a transaction body. 
 // Checks the excess value against the signature as well as range proofs for each output.
 bool TransactionBodyValidator::ValidateTransactionBody(const TransactionBody& transactionBody, const bool withReward) const
@@ -119,27 +125,47 @@ bool TransactionBodyValidator::VerifyCutThrough(const TransactionBody& transacti
 	return true;
 }
 
+// Verify the range proofs of any outputs not already in the verifier cache.
 bool TransactionBodyValidator::VerifyOutputs(const std::vector<TransactionOutput>& outputs) const
 {
+	const std::vector<TransactionOutput> unverifiedOutputs = m_verifierCache.FilterUnverifiedRangeProofs(outputs);
+	if (unverifiedOutputs.empty())
+	{
+		return true;
+	}
+
 	std::vector<Commitment> commitments;
 	std::vector<RangeProof> proofs;
+	commitments.reserve(unverifiedOutputs.size());
+	proofs.reserve(unverifiedOutputs.size());
 
-	for (auto output : outputs)
+	for (const TransactionOutput& output : unverifiedOutputs)
 	{
 		commitments.push_back(output.GetCommitment());
 		proofs.push_back(output.GetRangeProof());
 	}
 
-	return Crypto::VerifyRangeProofs(commitments, proofs);
+	if (!Crypto::VerifyRangeProofs(commitments, proofs))
+	{
+		return false;
+	}
+
+	m_verifierCache.AddVerifiedRangeProofs(unverifiedOutputs);
+	return true;
 }
 
 // Verify the unverified tx kernels.
-// No ability to batch verify these right now
-// so just do them individually.
-bool TransactionBodyValidator::VerifyKernels(const std::vector<TransactionKernel>& kernels) const
+// Kernels already in the verifier cache are skipped.
+bool TransactionBodyValidator::VerifyKernels(const std::vector<TransactionKernel>& allKernels) const
 {
+	const std::vector<TransactionKernel> kernels = m_verifierCache.FilterUnverifiedKernels(allKernels);
+	if (kernels.empty())
+	{
+		return true;
+	}
+
 	// Verify the transaction proof validity. Entails handling the commitment as a public key and checking the signature verifies with the fee as message.
-	for (auto kernel : kernels)
+	for (const TransactionKernel& kernel : kernels)
 	{
 		const Commitment& publicKey = kernel.GetExcessCommitment();
 		const Signature& signature = kernel.GetExcessSignature();
@@ -152,5 +178,6 @@ bool TransactionBodyValidator::VerifyKernels(const std::vector<TransactionKernel
 		}
 	}
 
+	m_verifierCache.AddVerifiedKernels(kernels);
 	return true;
 }
\ No newline at end of file
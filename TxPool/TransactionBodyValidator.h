@@ -1,10 +1,14 @@
 #pragma once
 
+#include "VerifierCache.h"
+
 #include <Core/TransactionBody.h>
 
 class TransactionBodyValidator
 {
 public:
+	TransactionBodyValidator(VerifierCache& verifierCache);
+
 	bool ValidateTransactionBody(const TransactionBody& transactionBody, const bool withReward) const;
 
 private:
@@ -12,5 +16,7 @@ private:
 	bool VerifySorted(const TransactionBody& transactionBody) const;
 	bool VerifyCutThrough(const TransactionBody& transactionBody) const;
 	bool VerifyOutputs(const std::vector<TransactionOutput>& outputs) const;
-	bool VerifyKernels(const std::vector<TransactionKernel>& kernels) const;
+	bool VerifyKernels(const std::vector<TransactionKernel>& allKernels) const;
+
+	VerifierCache& m_verifierCache;
 };
\ No newline at end of file
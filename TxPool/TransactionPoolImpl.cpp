@@ -5,10 +5,29 @@
 #include "ValidTransactionFinder.h"
 
 #include <Database/BlockDb.h>
+#include <Consensus/BlockWeight.h>
 #include <Crypto/RandomNumberGenerator.h>
+#include <Infrastructure/Logger.h>
+#include <StringUtil.h>
+
+// Maximum number of verified range proofs and kernels remembered by the verifier cache.
+static const size_t VERIFIER_CACHE_MAX_RANGE_PROOFS = 50000;
+static const size_t VERIFIER_CACHE_MAX_KERNELS = 50000;
+
+// Maximum total weight of the transactions in each pool, equivalent to 100 full blocks.
+static const uint64_t MEMPOOL_MAX_WEIGHT = 100 * (uint64_t)Consensus::MAX_BLOCK_WEIGHT;
+static const uint64_t STEMPOOL_MAX_WEIGHT = 100 * (uint64_t)Consensus::MAX_BLOCK_WEIGHT;
+
+// Number of confirmed transactions kept to serve peers hydrating recent compact blocks.
+static const size_t MAX_CONFIRMED_TRANSACTIONS = 2000;
 
 TransactionPool::TransactionPool(const Config& config, const TxHashSetManager& txHashSetManager, const IBlockDB& blockDB)
-	: m_config(config), m_txHashSetManager(txHashSetManager), m_blockDB(blockDB)
+	: m_config(config),
+	m_txHashSetManager(txHashSetManager),
+	m_blockDB(blockDB),
+	m_verifierCache(VERIFIER_CACHE_MAX_RANGE_PROOFS, VERIFIER_CACHE_MAX_KERNELS),
+	m_memPool(m_verifierCache, MEMPOOL_MAX_WEIGHT),
+	m_stemPool(m_verifierCache, STEMPOOL_MAX_WEIGHT)
 {
 
 }
@@ -17,7 +36,33 @@ TransactionPool::TransactionPool(const Config& config, const TxHashSetManager& t
 // Note: does not validate that we return the full set of required txs. The caller will need to validate that themselves.
 std::vector<Transaction> TransactionPool::GetTransactionsByShortId(const Hash& hash, const uint64_t nonce, const std::set<ShortId>& missingShortIds) const
 {
-	return m_memPool.GetTransactionsByShortId(hash, nonce, missingShortIds);
+	std::vector<Transaction> transactions = m_memPool.GetTransactionsByShortId(hash, nonce, missingShortIds);
+
+	std::set<ShortId> shortIdsNotFound = missingShortIds;
+	for (const Transaction& transaction : transactions)
+	{
+		for (const TransactionKernel& kernel : transaction.GetBody().GetKernels())
+		{
+			shortIdsNotFound.erase(ShortId::Create(kernel.GetHash(), hash, nonce));
+		}
+	}
+
+	std::lock_guard<std::mutex> lockGuard(m_confirmedMutex);
+	for (auto iter = m_confirmedTransactions.crbegin(); iter != m_confirmedTransactions.crend() && !shortIdsNotFound.empty(); iter++)
+	{
+		bool found = false;
+		for (const TransactionKernel& kernel : iter->GetBody().GetKernels())
+		{
+			found = (shortIdsNotFound.erase(ShortId::Create(kernel.GetHash(), hash, nonce)) > 0) || found;
+		}
+
+		if (found)
+		{
+			transactions.push_back(*iter);
+		}
+	}
+
+	return transactions;
 }
 
 bool TransactionPool::AddTransaction(const Transaction& transaction, const EPoolType poolType, const BlockHeader& lastConfirmedBlock)
@@ -57,13 +102,29 @@ void TransactionPool::ReconcileBlock(const FullBlock& block)
 {
 	// TODO: Finish implementing
 	// First reconcile the txpool.
-	m_memPool.ReconcileBlock(block);
+	std::vector<Transaction> confirmedTransactions = m_memPool.ReconcileBlock(block);
 	//self.txpool.reconcile(None, &block.header) ? ;
 
+	{
+		std::lock_guard<std::mutex> lockGuard(m_confirmedMutex);
+		for (Transaction& transaction : confirmedTransactions)
+		{
+			m_confirmedTransactions.emplace_back(std::move(transaction));
+		}
+
+		while (m_confirmedTransactions.size() > MAX_CONFIRMED_TRANSACTIONS)
+		{
+			m_confirmedTransactions.pop_front();
+		}
+	}
+
 	// Now reconcile our stempool, accounting for the updated txpool txs.
 	m_stemPool.ReconcileBlock(block);
 	//let txpool_tx = self.txpool.aggregate_transaction() ? ;
 	//self.stempool.reconcile(txpool_tx, &block.header) ? ;
+
+	LoggerAPI::LogDebug(StringUtil::Format("TransactionPool::ReconcileBlock - Verifier cache range proofs (%llu hits, %llu misses), kernels (%llu hits, %llu misses)",
+		m_verifierCache.GetRangeProofHits(), m_verifierCache.GetRangeProofMisses(), m_verifierCache.GetKernelHits(), m_verifierCache.GetKernelMisses()));
 }
 
 std::unique_ptr<Transaction> TransactionPool::GetTransactionToStem(const BlockHeader& lastConfirmedBlock)
@@ -76,7 +137,7 @@ std::unique_ptr<Transaction> TransactionPool::GetTransactionToStem(const BlockHe
 
 	const std::unique_ptr<Transaction> pMemPoolAggTx = m_memPool.Aggregate();
 
-	std::vector<Transaction> validTransactionsToStem = ValidTransactionFinder(m_txHashSetManager, m_blockDB).FindValidTransactions(transactionsToStem, pMemPoolAggTx, lastConfirmedBlock);
+	std::vector<Transaction> validTransactionsToStem = ValidTransactionFinder(m_txHashSetManager, m_blockDB, m_verifierCache).FindValidTransactions(transactionsToStem, pMemPoolAggTx, lastConfirmedBlock);
 	if (validTransactionsToStem.empty())
 	{
 		return std::unique_ptr<Transaction>(nullptr);
@@ -87,7 +148,11 @@ std::unique_ptr<Transaction> TransactionPool::GetTransactionToStem(const BlockHe
 	std::unique_ptr<Transaction> pTransactionToStem = TransactionAggregator::Aggregate(validTransactionsToStem);
 	if (pTransactionToStem != nullptr)
 	{
-		// TODO: agg_tx.validate(verifier_cache.clone()) ? ;
+		// Range proofs and kernel signatures were all cached when the transactions entered the pool, so this only checks the aggregate's sums.
+		if (!TransactionValidator(m_verifierCache).ValidateTransaction(*pTransactionToStem))
+		{
+			return std::unique_ptr<Transaction>(nullptr);
+		}
 	}
 
 	return pTransactionToStem;
@@ -103,7 +168,7 @@ std::unique_ptr<Transaction> TransactionPool::GetTransactionToFluff(const BlockH
 
 	const std::unique_ptr<Transaction> pMemPoolAggTx = m_memPool.Aggregate();
 
-	std::vector<Transaction> validTransactionsToFluff = ValidTransactionFinder(m_txHashSetManager, m_blockDB).FindValidTransactions(transactionsToFluff, pMemPoolAggTx, lastConfirmedBlock);
+	std::vector<Transaction> validTransactionsToFluff = ValidTransactionFinder(m_txHashSetManager, m_blockDB, m_verifierCache).FindValidTransactions(transactionsToFluff, pMemPoolAggTx, lastConfirmedBlock);
 	if (validTransactionsToFluff.empty())
 	{
 		return std::unique_ptr<Transaction>(nullptr);
@@ -114,7 +179,11 @@ std::unique_ptr<Transaction> TransactionPool::GetTransactionToFluff(const BlockH
 	std::unique_ptr<Transaction> pTransactionToFluff = TransactionAggregator::Aggregate(validTransactionsToFluff);
 	if (pTransactionToFluff != nullptr)
 	{
-		// TODO: agg_tx.validate(verifier_cache.clone()) ? ;
+		// Range proofs and kernel signatures were all cached when the transactions entered the pool, so this only checks the aggregate's sums.
+		if (!TransactionValidator(m_verifierCache).ValidateTransaction(*pTransactionToFluff))
+		{
+			return std::unique_ptr<Transaction>(nullptr);
+		}
 	}
 
 	return pTransactionToFluff;
@@ -128,12 +197,17 @@ std::vector<Transaction> TransactionPool::GetExpiredTransactions() const
 
 bool TransactionPool::ValidateTransaction(const Transaction& transaction) const
 {
-	return TransactionValidator().ValidateTransaction(transaction);
+	return TransactionValidator(m_verifierCache).ValidateTransaction(transaction);
 }
 
 bool TransactionPool::ValidateTransactionBody(const TransactionBody& transactionBody, const bool withReward) const
 {
-	return TransactionBodyValidator().ValidateTransactionBody(transactionBody, withReward);
+	return TransactionBodyValidator(m_verifierCache).ValidateTransactionBody(transactionBody, withReward);
+}
+
+std::unique_ptr<Transaction> TransactionPool::BuildBlockTemplate(const uint64_t maxWeight)
+{
+	return m_memPool.BuildBlockTemplate(maxWeight);
 }
 
 namespace TxPoolAPI
@@ -1,11 +1,14 @@
 #pragma once
 
 #include "Pool.h"
+#include "VerifierCache.h"
 
 #include <TxPool/TransactionPool.h>
 #include <Core/Transaction.h>
 #include <Core/ShortId.h>
 #include <Hash.h>
+#include <deque>
+#include <mutex>
 #include <set>
 
 class TransactionPool : public ITransactionPool
@@ -27,11 +30,18 @@ public:
 	virtual bool ValidateTransaction(const Transaction& transaction) const override final;
 	virtual bool ValidateTransactionBody(const TransactionBody& transactionBody, const bool withReward) const override final;
 
+	virtual std::unique_ptr<Transaction> BuildBlockTemplate(const uint64_t maxWeight) override final;
+
 private:
 	const Config& m_config;
 	const TxHashSetManager& m_txHashSetManager;
 	const IBlockDB& m_blockDB;
 
+	mutable VerifierCache m_verifierCache;
 	Pool m_memPool;
 	Pool m_stemPool;
+
+	// Mempool transactions confirmed by the most recent blocks, oldest first.
+	mutable std::mutex m_confirmedMutex;
+	std::deque<Transaction> m_confirmedTransactions;
 };
\ No newline at end of file
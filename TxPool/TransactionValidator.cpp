@@ -6,11 +6,17 @@
 #include <Infrastructure/Logger.h>
 #include <Common/FunctionalUtil.h>
 
+TransactionValidator::TransactionValidator(VerifierCache& verifierCache)
+	: m_verifierCache(verifierCache)
+{
+
+}
+
 // See: https://github.com/mimblewimble/docs/wiki/Validation-logic
 bool TransactionValidator::ValidateTransaction(const Transaction& transaction) const
 {
 	// Validate the "transaction body"
-	if (!TransactionBodyValidator().ValidateTransactionBody(transaction.GetBody(), false))
+	if (!TransactionBodyValidator(m_verifierCache).ValidateTransactionBody(transaction.GetBody(), false))
 	{
 		return false;
 	}
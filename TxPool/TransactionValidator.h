@@ -1,13 +1,19 @@
 #pragma once
 
+#include "VerifierCache.h"
+
 #include <Core/Transaction.h>
 
 class TransactionValidator
 {
 public:
+	TransactionValidator(VerifierCache& verifierCache);
+
 	bool ValidateTransaction(const Transaction& transaction) const;
 
 private:
 	bool ValidateFeatures(const TransactionBody& transactionBody) const;
 	bool ValidateKernelSums(const Transaction& transaction) const;
+
+	VerifierCache& m_verifierCache;
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Core/Transaction.h>
+#include <Consensus/BlockWeight.h>
 #include <TxPool/DandelionStatus.h>
 #include <ctime>
 
@@ -11,12 +12,12 @@ public:
 	// Constructors
 	//
 	TxPoolEntry(const Transaction& transaction, const EDandelionStatus status, const std::time_t timestamp)
-		: m_transaction(transaction), m_status(status), m_timestamp(timestamp)
+		: m_transaction(transaction), m_status(status), m_timestamp(timestamp), m_fee(CalculateFee(m_transaction)), m_weight(CalculateWeight(m_transaction))
 	{
 
 	}
 	TxPoolEntry(Transaction&& transaction, const EDandelionStatus status, const std::time_t timestamp)
-		: m_transaction(std::move(transaction)), m_status(status), m_timestamp(timestamp)
+		: m_transaction(std::move(transaction)), m_status(status), m_timestamp(timestamp), m_fee(CalculateFee(m_transaction)), m_weight(CalculateWeight(m_transaction))
 	{
 
 	}
@@ -45,13 +46,40 @@ public:
 	inline EDandelionStatus GetStatus() const { return m_status; }
 	inline std::time_t GetTimestamp() const { return m_timestamp; }
 
+	// The sum of the fees of the transaction's kernels.
+	inline uint64_t GetFee() const { return m_fee; }
+
+	// The weight the transaction counts for against Consensus::MAX_BLOCK_WEIGHT.
+	inline uint64_t GetWeight() const { return m_weight; }
+
 	//
 	// Setters
 	//
 	inline void SetStatus(const EDandelionStatus status) { m_status = status; }
 
 private:
+	static uint64_t CalculateFee(const Transaction& transaction)
+	{
+		uint64_t fee = 0;
+		for (const TransactionKernel& kernel : transaction.GetBody().GetKernels())
+		{
+			fee += kernel.GetFee();
+		}
+
+		return fee;
+	}
+
+	static uint64_t CalculateWeight(const Transaction& transaction)
+	{
+		const TransactionBody& body = transaction.GetBody();
+		return (body.GetInputs().size() * Consensus::BLOCK_INPUT_WEIGHT)
+			+ (body.GetOutputs().size() * Consensus::BLOCK_OUTPUT_WEIGHT)
+			+ (body.GetKernels().size() * Consensus::BLOCK_KERNEL_WEIGHT);
+	}
+
 	Transaction m_transaction;
 	EDandelionStatus m_status;
 	std::time_t m_timestamp;
+	uint64_t m_fee;
+	uint64_t m_weight;
 };
\ No newline at end of file
@@ -1,11 +1,11 @@
 #include "ValidTransactionFinder.h"
-#include "TransactionAggregator.h"
 #include "TransactionValidator.h"
 
-#include <Common/FunctionalUtil.h>
+#include <Core/OutputIdentifier.h>
+#include <Crypto.h>
 
-ValidTransactionFinder::ValidTransactionFinder(const TxHashSetManager& txHashSetManager, const IBlockDB& blockDB)
-	: m_txHashSetManager(txHashSetManager), m_blockDB(blockDB)
+ValidTransactionFinder::ValidTransactionFinder(const TxHashSetManager& txHashSetManager, const IBlockDB& blockDB, VerifierCache& verifierCache)
+	: m_txHashSetManager(txHashSetManager), m_blockDB(blockDB), m_verifierCache(verifierCache)
 {
 
 }
@@ -14,80 +14,159 @@ std::vector<Transaction> ValidTransactionFinder::FindValidTransactions(const std
 {
 	std::vector<Transaction> validTransactions;
 
-	for (const Transaction& transaction : transactions)
+	const ITxHashSet* pTxHashSet = m_txHashSetManager.GetTxHashSet();
+	if (pTxHashSet == nullptr)
 	{
-		std::vector<Transaction> candidateTransactions = validTransactions;
-		if (pExtraTransaction != nullptr)
-		{
-			candidateTransactions.push_back(*pExtraTransaction);
-		}
+		return validTransactions;
+	}
 
-		candidateTransactions.push_back(transaction);
+	std::unique_ptr<BlockSums> pBlockSums = m_blockDB.GetBlockSums(header.GetHash());
+	if (pBlockSums == nullptr)
+	{
+		return validTransactions;
+	}
 
-		// Build a single aggregate tx from candidate txs.
-		std::unique_ptr<Transaction> pAggregateTransaction = TransactionAggregator::Aggregate(candidateTransactions);
-		if (pAggregateTransaction != nullptr)
+	RunningSums runningSums(*pBlockSums, header.GetTotalKernelOffset());
+
+	// Every candidate is built on top of the extra transaction, so if it can't be applied, none of the candidates can.
+	if (pExtraTransaction != nullptr && !ApplyTransaction(*pExtraTransaction, *pTxHashSet, runningSums))
+	{
+		return validTransactions;
+	}
+
+	for (const Transaction& transaction : transactions)
+	{
+		if (ApplyTransaction(transaction, *pTxHashSet, runningSums))
 		{
-			// We know the tx is valid if the entire aggregate tx is valid.
-			if (IsValidTransaction(*pAggregateTransaction, header))
-			{
-				validTransactions.push_back(transaction);
-			}
+			validTransactions.push_back(transaction);
 		}
 	}
 
 	return validTransactions;
 }
 
-bool ValidTransactionFinder::IsValidTransaction(const Transaction& transaction, const BlockHeader& header) const
+// Validates the transaction on top of the running sums, and updates the running sums if it's valid.
+// The running sums are left untouched if the transaction is invalid.
+bool ValidTransactionFinder::ApplyTransaction(const Transaction& transaction, const ITxHashSet& txHashSet, RunningSums& runningSums) const
 {
-	if (!TransactionValidator().ValidateTransaction(transaction))
+	if (!TransactionValidator(m_verifierCache).ValidateTransaction(transaction))
 	{
 		return false;
 	}
 
-	const ITxHashSet* pTxHashSet = m_txHashSetManager.GetTxHashSet();
-	if (pTxHashSet == nullptr)
+	// Reject double spends and duplicate outputs within the set of accepted transactions.
+	if (IsConflicting(transaction, runningSums))
 	{
 		return false;
 	}
 
-	// Validate the tx against current chain state.
-	// Check all inputs are in the current UTXO set.
-	// Check all outputs are unique in current UTXO set.
-	if (!pTxHashSet->IsValid(transaction))
+	// Validate the tx against current chain state, and the outputs of the transactions already accepted.
+	if (!IsSpendable(transaction, txHashSet, runningSums))
 	{
 		return false;
 	}
 
-	std::unique_ptr<BlockSums> pBlockSums = m_blockDB.GetBlockSums(header.GetHash());
-	if (pBlockSums == nullptr)
+	std::unique_ptr<Commitment> pOutputSum = AddCommitments(transaction, runningSums.outputSum);
+	if (pOutputSum == nullptr)
 	{
 		return false;
 	}
 
-	std::unique_ptr<Commitment> pUTXOSum = AddCommitments(transaction, *pBlockSums);
-	if (pUTXOSum == nullptr)
+	std::unique_ptr<Commitment> pKernelSum = AddKernels(transaction, runningSums.kernelSum);
+	if (pKernelSum == nullptr)
 	{
 		return false;
 	}
 
-	std::unique_ptr<Commitment> pKernelSumPlusOffset = AddKernelOffsets(transaction, header, *pBlockSums);
-	if (pKernelSumPlusOffset == nullptr)
+	const std::unique_ptr<BlindingFactor> pKernelOffset = Crypto::AddBlindingFactors(std::vector<BlindingFactor>({ runningSums.kernelOffset, transaction.GetOffset() }), std::vector<BlindingFactor>());
+	if (pKernelOffset == nullptr)
 	{
 		return false;
 	}
 
 	// Verify the kernel sums for the block_sums with the new tx applied, accounting for overage and offset.
-	if (*pUTXOSum != *pKernelSumPlusOffset)
+	std::unique_ptr<Commitment> pKernelSumPlusOffset = std::make_unique<Commitment>(*pKernelSum);
+	if (*pKernelOffset != BlindingFactor(CBigInteger<32>::ValueOf(0)))
+	{
+		// Commit to zero.
+		std::unique_ptr<Commitment> pOffsetCommitment = Crypto::CommitBlinded((uint64_t)0, *pKernelOffset);
+		if (pOffsetCommitment == nullptr)
+		{
+			return false;
+		}
+
+		pKernelSumPlusOffset = Crypto::AddCommitments(std::vector<Commitment>({ *pKernelSum, *pOffsetCommitment }), std::vector<Commitment>());
+	}
+
+	if (pKernelSumPlusOffset == nullptr || *pOutputSum != *pKernelSumPlusOffset)
 	{
 		return false;
 	}
 
+	for (const TransactionInput& input : transaction.GetBody().GetInputs())
+	{
+		runningSums.spentCommitments.insert(input.GetCommitment());
+	}
+
+	for (const TransactionOutput& output : transaction.GetBody().GetOutputs())
+	{
+		runningSums.createdCommitments.insert(output.GetCommitment());
+	}
+
+	runningSums.outputSum = *pOutputSum;
+	runningSums.kernelSum = *pKernelSum;
+	runningSums.kernelOffset = *pKernelOffset;
+
 	return true;
 }
 
-std::unique_ptr<Commitment> ValidTransactionFinder::AddCommitments(const Transaction& transaction, const BlockSums& blockSums) const
+bool ValidTransactionFinder::IsConflicting(const Transaction& transaction, const RunningSums& runningSums) const
+{
+	for (const TransactionInput& input : transaction.GetBody().GetInputs())
+	{
+		if (runningSums.spentCommitments.count(input.GetCommitment()) > 0)
+		{
+			return true;
+		}
+	}
+
+	for (const TransactionOutput& output : transaction.GetBody().GetOutputs())
+	{
+		if (runningSums.createdCommitments.count(output.GetCommitment()) > 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Checks that every input spends an output in the current UTXO set, or an output created by an accepted transaction
+// (so children can follow their parents), and that no output is already in the current UTXO set.
+bool ValidTransactionFinder::IsSpendable(const Transaction& transaction, const ITxHashSet& txHashSet, const RunningSums& runningSums) const
+{
+	for (const TransactionInput& input : transaction.GetBody().GetInputs())
+	{
+		if (runningSums.createdCommitments.count(input.GetCommitment()) == 0
+			&& !txHashSet.IsUnspent(OutputIdentifier(input.GetFeatures(), Commitment(input.GetCommitment()))))
+		{
+			return false;
+		}
+	}
+
+	for (const TransactionOutput& output : transaction.GetBody().GetOutputs())
+	{
+		if (txHashSet.IsUnspent(OutputIdentifier(output.GetFeatures(), Commitment(output.GetCommitment()))))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Returns outputSum + outputs - inputs + overage, where the overage is the sum of the transaction's kernel fees.
+std::unique_ptr<Commitment> ValidTransactionFinder::AddCommitments(const Transaction& transaction, const Commitment& outputSum) const
 {
 	// Calculate overage
 	uint64_t overage = 0;
@@ -96,49 +175,50 @@ std::unique_ptr<Commitment> ValidTransactionFinder::AddCommitments(const Transac
 		overage += kernel.GetFee();
 	}
 
-	std::unique_ptr<Commitment> pOverageCommitment = Crypto::CommitTransparent(overage);
-
 	// Gather the commitments
-	auto getInputCommitments = [](TransactionInput& input) -> Commitment { return input.GetCommitment(); };
-	std::vector<Commitment> inputCommitments = FunctionalUtil::map<std::vector<Commitment>>(transaction.GetBody().GetInputs(), getInputCommitments);
+	std::vector<Commitment> inputCommitments;
+	inputCommitments.reserve(transaction.GetBody().GetInputs().size());
+	for (const TransactionInput& input : transaction.GetBody().GetInputs())
+	{
+		inputCommitments.push_back(input.GetCommitment());
+	}
 
-	auto getOutputCommitments = [](TransactionOutput& output) -> Commitment { return output.GetCommitment(); };
-	std::vector<Commitment> outputCommitments = FunctionalUtil::map<std::vector<Commitment>>(transaction.GetBody().GetOutputs(), getOutputCommitments);
+	std::vector<Commitment> outputCommitments;
+	outputCommitments.reserve(transaction.GetBody().GetOutputs().size() + 2);
+	for (const TransactionOutput& output : transaction.GetBody().GetOutputs())
+	{
+		outputCommitments.push_back(output.GetCommitment());
+	}
 
-	outputCommitments.push_back(blockSums.GetOutputSum());
+	outputCommitments.push_back(outputSum);
 
 	// add the overage as output commitment if positive,
 	// or as an input commitment if negative
 	if (overage != 0)
 	{
+		std::unique_ptr<Commitment> pOverageCommitment = Crypto::CommitTransparent(overage);
+		if (pOverageCommitment == nullptr)
+		{
+			return std::unique_ptr<Commitment>(nullptr);
+		}
+
 		outputCommitments.push_back(*pOverageCommitment);
 	}
 
 	return Crypto::AddCommitments(outputCommitments, inputCommitments);
 }
 
-std::unique_ptr<Commitment> ValidTransactionFinder::AddKernelOffsets(const Transaction& transaction, const BlockHeader& header, const BlockSums& blockSums) const
+// Returns kernelSum plus the transaction's kernel excesses.
+std::unique_ptr<Commitment> ValidTransactionFinder::AddKernels(const Transaction& transaction, const Commitment& kernelSum) const
 {
-	// Calculate the offset
-	const std::unique_ptr<BlindingFactor> pOffset = Crypto::AddBlindingFactors(std::vector<BlindingFactor>({ header.GetTotalKernelOffset(), transaction.GetOffset() }), std::vector<BlindingFactor>());
-	if (pOffset == nullptr)
+	std::vector<Commitment> kernelCommitments;
+	kernelCommitments.reserve(transaction.GetBody().GetKernels().size() + 1);
+	for (const TransactionKernel& kernel : transaction.GetBody().GetKernels())
 	{
-		return std::unique_ptr<Commitment>(nullptr);
+		kernelCommitments.push_back(kernel.GetExcessCommitment());
 	}
 
-	// Gather the kernel excess commitments
-	auto getKernelCommitments = [](TransactionKernel& kernel) -> Commitment { return kernel.GetExcessCommitment(); };
-	std::vector<Commitment> kernelCommitments = FunctionalUtil::map<std::vector<Commitment>>(transaction.GetBody().GetKernels(), getKernelCommitments);
-
-	kernelCommitments.push_back(blockSums.GetKernelSum());
-
-	if (*pOffset != BlindingFactor(CBigInteger<32>::ValueOf(0)))
-	{
-		// Commit to zero.
-		std::unique_ptr<Commitment> pOffsetCommitment = Crypto::CommitBlinded((uint64_t)0, *pOffset);
-		kernelCommitments.push_back(*pOffsetCommitment);
-	}
+	kernelCommitments.push_back(kernelSum);
 
-	// sum the commitments
-	return Crypto::AddCommitments(kernelCommitments, std::vector<Commitment>({}));
+	return Crypto::AddCommitments(kernelCommitments, std::vector<Commitment>());
 }
\ No newline at end of file
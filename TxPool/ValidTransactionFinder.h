@@ -1,23 +1,53 @@
 #pragma once
 
+#include "VerifierCache.h"
+
 #include <Core/Transaction.h>
 #include <Core/BlockHeader.h>
 #include <Core/BlockSums.h>
 #include <PMMR/TxHashSetManager.h>
 #include <Database/BlockDb.h>
+#include <set>
 
+//
+// Finds the subset of candidate transactions that can be applied, in order, on top of the given block header.
+//
+// Rather than rebuilding and revalidating an aggregate of every accepted transaction for each new candidate,
+// the finder keeps running output and kernel sums and a running kernel offset, starting from the header's BlockSums.
+// Each candidate is validated on its own (with range proofs and signatures served from the VerifierCache), and then only
+// its own inputs, outputs and kernels are added to the running sums, so a pass over n transactions is linear in n.
+// Inputs may spend the UTXO set or the outputs of the extra transaction and of candidates already accepted, as they could in an aggregate.
+//
 class ValidTransactionFinder
 {
 public:
-	ValidTransactionFinder(const TxHashSetManager& txHashSetManager, const IBlockDB& blockDB);
+	ValidTransactionFinder(const TxHashSetManager& txHashSetManager, const IBlockDB& blockDB, VerifierCache& verifierCache);
 
 	std::vector<Transaction> FindValidTransactions(const std::vector<Transaction>& transactions, const std::unique_ptr<Transaction>& pExtraTransaction, const BlockHeader& header) const;
 
 private:
-	bool IsValidTransaction(const Transaction& transaction, const BlockHeader& header) const;
-	std::unique_ptr<Commitment> AddCommitments(const Transaction& transaction, const BlockSums& blockSums) const;
-	std::unique_ptr<Commitment> AddKernelOffsets(const Transaction& transaction, const BlockHeader& header, const BlockSums& blockSums) const;
+	struct RunningSums
+	{
+		RunningSums(const BlockSums& blockSums, const BlindingFactor& totalKernelOffset)
+			: outputSum(blockSums.GetOutputSum()), kernelSum(blockSums.GetKernelSum()), kernelOffset(totalKernelOffset)
+		{
+
+		}
+
+		Commitment outputSum;
+		Commitment kernelSum;
+		BlindingFactor kernelOffset;
+		std::set<Commitment> spentCommitments;
+		std::set<Commitment> createdCommitments;
+	};
+
+	bool ApplyTransaction(const Transaction& transaction, const ITxHashSet& txHashSet, RunningSums& runningSums) const;
+	bool IsConflicting(const Transaction& transaction, const RunningSums& runningSums) const;
+	bool IsSpendable(const Transaction& transaction, const ITxHashSet& txHashSet, const RunningSums& runningSums) const;
+	std::unique_ptr<Commitment> AddCommitments(const Transaction& transaction, const Commitment& outputSum) const;
+	std::unique_ptr<Commitment> AddKernels(const Transaction& transaction, const Commitment& kernelSum) const;
 
 	const TxHashSetManager& m_txHashSetManager;
 	const IBlockDB& m_blockDB;
+	VerifierCache& m_verifierCache;
 };
\ No newline at end of file
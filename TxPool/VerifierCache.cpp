@@ -0,0 +1,123 @@
+#include "VerifierCache.h"
+
+#include <Serialization/Serializer.h>
+#include <Crypto.h>
+
+VerifierCache::VerifierCache(const size_t maxRangeProofs, const size_t maxKernels)
+	: m_rangeProofs(maxRangeProofs),
+	m_kernels(maxKernels),
+	m_rangeProofHits(0),
+	m_rangeProofMisses(0),
+	m_kernelHits(0),
+	m_kernelMisses(0)
+{
+
+}
+
+std::vector<TransactionOutput> VerifierCache::FilterUnverifiedRangeProofs(const std::vector<TransactionOutput>& outputs)
+{
+	std::vector<Hash> keys;
+	keys.reserve(outputs.size());
+	for (const TransactionOutput& output : outputs)
+	{
+		keys.push_back(GetRangeProofKey(output));
+	}
+
+	std::vector<TransactionOutput> unverified;
+
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	for (size_t i = 0; i < outputs.size(); i++)
+	{
+		if (!m_rangeProofs.Touch(keys[i]))
+		{
+			unverified.push_back(outputs[i]);
+		}
+	}
+
+	m_rangeProofHits += (outputs.size() - unverified.size());
+	m_rangeProofMisses += unverified.size();
+
+	return unverified;
+}
+
+void VerifierCache::AddVerifiedRangeProofs(const std::vector<TransactionOutput>& outputs)
+{
+	std::vector<Hash> keys;
+	keys.reserve(outputs.size());
+	for (const TransactionOutput& output : outputs)
+	{
+		keys.push_back(GetRangeProofKey(output));
+	}
+
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	for (const Hash& key : keys)
+	{
+		m_rangeProofs.Insert(key);
+	}
+}
+
+std::vector<TransactionKernel> VerifierCache::FilterUnverifiedKernels(const std::vector<TransactionKernel>& kernels)
+{
+	std::vector<TransactionKernel> unverified;
+
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	for (const TransactionKernel& kernel : kernels)
+	{
+		if (!m_kernels.Touch(kernel.GetHash()))
+		{
+			unverified.push_back(kernel);
+		}
+	}
+
+	m_kernelHits += (kernels.size() - unverified.size());
+	m_kernelMisses += unverified.size();
+
+	return unverified;
+}
+
+void VerifierCache::AddVerifiedKernels(const std::vector<TransactionKernel>& kernels)
+{
+	std::lock_guard<std::mutex> lockGuard(m_mutex);
+	for (const TransactionKernel& kernel : kernels)
+	{
+		m_kernels.Insert(kernel.GetHash());
+	}
+}
+
+Hash VerifierCache::GetRangeProofKey(const TransactionOutput& output)
+{
+	Serializer serializer;
+	output.Serialize(serializer);
+
+	return Crypto::Blake2b(serializer.GetBytes());
+}
+
+// Returns true and marks the hash as most recently used if it's in the set.
+bool VerifierCache::LRUHashSet::Touch(const Hash& hash)
+{
+	auto iter = m_hashIndex.find(hash);
+	if (iter == m_hashIndex.end())
+	{
+		return false;
+	}
+
+	m_hashes.splice(m_hashes.begin(), m_hashes, iter->second);
+	return true;
+}
+
+void VerifierCache::LRUHashSet::Insert(const Hash& hash)
+{
+	if (Touch(hash) || m_maxSize == 0)
+	{
+		return;
+	}
+
+	if (m_hashes.size() >= m_maxSize)
+	{
+		m_hashIndex.erase(m_hashes.back());
+		m_hashes.pop_back();
+	}
+
+	m_hashes.push_front(hash);
+	m_hashIndex.emplace(hash, m_hashes.begin());
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Core/TransactionOutput.h>
+#include <Core/TransactionKernel.h>
+#include <Hash.h>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+//
+// Remembers which range proofs and kernel signatures have already been verified, so that a transaction's proofs are only
+// checked once, when it enters the pool, and not again during stem/fluff aggregation or when its block is validated.
+//
+// Range proofs are keyed by the hash of the full output (features, commitment and proof), since the output hash alone doesn't cover the proof.
+// Kernels are keyed by the kernel hash, which already covers the excess signature.
+// Each set is bounded, with the least recently used entries evicted first. All methods are thread-safe.
+//
+class VerifierCache
+{
+public:
+	VerifierCache(const size_t maxRangeProofs, const size_t maxKernels);
+
+	//
+	// Returns the outputs whose range proofs have not been verified yet.
+	//
+	std::vector<TransactionOutput> FilterUnverifiedRangeProofs(const std::vector<TransactionOutput>& outputs);
+	void AddVerifiedRangeProofs(const std::vector<TransactionOutput>& outputs);
+
+	//
+	// Returns the kernels whose signatures have not been verified yet.
+	//
+	std::vector<TransactionKernel> FilterUnverifiedKernels(const std::vector<TransactionKernel>& kernels);
+	void AddVerifiedKernels(const std::vector<TransactionKernel>& kernels);
+
+	inline uint64_t GetRangeProofHits() const { return m_rangeProofHits; }
+	inline uint64_t GetRangeProofMisses() const { return m_rangeProofMisses; }
+	inline uint64_t GetKernelHits() const { return m_kernelHits; }
+	inline uint64_t GetKernelMisses() const { return m_kernelMisses; }
+
+private:
+	class LRUHashSet
+	{
+	public:
+		LRUHashSet(const size_t maxSize) : m_maxSize(maxSize) { }
+
+		bool Touch(const Hash& hash);
+		void Insert(const Hash& hash);
+
+	private:
+		size_t m_maxSize;
+		std::list<Hash> m_hashes;
+		std::unordered_map<Hash, std::list<Hash>::iterator> m_hashIndex;
+	};
+
+	static Hash GetRangeProofKey(const TransactionOutput& output);
+
+	mutable std::mutex m_mutex;
+	LRUHashSet m_rangeProofs;
+	LRUHashSet m_kernels;
+
+	std::atomic<uint64_t> m_rangeProofHits;
+	std::atomic<uint64_t> m_rangeProofMisses;
+	std::atomic<uint64_t> m_kernelHits;
+	std::atomic<uint64_t> m_kernelMisses;
+};
\ No newline at end of file
@@ -6,13 +6,24 @@
 // Author: David Burkett (davidburkett38@gmail.com)
 //
 
+#include <Common/ByteSpan.h>
+
 #include <stdint.h>
+#include <string.h>
+#include <array>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <algorithm>
+#include <functional>
 #include <stdexcept>
 
 #pragma warning(disable: 4505)
 
+//
+// Fixed-size, big-endian unsigned integer whose bytes are stored inline.
+// CBigInteger is trivially copyable, so Hashes, Commitments, BlindingFactors etc. can be created and copied without touching the heap.
+//
 template<size_t NUM_BYTES>
 class CBigInteger
 {
@@ -20,33 +31,39 @@ public:
 	//
 	// Constructors
 	//
-	CBigInteger()
-		: m_data(NUM_BYTES)
+	constexpr CBigInteger()
+		: m_data{}
 	{
 	}
 
+	//
+	// Copies up to NUM_BYTES bytes from the given vector. Any remaining bytes are zero.
+	// Kept for callers that still produce std::vectors. Prefer the pointer or span constructors.
+	//
 	CBigInteger(const std::vector<unsigned char>& data)
-		: m_data(data)
+		: m_data{}
 	{
-
+		std::copy_n(data.cbegin(), std::min(data.size(), NUM_BYTES), m_data.begin());
 	}
 
-	CBigInteger(std::vector<unsigned char>&& data)
-		: m_data(std::move(data))
+	CBigInteger(const unsigned char* data)
+		: m_data{}
 	{
-
+		std::copy_n(data, NUM_BYTES, m_data.begin());
 	}
 
-	CBigInteger(const unsigned char* data)
-		: m_data(data, data + NUM_BYTES)
+	explicit CBigInteger(const ByteSpan& data)
+		: m_data{}
 	{
+		std::copy_n(data.cbegin(), std::min(data.size(), NUM_BYTES), m_data.begin());
 	}
 
-	CBigInteger(const CBigInteger& bigInteger)
+	constexpr CBigInteger(const std::array<unsigned char, NUM_BYTES>& data)
+		: m_data(data)
 	{
-		m_data = bigInteger.GetData();
 	}
 
+	CBigInteger(const CBigInteger& bigInteger) = default;
 	CBigInteger(CBigInteger&& bigInteger) noexcept = default;
 
 	//
@@ -54,16 +71,20 @@ public:
 	//
 	~CBigInteger() = default;
 
-	inline const std::vector<unsigned char>& GetData() const
-	{
-		return m_data;
-	}
+	inline constexpr const std::array<unsigned char, NUM_BYTES>& GetData() const { return m_data; }
+	inline constexpr ByteSpan ToSpan() const { return ByteSpan(m_data); }
+
+	//
+	// Copies the bytes into a newly allocated vector.
+	// Only intended for legacy APIs that still require a std::vector.
+	//
+	inline std::vector<unsigned char> ToVector() const { return std::vector<unsigned char>(m_data.cbegin(), m_data.cend()); }
 
-	static CBigInteger<NUM_BYTES> ValueOf(const unsigned char value);
-	static CBigInteger<NUM_BYTES> FromHex(const std::string& hex);
-	static CBigInteger<NUM_BYTES> GetMaximumValue();
+	static constexpr CBigInteger<NUM_BYTES> ValueOf(const unsigned char value);
+	static constexpr CBigInteger<NUM_BYTES> FromHex(const std::string_view& hex);
+	static constexpr CBigInteger<NUM_BYTES> GetMaximumValue();
 
-	const unsigned char* ToCharArray() const { return &m_data[0]; }
+	const unsigned char* ToCharArray() const { return m_data.data(); }
 
 	CBigInteger<NUM_BYTES>& ReverseByteOrder();
 
@@ -87,24 +108,12 @@ public:
 	int operator%(const int modulo) const;
 	CBigInteger operator%(const CBigInteger& modulo) const;
 
-	unsigned char& operator[] (const int x) { return m_data[x]; }
-	const unsigned char& operator[] (const int x) const { return m_data[x]; }
+	constexpr unsigned char& operator[] (const int x) { return m_data[x]; }
+	constexpr const unsigned char& operator[] (const int x) const { return m_data[x]; }
 
 	inline bool operator<(const CBigInteger& rhs) const
 	{
-		for (size_t i = 0; i < NUM_BYTES; i++)
-		{
-			if (this->m_data[i] < rhs.m_data[i])
-			{
-				return true;
-			}
-			else if (this->m_data[i] > rhs.m_data[i])
-			{
-				return false;
-			}
-		}
-
-		return false;
+		return memcmp(m_data.data(), rhs.m_data.data(), NUM_BYTES) < 0;
 	}
 
 	inline bool operator>(const CBigInteger& rhs) const
@@ -114,15 +123,7 @@ public:
 
 	inline bool operator==(const CBigInteger& rhs) const
 	{
-		for (size_t i = 0; i < NUM_BYTES; i++)
-		{
-			if (this->m_data[i] != rhs.m_data[i])
-			{
-				return false;
-			}
-		}
-
-		return true;
+		return memcmp(m_data.data(), rhs.m_data.data(), NUM_BYTES) == 0;
 	}
 
 	inline bool operator!=(const CBigInteger& rhs) const
@@ -132,12 +133,12 @@ public:
 
 	inline bool operator<=(const CBigInteger& rhs) const
 	{
-		return *this < rhs || *this == rhs;
+		return !(rhs < *this);
 	}
 
 	inline bool operator>=(const CBigInteger& rhs) const
 	{
-		return *this > rhs || *this == rhs;
+		return !(*this < rhs);
 	}
 
 	inline CBigInteger operator+=(const CBigInteger& rhs)
@@ -165,60 +166,75 @@ public:
 	}
 
 private:
-	std::vector<unsigned char> m_data;
+	static constexpr unsigned char FromHexChar(const char value);
+
+	std::array<unsigned char, NUM_BYTES> m_data;
 };
 
 template<size_t NUM_BYTES>
-CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::ValueOf(const unsigned char value)
+constexpr CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::ValueOf(const unsigned char value)
 {
-	std::vector<unsigned char> data(NUM_BYTES);
-	data[NUM_BYTES - 1] = value;
-	return CBigInteger<NUM_BYTES>(&data[0]);
+	CBigInteger<NUM_BYTES> result;
+	result.m_data[NUM_BYTES - 1] = value;
+	return result;
 }
 
 template<size_t NUM_BYTES>
-CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::GetMaximumValue()
+constexpr CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::GetMaximumValue()
 {
-	std::vector<unsigned char> data(NUM_BYTES);
-	for (int i = 0; i < NUM_BYTES; i++)
+	CBigInteger<NUM_BYTES> result;
+	for (size_t i = 0; i < NUM_BYTES; i++)
 	{
-		data[i] = 0xFF;
+		result.m_data[i] = 0xFF;
 	}
 
-	return CBigInteger<NUM_BYTES>(&data[0]);
+	return result;
 }
 
 template<size_t NUM_BYTES>
-CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::FromHex(const std::string& hex)
+constexpr CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::FromHex(const std::string_view& hex)
 {
-	// TODO: Verify input size
 	size_t index = 0;
-	if (hex[0] == '0' && hex[1] == 'x')
+	if (hex.size() >= 2 && hex[0] == '0' && hex[1] == 'x')
 	{
 		index = 2;
 	}
 
-	std::string hexNoSpaces = "";
+	CBigInteger<NUM_BYTES> result;
+
+	size_t numDigits = 0;
 	for (size_t i = index; i < hex.length(); i++)
 	{
-		if (hex[i] != ' ')
+		if (hex[i] == ' ')
 		{
-			hexNoSpaces += hex[i];
+			continue;
 		}
-	}
 
-	std::vector<unsigned char> data(NUM_BYTES);
-	for (size_t i = 0; i < hexNoSpaces.length(); i += 2)
-	{
-		data[i / 2] = (FromHexChar(hexNoSpaces[i]) * 16 + FromHexChar(hexNoSpaces[i + 1]));
+		if (numDigits >= NUM_BYTES * 2)
+		{
+			throw std::invalid_argument("CBigInteger::FromHex - Too many hex digits.");
+		}
+
+		const unsigned char nibble = FromHexChar(hex[i]);
+		if (numDigits % 2 == 0)
+		{
+			result.m_data[numDigits / 2] = (unsigned char)(nibble * 16);
+		}
+		else
+		{
+			result.m_data[numDigits / 2] = (unsigned char)(result.m_data[numDigits / 2] + nibble);
+		}
+
+		numDigits++;
 	}
 
-	return CBigInteger<NUM_BYTES>(&data[0]);
+	return result;
 }
 
-static unsigned char FromHexChar(const char value)
+template<size_t NUM_BYTES>
+constexpr unsigned char CBigInteger<NUM_BYTES>::FromHexChar(const char value)
 {
-	if (value <= '9' && value >= 0)
+	if (value <= '9' && value >= '0')
 	{
 		return (unsigned char)(value - '0');
 	}
@@ -349,14 +365,14 @@ CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::operator*(const CBigInteger<NUM_B
 template<size_t NUM_BYTES>
 CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::operator+(const CBigInteger<NUM_BYTES>& addend) const
 {
-	std::vector<unsigned char> totalSum(NUM_BYTES);
+	CBigInteger<NUM_BYTES> totalSum;
 
 	int carry = 0;
 
 	for (int i = NUM_BYTES - 1; i >= 0; i--)
 	{
 		int digit1 = m_data[i];
-		int digit2 = addend.GetData()[i];
+		int digit2 = addend.m_data[i];
 
 		int sum = digit1 + digit2 + carry;
 
@@ -370,23 +386,23 @@ CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::operator+(const CBigInteger<NUM_B
 			carry = 0;
 		}
 
-		totalSum[i] = (unsigned char)sum;
+		totalSum.m_data[i] = (unsigned char)sum;
 	}
 
-	return CBigInteger<NUM_BYTES>(&totalSum[0]);
+	return totalSum;
 }
 
 template<size_t NUM_BYTES>
 CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::operator-(const CBigInteger<NUM_BYTES>& amount) const
 {
-	std::vector<unsigned char> result(NUM_BYTES);
+	CBigInteger<NUM_BYTES> result;
 
 	int carry = 0;
 
 	for (int i = NUM_BYTES - 1; i >= 0; i--)
 	{
 		int digit1 = m_data[i];
-		int digit2 = amount.GetData()[i];
+		int digit2 = amount.m_data[i];
 
 		int temp = digit1 - carry;
 		carry = 0;
@@ -397,16 +413,16 @@ CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::operator-(const CBigInteger<NUM_B
 			temp += 256;
 		}
 
-		result[i] = (unsigned char)(temp - digit2);
+		result.m_data[i] = (unsigned char)(temp - digit2);
 	}
 
-	return CBigInteger<NUM_BYTES>(&result[0]);
+	return result;
 }
 
 template<size_t NUM_BYTES>
 CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::operator*(const int multiplier) const
 {
-	CBigInteger temp(&m_data[0]);
+	CBigInteger temp = *this;
 	for (int i = 1; i < multiplier; i++)
 	{
 		temp = temp + *this;
@@ -418,17 +434,17 @@ CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::operator*(const int multiplier) c
 template<size_t NUM_BYTES>
 CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::operator/(const int divisor) const
 {
-	std::vector<unsigned char> quotient(NUM_BYTES);
+	CBigInteger<NUM_BYTES> quotient;
 
 	int remainder = 0;
-	for (int i = 0; i < NUM_BYTES; i++)
+	for (size_t i = 0; i < NUM_BYTES; i++)
 	{
 		remainder = remainder * 256 + m_data[i];
-		quotient[i] = remainder / divisor;
-		remainder -= quotient[i] * divisor;
+		quotient.m_data[i] = (unsigned char)(remainder / divisor);
+		remainder -= quotient.m_data[i] * divisor;
 	}
 
-	return CBigInteger<NUM_BYTES>(&quotient[0]);
+	return quotient;
 }
 
 template<size_t NUM_BYTES>
@@ -497,4 +513,24 @@ CBigInteger<NUM_BYTES> CBigInteger<NUM_BYTES>::operator%(const CBigInteger<NUM_B
 	CBigInteger<NUM_BYTES> modResult = *this - product;
 
 	return modResult;
+}
+
+//
+// Allows CBigIntegers to be used as keys in unordered containers.
+// Uses the trailing bytes, which are uniformly distributed for hashes as well as for commitment and public key x-coordinates.
+//
+namespace std
+{
+	template<size_t NUM_BYTES>
+	struct hash<CBigInteger<NUM_BYTES>>
+	{
+		size_t operator()(const CBigInteger<NUM_BYTES>& value) const noexcept
+		{
+			const size_t numBytes = std::min(sizeof(size_t), NUM_BYTES);
+
+			size_t result = 0;
+			memcpy(&result, value.GetData().data() + (NUM_BYTES - numBytes), numBytes);
+			return result;
+		}
+	};
 }
\ No newline at end of file
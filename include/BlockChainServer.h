@@ -18,10 +18,12 @@
 
 #include <vector>
 #include <memory>
+#include <functional>
 
 // Forward Declarations
 class Config;
 class IDatabase;
+class TxHashSetSnapshot;
 
 #ifdef MW_BLOCK_CHAIN
 #define BLOCK_CHAIN_API EXPORT
@@ -42,9 +44,40 @@ public:
 	virtual EBlockChainStatus AddBlock(const FullBlock& block) = 0;
 	virtual EBlockChainStatus AddCompactBlock(const CompactBlock& compactBlock) = 0;
 
+	//
+	// Hydrates the compact block from the transaction pool and the transactions received from a peer, then adds the block.
+	// Returns TRANSACTIONS_MISSING if some short ids still can't be matched to a transaction.
+	//
+	virtual EBlockChainStatus AddCompactBlock(const CompactBlock& compactBlock, const std::vector<Transaction>& receivedTransactions) = 0;
+
+	//
+	// Returns the short ids of the compact block that don't match any transaction in the transaction pool.
+	//
+	virtual std::vector<ShortId> GetMissingShortIds(const CompactBlock& compactBlock) const = 0;
+
+	//
+	// Returns the transactions matching the given kernel short ids of a compact block, from the mempool or from recently confirmed transactions.
+	// Transactions are only returned for the short ids that could be matched.
+	//
+	virtual std::vector<Transaction> GetTransactionsByShortId(const Hash& blockHash, const uint64_t nonce, const std::vector<ShortId>& shortIds) const = 0;
+
 	virtual EBlockChainStatus ProcessTransactionHashSet(const Hash& blockHash, const std::string& path) = 0;
+
+	//
+	// Extracts the TxHashSet archive for the given block while it's being downloaded, then validates it.
+	// readChunk is called on the calling thread to fill the given buffer with the next bytes of the zipped archive.
+	// It should return the number of bytes read, or 0 if the transfer failed.
+	//
+	virtual EBlockChainStatus ProcessTransactionHashSet(const Hash& blockHash, const uint64_t zippedSize, const std::function<size_t(unsigned char*, const size_t)>& readChunk) = 0;
 	virtual EBlockChainStatus AddTransaction(const Transaction& transaction, const EPoolType poolType) = 0;
 
+	//
+	// Returns a zipped TxHashSet snapshot that can be served to a peer requesting state at the given height.
+	// The same snapshot is reused for every requester until the horizon moves past it.
+	// This will be null if the confirmed chain isn't within range of the requested height.
+	//
+	virtual std::shared_ptr<const TxHashSetSnapshot> GetTxHashSetSnapshot(const uint64_t requestedHeight) = 0;
+
 	virtual EBlockChainStatus AddBlockHeader(const BlockHeader& blockHeader) = 0;
 
 	//
@@ -57,25 +90,26 @@ public:
 	//
 	// Returns the block header at the given height.
 	// This will be null if no matching block header is found.
+	// Headers are shared with the chain's in-memory header table rather than copied, and are never modified once added.
 	//
-	virtual std::unique_ptr<BlockHeader> GetBlockHeaderByHeight(const uint64_t height, const EChainType chainType) const = 0;
+	virtual std::shared_ptr<const BlockHeader> GetBlockHeaderByHeight(const uint64_t height, const EChainType chainType) const = 0;
 
 	//
 	// Returns the block header matching the given hash.
 	// This will be null if no matching block header is found.
 	//
-	virtual std::unique_ptr<BlockHeader> GetBlockHeaderByHash(const Hash& blockHeaderHash) const = 0;
+	virtual std::shared_ptr<const BlockHeader> GetBlockHeaderByHash(const Hash& blockHeaderHash) const = 0;
 
 	//
 	// Returns the block header containing the output commitment.
 	// This will be null if the output commitment is not found.
 	//
-	virtual std::unique_ptr<BlockHeader> GetBlockHeaderByCommitment(const Hash& outputCommitment) const = 0;
+	virtual std::shared_ptr<const BlockHeader> GetBlockHeaderByCommitment(const Hash& outputCommitment) const = 0;
 
 	//
 	// Returns the block header at the tip of the specified chain type.
 	//
-	virtual std::unique_ptr<BlockHeader> GetTipBlockHeader(const EChainType chainType) const = 0;
+	virtual std::shared_ptr<const BlockHeader> GetTipBlockHeader(const EChainType chainType) const = 0;
 
 	//
 	// Returns the block headers matching the given hashes.
@@ -100,6 +134,12 @@ public:
 	//
 	virtual std::unique_ptr<FullBlock> GetBlockByCommitment(const Hash& outputCommitment) const = 0;
 
+	//
+	// Returns the block matching the given hash as a compact block, with a newly generated nonce.
+	// This will be null if no matching block is found.
+	//
+	virtual std::unique_ptr<CompactBlock> GetCompactBlockByHash(const Hash& blockHash) const = 0;
+
 	//
 	// Returns the hashes of blocks(indexed by height) that are part of the candidate (header) chain, but whose bodies haven't been downloaded yet.
 	//
@@ -0,0 +1,91 @@
+#pragma once
+
+//
+// This code is free for all purposes without any express guarantee it works.
+//
+// Author: David Burkett (davidburkett38@gmail.com)
+//
+
+#include <stdint.h>
+#include <array>
+#include <vector>
+#include <stdexcept>
+
+//
+// A non-owning, read-only view over a contiguous range of bytes.
+// The caller is responsible for keeping the underlying storage alive while the span is in use.
+//
+class ByteSpan
+{
+public:
+	//
+	// Constructors
+	//
+	constexpr ByteSpan() noexcept
+		: m_pData(nullptr), m_size(0)
+	{
+
+	}
+
+	constexpr ByteSpan(const unsigned char* pData, const size_t size) noexcept
+		: m_pData(pData), m_size(size)
+	{
+
+	}
+
+	ByteSpan(const std::vector<unsigned char>& bytes) noexcept
+		: m_pData(bytes.data()), m_size(bytes.size())
+	{
+
+	}
+
+	template<size_t NUM_BYTES>
+	constexpr ByteSpan(const std::array<unsigned char, NUM_BYTES>& bytes) noexcept
+		: m_pData(bytes.data()), m_size(NUM_BYTES)
+	{
+
+	}
+
+	ByteSpan(const ByteSpan& other) = default;
+	ByteSpan& operator=(const ByteSpan& other) = default;
+
+	//
+	// Getters
+	//
+	inline constexpr const unsigned char* data() const noexcept { return m_pData; }
+	inline constexpr size_t size() const noexcept { return m_size; }
+	inline constexpr bool empty() const noexcept { return m_size == 0; }
+
+	inline constexpr const unsigned char* begin() const noexcept { return m_pData; }
+	inline constexpr const unsigned char* end() const noexcept { return m_pData + m_size; }
+	inline constexpr const unsigned char* cbegin() const noexcept { return m_pData; }
+	inline constexpr const unsigned char* cend() const noexcept { return m_pData + m_size; }
+
+	inline constexpr const unsigned char& operator[](const size_t index) const { return m_pData[index]; }
+
+	//
+	// Returns a view of numBytes bytes beginning at offset.
+	// Throws std::out_of_range if the requested range is not fully contained in this span.
+	//
+	inline ByteSpan SubSpan(const size_t offset, const size_t numBytes) const
+	{
+		if (offset > m_size || numBytes > m_size - offset)
+		{
+			throw std::out_of_range("ByteSpan::SubSpan - Range out of bounds.");
+		}
+
+		return ByteSpan(m_pData + offset, numBytes);
+	}
+
+	//
+	// Copies the viewed bytes into a newly allocated vector.
+	//
+	inline std::vector<unsigned char> ToVector() const
+	{
+		return std::vector<unsigned char>(m_pData, m_pData + m_size);
+	}
+
+private:
+	const unsigned char* m_pData;
+	size_t m_size;
+};
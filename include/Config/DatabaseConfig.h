@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+enum class EDBCompression
+{
+	NONE,
+	LZ4,
+	ZSTD
+};
+
+class DatabaseConfig
+{
+public:
+	DatabaseConfig() : DatabaseConfig(256, 10, EDBCompression::NONE)
+	{
+
+	}
+
+	DatabaseConfig(const uint32_t blockCacheMB, const uint32_t bloomBitsPerKey, const EDBCompression blockCompression)
+		: m_blockCacheMB(blockCacheMB), m_bloomBitsPerKey(bloomBitsPerKey), m_blockCompression(blockCompression)
+	{
+
+	}
+
+	// Size of the block cache shared by every column family of the chain database.
+	inline uint32_t GetBlockCacheMB() const { return m_blockCacheMB; }
+
+	// Bloom filter bits per key for the header, block sums and output position columns. 0 disables the filters.
+	inline uint32_t GetBloomBitsPerKey() const { return m_bloomBitsPerKey; }
+
+	// Compression of full blocks. The point lookup columns are left uncompressed.
+	// Off by default, since RocksDB may be built without LZ4 or ZSTD, in which case the chain database falls back to no compression.
+	inline EDBCompression GetBlockCompression() const { return m_blockCompression; }
+
+private:
+	uint32_t m_blockCacheMB;
+	uint32_t m_bloomBitsPerKey;
+	EDBCompression m_blockCompression;
+};
\ No newline at end of file
@@ -1,15 +1,18 @@
 #pragma once
 
+#include <Hash.h>
+#include <map>
+
 class P2PConfig
 {
 public:
-	P2PConfig() : P2PConfig(15, 5)
+	P2PConfig() : P2PConfig(15, 5, std::map<uint64_t, Hash>())
 	{
 		
 	}
 
-	P2PConfig(const int maxPeerConnections, const int preferredMinimumConnections)
-		: m_maxPeerConnections(maxPeerConnections), m_preferredMinimumConnections(preferredMinimumConnections)
+	P2PConfig(const int maxPeerConnections, const int preferredMinimumConnections, const std::map<uint64_t, Hash>& headerCheckpoints)
+		: m_maxPeerConnections(maxPeerConnections), m_preferredMinimumConnections(preferredMinimumConnections), m_headerCheckpoints(headerCheckpoints)
 	{
 
 	}
@@ -17,7 +20,11 @@ public:
 	inline int GetMaxConnections() const { return m_maxPeerConnections; }
 	inline int GetPreferredMinConnections() const { return m_preferredMinimumConnections; }
 
+	// Known header hashes by height. Header sync downloads the ranges between checkpoints from different peers in parallel.
+	inline const std::map<uint64_t, Hash>& GetHeaderCheckpoints() const { return m_headerCheckpoints; }
+
 private:
 	int m_maxPeerConnections;
 	int m_preferredMinimumConnections;
+	std::map<uint64_t, Hash> m_headerCheckpoints;
 };
\ No newline at end of file
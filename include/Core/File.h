@@ -1,5 +1,6 @@
 #pragma once
 
+#ifdef _WIN32
 #pragma warning(push)
 #pragma warning(disable:4244)
 #pragma warning(disable:4267)
@@ -7,31 +8,66 @@
 #pragma warning(disable:4018)
 #include <mio/mmap.hpp>
 #pragma warning(pop)
+#endif
+
+#include <Common/ByteSpan.h>
 
 #include <stdint.h>
 #include <string>
 #include <vector>
 
+//
+// An append-only file that buffers writes in memory until Flush() is called.
+// Flushed data is read through a memory mapping of the file.
+//
+// On Windows, the file is rewritten through std::ofstream and remapped with mio on every flush.
+// On POSIX systems, the file descriptor and mapping are kept open for the lifetime of the File.
+// Appends are written with pwrite, rewinds are applied with ftruncate, flushes are made durable with fdatasync,
+// and the mapping is grown in place (mremap on Linux), so the cost of a flush scales with the bytes appended.
+//
 class File
 {
 public:
 	File(const std::string& path);
+	File(File&& other) noexcept;
+	File(const File& other) = delete;
+	File& operator=(const File& other) = delete;
+	~File();
 
 	bool Load();
 	bool Flush();
 
-	void Append(const std::vector<unsigned char>& data);
+	void Append(const ByteSpan& data);
 
 	bool Rewind(const uint64_t nextPosition);
 	bool Discard();
 
 	uint64_t GetSize() const;
-	bool Read(const uint64_t position, const uint64_t numBytes, std::vector<unsigned char>& data) const;
+
+	//
+	// Returns a view of the numBytes bytes at the given position, taken directly from the mapped file or the pending append buffer.
+	// The view is only valid until the next call to Append, Flush, Rewind or Discard.
+	// Returns an empty span if the requested range does not lie entirely within the mapped file or within the append buffer.
+	//
+	ByteSpan Read(const uint64_t position, const uint64_t numBytes) const;
 
 private:
+	const unsigned char* GetMappedData() const;
+
 	const std::string m_path;
 	uint64_t m_bufferIndex;
 	uint64_t m_fileSize;
 	std::vector<unsigned char> m_buffer;
+
+#ifdef _WIN32
 	mio::mmap_source m_mmap;
-};
\ No newline at end of file
+#else
+	bool Open();
+	bool Map(const uint64_t size);
+	void Unmap();
+
+	int m_fileDescriptor;
+	unsigned char* m_pMapping;
+	uint64_t m_mappingSize;
+#endif
+};
@@ -34,6 +34,7 @@ public:
 	ShortId& operator=(const ShortId& other) = default;
 	ShortId& operator=(ShortId&& other) noexcept = default;
 	inline bool operator<(const ShortId& shortId) const { return m_id < shortId.m_id; }
+	inline bool operator==(const ShortId& shortId) const { return m_id == shortId.m_id; }
 
 	//
 	// Getters
@@ -48,4 +49,16 @@ public:
 
 private:
 	CBigInteger<6> m_id;
-};
\ No newline at end of file
+};
+
+namespace std
+{
+	template<>
+	struct hash<ShortId>
+	{
+		size_t operator()(const ShortId& shortId) const noexcept
+		{
+			return hash<CBigInteger<6>>()(shortId.GetId());
+		}
+	};
+}
\ No newline at end of file
@@ -59,4 +59,16 @@ public:
 private:
 	// The 33 byte commitment.
 	CBigInteger<33> m_commitmentBytes;
-};
\ No newline at end of file
+};
+
+namespace std
+{
+	template<>
+	struct hash<Commitment>
+	{
+		size_t operator()(const Commitment& commitment) const noexcept
+		{
+			return hash<CBigInteger<33>>()(commitment.GetCommitmentBytes());
+		}
+	};
+}
\ No newline at end of file
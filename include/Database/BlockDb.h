@@ -6,6 +6,8 @@
 #include <Core/ChainType.h>
 #include <memory>
 #include <optional>
+#include <utility>
+#include <vector>
 
 class IBlockDB
 {
@@ -14,7 +16,7 @@ public:
 	virtual std::unique_ptr<BlockHeader> GetBlockHeader(const Hash& hash) const = 0;
 
 	virtual void AddBlockHeader(const BlockHeader& blockHeader) = 0;
-	virtual void AddBlockHeaders(const std::vector<BlockHeader*>& blockHeaders) = 0;
+	virtual void AddBlockHeaders(const std::vector<const BlockHeader*>& blockHeaders) = 0;
 
 	virtual void AddBlock(const FullBlock& block) = 0;
 	virtual std::unique_ptr<FullBlock> GetBlock(const Hash& hash) const = 0;
@@ -24,4 +26,10 @@ public:
 
 	virtual void AddOutputPosition(const Commitment& outputCommitment, const uint64_t mmrIndex) = 0;
 	virtual std::optional<uint64_t> GetOutputPosition(const Commitment& outputCommitment) const = 0;
+
+	//
+	// Bulk loads output positions, such as those of a newly downloaded TxHashSet, by ingesting them as a single sorted table file.
+	// This bypasses the write-ahead log and memtable entirely. Where a commitment appears more than once, the last position wins.
+	//
+	virtual bool AddOutputPositions(const std::vector<std::pair<Commitment, uint64_t>>& outputPositions) = 0;
 };
\ No newline at end of file
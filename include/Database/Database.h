@@ -35,7 +35,7 @@ public:
 namespace DatabaseAPI
 {
 	//
-	// Creates a new instance of the BlockChain server.
+	// Opens the chain and peer databases. Returns nullptr if either of them fails to open.
 	//
 	DATABASE_API IDatabase* OpenDatabase(const Config& config);
 
@@ -5,5 +5,5 @@
 // TODO: Find better location for this.
 typedef CBigInteger<32> Hash;
 
-static const Hash ZERO_HASH = { Hash::ValueOf(0) };
+static constexpr Hash ZERO_HASH = Hash::ValueOf(0);
 static const int HASH_SIZE = 32;
\ No newline at end of file
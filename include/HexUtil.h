@@ -6,6 +6,7 @@
 #include <ios>
 #include <iomanip>
 #include <Hash.h>
+#include <Common/ByteSpan.h>
 
 namespace HexUtil
 {
@@ -21,7 +22,7 @@ namespace HexUtil
 		}
 	}
 
-	static std::string ConvertToHex(const std::vector<unsigned char>& data, const bool upperCase, const bool includePrefix)
+	static std::string ConvertToHex(const ByteSpan& data, const bool upperCase, const bool includePrefix)
 	{
 		std::ostringstream stream;
 		for (const unsigned char byte : data)
@@ -37,11 +38,13 @@ namespace HexUtil
 		return stream.str();
 	}
 
+	static std::string ConvertToHex(const std::vector<unsigned char>& data, const bool upperCase, const bool includePrefix)
+	{
+		return ConvertToHex(ByteSpan(data), upperCase, includePrefix);
+	}
+
 	static std::string ConvertHash(const Hash& hash)
 	{
-		const std::vector<unsigned char>& bytes = hash.GetData();
-		const std::vector<unsigned char> firstSixBytes = std::vector<unsigned char>(bytes.cbegin(), bytes.cbegin() + 6);
-		
-		return ConvertToHex(firstSixBytes, false, false);
+		return ConvertToHex(hash.ToSpan().SubSpan(0, 6), false, false);
 	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <P2P/IPAddress.h>
 #include <P2P/Capabilities.h>
 #include <P2P/SocketAddress.h>
+#include <P2P/PeerMetrics.h>
 
 #include <string>
 #include <stdint.h>
@@ -29,9 +30,14 @@ public:
 		: m_socketAddress(socketAddress), m_version(version), m_capabilities(capabilities), m_userAgent(userAgent), m_lastContactTime(lastContactTime)
 	{
 
+	}
+	Peer(const SocketAddress& socketAddress, const uint32_t version, const Capabilities& capabilities, const std::string& userAgent, const std::time_t lastContactTime, const PeerMetrics& metrics)
+		: m_socketAddress(socketAddress), m_version(version), m_capabilities(capabilities), m_userAgent(userAgent), m_lastContactTime(lastContactTime), m_metrics(metrics)
+	{
+
 	}
 	Peer(const Peer& other)
-		: m_socketAddress(other.m_socketAddress), m_version(other.m_version), m_capabilities(other.m_capabilities.load()), m_userAgent(other.m_userAgent), m_lastContactTime(other.m_lastContactTime.load())
+		: m_socketAddress(other.m_socketAddress), m_version(other.m_version), m_capabilities(other.m_capabilities.load()), m_userAgent(other.m_userAgent), m_lastContactTime(other.m_lastContactTime.load()), m_metrics(other.m_metrics)
 	{
 
 	}
@@ -56,6 +62,7 @@ public:
 	inline void UpdateCapabilities(const Capabilities& capabilities) { m_capabilities = capabilities; }
 	inline void UpdateLastContactTime() const { m_lastContactTime = std::time_t(); }
 	inline void UpdateUserAgent(const std::string& userAgent) { m_userAgent = userAgent; }
+	inline void UpdateMetrics(const PeerMetrics& metrics) { m_metrics = metrics; }
 
 	//
 	// Getters
@@ -67,6 +74,7 @@ public:
 	inline Capabilities GetCapabilities() const { return m_capabilities; }
 	inline const std::string& GetUserAgent() const { return m_userAgent; }
 	inline std::time_t GetLastContactTime() const { return m_lastContactTime; }
+	inline const PeerMetrics& GetMetrics() const { return m_metrics; }
 
 	//
 	// Serialization/Deserialization
@@ -78,6 +86,7 @@ public:
 		m_capabilities.load().Serialize(serializer);
 		serializer.AppendVarStr(m_userAgent);
 		serializer.Append<int64_t>(m_lastContactTime.load());
+		m_metrics.Serialize(serializer);
 	}
 
 	static Peer Deserialize(ByteBuffer& byteBuffer)
@@ -88,7 +97,10 @@ public:
 		std::string userAgent = byteBuffer.ReadVarStr();
 		std::time_t lastContactTIme = (std::time_t)byteBuffer.Read64();
 
-		return Peer(socketAddress, version, capabilities, userAgent, lastContactTIme);
+		// Peers saved before metrics were tracked have none.
+		const PeerMetrics metrics = byteBuffer.GetRemainingSize() > 0 ? PeerMetrics::Deserialize(byteBuffer) : PeerMetrics();
+
+		return Peer(socketAddress, version, capabilities, userAgent, lastContactTIme, metrics);
 	}
 
 private:
@@ -97,4 +109,5 @@ private:
 	std::atomic<Capabilities> m_capabilities;
 	std::string m_userAgent;
 	mutable std::atomic<std::time_t> m_lastContactTime;
+	PeerMetrics m_metrics;
 };
\ No newline at end of file
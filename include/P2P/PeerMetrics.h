@@ -0,0 +1,139 @@
+#pragma once
+
+#include <Serialization/ByteBuffer.h>
+#include <Serialization/Serializer.h>
+
+#include <algorithm>
+#include <ctime>
+#include <stdint.h>
+
+//
+// Measurements of how well a peer has served us. These are persisted with the peer, so they carry over between connections.
+// Latency and throughput are moving averages, where 0 means not yet measured.
+// Every successful delivery cancels out an earlier timeout, so timeouts count the peer's recent failures rather than every failure ever.
+// Timeouts and invalid data are also forgiven one at a time as time passes without another, so no peer is penalized forever.
+//
+class PeerMetrics
+{
+public:
+	//
+	// Constructors
+	//
+	PeerMetrics()
+		: m_latencyMs(0), m_bytesPerSecond(0), m_timeouts(0), m_invalidData(0), m_lastTimeoutTime(0), m_lastInvalidDataTime(0)
+	{
+
+	}
+	PeerMetrics(const uint32_t latencyMs, const uint64_t bytesPerSecond, const uint32_t timeouts, const uint32_t invalidData, const std::time_t lastTimeoutTime, const std::time_t lastInvalidDataTime)
+		: m_latencyMs(latencyMs), m_bytesPerSecond(bytesPerSecond), m_timeouts(timeouts), m_invalidData(invalidData), m_lastTimeoutTime(lastTimeoutTime), m_lastInvalidDataTime(lastInvalidDataTime)
+	{
+
+	}
+	PeerMetrics(const PeerMetrics& other) = default;
+	PeerMetrics(PeerMetrics&& other) noexcept = default;
+
+	//
+	// Operators
+	//
+	PeerMetrics& operator=(const PeerMetrics& other) = default;
+	PeerMetrics& operator=(PeerMetrics&& other) noexcept = default;
+
+	//
+	// Setters
+	//
+	void RecordLatency(const uint32_t latencyMs)
+	{
+		const uint32_t sample = std::max(latencyMs, (uint32_t)1);
+		m_latencyMs = (m_latencyMs == 0) ? sample : (uint32_t)(((uint64_t)m_latencyMs * 3 + sample) / 4);
+	}
+
+	void RecordThroughput(const uint64_t bytesPerSecond)
+	{
+		const uint64_t sample = std::max(bytesPerSecond, (uint64_t)1);
+		m_bytesPerSecond = (m_bytesPerSecond == 0) ? sample : (m_bytesPerSecond * 3 + sample) / 4;
+		m_timeouts = (m_timeouts > 0) ? (m_timeouts - 1) : 0;
+	}
+
+	void RecordTimeout()
+	{
+		const std::time_t now = std::time(nullptr);
+		m_timeouts = GetDecayed(m_timeouts, m_lastTimeoutTime, TIMEOUT_DECAY_SECONDS, now) + 1;
+		m_lastTimeoutTime = now;
+	}
+
+	void RecordInvalidData()
+	{
+		const std::time_t now = std::time(nullptr);
+		m_invalidData = GetDecayed(m_invalidData, m_lastInvalidDataTime, INVALID_DATA_DECAY_SECONDS, now) + 1;
+		m_lastInvalidDataTime = now;
+	}
+
+	//
+	// Getters
+	//
+	inline uint32_t GetLatencyMs() const { return m_latencyMs; }
+	inline uint64_t GetBytesPerSecond() const { return m_bytesPerSecond; }
+	inline uint32_t GetTimeouts() const { return GetDecayed(m_timeouts, m_lastTimeoutTime, TIMEOUT_DECAY_SECONDS, std::time(nullptr)); }
+	inline uint32_t GetInvalidData() const { return GetDecayed(m_invalidData, m_lastInvalidDataTime, INVALID_DATA_DECAY_SECONDS, std::time(nullptr)); }
+
+	//
+	// Higher is better. A peer earns a point for every 16KB/s of throughput (up to 500), and loses a point for every 10ms of latency,
+	// 100 points for every recent timeout, and 1000 points for every time it sent invalid data.
+	// Unmeasured peers score 0, so they're tried before peers that have failed us, but after peers that have served us well.
+	//
+	int64_t GetScore() const
+	{
+		int64_t score = (int64_t)std::min(m_bytesPerSecond / 16384, (uint64_t)500);
+		score -= m_latencyMs / 10;
+		score -= 100 * (int64_t)GetTimeouts();
+		score -= 1000 * (int64_t)GetInvalidData();
+
+		return score;
+	}
+
+	//
+	// Serialization/Deserialization
+	//
+	void Serialize(Serializer& serializer) const
+	{
+		serializer.Append<uint32_t>(m_latencyMs);
+		serializer.Append<uint64_t>(m_bytesPerSecond);
+		serializer.Append<uint32_t>(m_timeouts);
+		serializer.Append<uint32_t>(m_invalidData);
+		serializer.Append<int64_t>(m_lastTimeoutTime);
+		serializer.Append<int64_t>(m_lastInvalidDataTime);
+	}
+
+	static PeerMetrics Deserialize(ByteBuffer& byteBuffer)
+	{
+		const uint32_t latencyMs = byteBuffer.ReadU32();
+		const uint64_t bytesPerSecond = byteBuffer.ReadU64();
+		const uint32_t timeouts = byteBuffer.ReadU32();
+		const uint32_t invalidData = byteBuffer.ReadU32();
+
+		// Metrics saved before failures were timestamped are treated as long forgiven.
+		const bool hasTimes = byteBuffer.GetRemainingSize() > 0;
+		const std::time_t lastTimeoutTime = hasTimes ? (std::time_t)byteBuffer.Read64() : 0;
+		const std::time_t lastInvalidDataTime = hasTimes ? (std::time_t)byteBuffer.Read64() : 0;
+
+		return PeerMetrics(latencyMs, bytesPerSecond, timeouts, invalidData, lastTimeoutTime, lastInvalidDataTime);
+	}
+
+private:
+	// A timeout is forgiven every 10 minutes, and invalid data every 3 hours, counted from the most recent one.
+	static const std::time_t TIMEOUT_DECAY_SECONDS = 10 * 60;
+	static const std::time_t INVALID_DATA_DECAY_SECONDS = 3 * 60 * 60;
+
+	static uint32_t GetDecayed(const uint32_t count, const std::time_t lastTime, const std::time_t decaySeconds, const std::time_t now)
+	{
+		const uint64_t forgiven = (now > lastTime) ? (uint64_t)((now - lastTime) / decaySeconds) : 0;
+		return (forgiven >= count) ? 0 : (uint32_t)(count - forgiven);
+	}
+
+	uint32_t m_latencyMs;
+	uint64_t m_bytesPerSecond;
+	uint32_t m_timeouts;
+	uint32_t m_invalidData;
+	std::time_t m_lastTimeoutTime;
+	std::time_t m_lastInvalidDataTime;
+};
\ No newline at end of file
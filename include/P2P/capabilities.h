@@ -21,6 +21,9 @@ public:
 		// Can provide a list of healthy peers
 		PEER_LIST = 0x04,
 
+		// Can serve the transactions of recent compact blocks by kernel short id (GetBlockTransactions/BlockTransactions).
+		BLOCK_TRANSACTIONS = 0x80,
+
 		FAST_SYNC_NODE = (TXHASHET_HIST | PEER_LIST),
 
 		ARCHIVE_NODE = (FULL_HIST | TXHASHET_HIST | PEER_LIST)
@@ -17,7 +17,12 @@ class ITxHashSet
 public:
 	virtual bool IsUnspent(const OutputIdentifier& output) const = 0;
 	virtual bool IsValid(const Transaction& transaction) const = 0;
-	virtual bool Validate(const BlockHeader& header, const IBlockChainServer& blockChainServer, Commitment& outputSumOut, Commitment& kernelSumOut) = 0;
+
+	//
+	// Fully validates the TxHashSet against the given header.
+	// If mmrHashesVerified is true, the parent hashes of each MMR were already verified while the TxHashSet was being extracted, so they aren't checked again.
+	//
+	virtual bool Validate(const BlockHeader& header, const IBlockChainServer& blockChainServer, const bool mmrHashesVerified, Commitment& outputSumOut, Commitment& kernelSumOut) = 0;
 	virtual bool ApplyBlock(const FullBlock& block) = 0;
 	virtual bool SaveOutputPositions() = 0;
 
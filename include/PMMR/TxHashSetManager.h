@@ -4,6 +4,8 @@
 #include <PMMR/TxHashSet.h>
 #include <Config/Config.h>
 #include <Database/BlockDb.h>
+#include <functional>
+#include <vector>
 
 #ifdef MW_PMMR
 #define TXHASHSET_API __declspec(dllexport)
@@ -14,6 +16,16 @@
 class TXHASHSET_API TxHashSetManager
 {
 public:
+	//
+	// Why LoadFromStream failed. Only INVALID_ARCHIVE means the peer sent a bad archive.
+	//
+	enum class EStreamFailure
+	{
+		TRANSFER_FAILED,
+		INVALID_ARCHIVE,
+		LOCAL_FAILURE
+	};
+
 	TxHashSetManager(const Config& config, IBlockDB& blockDB);
 	~TxHashSetManager() = default;
 
@@ -26,9 +38,40 @@ public:
 	void SetTxHashSet(ITxHashSet* pTxHashSet);
 	static void DestroyTxHashSet(ITxHashSet* pTxHashSet);
 
+	//
+	// Commits the TxHashSet and saves snapshots of the output and rangeproof leaf sets and prune lists into snapshotDir.
+	// The MMR data and hash files are too large to copy while the chain is locked, so their paths (relative to the TxHashSet directory)
+	// and current sizes are returned in filesToCopy, to be copied by CopySnapshotFiles once the lock is released.
+	// The chain must be locked, and the TxHashSet must be at the given header, until this returns.
+	//
+	bool SaveSnapshot(const BlockHeader& header, const std::string& snapshotDir, std::vector<std::pair<std::string, uint64_t>>& filesToCopy);
+
+	//
+	// Copies the first 'size' bytes of each of the files returned by SaveSnapshot into snapshotDir.
+	// The MMR files are only appended to, so those bytes are unchanged unless the TxHashSet is rewound below the snapshot's block.
+	// The caller must check that the block is still confirmed afterwards.
+	//
+	static bool CopySnapshotFiles(const Config& config, const std::string& snapshotDir, const std::vector<std::pair<std::string, uint64_t>>& filesToCopy);
+
+	//
+	// Zips a snapshot saved by SaveSnapshot into a TxHashSet archive at zipPath, then deletes the snapshot folder.
+	// This doesn't need the chain to be locked.
+	//
+	static bool ZipSnapshot(const Config& config, const BlockHeader& header, const std::string& snapshotDir, const std::string& zipPath);
+
 	static ITxHashSet* LoadFromZip(const Config& config, IBlockDB& blockDB, const std::string& zipFilePath, const BlockHeader& header);
 
+	//
+	// Extracts a zipped TxHashSet archive of zippedSize bytes while it's being received, and verifies the MMR hashes as they're extracted.
+	// readChunk is called on the calling thread to fill the given buffer with the next bytes of the archive, and should return 0 if the transfer failed.
+	// Returns null if the transfer failed, the archive was malformed, any MMR hash was invalid, or the files couldn't be written,
+	// in which case failure is set to the reason.
+	//
+	static ITxHashSet* LoadFromStream(const Config& config, IBlockDB& blockDB, const BlockHeader& header, const uint64_t zippedSize, const std::function<size_t(unsigned char*, const size_t)>& readChunk, EStreamFailure& failure);
+
 private:
+	static ITxHashSet* LoadExtracted(const Config& config, IBlockDB& blockDB, const BlockHeader& header);
+
 	const Config& m_config;
 	IBlockDB& m_blockDB;
 	ITxHashSet* m_pTxHashSet;
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Core/BlockHeader.h>
+#include <FileUtil.h>
+#include <string>
+
+//
+// A zipped TxHashSet archive, taken at a specific block, that can be served to any peer requesting state at or near that block.
+// Snapshots are shared by every peer being served, and the archive is deleted once the last reference to the snapshot is released.
+//
+class TxHashSetSnapshot
+{
+public:
+	TxHashSetSnapshot(const BlockHeader& header, const std::string& zipPath, const uint64_t zippedSize)
+		: m_header(header), m_zipPath(zipPath), m_zippedSize(zippedSize)
+	{
+
+	}
+
+	TxHashSetSnapshot(const TxHashSetSnapshot& other) = delete;
+	TxHashSetSnapshot& operator=(const TxHashSetSnapshot& other) = delete;
+
+	~TxHashSetSnapshot()
+	{
+		FileUtil::RemoveFile(m_zipPath);
+	}
+
+	inline const BlockHeader& GetHeader() const { return m_header; }
+	inline const std::string& GetZipPath() const { return m_zipPath; }
+	inline uint64_t GetZippedSize() const { return m_zippedSize; }
+
+private:
+	BlockHeader m_header;
+	std::string m_zipPath;
+	uint64_t m_zippedSize;
+};
\ No newline at end of file
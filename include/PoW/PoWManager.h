@@ -24,6 +24,17 @@ public:
 
 	bool IsPoWValid(const BlockHeader& header, const BlockHeader& previousHeader) const;
 
+	//
+	// Validates the difficulty claimed by the header against the previous header, without verifying the proof's cycle.
+	//
+	bool IsDifficultyValid(const BlockHeader& header, const BlockHeader& previousHeader) const;
+
+	//
+	// Verifies the Cuckaroo/Cuckatoo cycle. This is the expensive part of IsPoWValid, and depends only on the header,
+	// so it can be run for many headers in parallel before their predecessors are known.
+	//
+	bool IsProofValid(const BlockHeader& header) const;
+
 private:
 	const Config& m_config;
 };
\ No newline at end of file
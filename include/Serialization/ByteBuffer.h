@@ -14,12 +14,23 @@
 #include <stdint.h>
 
 #include <BigInteger.h>
+#include <Common/ByteSpan.h>
 
+//
+// Reads serialized values from a borrowed range of bytes.
+// The ByteBuffer does not copy or own the bytes, so they must outlive it.
+//
 class ByteBuffer
 {
 public:
 	ByteBuffer(const std::vector<unsigned char>& bytes)
-		: m_bytes(bytes), m_index(0)
+		: m_index(0), m_bytes(bytes)
+	{
+
+	}
+
+	ByteBuffer(const ByteSpan& bytes)
+		: m_index(0), m_bytes(bytes)
 	{
 
 	}
@@ -38,10 +49,9 @@ public:
 		}
 		else
 		{
-			std::vector<unsigned char> temp;
-			temp.resize(sizeof(T));
-			std::reverse_copy(m_bytes.cbegin() + m_index, m_bytes.cbegin() + m_index + sizeof(T), temp.begin());
-			memcpy(&t, &temp[0], sizeof(T));
+			unsigned char temp[sizeof(T)];
+			std::reverse_copy(m_bytes.cbegin() + m_index, m_bytes.cbegin() + m_index + sizeof(T), temp);
+			memcpy(&t, temp, sizeof(T));
 		}
 
 		m_index += sizeof(T);
@@ -57,10 +67,9 @@ public:
 
 		if (EndianHelper::IsBigEndian())
 		{
-			std::vector<unsigned char> temp;
-			temp.resize(sizeof(T));
-			std::reverse_copy(m_bytes.cbegin() + m_index, m_bytes.cbegin() + m_index + sizeof(T), temp.begin());
-			memcpy(&t, &temp[0], sizeof(T));
+			unsigned char temp[sizeof(T)];
+			std::reverse_copy(m_bytes.cbegin() + m_index, m_bytes.cbegin() + m_index + sizeof(T), temp);
+			memcpy(&t, temp, sizeof(T));
 		}
 		else
 		{
@@ -169,11 +178,11 @@ public:
 			throw DeserializationException();
 		}
 
-		std::vector<unsigned char> data(m_bytes.cbegin() + m_index, m_bytes.cbegin() + m_index + NUM_BYTES);
+		const CBigInteger<NUM_BYTES> bigInteger(&m_bytes[m_index]);
 
 		m_index += NUM_BYTES;
 
-		return CBigInteger<NUM_BYTES>(data);
+		return bigInteger;
 	}
 
 	std::vector<unsigned char> ReadVector(const uint64_t numBytes)
@@ -189,7 +198,9 @@ public:
 		return std::vector<unsigned char>(m_bytes.cbegin() + index, m_bytes.cbegin() + index + numBytes);
 	}
 
+	inline size_t GetRemainingSize() const { return m_bytes.size() - m_index; }
+
 private:
 	size_t m_index;
-	const std::vector<unsigned char>& m_bytes;
+	ByteSpan m_bytes;
 };
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <iterator>
 
 class Serializer
 {
@@ -20,31 +21,31 @@ public:
 	template <class T>
 	void Append(const T& t)
 	{
-		std::vector<unsigned char> temp(sizeof(T));
-		memcpy(&temp[0], &t, sizeof(T));
+		unsigned char temp[sizeof(T)];
+		memcpy(temp, &t, sizeof(T));
 
 		if (EndianHelper::IsBigEndian())
 		{
-			m_serialized.insert(m_serialized.end(), temp.cbegin(), temp.cend());
+			m_serialized.insert(m_serialized.end(), temp, temp + sizeof(T));
 		}
 		else
 		{
-			m_serialized.insert(m_serialized.end(), temp.crbegin(), temp.crend());
+			m_serialized.insert(m_serialized.end(), std::reverse_iterator<unsigned char*>(temp + sizeof(T)), std::reverse_iterator<unsigned char*>(temp));
 		}
 	}
 	template <class T>
 	void AppendLittleEndian(const T& t)
 	{
-		std::vector<unsigned char> temp(sizeof(T));
-		memcpy(&temp[0], &t, sizeof(T));
+		unsigned char temp[sizeof(T)];
+		memcpy(temp, &t, sizeof(T));
 
 		if (EndianHelper::IsBigEndian())
 		{
-			m_serialized.insert(m_serialized.end(), temp.crbegin(), temp.crend());
+			m_serialized.insert(m_serialized.end(), std::reverse_iterator<unsigned char*>(temp + sizeof(T)), std::reverse_iterator<unsigned char*>(temp));
 		}
 		else
 		{
-			m_serialized.insert(m_serialized.end(), temp.cbegin(), temp.cend());
+			m_serialized.insert(m_serialized.end(), temp, temp + sizeof(T));
 		}
 	}
 
@@ -63,12 +64,12 @@ public:
 	template<size_t NUM_BYTES>
 	void AppendBigInteger(const CBigInteger<NUM_BYTES>& bigInteger)
 	{
-		const std::vector<unsigned char>& data = bigInteger.GetData();
-		//std::reverse(data.begin(), data.end());
+		const std::array<unsigned char, NUM_BYTES>& data = bigInteger.GetData();
 		m_serialized.insert(m_serialized.end(), data.cbegin(), data.cend());
 	}
 
 	inline const std::vector<unsigned char>& GetBytes() const { return m_serialized; }
+	inline std::vector<unsigned char> TakeBytes() { return std::move(m_serialized); }
 
 private:
 	std::vector<unsigned char> m_serialized;
@@ -32,6 +32,10 @@ class IBlockDB;
 class ITransactionPool
 {
 public:
+	//
+	// Looks up the kernel short ids of a compact block in the mempool, and in the transactions confirmed by the most recent blocks,
+	// so peers that are still hydrating a block can be served the transactions it confirmed.
+	//
 	virtual std::vector<Transaction> GetTransactionsByShortId(const Hash& hash, const uint64_t nonce, const std::set<ShortId>& missingShortIds) const = 0;
 	virtual bool AddTransaction(const Transaction& transaction, const EPoolType poolType, const BlockHeader& lastConfirmedBlock) = 0;
 	virtual std::vector<Transaction> FindTransactionsByKernel(const std::set<TransactionKernel>& kernels) const = 0;
@@ -46,7 +50,11 @@ public:
 	virtual bool ValidateTransaction(const Transaction& transaction) const = 0;
 	virtual bool ValidateTransactionBody(const TransactionBody& transactionBody, const bool withReward) const = 0;
 
-	// TODO: Prepare Mineable Transactions
+	//
+	// Returns an aggregate of the highest fee rate mempool transactions that fit in a block of the given weight
+	// (capped at Consensus::MAX_BLOCK_WEIGHT), with room left for the coinbase output and kernel.
+	//
+	virtual std::unique_ptr<Transaction> BuildBlockTemplate(const uint64_t maxWeight) = 0;
 };
 
 namespace TxPoolAPI